@@ -26,12 +26,20 @@ SOFTWARE.
 #include "Perlin.h"
 
 #include "PolyVox/MaterialDensityPair.h"
+#include "PolyVox/CompressedFilePager.h"
 #include "PolyVox/CubicSurfaceExtractor.h"
+#include "PolyVox/LZCompressor.h"
 #include "PolyVox/MarchingCubesSurfaceExtractor.h"
 #include "PolyVox/Mesh.h"
 #include "PolyVox/PagedVolume.h"
+#include "PolyVox/RLECompressor.h"
+
+#include "PolyVox/Impl/Timer.h"
 
 #include <QApplication>
+#include <QTemporaryDir>
+
+#include <vector>
 
 // Use the PolyVox namespace
 using namespace PolyVox;
@@ -104,11 +112,53 @@ public:
 	}
 };
 
+/**
+ * Writes the given voxels to disk through a CompressedFilePager and reads them back, reporting the throughput and compression ratio.
+ * The chunk files go in a temporary folder, which is deleted again afterwards.
+ */
+void benchmarkCompressedFilePager(const char* szName, Compressor* pCompressor, const Region& region, const std::vector<MaterialDensityPair44>& vecVoxels)
+{
+	QTemporaryDir tempDir;
+	if (!tempDir.isValid())
+	{
+		std::cout << szName << ": could not create a temporary folder for the chunk files" << std::endl;
+		return;
+	}
+
+	const int32_t iChunkSideLength = 64;
+	CompressedFilePager<MaterialDensityPair44> pager(tempDir.path().toStdString(), pCompressor);
+
+	float fWriteTime = 0.0f;
+	{
+		PagedVolume<MaterialDensityPair44> volData(&pager, 64 * 1024 * 1024, iChunkSideLength);
+		volData.writeRegion(region, vecVoxels.data());
+
+		Timer timer;
+		volData.flushAll();
+		fWriteTime = timer.elapsedTimeInSeconds();
+	}
+
+	float fReadTime = 0.0f;
+	{
+		PagedVolume<MaterialDensityPair44> volData(&pager, 64 * 1024 * 1024, iChunkSideLength);
+
+		Timer timer;
+		volData.prefetch(region);
+		fReadTime = timer.elapsedTimeInSeconds();
+	}
+
+	const CompressedFilePager<MaterialDensityPair44>::Statistics stats = pager.getStatistics();
+	const double dMegabytes = stats.uNoOfUncompressedBytesWritten / 1024.0 / 1024.0;
+	std::cout << szName << ": wrote " << dMegabytes / fWriteTime << "MB/s, read " << dMegabytes / fReadTime << "MB/s, compression ratio "
+		<< static_cast<double>(stats.uNoOfUncompressedBytesWritten) / stats.uNoOfStoredBytesWritten << ":1" << std::endl;
+}
+
 class PagingExample : public PolyVoxExample
 {
 public:
-	PagingExample(QWidget *parent)
+	PagingExample(QWidget *parent, bool bBenchmarkPager)
 		:PolyVoxExample(parent)
+		, m_bBenchmarkPager(bBenchmarkPager)
 	{
 	}
 
@@ -128,6 +178,20 @@ protected:
 		volData.flushAll();
 		std::cout << "Memory usage: " << (volData.calculateSizeInBytes() / 1024.0 / 1024.0) << "MB" << std::endl;
 
+		// Compare the compressors which can be used for storing the terrain on disk. The region is aligned to the chunks.
+		// This writes and reads back 256^3 voxels for each compressor, so it only happens when asked for on the command line.
+		if (m_bBenchmarkPager)
+		{
+			PolyVox::Region regBenchmark(Vector3DInt32(0, 0, 0), Vector3DInt32(255, 255, 255));
+			std::vector<MaterialDensityPair44> vecVoxels(regBenchmark.getWidthInVoxels() * regBenchmark.getHeightInVoxels() * regBenchmark.getDepthInVoxels());
+			volData.readRegion(regBenchmark, vecVoxels.data());
+
+			LZCompressor lzCompressor;
+			benchmarkCompressedFilePager("LZCompressor", &lzCompressor, regBenchmark, vecVoxels);
+			RLECompressor<MaterialDensityPair44, uint16_t> rleCompressor;
+			benchmarkCompressedFilePager("RLECompressor", &rleCompressor, regBenchmark, vecVoxels);
+		}
+
 		// Extract the surface
 		PolyVox::Region reg2(Vector3DInt32(0, 0, 0), Vector3DInt32(254, 254, 254));
 		auto mesh = extractCubicMesh(&volData, reg2);
@@ -140,13 +204,18 @@ protected:
 
 		setCameraTransform(QVector3D(300.0f, 300.0f, 300.0f), -(PI / 4.0f), PI + (PI / 4.0f));
 	}
+
+private:
+	bool m_bBenchmarkPager;
 };
 
 int main(int argc, char *argv[])
 {
 	// Create and show the Qt OpenGL window
 	QApplication app(argc, argv);
-	PagingExample openGLWidget(0);
+
+	// Pass --benchmark-pager to also time the CompressedFilePager with each compressor.
+	PagingExample openGLWidget(0, app.arguments().contains("--benchmark-pager"));
 	openGLWidget.show();
 
 	// Run the message pump.
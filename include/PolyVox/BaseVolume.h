@@ -25,17 +25,19 @@
 #ifndef __PolyVox_BaseVolume_H__
 #define __PolyVox_BaseVolume_H__
 
+#include "BufferLayout.h"
 #include "Region.h"
 #include "Vector.h"
 
 #include <limits>
+#include <type_traits>
 
 namespace PolyVox
 {
 	/// The BaseVolume class provides common functionality and an interface for other volume classes to implement.
-	/// You should not try to create an instance of this class directly. Instead you should use RawVolume or PagedVolume.
+	/// You should not try to create an instance of this class directly. Instead you should use RawVolume, PagedVolume, SparseOctreeVolume or BrickVolume.
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	/// \sa RawVolume, PagedVolume
+	/// \sa RawVolume, PagedVolume, SparseOctreeVolume, BrickVolume
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <typename _VoxelType>
 	class BaseVolume
@@ -118,6 +120,11 @@ namespace PolyVox
 		/// Sets the voxel at the position given by a 3D vector
 		void setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue);
 
+		/// Copies all the voxels in a region into a buffer. Subclasses which don't provide this can be read with readVolumeRegion()
+		void readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout = BufferLayout()) const;
+		/// Copies all the voxels in a region from a buffer. Subclasses which don't provide this can be written with writeVolumeRegion()
+		void writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout = BufferLayout());
+
 		/// Calculates approximatly how many bytes of memory the volume is currently using.
 		uint32_t calculateSizeInBytes(void);
 
@@ -134,6 +141,16 @@ namespace PolyVox
 		/// Assignment operator
 		BaseVolume& operator=(const BaseVolume& rhs);
 	};
+
+	/// Copies all the voxels in a region of a volume into a buffer. This uses the volume's own readRegion() if it has one, and
+	/// otherwise falls back to reading the voxels one at a time with getVoxel(), so that it works with any subclass of BaseVolume.
+	template <typename VolumeType>
+	void readVolumeRegion(const VolumeType* pVolume, const Region& regRead, typename VolumeType::VoxelType* pDstBuffer, const BufferLayout& layout = BufferLayout());
+
+	/// Copies all the voxels in a region of a volume from a buffer. This uses the volume's own writeRegion() if it has one, and
+	/// otherwise falls back to writing the voxels one at a time with setVoxel(), so that it works with any subclass of BaseVolume.
+	template <typename VolumeType>
+	void writeVolumeRegion(VolumeType* pVolume, const Region& regWrite, const typename VolumeType::VoxelType* pSrcBuffer, const BufferLayout& layout = BufferLayout());
 }
 
 #include "BaseVolume.inl"
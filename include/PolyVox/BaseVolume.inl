@@ -27,7 +27,7 @@ namespace PolyVox
 	////////////////////////////////////////////////////////////////////////////////
 	/// This is protected because you should never create a BaseVolume directly, you should instead use one of the derived classes.
 	///
-	/// \sa RawVolume, PagedVolume
+	/// \sa RawVolume, PagedVolume, SparseOctreeVolume, BrickVolume
 	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
 	BaseVolume<VoxelType>::BaseVolume()
@@ -118,6 +118,28 @@ namespace PolyVox
 		POLYVOX_THROW(not_implemented, "You should never call the base class version of this function.");
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param regRead The region to copy
+	/// \param pDstBuffer The buffer to copy into, which must hold at least layout.getRequiredBufferSize(regRead) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BaseVolume<VoxelType>::readRegion(const Region& /*regRead*/, VoxelType* /*pDstBuffer*/, const BufferLayout& /*layout*/) const
+	{
+		POLYVOX_THROW(not_implemented, "This volume does not implement readRegion(), use readVolumeRegion() instead.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param regWrite The region to copy
+	/// \param pSrcBuffer The buffer to copy from, which must hold at least layout.getRequiredBufferSize(regWrite) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BaseVolume<VoxelType>::writeRegion(const Region& /*regWrite*/, const VoxelType* /*pSrcBuffer*/, const BufferLayout& /*layout*/)
+	{
+		POLYVOX_THROW(not_implemented, "This volume does not implement writeRegion(), use writeVolumeRegion() instead.");
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// 
 	////////////////////////////////////////////////////////////////////////////////
@@ -126,5 +148,95 @@ namespace PolyVox
 	{
 		POLYVOX_THROW(not_implemented, "You should never call the base class version of this function.");
 	}
-}
 
+	namespace Impl
+	{
+		// A volume which doesn't declare its own readRegion() or writeRegion() inherits the ones from BaseVolume, and
+		// taking their address then gives a pointer to a member of the base class rather than of the volume itself.
+		template <typename VolumeType>
+		struct HasOwnReadRegion
+		{
+			typedef typename VolumeType::VoxelType VoxelType;
+			static const bool value = !std::is_same<decltype(&VolumeType::readRegion),
+				void (BaseVolume<VoxelType>::*)(const Region&, VoxelType*, const BufferLayout&) const>::value;
+		};
+
+		template <typename VolumeType>
+		struct HasOwnWriteRegion
+		{
+			typedef typename VolumeType::VoxelType VoxelType;
+			static const bool value = !std::is_same<decltype(&VolumeType::writeRegion),
+				void (BaseVolume<VoxelType>::*)(const Region&, const VoxelType*, const BufferLayout&)>::value;
+		};
+
+		template <typename VolumeType>
+		void readVolumeRegion(const VolumeType* pVolume, const Region& regRead, typename VolumeType::VoxelType* pDstBuffer, const BufferLayout& layout, std::true_type)
+		{
+			pVolume->readRegion(regRead, pDstBuffer, layout);
+		}
+
+		template <typename VolumeType>
+		void readVolumeRegion(const VolumeType* pVolume, const Region& regRead, typename VolumeType::VoxelType* pDstBuffer, const BufferLayout& layout, std::false_type)
+		{
+			layout.validate(regRead);
+
+			for (int32_t z = 0; z < regRead.getDepthInVoxels(); z++)
+			{
+				for (int32_t y = 0; y < regRead.getHeightInVoxels(); y++)
+				{
+					for (int32_t x = 0; x < regRead.getWidthInVoxels(); x++)
+					{
+						pDstBuffer[layout.getIndex(regRead, x, y, z)] = pVolume->getVoxel(regRead.getLowerX() + x, regRead.getLowerY() + y, regRead.getLowerZ() + z);
+					}
+				}
+			}
+		}
+
+		template <typename VolumeType>
+		void writeVolumeRegion(VolumeType* pVolume, const Region& regWrite, const typename VolumeType::VoxelType* pSrcBuffer, const BufferLayout& layout, std::true_type)
+		{
+			pVolume->writeRegion(regWrite, pSrcBuffer, layout);
+		}
+
+		template <typename VolumeType>
+		void writeVolumeRegion(VolumeType* pVolume, const Region& regWrite, const typename VolumeType::VoxelType* pSrcBuffer, const BufferLayout& layout, std::false_type)
+		{
+			layout.validate(regWrite);
+
+			for (int32_t z = 0; z < regWrite.getDepthInVoxels(); z++)
+			{
+				for (int32_t y = 0; y < regWrite.getHeightInVoxels(); y++)
+				{
+					for (int32_t x = 0; x < regWrite.getWidthInVoxels(); x++)
+					{
+						pVolume->setVoxel(regWrite.getLowerX() + x, regWrite.getLowerY() + y, regWrite.getLowerZ() + z, pSrcBuffer[layout.getIndex(regWrite, x, y, z)]);
+					}
+				}
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param pVolume The volume to copy from
+	/// \param regRead The region to copy
+	/// \param pDstBuffer The buffer to copy into, which must hold at least layout.getRequiredBufferSize(regRead) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VolumeType>
+	void readVolumeRegion(const VolumeType* pVolume, const Region& regRead, typename VolumeType::VoxelType* pDstBuffer, const BufferLayout& layout)
+	{
+		Impl::readVolumeRegion(pVolume, regRead, pDstBuffer, layout, std::integral_constant<bool, Impl::HasOwnReadRegion<VolumeType>::value>());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param pVolume The volume to copy into
+	/// \param regWrite The region to copy
+	/// \param pSrcBuffer The buffer to copy from, which must hold at least layout.getRequiredBufferSize(regWrite) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VolumeType>
+	void writeVolumeRegion(VolumeType* pVolume, const Region& regWrite, const typename VolumeType::VoxelType* pSrcBuffer, const BufferLayout& layout)
+	{
+		Impl::writeVolumeRegion(pVolume, regWrite, pSrcBuffer, layout, std::integral_constant<bool, Impl::HasOwnWriteRegion<VolumeType>::value>());
+	}
+}
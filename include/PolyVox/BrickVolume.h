@@ -0,0 +1,274 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_BrickVolume_H__
+#define __PolyVox_BrickVolume_H__
+
+#include "BaseVolume.h"
+#include "Region.h"
+#include "Vector.h"
+
+#include "Impl/SlabPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new> //For placement new
+#include <stdexcept> //For invalid_argument
+#include <vector>
+
+namespace PolyVox
+{
+	/**
+	 * A fixed size volume which stores its voxels in small bricks, and shares a single brick between all the parts of the volume which
+	 * are entirely empty or entirely full.
+	 *
+	 * The volume is divided into bricks of 8x8x8 voxels, and a flat grid holds a pointer to the brick for each part of the volume. Finding
+	 * a voxel therefore takes two array lookups (one in the grid and one in the brick) with no hashing, so access is almost as fast as for
+	 * a RawVolume. Bricks in which every voxel has the default value of the VoxelType all point at one shared 'empty' brick, and those in
+	 * which every voxel has the 'full' value given to the constructor all point at a shared 'full' brick. A brick of its own is only
+	 * allocated when a voxel in a shared brick is changed, and is given back when it becomes entirely empty or full again. Bricks are
+	 * allocated from a pool rather than individually on the heap.
+	 *
+	 * Each brick also keeps a bitmask recording which of its voxels are occupied (i.e. do not have the default value). This lets the volume
+	 * tell when a brick has become empty without examining its voxels, and lets isRegionEmpty() check whole rows of a brick at once.
+	 *
+	 * This sits between the RawVolume, which needs memory for every voxel, and the PagedVolume, which supports unbounded volumes but has
+	 * to find its chunks through a hash map and a Pager. It is a good fit for scenes which are too sparse to store densely but which are
+	 * accessed too heavily for the SparseOctreeVolume, such as edited terrain with large areas of air and solid ground.
+	 *
+	 * The Sampler keeps pointers to the brick containing its current position and to the 26 bricks around it, so its peek functions can
+	 * read neighbouring voxels without any lookups in the grid even when they lie in a different brick.
+	 */
+	template <typename VoxelType>
+	class BrickVolume : public BaseVolume<VoxelType>
+	{
+	public:
+		/// The length of each side of a brick, in voxels.
+		static const uint32_t uBrickSideLength = 8;
+		/// The base two logarithm of uBrickSideLength.
+		static const uint32_t uBrickSideLengthPower = 3;
+		/// The number of voxels in each brick.
+		static const uint32_t uBrickSizeInVoxels = uBrickSideLength * uBrickSideLength * uBrickSideLength;
+
+	private:
+		struct Brick
+		{
+			VoxelType atVoxels[uBrickSizeInVoxels];
+			// One bit for each voxel, which is set if the voxel does not have the default value.
+			uint64_t auOccupancy[uBrickSizeInVoxels / 64];
+			// The number of voxels which do not have the default value, and the number which have the full value.
+			uint16_t uNoOfOccupiedVoxels;
+			uint16_t uNoOfFullVoxels;
+		};
+
+	public:
+#ifndef SWIG
+#if defined(_MSC_VER)
+		class Sampler : public BaseVolume<VoxelType>::Sampler< BrickVolume<VoxelType> > //This line works on VS2010
+#else
+		class Sampler : public BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> > //This line works on GCC
+#endif
+		{
+		public:
+			Sampler(BrickVolume<VoxelType>* volume);
+			~Sampler();
+
+			inline VoxelType getVoxel(void) const;
+
+			bool isCurrentPositionValid(void) const;
+
+			void setPosition(const Vector3DInt32& v3dNewPos);
+			void setPosition(int32_t xPos, int32_t yPos, int32_t zPos);
+			inline bool setVoxel(VoxelType tValue);
+
+			void movePositiveX(void);
+			void movePositiveY(void);
+			void movePositiveZ(void);
+
+			void moveNegativeX(void);
+			void moveNegativeY(void);
+			void moveNegativeZ(void);
+
+			inline VoxelType peekVoxel1nx1ny1nz(void) const;
+			inline VoxelType peekVoxel1nx1ny0pz(void) const;
+			inline VoxelType peekVoxel1nx1ny1pz(void) const;
+			inline VoxelType peekVoxel1nx0py1nz(void) const;
+			inline VoxelType peekVoxel1nx0py0pz(void) const;
+			inline VoxelType peekVoxel1nx0py1pz(void) const;
+			inline VoxelType peekVoxel1nx1py1nz(void) const;
+			inline VoxelType peekVoxel1nx1py0pz(void) const;
+			inline VoxelType peekVoxel1nx1py1pz(void) const;
+
+			inline VoxelType peekVoxel0px1ny1nz(void) const;
+			inline VoxelType peekVoxel0px1ny0pz(void) const;
+			inline VoxelType peekVoxel0px1ny1pz(void) const;
+			inline VoxelType peekVoxel0px0py1nz(void) const;
+			inline VoxelType peekVoxel0px0py0pz(void) const;
+			inline VoxelType peekVoxel0px0py1pz(void) const;
+			inline VoxelType peekVoxel0px1py1nz(void) const;
+			inline VoxelType peekVoxel0px1py0pz(void) const;
+			inline VoxelType peekVoxel0px1py1pz(void) const;
+
+			inline VoxelType peekVoxel1px1ny1nz(void) const;
+			inline VoxelType peekVoxel1px1ny0pz(void) const;
+			inline VoxelType peekVoxel1px1ny1pz(void) const;
+			inline VoxelType peekVoxel1px0py1nz(void) const;
+			inline VoxelType peekVoxel1px0py0pz(void) const;
+			inline VoxelType peekVoxel1px0py1pz(void) const;
+			inline VoxelType peekVoxel1px1py1nz(void) const;
+			inline VoxelType peekVoxel1px1py0pz(void) const;
+			inline VoxelType peekVoxel1px1py1pz(void) const;
+
+		private:
+			// Looks up the bricks around the current position, and works out where each neighbouring voxel is found.
+			void updateBricks(void);
+			// Works out where the neighbours along one axis are found, given the position within the brick along that axis and the
+			// distance between bricks in m_apBricks and between voxels in a brick along that axis.
+			static void updateNeighbourOffsets(uint32_t uPosInBrick, uint32_t uBrickStride, int32_t iVoxelStride, uint32_t* pBrickOffsets, int32_t* pVoxelOffsets);
+			// Works out whether the current position and its neighbours are inside the volume. Returns whether the brick pointers can
+			// still be used, which is the case if the position is valid and no bricks have been allocated or freed since they were found.
+			bool updateValidity(void);
+			inline VoxelType peekVoxel(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const;
+
+			// The current position relative to the lower corner of the volume.
+			uint32_t m_uXPosInGrid;
+			uint32_t m_uYPosInGrid;
+			uint32_t m_uZPosInGrid;
+
+			// The brick containing the current position and the 26 around it, with the x position varying fastest. The pointers are only
+			// meaningful while the current position is valid and no bricks have been allocated or freed since they were found (see
+			// m_uRevision). Any of them which lie outside the volume are null.
+			const Brick* m_apBricks[27];
+			uint32_t m_uIndexInBrick;
+			uint32_t m_uRevision;
+
+			// For an offset of -1, 0 or +1 along each axis, which of m_apBricks holds the neighbouring voxel (the x, y and z values
+			// are added together) and how far it is from the current voxel within that brick (likewise added to m_uIndexInBrick).
+			uint32_t m_auXBrickOffsets[3];
+			uint32_t m_auYBrickOffsets[3];
+			uint32_t m_auZBrickOffsets[3];
+			int32_t m_aiXVoxelOffsets[3];
+			int32_t m_aiYVoxelOffsets[3];
+			int32_t m_aiZVoxelOffsets[3];
+
+			bool m_bIsCurrentPositionValid;
+			// Whether all 26 neighbours of the current position are inside the volume, so that the peek functions can use the bricks.
+			bool m_bAreNeighboursValid;
+		};
+#endif // SWIG
+
+	public:
+		/// Constructor for creating a fixed size volume.
+		BrickVolume(const Region& regValid, VoxelType tFullValue = VoxelType());
+
+		/// Destructor
+		~BrickVolume();
+
+		/// Gets the value used for voxels which are outside the volume
+		VoxelType getBorderValue(void) const;
+		/// Gets a Region representing the extents of the Volume.
+		const Region& getEnclosingRegion(void) const;
+
+		/// Gets the width of the volume in voxels.
+		int32_t getWidth(void) const;
+		/// Gets the height of the volume in voxels.
+		int32_t getHeight(void) const;
+		/// Gets the depth of the volume in voxels.
+		int32_t getDepth(void) const;
+
+		/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+		VoxelType getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets a voxel at the position given by a 3D vector
+		VoxelType getVoxel(const Vector3DInt32& v3dPos) const;
+
+		/// Sets the value used for voxels which are outside the volume
+		void setBorderValue(const VoxelType& tBorder);
+		/// Sets the voxel at the position given by <tt>x,y,z</tt> coordinates
+		void setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
+		/// Sets the voxel at the position given by a 3D vector
+		void setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue);
+
+		/// Copies all the voxels in a region into a buffer
+		void readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout = BufferLayout()) const;
+		/// Copies all the voxels in a region from a buffer
+		void writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout = BufferLayout());
+
+		/// Determines whether every voxel in a region has the default value.
+		bool isRegionEmpty(const Region& regToCheck) const;
+
+		/// Gets the number of bricks which have been allocated, not counting the shared empty and full bricks.
+		uint32_t getNoOfAllocatedBricks(void) const;
+
+		/// Calculates approximatly how many bytes of memory the volume is currently using.
+		uint32_t calculateSizeInBytes(void);
+
+	protected:
+		/// Copy constructor
+		BrickVolume(const BrickVolume& rhs);
+
+		/// Assignment operator
+		BrickVolume& operator=(const BrickVolume& rhs);
+
+	private:
+		uint32_t getBrickIndex(uint32_t uXBrick, uint32_t uYBrick, uint32_t uZBrick) const;
+		static uint32_t getIndexInBrick(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos);
+
+		bool isSharedBrick(const Brick* pBrick) const;
+		void initialiseSharedBrick(Brick& brick, VoxelType tValue);
+		Brick* allocateBrick(const Brick& source);
+		void freeBrick(uint32_t uBrickIndex, Brick* pSharedBrick);
+
+		//The size of the volume
+		Region m_regValidRegion;
+
+		//The border value
+		VoxelType m_tBorderValue;
+
+		// The value of the voxels in the shared full brick.
+		VoxelType m_tFullValue;
+
+		// The grid of bricks, with the x position varying fastest. Each entry points either at one of the shared bricks (which are never
+		// written to) or at a brick from the pool which belongs to that entry alone.
+		uint32_t m_uWidthInBricks;
+		uint32_t m_uHeightInBricks;
+		uint32_t m_uDepthInBricks;
+		std::vector<Brick*> m_vecBricks;
+
+		Brick m_sharedEmptyBrick;
+		Brick m_sharedFullBrick;
+
+		// The bricks are allocated from here. It has room for the whole grid, though the slabs are only allocated as they are needed.
+		std::unique_ptr<SlabPool> m_pBrickPool;
+		uint32_t m_uNoOfAllocatedBricks;
+
+		// Incremented whenever a brick is allocated or freed, so that samplers know their brick pointers are out of date.
+		uint32_t m_uRevision;
+	};
+}
+
+#include "BrickVolume.inl"
+#include "BrickVolumeSampler.inl"
+
+#endif //__PolyVox_BrickVolume_H__
@@ -0,0 +1,533 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// This constructor creates a volume with a fixed size which is specified as a parameter. Initially every voxel has the
+	/// default value of the VoxelType, so every entry in the grid points at the shared empty brick.
+	/// \param regValid Specifies the minimum and maximum valid voxel positions.
+	/// \param tFullValue The value of the voxels in the shared full brick, such as the material of solid ground.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	BrickVolume<VoxelType>::BrickVolume(const Region& regValid, VoxelType tFullValue)
+		:BaseVolume<VoxelType>()
+		, m_regValidRegion(regValid)
+		, m_tBorderValue()
+		, m_tFullValue(tFullValue)
+		, m_uWidthInBricks(0)
+		, m_uHeightInBricks(0)
+		, m_uDepthInBricks(0)
+		, m_uNoOfAllocatedBricks(0)
+		, m_uRevision(0)
+	{
+		if (this->getWidth() <= 0)
+		{
+			POLYVOX_THROW(std::invalid_argument, "Volume width must be greater than zero.");
+		}
+		if (this->getHeight() <= 0)
+		{
+			POLYVOX_THROW(std::invalid_argument, "Volume height must be greater than zero.");
+		}
+		if (this->getDepth() <= 0)
+		{
+			POLYVOX_THROW(std::invalid_argument, "Volume depth must be greater than zero.");
+		}
+
+		// The bricks are aligned to the lower corner of the volume, and those at the upper edges may extend outside it.
+		m_uWidthInBricks = (static_cast<uint32_t>(this->getWidth()) + uBrickSideLength - 1) >> uBrickSideLengthPower;
+		m_uHeightInBricks = (static_cast<uint32_t>(this->getHeight()) + uBrickSideLength - 1) >> uBrickSideLengthPower;
+		m_uDepthInBricks = (static_cast<uint32_t>(this->getDepth()) + uBrickSideLength - 1) >> uBrickSideLengthPower;
+		const uint32_t uNoOfBricks = m_uWidthInBricks * m_uHeightInBricks * m_uDepthInBricks;
+
+		initialiseSharedBrick(m_sharedEmptyBrick, VoxelType());
+		initialiseSharedBrick(m_sharedFullBrick, m_tFullValue);
+		m_vecBricks.resize(uNoOfBricks, &m_sharedEmptyBrick);
+
+		m_pBrickPool.reset(new SlabPool(sizeof(Brick), uNoOfBricks));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This function should never be called. Copying volumes by value would be expensive, and we want to prevent users from doing
+	/// it by accident (such as when passing them as paramenters to functions). That said, there are times when you really do want to
+	/// make a copy of a volume and in this case you should look at the VolumeResampler.
+	///
+	/// \sa VolumeResampler
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	BrickVolume<VoxelType>::BrickVolume(const BrickVolume<VoxelType>& /*rhs*/)
+	{
+		POLYVOX_THROW(not_implemented, "Volume copy constructor not implemented for performance reasons.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Destroys the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	BrickVolume<VoxelType>::~BrickVolume()
+	{
+		// The pool expects all of its blocks to have been given back before it is destroyed.
+		for (uint32_t uBrickIndex = 0; uBrickIndex < m_vecBricks.size(); uBrickIndex++)
+		{
+			if (!isSharedBrick(m_vecBricks[uBrickIndex]))
+			{
+				freeBrick(uBrickIndex, &m_sharedEmptyBrick);
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This function should never be called. Copying volumes by value would be expensive, and we want to prevent users from doing
+	/// it by accident (such as when passing them as paramenters to functions). That said, there are times when you really do want to
+	/// make a copy of a volume and in this case you should look at the VolumeResampler.
+	///
+	/// \sa VolumeResampler
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	BrickVolume<VoxelType>& BrickVolume<VoxelType>::operator=(const BrickVolume<VoxelType>& /*rhs*/)
+	{
+		POLYVOX_THROW(not_implemented, "Volume assignment operator not implemented for performance reasons.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The border value is returned whenever an attempt is made to read a voxel which
+	/// is outside the extents of the volume.
+	/// \return The value used for voxels outside of the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::getBorderValue(void) const
+	{
+		return m_tBorderValue;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return A Region representing the extent of the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const Region& BrickVolume<VoxelType>::getEnclosingRegion(void) const
+	{
+		return m_regValidRegion;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The width of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g. 0 to 63 then the width is 64.
+	/// \sa getHeight(), getDepth()
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	int32_t BrickVolume<VoxelType>::getWidth(void) const
+	{
+		return m_regValidRegion.getUpperX() - m_regValidRegion.getLowerX() + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The height of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g. 0 to 63 then the height is 64.
+	/// \sa getWidth(), getDepth()
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	int32_t BrickVolume<VoxelType>::getHeight(void) const
+	{
+		return m_regValidRegion.getUpperY() - m_regValidRegion.getLowerY() + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The depth of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g. 0 to 63 then the depth is 64.
+	/// \sa getWidth(), getHeight()
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	int32_t BrickVolume<VoxelType>::getDepth(void) const
+	{
+		return m_regValidRegion.getUpperZ() - m_regValidRegion.getLowerZ() + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		if (this->m_regValidRegion.containsPoint(uXPos, uYPos, uZPos))
+		{
+			const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+			const uint32_t uXPosInGrid = uXPos - v3dLowerCorner.getX();
+			const uint32_t uYPosInGrid = uYPos - v3dLowerCorner.getY();
+			const uint32_t uZPosInGrid = uZPos - v3dLowerCorner.getZ();
+
+			const Brick* pBrick = m_vecBricks[getBrickIndex(uXPosInGrid >> uBrickSideLengthPower, uYPosInGrid >> uBrickSideLengthPower, uZPosInGrid >> uBrickSideLengthPower)];
+			return pBrick->atVoxels[getIndexInBrick(uXPosInGrid, uYPosInGrid, uZPosInGrid)];
+		}
+		else
+		{
+			return m_tBorderValue;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::getVoxel(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param tBorder The value to use for voxels outside the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::setBorderValue(const VoxelType& tBorder)
+	{
+		m_tBorderValue = tBorder;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// If the voxel is in one of the shared bricks then its part of the volume is given a brick of its own first. Conversely, if this
+	/// leaves the voxel's brick entirely empty or entirely full then the brick is freed and the shared one is used instead.
+	/// \param uXPos the \c x position of the voxel
+	/// \param uYPos the \c y position of the voxel
+	/// \param uZPos the \c z position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue)
+	{
+		if (this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)) == false)
+		{
+			POLYVOX_THROW(std::out_of_range, "Position is outside valid region");
+		}
+
+		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+		const uint32_t uXPosInGrid = uXPos - v3dLowerCorner.getX();
+		const uint32_t uYPosInGrid = uYPos - v3dLowerCorner.getY();
+		const uint32_t uZPosInGrid = uZPos - v3dLowerCorner.getZ();
+
+		const uint32_t uBrickIndex = getBrickIndex(uXPosInGrid >> uBrickSideLengthPower, uYPosInGrid >> uBrickSideLengthPower, uZPosInGrid >> uBrickSideLengthPower);
+		const uint32_t uIndexInBrick = getIndexInBrick(uXPosInGrid, uYPosInGrid, uZPosInGrid);
+
+		Brick* pBrick = m_vecBricks[uBrickIndex];
+		const VoxelType tOldValue = pBrick->atVoxels[uIndexInBrick];
+		if (tOldValue == tValue)
+		{
+			return;
+		}
+
+		if (isSharedBrick(pBrick))
+		{
+			pBrick = allocateBrick(*pBrick);
+			m_vecBricks[uBrickIndex] = pBrick;
+		}
+
+		pBrick->atVoxels[uIndexInBrick] = tValue;
+
+		const bool bWasOccupied = !(tOldValue == VoxelType());
+		const bool bIsOccupied = !(tValue == VoxelType());
+		if (bWasOccupied != bIsOccupied)
+		{
+			pBrick->auOccupancy[uIndexInBrick >> 6] ^= uint64_t(1) << (uIndexInBrick & 63);
+			if (bIsOccupied)
+			{
+				pBrick->uNoOfOccupiedVoxels++;
+			}
+			else
+			{
+				pBrick->uNoOfOccupiedVoxels--;
+			}
+		}
+
+		if (tOldValue == m_tFullValue)
+		{
+			pBrick->uNoOfFullVoxels--;
+		}
+		if (tValue == m_tFullValue)
+		{
+			pBrick->uNoOfFullVoxels++;
+		}
+
+		if (pBrick->uNoOfOccupiedVoxels == 0)
+		{
+			freeBrick(uBrickIndex, &m_sharedEmptyBrick);
+		}
+		else if (pBrick->uNoOfFullVoxels == uBrickSizeInVoxels)
+		{
+			freeBrick(uBrickIndex, &m_sharedFullBrick);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos the 3D position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue)
+	{
+		setVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Each row of the region is copied a brick at a time. The region may extend outside the volume, in which case the corresponding
+	/// parts of the buffer are filled with the border value.
+	/// \param regRead The region to copy
+	/// \param pDstBuffer The buffer to copy into, which must hold at least layout.getRequiredBufferSize(regRead) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const
+	{
+		layout.validate(regRead);
+		POLYVOX_THROW_IF(pDstBuffer == nullptr, std::invalid_argument, "Destination buffer must not be null.");
+
+		const Region& regValidRegion = this->m_regValidRegion;
+		const Vector3DInt32& v3dLowerCorner = regValidRegion.getLowerCorner();
+		const bool bLinear = (layout.getOrder() == BufferOrders::Linear);
+
+		// The part of each row which lies inside the volume, relative to the start of the row.
+		const int32_t iInsideBegin = (std::max)(regValidRegion.getLowerX() - regRead.getLowerX(), 0);
+		const int32_t iInsideEnd = (std::min)(regValidRegion.getUpperX() - regRead.getLowerX() + 1, regRead.getWidthInVoxels());
+		const int32_t iWidth = regRead.getWidthInVoxels();
+
+		for (int32_t z = regRead.getLowerZ(); z <= regRead.getUpperZ(); z++)
+		{
+			const uint32_t uBufferZ = z - regRead.getLowerZ();
+			for (int32_t y = regRead.getLowerY(); y <= regRead.getUpperY(); y++)
+			{
+				const uint32_t uBufferY = y - regRead.getLowerY();
+				const bool bRowInside = regValidRegion.containsPointInY(y) && regValidRegion.containsPointInZ(z) && (iInsideBegin < iInsideEnd);
+				const uint32_t uBufferYZ = bLinear ? layout.getIndex(regRead, 0, uBufferY, uBufferZ) : (morton256_y[uBufferY] | morton256_z[uBufferZ]);
+
+				// Everything outside the volume gets the border value.
+				const int32_t iBorderEnd = bRowInside ? iInsideBegin : iWidth;
+				const int32_t iBorderBegin = bRowInside ? iInsideEnd : iWidth;
+				for (int32_t x = 0; x < iWidth; x++)
+				{
+					if ((x < iBorderEnd) || (x >= iBorderBegin))
+					{
+						pDstBuffer[bLinear ? (uBufferYZ + x) : (morton256_x[x] | uBufferYZ)] = m_tBorderValue;
+					}
+				}
+
+				if (!bRowInside)
+				{
+					continue;
+				}
+
+				// Then the inside of the row is copied from each brick it passes through in turn.
+				const uint32_t uYPosInGrid = y - v3dLowerCorner.getY();
+				const uint32_t uZPosInGrid = z - v3dLowerCorner.getZ();
+				int32_t x = iInsideBegin;
+				while (x < iInsideEnd)
+				{
+					const uint32_t uXPosInGrid = regRead.getLowerX() + x - v3dLowerCorner.getX();
+					const Brick* pBrick = m_vecBricks[getBrickIndex(uXPosInGrid >> uBrickSideLengthPower, uYPosInGrid >> uBrickSideLengthPower, uZPosInGrid >> uBrickSideLengthPower)];
+					const VoxelType* pSrcRow = pBrick->atVoxels + getIndexInBrick(uXPosInGrid, uYPosInGrid, uZPosInGrid);
+					const int32_t iRunLength = (std::min)(static_cast<int32_t>(uBrickSideLength - (uXPosInGrid & (uBrickSideLength - 1))), iInsideEnd - x);
+
+					if (bLinear)
+					{
+						std::copy(pSrcRow, pSrcRow + iRunLength, pDstBuffer + uBufferYZ + x);
+					}
+					else
+					{
+						for (int32_t iRun = 0; iRun < iRunLength; iRun++)
+						{
+							pDstBuffer[morton256_x[x + iRun] | uBufferYZ] = pSrcRow[iRun];
+						}
+					}
+
+					x += iRunLength;
+				}
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The voxels are written one at a time, so that bricks are allocated and freed as they would be by setVoxel().
+	/// \param regWrite The region to copy, which must lie within the volume
+	/// \param pSrcBuffer The buffer to copy from, which must hold at least layout.getRequiredBufferSize(regWrite) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout)
+	{
+		layout.validate(regWrite);
+		POLYVOX_THROW_IF(pSrcBuffer == nullptr, std::invalid_argument, "Source buffer must not be null.");
+		POLYVOX_THROW_IF(!this->m_regValidRegion.containsRegion(regWrite), std::out_of_range, "Region is outside valid region");
+
+		for (int32_t z = regWrite.getLowerZ(); z <= regWrite.getUpperZ(); z++)
+		{
+			for (int32_t y = regWrite.getLowerY(); y <= regWrite.getUpperY(); y++)
+			{
+				for (int32_t x = regWrite.getLowerX(); x <= regWrite.getUpperX(); x++)
+				{
+					setVoxel(x, y, z, pSrcBuffer[layout.getIndex(regWrite, x - regWrite.getLowerX(), y - regWrite.getLowerY(), z - regWrite.getLowerZ())]);
+				}
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Shared empty bricks are skipped entirely, and for other bricks the occupancy bits of each row are tested together, so this is
+	/// much faster than reading the voxels. Any part of the region which is outside the volume is ignored.
+	/// \param regToCheck The region to check
+	/// \return Whether every voxel in the part of the region inside the volume has the default value of the VoxelType
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool BrickVolume<VoxelType>::isRegionEmpty(const Region& regToCheck) const
+	{
+		Region regCropped = regToCheck;
+		regCropped.cropTo(m_regValidRegion);
+		if (!regCropped.isValid())
+		{
+			return true;
+		}
+
+		const Vector3DInt32 v3dLower = regCropped.getLowerCorner() - m_regValidRegion.getLowerCorner();
+		const Vector3DInt32 v3dUpper = regCropped.getUpperCorner() - m_regValidRegion.getLowerCorner();
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+
+		for (uint32_t uZBrick = v3dLower.getZ() >> uBrickSideLengthPower; uZBrick <= (static_cast<uint32_t>(v3dUpper.getZ()) >> uBrickSideLengthPower); uZBrick++)
+		{
+			for (uint32_t uYBrick = v3dLower.getY() >> uBrickSideLengthPower; uYBrick <= (static_cast<uint32_t>(v3dUpper.getY()) >> uBrickSideLengthPower); uYBrick++)
+			{
+				for (uint32_t uXBrick = v3dLower.getX() >> uBrickSideLengthPower; uXBrick <= (static_cast<uint32_t>(v3dUpper.getX()) >> uBrickSideLengthPower); uXBrick++)
+				{
+					const Brick* pBrick = m_vecBricks[getBrickIndex(uXBrick, uYBrick, uZBrick)];
+					if (pBrick == &m_sharedEmptyBrick)
+					{
+						continue;
+					}
+					if (pBrick == &m_sharedFullBrick)
+					{
+						return false;
+					}
+
+					// The part of the brick inside the region.
+					const uint32_t uLowerX = (std::max)(static_cast<uint32_t>(v3dLower.getX()), uXBrick << uBrickSideLengthPower) & uBrickMask;
+					const uint32_t uUpperX = (std::min)(static_cast<uint32_t>(v3dUpper.getX()), (uXBrick << uBrickSideLengthPower) + uBrickMask) & uBrickMask;
+					const uint32_t uLowerY = (std::max)(static_cast<uint32_t>(v3dLower.getY()), uYBrick << uBrickSideLengthPower) & uBrickMask;
+					const uint32_t uUpperY = (std::min)(static_cast<uint32_t>(v3dUpper.getY()), (uYBrick << uBrickSideLengthPower) + uBrickMask) & uBrickMask;
+					const uint32_t uLowerZ = (std::max)(static_cast<uint32_t>(v3dLower.getZ()), uZBrick << uBrickSideLengthPower) & uBrickMask;
+					const uint32_t uUpperZ = (std::min)(static_cast<uint32_t>(v3dUpper.getZ()), (uZBrick << uBrickSideLengthPower) + uBrickMask) & uBrickMask;
+
+					// Each row of a brick is eight consecutive bits of its occupancy mask.
+					const uint64_t uRowMask = ((uint64_t(1) << (uUpperX + 1)) - 1) & ~((uint64_t(1) << uLowerX) - 1);
+					for (uint32_t z = uLowerZ; z <= uUpperZ; z++)
+					{
+						for (uint32_t y = uLowerY; y <= uUpperY; y++)
+						{
+							const uint32_t uRowIndex = getIndexInBrick(0, y, z);
+							if ((pBrick->auOccupancy[uRowIndex >> 6] >> (uRowIndex & 63)) & uRowMask)
+							{
+								return false;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The number of bricks which belong to a single part of the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t BrickVolume<VoxelType>::getNoOfAllocatedBricks(void) const
+	{
+		return m_uNoOfAllocatedBricks;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This includes the grid, the shared bricks, and all the memory reserved by the pool (including bricks which have been freed
+	/// but are being kept for reuse).
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t BrickVolume<VoxelType>::calculateSizeInBytes(void)
+	{
+		const SlabPool::Statistics statistics = m_pBrickPool->getStatistics();
+		return static_cast<uint32_t>(m_vecBricks.capacity() * sizeof(Brick*) + sizeof(m_sharedEmptyBrick) + sizeof(m_sharedFullBrick) +
+			statistics.uNoOfBlocksReserved * m_pBrickPool->getBlockSizeInBytes());
+	}
+
+	template <typename VoxelType>
+	uint32_t BrickVolume<VoxelType>::getBrickIndex(uint32_t uXBrick, uint32_t uYBrick, uint32_t uZBrick) const
+	{
+		return uXBrick + (uYBrick + uZBrick * m_uHeightInBricks) * m_uWidthInBricks;
+	}
+
+	template <typename VoxelType>
+	uint32_t BrickVolume<VoxelType>::getIndexInBrick(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos)
+	{
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+		return (uXPos & uBrickMask) | ((uYPos & uBrickMask) << uBrickSideLengthPower) | ((uZPos & uBrickMask) << (uBrickSideLengthPower * 2));
+	}
+
+	template <typename VoxelType>
+	bool BrickVolume<VoxelType>::isSharedBrick(const Brick* pBrick) const
+	{
+		return (pBrick == &m_sharedEmptyBrick) || (pBrick == &m_sharedFullBrick);
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::initialiseSharedBrick(Brick& brick, VoxelType tValue)
+	{
+		std::fill(brick.atVoxels, brick.atVoxels + uBrickSizeInVoxels, tValue);
+
+		const bool bIsOccupied = !(tValue == VoxelType());
+		std::fill(brick.auOccupancy, brick.auOccupancy + uBrickSizeInVoxels / 64, bIsOccupied ? ~uint64_t(0) : uint64_t(0));
+		brick.uNoOfOccupiedVoxels = bIsOccupied ? uBrickSizeInVoxels : 0;
+		brick.uNoOfFullVoxels = (tValue == m_tFullValue) ? uBrickSizeInVoxels : 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Gets a brick from the pool, as a copy of the given one.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	typename BrickVolume<VoxelType>::Brick* BrickVolume<VoxelType>::allocateBrick(const Brick& source)
+	{
+		Brick* pBrick = new (m_pBrickPool->allocate()) Brick(source);
+		m_uNoOfAllocatedBricks++;
+		m_uRevision++;
+		return pBrick;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Gives the brick at the given position in the grid back to the pool, and points that position at a shared brick instead.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::freeBrick(uint32_t uBrickIndex, Brick* pSharedBrick)
+	{
+		Brick* pBrick = m_vecBricks[uBrickIndex];
+		POLYVOX_ASSERT(!isSharedBrick(pBrick), "Shared bricks cannot be freed");
+
+		pBrick->~Brick();
+		m_pBrickPool->deallocate(pBrick);
+		m_vecBricks[uBrickIndex] = pSharedBrick;
+		m_uNoOfAllocatedBricks--;
+		m_uRevision++;
+	}
+}
@@ -0,0 +1,493 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	BrickVolume<VoxelType>::Sampler::Sampler(BrickVolume<VoxelType>* volume)
+		:BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >(volume)
+		, m_uXPosInGrid(0)
+		, m_uYPosInGrid(0)
+		, m_uZPosInGrid(0)
+		, m_uIndexInBrick(0)
+		, m_uRevision(0)
+		, m_bIsCurrentPositionValid(false)
+		, m_bAreNeighboursValid(false)
+	{
+		std::fill(m_apBricks, m_apBricks + 27, nullptr);
+	}
+
+	template <typename VoxelType>
+	BrickVolume<VoxelType>::Sampler::~Sampler()
+	{
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::getVoxel(void) const
+	{
+		if (m_bIsCurrentPositionValid && (m_uRevision == this->mVolume->m_uRevision))
+		{
+			return m_apBricks[13]->atVoxels[m_uIndexInBrick];
+		}
+		else
+		{
+			return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	bool inline BrickVolume<VoxelType>::Sampler::isCurrentPositionValid(void) const
+	{
+		return m_bIsCurrentPositionValid;
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	{
+		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	{
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >::setPosition(xPos, yPos, zPos);
+
+		const Vector3DInt32& v3dLowerCorner = this->mVolume->m_regValidRegion.getLowerCorner();
+		m_uXPosInGrid = static_cast<uint32_t>(xPos - v3dLowerCorner.getX());
+		m_uYPosInGrid = static_cast<uint32_t>(yPos - v3dLowerCorner.getY());
+		m_uZPosInGrid = static_cast<uint32_t>(zPos - v3dLowerCorner.getZ());
+
+		// Then we find the bricks around the current position.
+		updateValidity();
+		if (m_bIsCurrentPositionValid)
+		{
+			updateBricks();
+		}
+	}
+
+	template <typename VoxelType>
+	bool BrickVolume<VoxelType>::Sampler::setVoxel(VoxelType tValue)
+	{
+		if (m_bIsCurrentPositionValid)
+		{
+			this->mVolume->setVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume, tValue);
+
+			// The write may have allocated or freed the current brick.
+			if (m_uRevision != this->mVolume->m_uRevision)
+			{
+				updateBricks();
+			}
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::movePositiveX(void)
+	{
+		// We'll need this in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >::movePositiveX();
+		m_uXPosInGrid++;
+
+		// If we are still in the same brick then only our position within it has changed.
+		if (bWasPositionValid && ((m_uXPosInGrid & uBrickMask) != 0) && updateValidity())
+		{
+			m_uIndexInBrick++;
+			updateNeighbourOffsets(m_uXPosInGrid & uBrickMask, 1, 1, m_auXBrickOffsets, m_aiXVoxelOffsets);
+		}
+		else
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::movePositiveY(void)
+	{
+		// We'll need this in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >::movePositiveY();
+		m_uYPosInGrid++;
+
+		// If we are still in the same brick then only our position within it has changed.
+		if (bWasPositionValid && ((m_uYPosInGrid & uBrickMask) != 0) && updateValidity())
+		{
+			m_uIndexInBrick += uBrickSideLength;
+			updateNeighbourOffsets(m_uYPosInGrid & uBrickMask, 3, uBrickSideLength, m_auYBrickOffsets, m_aiYVoxelOffsets);
+		}
+		else
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::movePositiveZ(void)
+	{
+		// We'll need this in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >::movePositiveZ();
+		m_uZPosInGrid++;
+
+		// If we are still in the same brick then only our position within it has changed.
+		if (bWasPositionValid && ((m_uZPosInGrid & uBrickMask) != 0) && updateValidity())
+		{
+			m_uIndexInBrick += uBrickSideLength * uBrickSideLength;
+			updateNeighbourOffsets(m_uZPosInGrid & uBrickMask, 9, uBrickSideLength * uBrickSideLength, m_auZBrickOffsets, m_aiZVoxelOffsets);
+		}
+		else
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::moveNegativeX(void)
+	{
+		// We'll need this in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >::moveNegativeX();
+		m_uXPosInGrid--;
+
+		// If we are still in the same brick then only our position within it has changed.
+		if (bWasPositionValid && ((m_uXPosInGrid & uBrickMask) != uBrickMask) && updateValidity())
+		{
+			m_uIndexInBrick--;
+			updateNeighbourOffsets(m_uXPosInGrid & uBrickMask, 1, 1, m_auXBrickOffsets, m_aiXVoxelOffsets);
+		}
+		else
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::moveNegativeY(void)
+	{
+		// We'll need this in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >::moveNegativeY();
+		m_uYPosInGrid--;
+
+		// If we are still in the same brick then only our position within it has changed.
+		if (bWasPositionValid && ((m_uYPosInGrid & uBrickMask) != uBrickMask) && updateValidity())
+		{
+			m_uIndexInBrick -= uBrickSideLength;
+			updateNeighbourOffsets(m_uYPosInGrid & uBrickMask, 3, uBrickSideLength, m_auYBrickOffsets, m_aiYVoxelOffsets);
+		}
+		else
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::moveNegativeZ(void)
+	{
+		// We'll need this in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uBrickMask = uBrickSideLength - 1;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< BrickVolume<VoxelType> >::moveNegativeZ();
+		m_uZPosInGrid--;
+
+		// If we are still in the same brick then only our position within it has changed.
+		if (bWasPositionValid && ((m_uZPosInGrid & uBrickMask) != uBrickMask) && updateValidity())
+		{
+			m_uIndexInBrick -= uBrickSideLength * uBrickSideLength;
+			updateNeighbourOffsets(m_uZPosInGrid & uBrickMask, 9, uBrickSideLength * uBrickSideLength, m_auZBrickOffsets, m_aiZVoxelOffsets);
+		}
+		else
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
+	{
+		return peekVoxel(-1, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx1ny0pz(void) const
+	{
+		return peekVoxel(-1, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx1ny1pz(void) const
+	{
+		return peekVoxel(-1, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx0py1nz(void) const
+	{
+		return peekVoxel(-1, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx0py0pz(void) const
+	{
+		return peekVoxel(-1, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx0py1pz(void) const
+	{
+		return peekVoxel(-1, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx1py1nz(void) const
+	{
+		return peekVoxel(-1, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx1py0pz(void) const
+	{
+		return peekVoxel(-1, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1nx1py1pz(void) const
+	{
+		return peekVoxel(-1, 1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px1ny1nz(void) const
+	{
+		return peekVoxel(0, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px1ny0pz(void) const
+	{
+		return peekVoxel(0, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px1ny1pz(void) const
+	{
+		return peekVoxel(0, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px0py1nz(void) const
+	{
+		return peekVoxel(0, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px0py0pz(void) const
+	{
+		return peekVoxel(0, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px0py1pz(void) const
+	{
+		return peekVoxel(0, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px1py1nz(void) const
+	{
+		return peekVoxel(0, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px1py0pz(void) const
+	{
+		return peekVoxel(0, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel0px1py1pz(void) const
+	{
+		return peekVoxel(0, 1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px1ny1nz(void) const
+	{
+		return peekVoxel(1, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px1ny0pz(void) const
+	{
+		return peekVoxel(1, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px1ny1pz(void) const
+	{
+		return peekVoxel(1, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px0py1nz(void) const
+	{
+		return peekVoxel(1, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px0py0pz(void) const
+	{
+		return peekVoxel(1, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px0py1pz(void) const
+	{
+		return peekVoxel(1, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px1py1nz(void) const
+	{
+		return peekVoxel(1, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px1py0pz(void) const
+	{
+		return peekVoxel(1, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel1px1py1pz(void) const
+	{
+		return peekVoxel(1, 1, 1);
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::updateBricks(void)
+	{
+		POLYVOX_ASSERT(m_bIsCurrentPositionValid, "Bricks can only be found for a valid position");
+
+		const BrickVolume<VoxelType>* pVolume = this->mVolume;
+		const int32_t iXBrick = static_cast<int32_t>(m_uXPosInGrid >> uBrickSideLengthPower);
+		const int32_t iYBrick = static_cast<int32_t>(m_uYPosInGrid >> uBrickSideLengthPower);
+		const int32_t iZBrick = static_cast<int32_t>(m_uZPosInGrid >> uBrickSideLengthPower);
+
+		for (int32_t iZOffset = -1; iZOffset <= 1; iZOffset++)
+		{
+			for (int32_t iYOffset = -1; iYOffset <= 1; iYOffset++)
+			{
+				for (int32_t iXOffset = -1; iXOffset <= 1; iXOffset++)
+				{
+					// Negative brick positions wrap around to large unsigned ones, so a single comparison catches both edges of the grid.
+					const uint32_t uXBrick = static_cast<uint32_t>(iXBrick + iXOffset);
+					const uint32_t uYBrick = static_cast<uint32_t>(iYBrick + iYOffset);
+					const uint32_t uZBrick = static_cast<uint32_t>(iZBrick + iZOffset);
+					const bool bIsInsideGrid = (uXBrick < pVolume->m_uWidthInBricks) && (uYBrick < pVolume->m_uHeightInBricks) && (uZBrick < pVolume->m_uDepthInBricks);
+
+					m_apBricks[(iXOffset + 1) + (iYOffset + 1) * 3 + (iZOffset + 1) * 9] = bIsInsideGrid ? pVolume->m_vecBricks[pVolume->getBrickIndex(uXBrick, uYBrick, uZBrick)] : nullptr;
+				}
+			}
+		}
+
+		m_uIndexInBrick = getIndexInBrick(m_uXPosInGrid, m_uYPosInGrid, m_uZPosInGrid);
+		updateNeighbourOffsets(m_uXPosInGrid & (uBrickSideLength - 1), 1, 1, m_auXBrickOffsets, m_aiXVoxelOffsets);
+		updateNeighbourOffsets(m_uYPosInGrid & (uBrickSideLength - 1), 3, uBrickSideLength, m_auYBrickOffsets, m_aiYVoxelOffsets);
+		updateNeighbourOffsets(m_uZPosInGrid & (uBrickSideLength - 1), 9, uBrickSideLength * uBrickSideLength, m_auZBrickOffsets, m_aiZVoxelOffsets);
+
+		m_uRevision = pVolume->m_uRevision;
+	}
+
+	template <typename VoxelType>
+	void BrickVolume<VoxelType>::Sampler::updateNeighbourOffsets(uint32_t uPosInBrick, uint32_t uBrickStride, int32_t iVoxelStride, uint32_t* pBrickOffsets, int32_t* pVoxelOffsets)
+	{
+		// The current voxel is in the middle brick.
+		pBrickOffsets[1] = uBrickStride;
+		pVoxelOffsets[1] = 0;
+
+		// At the lower edge of a brick the previous voxel is at the upper edge of the previous brick...
+		const int32_t iBrickSideLength = static_cast<int32_t>(uBrickSideLength);
+		const bool bAtLowerEdge = (uPosInBrick == 0);
+		pBrickOffsets[0] = bAtLowerEdge ? 0 : uBrickStride;
+		pVoxelOffsets[0] = bAtLowerEdge ? iVoxelStride * (iBrickSideLength - 1) : -iVoxelStride;
+
+		// ...and at the upper edge the next voxel is at the lower edge of the next brick.
+		const bool bAtUpperEdge = (uPosInBrick == uBrickSideLength - 1);
+		pBrickOffsets[2] = bAtUpperEdge ? uBrickStride * 2 : uBrickStride;
+		pVoxelOffsets[2] = bAtUpperEdge ? -iVoxelStride * (iBrickSideLength - 1) : iVoxelStride;
+	}
+
+	template <typename VoxelType>
+	bool BrickVolume<VoxelType>::Sampler::updateValidity(void)
+	{
+		// Positions below the volume wrap around to large unsigned ones, so a single comparison catches both edges of the volume. The
+		// same goes for the neighbours, which are all valid if the position is between one and the size minus two.
+		const BrickVolume<VoxelType>* pVolume = this->mVolume;
+		const uint32_t uWidth = static_cast<uint32_t>(pVolume->getWidth());
+		const uint32_t uHeight = static_cast<uint32_t>(pVolume->getHeight());
+		const uint32_t uDepth = static_cast<uint32_t>(pVolume->getDepth());
+
+		m_bIsCurrentPositionValid = (m_uXPosInGrid < uWidth) && (m_uYPosInGrid < uHeight) && (m_uZPosInGrid < uDepth);
+		m_bAreNeighboursValid = m_bIsCurrentPositionValid &&
+			(m_uXPosInGrid - 1 < uWidth - 2) && (m_uYPosInGrid - 1 < uHeight - 2) && (m_uZPosInGrid - 1 < uDepth - 2);
+
+		return m_bIsCurrentPositionValid && (m_uRevision == pVolume->m_uRevision);
+	}
+
+	template <typename VoxelType>
+	VoxelType BrickVolume<VoxelType>::Sampler::peekVoxel(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const
+	{
+		if (m_bAreNeighboursValid && (m_uRevision == this->mVolume->m_uRevision))
+		{
+			// The offsets are constants in each of the peek functions, so this is just a few table lookups.
+			const Brick* pBrick = m_apBricks[m_auXBrickOffsets[iXOffset + 1] + m_auYBrickOffsets[iYOffset + 1] + m_auZBrickOffsets[iZOffset + 1]];
+			return pBrick->atVoxels[m_uIndexInBrick + m_aiXVoxelOffsets[iXOffset + 1] + m_aiYVoxelOffsets[iYOffset + 1] + m_aiZVoxelOffsets[iZOffset + 1]];
+		}
+
+		return this->mVolume->getVoxel(this->mXPosInVolume + iXOffset, this->mYPosInVolume + iYOffset, this->mZPosInVolume + iZOffset);
+	}
+}
@@ -0,0 +1,162 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_BufferLayout_H__
+#define __PolyVox_BufferLayout_H__
+
+#include "Impl/ErrorHandling.h"
+#include "Impl/PlatformDefinitions.h"
+
+#include "Region.h"
+
+#include <cstdint>
+#include <stdexcept> //For invalid_argument
+
+#include "Impl/Morton.h"
+
+namespace PolyVox
+{
+	namespace BufferOrders
+	{
+		/**
+		 * Determines how the voxels of a region are arranged in a buffer passed to readRegion() or writeRegion().
+		 */
+		enum BufferOrder
+		{
+			Linear, ///< X varies fastest, then Y, then Z. Rows and slices may be padded (see BufferLayout::strided()).
+			Morton ///< Voxels are interleaved along a Z-order curve, matching the internal layout of a PagedVolume chunk.
+		};
+	}
+	typedef BufferOrders::BufferOrder BufferOrder;
+
+	/**
+	 * Describes the arrangement of voxels in a buffer which is copied to or from a region of a volume in a single call.
+	 *
+	 * Positions in the buffer are always relative to the lower corner of the region being copied. A linear layout places
+	 * voxel (x,y,z) at x + y * rowPitch + z * slicePitch, where by default the pitches are simply the width and the width
+	 * times the height of the region. Strided layouts let the caller copy into a sub-box of a larger buffer, or pad rows for
+	 * alignment. A Morton layout places each voxel at the Morton code of its position, and is limited to regions no larger
+	 * than 256 voxels along each side. For a cubic region whose side is a power of two this is a tightly packed buffer.
+	 */
+	class BufferLayout
+	{
+	public:
+		/// Constructs a tightly packed linear layout.
+		BufferLayout()
+			:m_eOrder(BufferOrders::Linear)
+			, m_uRowPitch(0)
+			, m_uSlicePitch(0)
+		{
+		}
+
+		/// A tightly packed linear layout.
+		static BufferLayout linear(void)
+		{
+			return BufferLayout();
+		}
+
+		/// A Morton (Z-order) layout.
+		static BufferLayout morton(void)
+		{
+			BufferLayout layout;
+			layout.m_eOrder = BufferOrders::Morton;
+			return layout;
+		}
+
+		/// A linear layout with the given distances (in voxels) between the start of consecutive rows and slices.
+		static BufferLayout strided(uint32_t uRowPitch, uint32_t uSlicePitch)
+		{
+			BufferLayout layout;
+			layout.m_uRowPitch = uRowPitch;
+			layout.m_uSlicePitch = uSlicePitch;
+			return layout;
+		}
+
+		BufferOrder getOrder(void) const
+		{
+			return m_eOrder;
+		}
+
+		/// The distance between the start of consecutive rows, when copying the given region with a linear layout.
+		uint32_t getRowPitch(const Region& region) const
+		{
+			return m_uRowPitch ? m_uRowPitch : static_cast<uint32_t>(region.getWidthInVoxels());
+		}
+
+		/// The distance between the start of consecutive slices, when copying the given region with a linear layout.
+		uint32_t getSlicePitch(const Region& region) const
+		{
+			return m_uSlicePitch ? m_uSlicePitch : getRowPitch(region) * static_cast<uint32_t>(region.getHeightInVoxels());
+		}
+
+		/// Whether each slice of the region forms a single contiguous block of the buffer, so that whole runs of voxels can be copied at once.
+		bool hasContiguousRows(const Region& region) const
+		{
+			return (m_eOrder == BufferOrders::Linear) && (getRowPitch(region) == static_cast<uint32_t>(region.getWidthInVoxels()));
+		}
+
+		/// Gets the index in the buffer of the voxel at the given offset from the lower corner of the region.
+		uint32_t getIndex(const Region& region, uint32_t uX, uint32_t uY, uint32_t uZ) const
+		{
+			if (m_eOrder == BufferOrders::Morton)
+			{
+				return morton256_x[uX] | morton256_y[uY] | morton256_z[uZ];
+			}
+			return uX + uY * getRowPitch(region) + uZ * getSlicePitch(region);
+		}
+
+		/// Gets the number of voxels the buffer must hold for the given region to be copied with this layout.
+		uint32_t getRequiredBufferSize(const Region& region) const
+		{
+			// For both orders the highest index is that of the voxel in the upper corner.
+			return getIndex(region, region.getWidthInVoxels() - 1, region.getHeightInVoxels() - 1, region.getDepthInVoxels() - 1) + 1;
+		}
+
+		/// Throws if the layout cannot be used to copy the given region.
+		void validate(const Region& region) const
+		{
+			POLYVOX_THROW_IF(!region.isValid(), std::invalid_argument, "Cannot copy an invalid region.");
+
+			if (m_eOrder == BufferOrders::Morton)
+			{
+				POLYVOX_THROW_IF((region.getWidthInVoxels() > 256) || (region.getHeightInVoxels() > 256) || (region.getDepthInVoxels() > 256),
+					std::invalid_argument, "A Morton buffer layout is limited to regions of at most 256 voxels along each side.");
+			}
+			else
+			{
+				POLYVOX_THROW_IF(getRowPitch(region) < static_cast<uint32_t>(region.getWidthInVoxels()), std::invalid_argument,
+					"The row pitch of a buffer layout must be at least the width of the region.");
+				POLYVOX_THROW_IF(getSlicePitch(region) < getRowPitch(region) * static_cast<uint32_t>(region.getHeightInVoxels()), std::invalid_argument,
+					"The slice pitch of a buffer layout must be at least the row pitch times the height of the region.");
+			}
+		}
+
+	private:
+		BufferOrder m_eOrder;
+		uint32_t m_uRowPitch;
+		uint32_t m_uSlicePitch;
+	};
+}
+
+#endif //__PolyVox_BufferLayout_H__
@@ -0,0 +1,372 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_CompressedFilePager_H__
+#define __PolyVox_CompressedFilePager_H__
+
+#include "Impl/Morton.h"
+#include "Impl/PlatformDefinitions.h"
+
+#include "BufferLayout.h"
+#include "Compressor.h"
+#include "LZCompressor.h"
+#include "PagedVolume.h"
+#include "Region.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace PolyVox
+{
+	/**
+	 * An implementation of Pager which stores each chunk in its own compressed file on disk.
+	 *
+	 * Like the RegionFilePager (and unlike the FilePager) the files written by this pager are persistent, so a volume can be
+	 * paged back in by a later run of the application. Each file starts with a small header giving the format version, the
+	 * size of the chunk, and a checksum of the uncompressed data, so files written with different settings are rejected and
+	 * corrupted files are detected when they are paged in rather than silently producing bad voxels.
+	 *
+	 * By default the data is compressed with an LZCompressor, which is fast and has no external dependencies, but any
+	 * Compressor can be passed to the constructor. For example an application which already links against zlib can wrap it
+	 * in a Compressor to trade some speed for better compression. If compression does not make a chunk any smaller then it
+	 * is stored uncompressed, and uniform chunks are always stored as a single voxel.
+	 *
+	 * Chunks are written in Morton order (which is how they are stored in memory) unless linear order is requested, which can
+	 * be useful if the files are to be read by other tools, and files in either order can be paged in. As with the other
+	 * file pagers the data is written in the native byte order, and calls to the pager are serialised by the PagedVolume.
+	 */
+	template <typename VoxelType>
+	class CompressedFilePager : public PagedVolume<VoxelType>::Pager
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t uNoOfChunksPagedIn; ///< Calls to pageIn(), including those for chunks which were not in any file.
+			uint64_t uNoOfChunksPagedOut; ///< Calls to pageOut().
+			uint64_t uNoOfUncompressedBytesWritten; ///< The size of the voxel data which has been paged out.
+			uint64_t uNoOfStoredBytesWritten; ///< The size of the same data after compression (not including the headers).
+		};
+
+		/// Constructor
+		/// \param strFolderName The folder containing the chunk files, which must already exist.
+		/// \param pCompressor The compressor used for the chunk data, which must outlive the pager. If this is null an LZCompressor is used.
+		/// \param eDataOrder The order in which the voxels of each chunk are written.
+		CompressedFilePager(const std::string& strFolderName = ".", Compressor* pCompressor = nullptr, BufferOrder eDataOrder = BufferOrders::Morton)
+			:PagedVolume<VoxelType>::Pager()
+			, m_strFolderName(strFolderName)
+			, m_pCompressor(pCompressor)
+			, m_eDataOrder(eDataOrder)
+		{
+			// Add the trailing slash, assuming the user dind't already do it.
+			if ((m_strFolderName.back() != '/') && (m_strFolderName.back() != '\\'))
+			{
+				m_strFolderName.append("/");
+			}
+
+			if (!m_pCompressor)
+			{
+				m_pOwnedCompressor.reset(new LZCompressor);
+				m_pCompressor = m_pOwnedCompressor.get();
+			}
+
+			m_statistics = Statistics();
+		}
+
+		/// Destructor
+		virtual ~CompressedFilePager()
+		{
+			// Chunk files are not deleted, as the whole point is that they persist.
+		}
+
+		virtual void pageIn(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
+		{
+			POLYVOX_ASSERT(pChunk, "Attempting to page in NULL chunk");
+
+			m_statistics.uNoOfChunksPagedIn++;
+
+			const std::string strFilename = getFilename(region);
+			FILE* pFile = fopen(strFilename.c_str(), "rb");
+			if (!pFile)
+			{
+				POLYVOX_LOG_TRACE("No data found for ", region, " during paging in.");
+				pChunk->setUniform(VoxelType());
+				return;
+			}
+
+			POLYVOX_LOG_TRACE("Paging in data for ", region);
+
+			FileHeader header;
+			const bool bHeaderRead = (fread(&header, sizeof(header), 1, pFile) == 1);
+			if (bHeaderRead)
+			{
+				m_vecStoredData.resize(header.uStoredSize);
+			}
+			const bool bDataRead = bHeaderRead && (fread(m_vecStoredData.data(), 1, m_vecStoredData.size(), pFile) == m_vecStoredData.size());
+			fclose(pFile);
+
+			POLYVOX_THROW_IF(!bDataRead, std::runtime_error, "Error reading in chunk data from '" + strFilename + "'.");
+			validateHeader(header, region, strFilename);
+
+			if (header.uFlags & FileFlags::Uniform)
+			{
+				POLYVOX_THROW_IF(header.uUncompressedSize != sizeof(VoxelType), std::runtime_error, "Uniform chunk in '" + strFilename + "' has the wrong size.");
+				VoxelType tUniformValue;
+				readStoredData(header, &tUniformValue, strFilename);
+				pChunk->setUniform(tUniformValue);
+				return;
+			}
+
+			POLYVOX_THROW_IF(header.uUncompressedSize != pChunk->getDataSizeInBytes(), std::runtime_error, "Chunk in '" + strFilename + "' has the wrong size.");
+			readStoredData(header, pChunk->getData(), strFilename);
+
+			if (header.uFlags & FileFlags::LinearOrder)
+			{
+				pChunk->changeLinearOrderingToMorton();
+			}
+		}
+
+		virtual void pageOut(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
+		{
+			POLYVOX_ASSERT(pChunk, "Attempting to page out NULL chunk");
+
+			POLYVOX_LOG_TRACE("Paging out data for ", region);
+
+			m_statistics.uNoOfChunksPagedOut++;
+
+			FileHeader header;
+			std::memcpy(header.acMagic, "PVCC", 4);
+			header.uVersion = uFileFormatVersion;
+			header.uFlags = 0;
+			header.uReserved = 0;
+			header.uChunkSideLength = region.getWidthInVoxels();
+			header.uVoxelSize = sizeof(VoxelType);
+
+			VoxelType tUniformValue;
+			const void* pData = nullptr;
+			if (pChunk->isUniform())
+			{
+				tUniformValue = pChunk->getUniformValue();
+				pData = &tUniformValue;
+				header.uFlags |= FileFlags::Uniform;
+				header.uUncompressedSize = sizeof(VoxelType);
+			}
+			else
+			{
+				pData = pChunk->getData();
+				header.uUncompressedSize = pChunk->getDataSizeInBytes();
+
+				// The chunk is converted in a separate buffer, as it may be paged out while it is still in use.
+				if (m_eDataOrder == BufferOrders::Linear)
+				{
+					pData = convertMortonToLinear(pChunk->getData(), header.uChunkSideLength);
+					header.uFlags |= FileFlags::LinearOrder;
+				}
+			}
+
+			header.uChecksum = calculateChecksum(pData, header.uUncompressedSize);
+
+			// Uniform chunks are too small to be worth compressing, and anything which does not get smaller is stored as it is.
+			const void* pStoredData = pData;
+			header.uStoredSize = header.uUncompressedSize;
+			if (!(header.uFlags & FileFlags::Uniform))
+			{
+				m_vecStoredData.resize(m_pCompressor->getMaxCompressedSize(header.uUncompressedSize));
+				const uint32_t uCompressedSize = m_pCompressor->compress(pData, header.uUncompressedSize, m_vecStoredData.data(), static_cast<uint32_t>(m_vecStoredData.size()));
+				if (uCompressedSize < header.uUncompressedSize)
+				{
+					pStoredData = m_vecStoredData.data();
+					header.uStoredSize = uCompressedSize;
+					header.uFlags |= FileFlags::Compressed;
+				}
+			}
+
+			// The file is written under a temporary name and then renamed, so an interruption leaves the old version of the chunk intact.
+			const std::string strFilename = getFilename(region);
+			const std::string strTempFilename = strFilename + ".tmp";
+
+			FILE* pFile = fopen(strTempFilename.c_str(), "wb");
+			POLYVOX_THROW_IF(!pFile, std::runtime_error, "Unable to open file '" + strTempFilename + "' to write out chunk data.");
+
+			fwrite(&header, sizeof(header), 1, pFile);
+			fwrite(pStoredData, 1, header.uStoredSize, pFile);
+			const bool bError = (ferror(pFile) != 0);
+			fclose(pFile);
+
+			if (bError)
+			{
+				std::remove(strTempFilename.c_str());
+				POLYVOX_THROW(std::runtime_error, "Error writing out chunk data to '" + strTempFilename + "'.");
+			}
+
+			// Renaming over an existing file is not allowed on all platforms.
+			std::remove(strFilename.c_str());
+			POLYVOX_THROW_IF(std::rename(strTempFilename.c_str(), strFilename.c_str()) != 0, std::runtime_error, "Unable to rename '" + strTempFilename + "' to '" + strFilename + "'.");
+
+			m_statistics.uNoOfUncompressedBytesWritten += header.uUncompressedSize;
+			m_statistics.uNoOfStoredBytesWritten += header.uStoredSize;
+		}
+
+		/// The name of the file which holds the chunk covering the given region.
+		std::string getFilename(const Region& region) const
+		{
+			std::stringstream ssFilename;
+			ssFilename << m_strFolderName << "chunk_" << region.getLowerX() << "_" << region.getLowerY() << "_" << region.getLowerZ() << ".pvc";
+			return ssFilename.str();
+		}
+
+		Statistics getStatistics(void) const
+		{
+			return m_statistics;
+		}
+
+	private:
+		static const uint16_t uFileFormatVersion = 1;
+
+		struct FileFlags
+		{
+			enum
+			{
+				Uniform = 0x01, ///< The data is a single voxel.
+				Compressed = 0x02, ///< The data has been compressed.
+				LinearOrder = 0x04 ///< The voxels are in linear rather than Morton order.
+			};
+		};
+
+		// The header is followed immediately by the (possibly compressed) chunk data.
+		struct FileHeader
+		{
+			char acMagic[4];
+			uint16_t uVersion;
+			uint8_t uFlags;
+			uint8_t uReserved;
+			uint32_t uChunkSideLength;
+			uint32_t uVoxelSize;
+			uint32_t uUncompressedSize;
+			uint32_t uStoredSize;
+			uint32_t uChecksum; ///< CRC-32 of the uncompressed data.
+		};
+
+		void validateHeader(const FileHeader& header, const Region& region, const std::string& strFilename) const
+		{
+			POLYVOX_THROW_IF(std::memcmp(header.acMagic, "PVCC", 4) != 0, std::runtime_error, "'" + strFilename + "' is not a chunk file.");
+			POLYVOX_THROW_IF(header.uVersion > uFileFormatVersion, std::runtime_error, "'" + strFilename + "' was written by a newer version of PolyVox.");
+			POLYVOX_THROW_IF(header.uChunkSideLength != static_cast<uint32_t>(region.getWidthInVoxels()), std::runtime_error, "'" + strFilename + "' was written with a different chunk side length.");
+			POLYVOX_THROW_IF(header.uVoxelSize != sizeof(VoxelType), std::runtime_error, "'" + strFilename + "' was written with a different voxel type.");
+		}
+
+		// Decompresses (or copies) the data which was read from the file, and checks it against the checksum.
+		void readStoredData(const FileHeader& header, void* pDstData, const std::string& strFilename)
+		{
+			if (header.uFlags & FileFlags::Compressed)
+			{
+				// Whatever the compressor throws for bad data, a corrupt file is always reported the same way.
+				uint32_t uDecompressedSize = 0;
+				try
+				{
+					uDecompressedSize = m_pCompressor->decompress(m_vecStoredData.data(), header.uStoredSize, pDstData, header.uUncompressedSize);
+				}
+				catch (std::exception&)
+				{
+					POLYVOX_THROW(std::runtime_error, "Chunk in '" + strFilename + "' could not be decompressed, the file is corrupt.");
+				}
+				POLYVOX_THROW_IF(uDecompressedSize != header.uUncompressedSize, std::runtime_error, "Chunk in '" + strFilename + "' did not decompress to the expected size.");
+			}
+			else
+			{
+				POLYVOX_THROW_IF(header.uStoredSize != header.uUncompressedSize, std::runtime_error, "Chunk in '" + strFilename + "' has the wrong size.");
+				std::memcpy(pDstData, m_vecStoredData.data(), header.uStoredSize);
+			}
+
+			POLYVOX_THROW_IF(calculateChecksum(pDstData, header.uUncompressedSize) != header.uChecksum, std::runtime_error, "Checksum mismatch for chunk in '" + strFilename + "', the file is corrupt.");
+		}
+
+		const VoxelType* convertMortonToLinear(const VoxelType* pMortonData, uint32_t uSideLength)
+		{
+			m_vecLinearData.resize(uSideLength * uSideLength * uSideLength);
+			for (uint32_t z = 0; z < uSideLength; z++)
+			{
+				for (uint32_t y = 0; y < uSideLength; y++)
+				{
+					VoxelType* pLinearRow = &m_vecLinearData[y * uSideLength + z * uSideLength * uSideLength];
+					const uint32_t uMortonYZ = morton256_y[y] | morton256_z[z];
+					for (uint32_t x = 0; x < uSideLength; x++)
+					{
+						pLinearRow[x] = pMortonData[morton256_x[x] | uMortonYZ];
+					}
+				}
+			}
+			return m_vecLinearData.data();
+		}
+
+		// The standard (IEEE 802.3) CRC-32, as used by zlib and PNG.
+		static uint32_t calculateChecksum(const void* pData, uint32_t uLength)
+		{
+			static const std::vector<uint32_t> vecTable = buildChecksumTable();
+
+			const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+			uint32_t uCrc = 0xFFFFFFFF;
+			for (uint32_t ct = 0; ct < uLength; ct++)
+			{
+				uCrc = vecTable[(uCrc ^ pBytes[ct]) & 0xFF] ^ (uCrc >> 8);
+			}
+			return uCrc ^ 0xFFFFFFFF;
+		}
+
+		static std::vector<uint32_t> buildChecksumTable(void)
+		{
+			std::vector<uint32_t> vecTable(256);
+			for (uint32_t uByte = 0; uByte < 256; uByte++)
+			{
+				uint32_t uCrc = uByte;
+				for (uint32_t uBit = 0; uBit < 8; uBit++)
+				{
+					uCrc = (uCrc & 1) ? (0xEDB88320 ^ (uCrc >> 1)) : (uCrc >> 1);
+				}
+				vecTable[uByte] = uCrc;
+			}
+			return vecTable;
+		}
+
+		std::string m_strFolderName;
+
+		Compressor* m_pCompressor;
+		std::unique_ptr<Compressor> m_pOwnedCompressor;
+
+		BufferOrder m_eDataOrder;
+
+		// Reused between calls to avoid allocations.
+		std::vector<uint8_t> m_vecStoredData;
+		std::vector<VoxelType> m_vecLinearData;
+
+		Statistics m_statistics;
+	};
+}
+
+#endif //__PolyVox_CompressedFilePager_H__
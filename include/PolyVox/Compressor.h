@@ -0,0 +1,98 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef __PolyVox_Compressor_H__
+#define __PolyVox_Compressor_H__
+
+#include "Impl/PlatformDefinitions.h"
+
+#include <cstdint>
+
+namespace PolyVox
+{
+	/**
+	 * Provides an interface for performing compression of data.
+	 *
+	 * This class provides an interface which can be implemented by derived classes which perform data compression.
+	 * The main purpose of this is to allow the user to change the compression algorithm used to keep chunks in
+	 * memory (see PagedVolume::setCompressedTier()), which may be useful if they want to make the trade-off between
+	 * speed and compression ratio differently, or to use an algorithm which suits their particular voxel data.
+	 *
+	 * PolyVox provides RLECompressor and LZCompressor, which have no external dependencies. Users can also use their own.
+	 * Compressors are also used by the CompressedFilePager when writing chunks to disk.
+	 */
+	class Compressor
+	{
+	public:
+		/// Constructor
+		Compressor() {};
+		/// Destructor
+		virtual ~Compressor() {};
+
+		/**
+		 * Computes a worst-case scenario for how big the output can be for a given input size.
+		 *
+		 * If necessary you can use this as a destination buffer size, though it may be somewhat wasteful. It is
+		 * not guaranteed that compression actually shrinks the data, so the worst-case value returned by this
+		 * function may be bigger than the input size.
+		 *
+		 * \param uUncompressedInputSize The size of the uncompressed input data
+		 * \return The largest possible size of the compressed output data.
+		 */
+		virtual uint32_t getMaxCompressedSize(uint32_t uUncompressedInputSize) = 0;
+
+		/**
+		 * Compresses the data.
+		 *
+		 * Performs compression of the data pointed to by pSrcData and stores the result in pDstData. The user is responsible for allocating
+		 * both buffers and for making sure that the destination buffer is large enough to hold the result. If you don't know how big the
+		 * compressed data will be (and you probably won't know this) then you can call getMaxCompressedSize() to get an upper bound.
+		 *
+		 * \param pSrcData A pointer to the data to be compressed.
+		 * \param uSrcLength The length of the data to be compressed.
+		 * \param pDstData A pointer to the memory where the result should be stored.
+		 * \param uDstLength The length of the destination buffer (compression will fail if this isn't big enough).
+		 * \return The size of the resulting compressed data.
+		 */
+		virtual uint32_t compress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength) = 0;
+
+		/**
+		 * Decompresses the data.
+		 *
+		 * Performs decompression of the data pointed to by pSrcData and stores the result in pDstData. The user is responsible for allocating
+		 * both buffers and for making sure that the destination buffer is large enough to hold the result. This means you need to know how large
+		 * the resulting data might be, so before compressing the data it may be worth storing this information somewhere.
+		 *
+		 * \param pSrcData A pointer to the data to be decompressed.
+		 * \param uSrcLength The length of the data to be decompressed.
+		 * \param pDstData A pointer to the memory where the result should be stored.
+		 * \param uDstLength The length of the destination buffer (decompression will fail if this isn't big enough).
+		 * \return The size of the resulting uncompressed data.
+		 */
+		virtual uint32_t decompress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength) = 0;
+	};
+}
+
+#endif //__PolyVox_Compressor_H__
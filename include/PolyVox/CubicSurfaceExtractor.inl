@@ -23,6 +23,11 @@
 *******************************************************************************/
 
 #include "Impl/Timer.h"
+#include "Impl/Utility.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace PolyVox
 {
@@ -52,23 +57,39 @@ namespace PolyVox
 		NoOfFaces
 	};
 
-	struct Quad
+	// A run of faces which are next to each other along a row, all facing the same way and with the same material.
+	template<typename VolumeType>
+	struct FaceRun
 	{
-		Quad(uint32_t v0, uint32_t v1, uint32_t v2, uint32_t v3)
+		FaceRun(uint32_t uStartIn, typename VolumeType::VoxelType uMaterialIn)
+			:uStart(uStartIn)
+			, uEnd(uStartIn)
+			, uMaterial(uMaterialIn)
 		{
-			vertices[0] = v0;
-			vertices[1] = v1;
-			vertices[2] = v2;
-			vertices[3] = v3;
 		}
 
-		uint32_t vertices[4];
+		uint32_t uStart;
+		uint32_t uEnd; // Inclusive
+		typename VolumeType::VoxelType uMaterial;
 	};
 
+	// A rectangle of faces within a plane, which covers the same part of one or more consecutive rows.
 	template<typename VolumeType>
-	struct IndexAndMaterial
+	struct FaceRect
 	{
-		int32_t iIndex;
+		FaceRect(const FaceRun<VolumeType>& run, uint32_t uAcross)
+			:uAlongStart(run.uStart)
+			, uAlongEnd(run.uEnd)
+			, uAcrossStart(uAcross)
+			, uAcrossEnd(uAcross)
+			, uMaterial(run.uMaterial)
+		{
+		}
+
+		uint32_t uAlongStart;
+		uint32_t uAlongEnd; // Inclusive
+		uint32_t uAcrossStart;
+		uint32_t uAcrossEnd; // Inclusive
 		typename VolumeType::VoxelType uMaterial;
 	};
 
@@ -97,107 +118,727 @@ namespace PolyVox
 	// Surface extraction
 	////////////////////////////////////////////////////////////////////////////////
 
-	template<typename MeshType>
-	bool mergeQuads(Quad& q1, Quad& q2, MeshType* m_meshCurrent)
+	// Used to avoid creating duplicate vertices. Each position in the region which has been given a vertex has a chain
+	// of the vertices there, one for each of the materials which have been used at that position. The positions are
+	// found through a hash table with open addressing, which is kept at most half full.
+	template<typename VolumeType>
+	class CubicVertexTable
 	{
-		//All four vertices of a given quad have the same data,
-		//so just check that the first pair of vertices match.
-		if (m_meshCurrent->getVertex(q1.vertices[0]).data == m_meshCurrent->getVertex(q2.vertices[0]).data)
-		{
-			//Now check whether quad 2 is adjacent to quad one by comparing vertices.
-			//Adjacent quads must share two vertices, and the second quad could be to the
-			//top, bottom, left, of right of the first one. This gives four combinations to test.
-			if ((q1.vertices[0] == q2.vertices[1]) && ((q1.vertices[3] == q2.vertices[2])))
+	public:
+		CubicVertexTable()
+			:m_uNoOfPositions(0)
+		{
+			m_vecSlots.resize(1024);
+		}
+
+		template<typename MeshType>
+		uint32_t addVertex(uint32_t uX, uint32_t uY, uint32_t uZ, typename VolumeType::VoxelType uMaterialIn, MeshType* m_meshCurrent)
+		{
+			// The vertex positions are less than 256 along each axis, as they are encoded with a byte per component.
+			const uint32_t uKey = uX | (uY << 8) | (uZ << 16);
+			Slot& slot = findSlot(uKey);
+
+			uint32_t uNoOfEntries = 0;
+			for (uint32_t uEntry = slot.uFirstEntry; uEntry != NoEntry; uEntry = m_vecEntries[uEntry].uNext)
+			{
+				//If we have an existing vertex and the material matches then we can return it.
+				if (m_vecEntries[uEntry].uMaterial == uMaterialIn)
+				{
+					return m_vecEntries[uEntry].uIndex;
+				}
+				uNoOfEntries++;
+			}
+
+			// If we get here with all the slots full then it is probably a bug in PolyVox. Please report it to us!
+			POLYVOX_THROW_IF(uNoOfEntries >= MaxVerticesPerPosition, std::runtime_error, "All slots full but no matches during cubic surface extraction. This is probably a bug in PolyVox");
+
+			//No vertices matched, so create one. The 0.5f offset is because vertices set between voxels in order to build cubes around them.
+			CubicVertex<typename VolumeType::VoxelType> cubicVertex;
+			cubicVertex.encodedPosition.setElements(static_cast<uint8_t>(uX), static_cast<uint8_t>(uY), static_cast<uint8_t>(uZ));
+			cubicVertex.data = uMaterialIn;
+
+			Entry entry;
+			entry.uIndex = static_cast<uint32_t>(m_meshCurrent->addVertex(cubicVertex));
+			entry.uMaterial = uMaterialIn;
+			entry.uNext = slot.uFirstEntry;
+
+			if (slot.uKey == NoEntry)
 			{
-				q1.vertices[0] = q2.vertices[0];
-				q1.vertices[3] = q2.vertices[3];
-				return true;
+				slot.uKey = uKey;
+				m_uNoOfPositions++;
 			}
-			else if ((q1.vertices[3] == q2.vertices[0]) && ((q1.vertices[2] == q2.vertices[1])))
+			slot.uFirstEntry = static_cast<uint32_t>(m_vecEntries.size());
+			m_vecEntries.push_back(entry);
+
+			if (m_uNoOfPositions * 2 > m_vecSlots.size())
 			{
-				q1.vertices[3] = q2.vertices[3];
-				q1.vertices[2] = q2.vertices[2];
-				return true;
+				grow();
 			}
-			else if ((q1.vertices[1] == q2.vertices[0]) && ((q1.vertices[2] == q2.vertices[3])))
+
+			return entry.uIndex;
+		}
+
+	private:
+		static const uint32_t NoEntry = 0xFFFFFFFF;
+
+		struct Slot
+		{
+			Slot()
+				:uKey(NoEntry)
+				, uFirstEntry(NoEntry)
 			{
-				q1.vertices[1] = q2.vertices[1];
-				q1.vertices[2] = q2.vertices[2];
-				return true;
 			}
-			else if ((q1.vertices[0] == q2.vertices[3]) && ((q1.vertices[1] == q2.vertices[2])))
+
+			uint32_t uKey;
+			uint32_t uFirstEntry;
+		};
+
+		struct Entry
+		{
+			uint32_t uIndex;
+			typename VolumeType::VoxelType uMaterial;
+			uint32_t uNext;
+		};
+
+		// Returns the slot for the given position, or the empty slot where it should go. The
+		// number of slots is always a power of two, so the hash only needs to be masked.
+		Slot& findSlot(uint32_t uKey)
+		{
+			const uint32_t uMask = static_cast<uint32_t>(m_vecSlots.size()) - 1;
+			uint32_t uSlot = (uKey * 2654435761u) & uMask;
+			while ((m_vecSlots[uSlot].uKey != uKey) && (m_vecSlots[uSlot].uKey != NoEntry))
+			{
+				uSlot = (uSlot + 1) & uMask;
+			}
+			return m_vecSlots[uSlot];
+		}
+
+		void grow()
+		{
+			std::vector<Slot> vecOldSlots(m_vecSlots.size() * 2);
+			vecOldSlots.swap(m_vecSlots);
+
+			for (typename std::vector<Slot>::const_iterator slotIter = vecOldSlots.begin(); slotIter != vecOldSlots.end(); slotIter++)
 			{
-				q1.vertices[0] = q2.vertices[0];
-				q1.vertices[1] = q2.vertices[1];
-				return true;
+				if (slotIter->uKey != NoEntry)
+				{
+					findSlot(slotIter->uKey) = *slotIter;
+				}
 			}
 		}
 
-		//Quads cannot be merged.
-		return false;
+		std::vector<Slot> m_vecSlots;
+		uint32_t m_uNoOfPositions;
+		std::vector<Entry> m_vecEntries;
+	};
+
+	// Faces are merged on a 2D grid within the plane they lie in. This maps a position on that grid (along a row, and
+	// across the rows) back into the region, and adds a vertex there.
+	template<typename VolumeType, typename MeshType>
+	uint32_t addFaceVertex(FaceNames face, uint32_t uPlane, uint32_t uAlong, uint32_t uAcross, typename VolumeType::VoxelType uMaterial, CubicVertexTable<VolumeType>& existingVertices, MeshType* m_meshCurrent)
+	{
+		switch (face)
+		{
+		case PositiveX:
+		case NegativeX:
+			return existingVertices.addVertex(uPlane, uAlong, uAcross, uMaterial, m_meshCurrent);
+		case PositiveY:
+		case NegativeY:
+			return existingVertices.addVertex(uAlong, uPlane, uAcross, uMaterial, m_meshCurrent);
+		default:
+			return existingVertices.addVertex(uAlong, uAcross, uPlane, uMaterial, m_meshCurrent);
+		}
+	}
+
+	template<typename VolumeType>
+	void addFaceToRun(std::vector< FaceRun<VolumeType> >& runs, uint32_t uPosition, typename VolumeType::VoxelType uMaterial, bool bMergeQuads)
+	{
+		if (bMergeQuads && !runs.empty() && (runs.back().uEnd + 1 == uPosition) && (runs.back().uMaterial == uMaterial))
+		{
+			runs.back().uEnd = uPosition;
+		}
+		else
+		{
+			runs.push_back(FaceRun<VolumeType>(uPosition, uMaterial));
+		}
+	}
+
+	template<typename VolumeType, typename MeshType>
+	void addFaceRect(FaceNames face, uint32_t uPlane, const FaceRect<VolumeType>& rect, CubicVertexTable<VolumeType>& existingVertices, MeshType* m_meshCurrent)
+	{
+		const uint32_t uStartLowerVertex = addFaceVertex(face, uPlane, rect.uAlongStart, rect.uAcrossStart, rect.uMaterial, existingVertices, m_meshCurrent);
+		const uint32_t uStartUpperVertex = addFaceVertex(face, uPlane, rect.uAlongEnd + 1, rect.uAcrossStart, rect.uMaterial, existingVertices, m_meshCurrent);
+		const uint32_t uEndLowerVertex = addFaceVertex(face, uPlane, rect.uAlongStart, rect.uAcrossEnd + 1, rect.uMaterial, existingVertices, m_meshCurrent);
+		const uint32_t uEndUpperVertex = addFaceVertex(face, uPlane, rect.uAlongEnd + 1, rect.uAcrossEnd + 1, rect.uMaterial, existingVertices, m_meshCurrent);
+
+		// Rows of y faces run along x and are stacked along z, which is the opposite way round to the x and z faces.
+		const bool bIsYFace = (face == PositiveY) || (face == NegativeY);
+		const uint32_t v0 = uStartLowerVertex;
+		const uint32_t v1 = bIsYFace ? uStartUpperVertex : uEndLowerVertex;
+		const uint32_t v2 = uEndUpperVertex;
+		const uint32_t v3 = bIsYFace ? uEndLowerVertex : uStartUpperVertex;
+
+		if ((face == NegativeX) || (face == NegativeY) || (face == NegativeZ))
+		{
+			m_meshCurrent->addTriangle(v0, v1, v2);
+			m_meshCurrent->addTriangle(v0, v2, v3);
+		}
+		else
+		{
+			m_meshCurrent->addTriangle(v0, v3, v2);
+			m_meshCurrent->addTriangle(v0, v2, v1);
+		}
 	}
 
-	template<typename MeshType>
-	bool performQuadMerging(std::list<Quad>& quads, MeshType* m_meshCurrent)
+	// Covers the faces of a plane with rectangles. Two different greedy methods are tried, as neither of them always finds
+	// the fewest rectangles, and whichever gives fewer is used (the second one if they give the same number). Between them they never need more rectangles than merging
+	// neighbouring faces pair by pair does, because the second method gives exactly the same result as that does.
+	template<typename VolumeType>
+	class FaceRectFinder
 	{
-		bool bDidMerge = false;
-		for (typename std::list<Quad>::iterator outerIter = quads.begin(); outerIter != quads.end(); outerIter++)
+	public:
+		typedef std::vector< std::vector< FaceRun<VolumeType> > > PlaneRows;
+
+		// The rows are indexed by their position across the plane, and their runs must be in order along it.
+		void findRects(const PlaneRows& rows, uint32_t uAlongSize, bool bMergeQuads, std::vector< FaceRect<VolumeType> >& result)
 		{
-			typename std::list<Quad>::iterator innerIter = outerIter;
-			innerIter++;
-			while (innerIter != quads.end())
+			result.clear();
+
+			if (!bMergeQuads)
 			{
-				Quad& q1 = *outerIter;
-				Quad& q2 = *innerIter;
+				for (uint32_t uAcross = 0; uAcross < rows.size(); uAcross++)
+				{
+					for (typename std::vector< FaceRun<VolumeType> >::const_iterator runIter = rows[uAcross].begin(); runIter != rows[uAcross].end(); runIter++)
+					{
+						result.push_back(FaceRect<VolumeType>(*runIter, uAcross));
+					}
+				}
+				return;
+			}
 
-				bool result = mergeQuads(q1, q2, m_meshCurrent);
+			growRows(rows, result);
+			mergeNeighbours(rows, uAlongSize, m_vecMerged);
 
-				if (result)
+			if (m_vecMerged.size() <= result.size())
+			{
+				result.swap(m_vecMerged);
+			}
+		}
+
+	private:
+		// Grows rectangles one row at a time. An open rectangle grows into the next row if that row has a run of faces of the
+		// same material which covers it. A run can cover several rectangles, and any parts of it which are left over open
+		// new rectangles. Growing them is only worthwhile if it leaves at most one such part, as otherwise closing them and
+		// opening a single rectangle for the whole run needs fewer. The open rectangles are sorted and never overlap, so each
+		// row is a single pass over its runs and the open rectangles.
+		void growRows(const PlaneRows& rows, std::vector< FaceRect<VolumeType> >& result)
+		{
+			m_vecOpen.clear();
+
+			// The extra row at the end has no faces, so it closes all the rectangles which are still open.
+			for (uint32_t uAcross = 0; uAcross <= rows.size(); uAcross++)
+			{
+				m_vecNextOpen.clear();
+
+				typename std::vector< FaceRect<VolumeType> >::iterator openIter = m_vecOpen.begin();
+				if (uAcross < rows.size())
+				{
+					for (typename std::vector< FaceRun<VolumeType> >::const_iterator runIter = rows[uAcross].begin(); runIter != rows[uAcross].end(); runIter++)
+					{
+						const FaceRun<VolumeType>& run = *runIter;
+
+						// Rectangles which start before this run cannot be covered by it.
+						while ((openIter != m_vecOpen.end()) && (openIter->uAlongStart < run.uStart))
+						{
+							result.push_back(*openIter);
+							openIter++;
+						}
+
+						m_vecCovered.clear();
+						while ((openIter != m_vecOpen.end()) && (openIter->uAlongStart <= run.uEnd))
+						{
+							if ((openIter->uAlongEnd <= run.uEnd) && (openIter->uMaterial == run.uMaterial))
+							{
+								m_vecCovered.push_back(*openIter);
+							}
+							else
+							{
+								result.push_back(*openIter);
+							}
+							openIter++;
+						}
+
+						uint32_t uNoOfParts = 0;
+						uint32_t uUncovered = run.uStart;
+						for (typename std::vector< FaceRect<VolumeType> >::iterator coveredIter = m_vecCovered.begin(); coveredIter != m_vecCovered.end(); coveredIter++)
+						{
+							uNoOfParts += (coveredIter->uAlongStart > uUncovered) ? 1 : 0;
+							uUncovered = coveredIter->uAlongEnd + 1;
+						}
+						uNoOfParts += (uUncovered <= run.uEnd) ? 1 : 0;
+
+						if (uNoOfParts <= 1)
+						{
+							uUncovered = run.uStart;
+							for (typename std::vector< FaceRect<VolumeType> >::iterator coveredIter = m_vecCovered.begin(); coveredIter != m_vecCovered.end(); coveredIter++)
+							{
+								if (coveredIter->uAlongStart > uUncovered)
+								{
+									openPart(run, uUncovered, coveredIter->uAlongStart - 1, uAcross);
+								}
+
+								coveredIter->uAcrossEnd = uAcross;
+								m_vecNextOpen.push_back(*coveredIter);
+								uUncovered = coveredIter->uAlongEnd + 1;
+							}
+
+							if (uUncovered <= run.uEnd)
+							{
+								openPart(run, uUncovered, run.uEnd, uAcross);
+							}
+						}
+						else
+						{
+							result.insert(result.end(), m_vecCovered.begin(), m_vecCovered.end());
+							m_vecNextOpen.push_back(FaceRect<VolumeType>(run, uAcross));
+						}
+					}
+				}
+
+				result.insert(result.end(), openIter, m_vecOpen.end());
+				m_vecOpen.swap(m_vecNextOpen);
+			}
+		}
+
+		void openPart(const FaceRun<VolumeType>& run, uint32_t uStart, uint32_t uEnd, uint32_t uAcross)
+		{
+			FaceRect<VolumeType> rect(run, uAcross);
+			rect.uAlongStart = uStart;
+			rect.uAlongEnd = uEnd;
+			m_vecNextOpen.push_back(rect);
+		}
+
+		// Starts with a rectangle for each face and merges pairs of rectangles which share a whole edge, visiting them in
+		// order and repeating until nothing changes. This is how the extractor used to merge its quads, but finding the
+		// neighbours through a grid of which rectangle owns each face avoids searching through all the others.
+		void mergeNeighbours(const PlaneRows& rows, uint32_t uAlongSize, std::vector< FaceRect<VolumeType> >& result)
+		{
+			const uint32_t uAcrossSize = static_cast<uint32_t>(rows.size());
+			if (m_vecOwners.size() < uAlongSize * uAcrossSize)
+			{
+				// Every entry is -1 (no face) between calls, as they are reset below.
+				m_vecOwners.resize(uAlongSize * uAcrossSize, -1);
+			}
+
+			m_vecRects.clear();
+			for (uint32_t uAcross = 0; uAcross < uAcrossSize; uAcross++)
+			{
+				for (typename std::vector< FaceRun<VolumeType> >::const_iterator runIter = rows[uAcross].begin(); runIter != rows[uAcross].end(); runIter++)
 				{
-					bDidMerge = true;
-					innerIter = quads.erase(innerIter);
+					FaceRect<VolumeType> rect(*runIter, uAcross);
+					for (uint32_t uAlong = runIter->uStart; uAlong <= runIter->uEnd; uAlong++)
+					{
+						rect.uAlongStart = uAlong;
+						rect.uAlongEnd = uAlong;
+						m_vecOwners[uAlong + uAcross * uAlongSize] = static_cast<int32_t>(m_vecRects.size());
+						m_vecRects.push_back(rect);
+					}
 				}
-				else
+			}
+
+			bool bDidMerge = true;
+			while (bDidMerge)
+			{
+				bDidMerge = false;
+				for (int32_t iRect = 0; iRect < static_cast<int32_t>(m_vecRects.size()); iRect++)
 				{
-					innerIter++;
+					FaceRect<VolumeType>& rect = m_vecRects[iRect];
+					if (getOwner(rect.uAlongStart, rect.uAcrossStart, uAlongSize) != iRect)
+					{
+						continue; // Already merged into another rectangle.
+					}
+
+					// Only the rectangles after the last one merged are considered, which keeps the order of the merges the same
+					// as it was when each rectangle was compared with every later one in turn.
+					int32_t iLastMerged = iRect;
+					for (;;)
+					{
+						int32_t iNext = -1;
+						if (rect.uAlongStart > 0)
+						{
+							considerNeighbour(rect, getOwner(rect.uAlongStart - 1, rect.uAcrossStart, uAlongSize), iLastMerged, iNext);
+						}
+						if (rect.uAlongEnd + 1 < uAlongSize)
+						{
+							considerNeighbour(rect, getOwner(rect.uAlongEnd + 1, rect.uAcrossStart, uAlongSize), iLastMerged, iNext);
+						}
+						if (rect.uAcrossStart > 0)
+						{
+							considerNeighbour(rect, getOwner(rect.uAlongStart, rect.uAcrossStart - 1, uAlongSize), iLastMerged, iNext);
+						}
+						if (rect.uAcrossEnd + 1 < uAcrossSize)
+						{
+							considerNeighbour(rect, getOwner(rect.uAlongStart, rect.uAcrossEnd + 1, uAlongSize), iLastMerged, iNext);
+						}
+
+						if (iNext == -1)
+						{
+							break;
+						}
+
+						const FaceRect<VolumeType>& other = m_vecRects[iNext];
+						for (uint32_t uAcross = other.uAcrossStart; uAcross <= other.uAcrossEnd; uAcross++)
+						{
+							std::fill(&m_vecOwners[other.uAlongStart + uAcross * uAlongSize], &m_vecOwners[other.uAlongEnd + uAcross * uAlongSize] + 1, iRect);
+						}
+						rect.uAlongStart = (std::min)(rect.uAlongStart, other.uAlongStart);
+						rect.uAlongEnd = (std::max)(rect.uAlongEnd, other.uAlongEnd);
+						rect.uAcrossStart = (std::min)(rect.uAcrossStart, other.uAcrossStart);
+						rect.uAcrossEnd = (std::max)(rect.uAcrossEnd, other.uAcrossEnd);
+
+						iLastMerged = iNext;
+						bDidMerge = true;
+					}
+				}
+			}
+
+			result.clear();
+			for (int32_t iRect = 0; iRect < static_cast<int32_t>(m_vecRects.size()); iRect++)
+			{
+				const FaceRect<VolumeType>& rect = m_vecRects[iRect];
+				if (getOwner(rect.uAlongStart, rect.uAcrossStart, uAlongSize) == iRect)
+				{
+					result.push_back(rect);
+				}
+			}
+
+			for (uint32_t uAcross = 0; uAcross < uAcrossSize; uAcross++)
+			{
+				for (typename std::vector< FaceRun<VolumeType> >::const_iterator runIter = rows[uAcross].begin(); runIter != rows[uAcross].end(); runIter++)
+				{
+					std::fill(&m_vecOwners[runIter->uStart + uAcross * uAlongSize], &m_vecOwners[runIter->uEnd + uAcross * uAlongSize] + 1, -1);
 				}
 			}
 		}
 
-		return bDidMerge;
-	}
+		int32_t getOwner(uint32_t uAlong, uint32_t uAcross, uint32_t uAlongSize) const
+		{
+			return m_vecOwners[uAlong + uAcross * uAlongSize];
+		}
+
+		// Two rectangles can be merged if they have the same material and one of them has an edge which is exactly the same as
+		// the opposite edge of the other. Of those which can be merged, the one which comes first (after the last merge) is chosen.
+		void considerNeighbour(const FaceRect<VolumeType>& rect, int32_t iOther, int32_t iLastMerged, int32_t& iNext) const
+		{
+			if ((iOther <= iLastMerged) || ((iNext != -1) && (iOther > iNext)))
+			{
+				return;
+			}
 
+			const FaceRect<VolumeType>& other = m_vecRects[iOther];
+			if (!(other.uMaterial == rect.uMaterial))
+			{
+				return;
+			}
+
+			const bool bSameRows = (other.uAcrossStart == rect.uAcrossStart) && (other.uAcrossEnd == rect.uAcrossEnd);
+			const bool bSameColumns = (other.uAlongStart == rect.uAlongStart) && (other.uAlongEnd == rect.uAlongEnd);
+			if ((bSameRows && ((other.uAlongEnd + 1 == rect.uAlongStart) || (rect.uAlongEnd + 1 == other.uAlongStart))) ||
+				(bSameColumns && ((other.uAcrossEnd + 1 == rect.uAcrossStart) || (rect.uAcrossEnd + 1 == other.uAcrossStart))))
+			{
+				iNext = iOther;
+			}
+		}
+
+		std::vector< FaceRect<VolumeType> > m_vecOpen;
+		std::vector< FaceRect<VolumeType> > m_vecNextOpen;
+		std::vector< FaceRect<VolumeType> > m_vecCovered;
+
+		std::vector< FaceRect<VolumeType> > m_vecRects;
+		std::vector< FaceRect<VolumeType> > m_vecMerged;
+		std::vector<int32_t> m_vecOwners;
+	};
+
+	// Adds the faces of a complete plane to the mesh, and empties its rows ready for reuse.
 	template<typename VolumeType, typename MeshType>
-	int32_t addVertex(uint32_t uX, uint32_t uY, uint32_t uZ, typename VolumeType::VoxelType uMaterialIn, Array<3, IndexAndMaterial<VolumeType> >& existingVertices, MeshType* m_meshCurrent)
+	void addFacePlane(FaceNames face, uint32_t uPlane, std::vector< std::vector< FaceRun<VolumeType> > >& rows, uint32_t uAlongSize, bool bMergeQuads,
+		FaceRectFinder<VolumeType>& rectFinder, std::vector< FaceRect<VolumeType> >& rects, CubicVertexTable<VolumeType>& existingVertices, MeshType* m_meshCurrent)
+	{
+		rectFinder.findRects(rows, uAlongSize, bMergeQuads, rects);
+		for (typename std::vector< FaceRect<VolumeType> >::const_iterator rectIter = rects.begin(); rectIter != rects.end(); rectIter++)
+		{
+			addFaceRect(face, uPlane, *rectIter, existingVertices, m_meshCurrent);
+		}
+
+		for (uint32_t uAcross = 0; uAcross < rows.size(); uAcross++)
+		{
+			rows[uAcross].clear();
+		}
+	}
+
+	// Whether the faces can be found with the bitmasks below, which only deal with numeric voxels.
+	template<typename VolumeType, typename IsQuadNeeded>
+	struct CanUseOccupancyMasks
+	{
+		typedef typename VolumeType::VoxelType VoxelType;
+		static const bool value = UsesOccupancyMasks<IsQuadNeeded>::value
+			&& std::is_arithmetic<VoxelType>::value && !std::is_same<VoxelType, bool>::value; // No std::vector<bool> for the slices.
+	};
+
+	// Finds the faces along a row of the region and adds them to the runs for that row. This general version asks the
+	// IsQuadNeeded functor about every pair of neighbouring voxels, which is six calls for each voxel in the region.
+	template<typename VolumeType, typename IsQuadNeeded, bool bUseMasks = CanUseOccupancyMasks<VolumeType, IsQuadNeeded>::value>
+	class CubicFaceFinder
+	{
+	public:
+		typedef std::vector< std::vector< FaceRun<VolumeType> > > RunLists;
+
+		CubicFaceFinder(VolumeType* volData, const Region& region, IsQuadNeeded isQuadNeeded)
+			:m_sampler(volData)
+			, m_region(region)
+			, m_isQuadNeeded(isQuadNeeded)
+		{
+		}
+
+		void beginSlice(int32_t /*z*/)
+		{
+		}
+
+		void findFacesInRow(int32_t y, int32_t z, RunLists* vecRuns, bool bMergeQuads)
+		{
+			const uint32_t regY = y - m_region.getLowerY();
+
+			m_sampler.setPosition(m_region.getLowerX(), y, z);
+
+			for (int32_t x = m_region.getLowerX(); x <= m_region.getUpperX(); x++)
+			{
+				uint32_t regX = x - m_region.getLowerX();
+
+				typename VolumeType::VoxelType material; //Filled in by callback
+				typename VolumeType::VoxelType currentVoxel = m_sampler.getVoxel();
+				typename VolumeType::VoxelType negXVoxel = m_sampler.peekVoxel1nx0py0pz();
+				typename VolumeType::VoxelType negYVoxel = m_sampler.peekVoxel0px1ny0pz();
+				typename VolumeType::VoxelType negZVoxel = m_sampler.peekVoxel0px0py1nz();
+
+				// X
+				if (m_isQuadNeeded(currentVoxel, negXVoxel, material))
+				{
+					addFaceToRun(vecRuns[NegativeX][regX], regY, material, bMergeQuads);
+				}
+
+				if (m_isQuadNeeded(negXVoxel, currentVoxel, material))
+				{
+					addFaceToRun(vecRuns[PositiveX][regX], regY, material, bMergeQuads);
+				}
+
+				// Y
+				if (m_isQuadNeeded(currentVoxel, negYVoxel, material))
+				{
+					addFaceToRun(vecRuns[NegativeY][0], regX, material, bMergeQuads);
+				}
+
+				if (m_isQuadNeeded(negYVoxel, currentVoxel, material))
+				{
+					addFaceToRun(vecRuns[PositiveY][0], regX, material, bMergeQuads);
+				}
+
+				// Z
+				if (m_isQuadNeeded(currentVoxel, negZVoxel, material))
+				{
+					addFaceToRun(vecRuns[NegativeZ][0], regX, material, bMergeQuads);
+				}
+
+				if (m_isQuadNeeded(negZVoxel, currentVoxel, material))
+				{
+					addFaceToRun(vecRuns[PositiveZ][0], regX, material, bMergeQuads);
+				}
+
+				m_sampler.movePositiveX();
+			}
+		}
+
+	private:
+		typename VolumeType::Sampler m_sampler;
+		Region m_region;
+		IsQuadNeeded m_isQuadNeeded;
+	};
+
+	// With the DefaultIsQuadNeeded criteria a voxel is either solid (greater than zero), empty (equal to zero) or neither, and
+	// a face is needed wherever a solid voxel is in front of an empty one. Each slice is therefore read once and turned into
+	// masks of its solid and empty voxels with one bit per voxel along each row. The faces of a row are then found a whole
+	// word at a time by combining these masks with shifted copies of themselves (for the x faces) or with the masks of the
+	// neighbouring row or slice (for the y and z faces), and only the bits which are set need to be visited.
+	template<typename VolumeType, typename IsQuadNeeded>
+	class CubicFaceFinder<VolumeType, IsQuadNeeded, true>
 	{
-		for (uint32_t ct = 0; ct < MaxVerticesPerPosition; ct++)
+	public:
+		typedef std::vector< std::vector< FaceRun<VolumeType> > > RunLists;
+
+		CubicFaceFinder(VolumeType* volData, const Region& region, IsQuadNeeded /*isQuadNeeded*/)
+			:m_sampler(volData)
+			, m_region(region)
+			// The slices cover the region plus the row, column and slice of voxels before it. Bit 'i' of a row is for x = lowerX - 1 + i.
+			, m_uSliceWidth(region.getWidthInVoxels() + 1)
+			, m_uSliceHeight(region.getHeightInVoxels() + 1)
+			, m_uWordsPerRow((m_uSliceWidth + 63) / 64)
+		{
+			for (uint32_t ct = 0; ct < 2; ct++)
+			{
+				m_vecVoxels[ct].resize(m_uSliceWidth * m_uSliceHeight);
+				m_vecSolid[ct].resize(m_uWordsPerRow * m_uSliceHeight);
+				m_vecEmpty[ct].resize(m_uWordsPerRow * m_uSliceHeight);
+			}
+			m_vecFaces.resize(m_uWordsPerRow);
+
+			// Prime the 'current' slice with the one before the region, so that it becomes the 'previous' slice in beginSlice().
+			m_uCurrent = 0;
+			readSlice(region.getLowerZ() - 1);
+		}
+
+		void beginSlice(int32_t z)
 		{
-			IndexAndMaterial<VolumeType>& rEntry = existingVertices(uX, uY, ct);
+			m_uCurrent = 1 - m_uCurrent;
+			readSlice(z);
+		}
 
-			if (rEntry.iIndex == -1)
+		void findFacesInRow(int32_t y, int32_t /*z*/, RunLists* vecRuns, bool bMergeQuads)
+		{
+			const uint32_t regY = y - m_region.getLowerY();
+			const uint32_t uRow = regY + 1;
+			const uint32_t uPrevious = 1 - m_uCurrent;
+
+			const uint64_t* pSolid = &m_vecSolid[m_uCurrent][uRow * m_uWordsPerRow];
+			const uint64_t* pEmpty = &m_vecEmpty[m_uCurrent][uRow * m_uWordsPerRow];
+			const uint64_t* pSolidBelow = pSolid - m_uWordsPerRow;
+			const uint64_t* pEmptyBelow = pEmpty - m_uWordsPerRow;
+			const uint64_t* pSolidBehind = &m_vecSolid[uPrevious][uRow * m_uWordsPerRow];
+			const uint64_t* pEmptyBehind = &m_vecEmpty[uPrevious][uRow * m_uWordsPerRow];
+
+			const typename VolumeType::VoxelType* pVoxels = &m_vecVoxels[m_uCurrent][uRow * m_uSliceWidth];
+			const typename VolumeType::VoxelType* pVoxelsBelow = pVoxels - m_uSliceWidth;
+			const typename VolumeType::VoxelType* pVoxelsBehind = &m_vecVoxels[uPrevious][uRow * m_uSliceWidth];
+
+			// The first bit of each row is outside the region, so only the faces of the x neighbour
+			// are needed from it. Shifting a mask up by one moves each voxel onto its positive x neighbour.
+			uint64_t uEmptyCarry = 0;
+			for (uint32_t uWord = 0; uWord < m_uWordsPerRow; uWord++)
 			{
-				//No vertices matched and we've now hit an empty space. Fill it by creating a vertex. The 0.5f offset is because vertices set between voxels in order to build cubes around them.
-				CubicVertex<typename VolumeType::VoxelType> cubicVertex;
-				cubicVertex.encodedPosition.setElements(static_cast<uint8_t>(uX), static_cast<uint8_t>(uY), static_cast<uint8_t>(uZ));
-				cubicVertex.data = uMaterialIn;
-				rEntry.iIndex = m_meshCurrent->addVertex(cubicVertex);
-				rEntry.uMaterial = uMaterialIn;
-
-				return rEntry.iIndex;
+				const uint64_t uEmptyShifted = (pEmpty[uWord] << 1) | uEmptyCarry;
+				uEmptyCarry = pEmpty[uWord] >> 63;
+
+				m_vecFaces[uWord] = pSolid[uWord] & uEmptyShifted;
 			}
+			addFacesToColumns(vecRuns[NegativeX], regY, pVoxels, bMergeQuads);
 
-			//If we have an existing vertex and the material matches then we can return it.
-			if (rEntry.uMaterial == uMaterialIn)
+			// For the positive x faces the solid voxel is the one before, so the materials are offset by one.
+			uint64_t uSolidCarry = 0;
+			for (uint32_t uWord = 0; uWord < m_uWordsPerRow; uWord++)
 			{
-				return rEntry.iIndex;
+				const uint64_t uSolidShifted = (pSolid[uWord] << 1) | uSolidCarry;
+				uSolidCarry = pSolid[uWord] >> 63;
+
+				m_vecFaces[uWord] = uSolidShifted & pEmpty[uWord];
 			}
+			addFacesToColumns(vecRuns[PositiveX], regY, pVoxels - 1, bMergeQuads);
+
+			findFacesBetween(pSolid, pEmptyBelow);
+			addFacesToRow(vecRuns[NegativeY][0], pVoxels, bMergeQuads);
+
+			findFacesBetween(pSolidBelow, pEmpty);
+			addFacesToRow(vecRuns[PositiveY][0], pVoxelsBelow, bMergeQuads);
+
+			findFacesBetween(pSolid, pEmptyBehind);
+			addFacesToRow(vecRuns[NegativeZ][0], pVoxels, bMergeQuads);
+
+			findFacesBetween(pSolidBehind, pEmpty);
+			addFacesToRow(vecRuns[PositiveZ][0], pVoxelsBehind, bMergeQuads);
 		}
 
-		// If we exit the loop here then apparently all the slots were full but none of them matched.
-		// This shouldn't ever happen, so if it does it is probably a bug in PolyVox. Please report it to us!
-		POLYVOX_THROW(std::runtime_error, "All slots full but no matches during cubic surface extraction. This is probably a bug in PolyVox");
-		return -1; //Should never happen.
-	}
+	private:
+		void readSlice(int32_t z)
+		{
+			typename VolumeType::VoxelType* pVoxels = &m_vecVoxels[m_uCurrent][0];
+			uint64_t* pSolid = &m_vecSolid[m_uCurrent][0];
+			uint64_t* pEmpty = &m_vecEmpty[m_uCurrent][0];
+
+			std::fill(m_vecSolid[m_uCurrent].begin(), m_vecSolid[m_uCurrent].end(), 0);
+			std::fill(m_vecEmpty[m_uCurrent].begin(), m_vecEmpty[m_uCurrent].end(), 0);
+
+			for (uint32_t uRow = 0; uRow < m_uSliceHeight; uRow++)
+			{
+				m_sampler.setPosition(m_region.getLowerX() - 1, m_region.getLowerY() - 1 + static_cast<int32_t>(uRow), z);
+
+				for (uint32_t uBit = 0; uBit < m_uSliceWidth; uBit++)
+				{
+					const typename VolumeType::VoxelType voxel = m_sampler.getVoxel();
+					pVoxels[uBit] = voxel;
+					pSolid[uBit / 64] |= static_cast<uint64_t>(voxel > 0) << (uBit % 64);
+					pEmpty[uBit / 64] |= static_cast<uint64_t>(voxel == 0) << (uBit % 64);
+
+					m_sampler.movePositiveX();
+				}
+
+				pVoxels += m_uSliceWidth;
+				pSolid += m_uWordsPerRow;
+				pEmpty += m_uWordsPerRow;
+			}
+		}
+
+		// Finds where a voxel in one row is solid and the matching voxel in another is empty. The
+		// first bit is cleared because that voxel is outside the region in both of the rows.
+		void findFacesBetween(const uint64_t* pSolid, const uint64_t* pEmpty)
+		{
+			for (uint32_t uWord = 0; uWord < m_uWordsPerRow; uWord++)
+			{
+				m_vecFaces[uWord] = pSolid[uWord] & pEmpty[uWord];
+			}
+			m_vecFaces[0] &= ~static_cast<uint64_t>(1);
+		}
+
+		// The materials are taken from the solid voxels, which are passed in as the row they lie in.
+		void addFacesToRow(std::vector< FaceRun<VolumeType> >& runs, const typename VolumeType::VoxelType* pMaterials, bool bMergeQuads)
+		{
+			for (uint32_t uWord = 0; uWord < m_uWordsPerRow; uWord++)
+			{
+				uint64_t uFaces = m_vecFaces[uWord];
+				while (uFaces != 0)
+				{
+					const uint32_t uBit = uWord * 64 + countTrailingZeros(uFaces);
+					addFaceToRun(runs, uBit - 1, pMaterials[uBit], bMergeQuads);
+					uFaces &= uFaces - 1;
+				}
+			}
+		}
+
+		void addFacesToColumns(std::vector< std::vector< FaceRun<VolumeType> > >& columns, uint32_t regY, const typename VolumeType::VoxelType* pMaterials, bool bMergeQuads)
+		{
+			for (uint32_t uWord = 0; uWord < m_uWordsPerRow; uWord++)
+			{
+				uint64_t uFaces = m_vecFaces[uWord];
+				while (uFaces != 0)
+				{
+					const uint32_t uBit = uWord * 64 + countTrailingZeros(uFaces);
+					addFaceToRun(columns[uBit - 1], regY, pMaterials[uBit], bMergeQuads);
+					uFaces &= uFaces - 1;
+				}
+			}
+		}
+
+		typename VolumeType::Sampler m_sampler;
+		Region m_region;
+
+		uint32_t m_uSliceWidth;
+		uint32_t m_uSliceHeight;
+		uint32_t m_uWordsPerRow;
+
+		// Two slices which take turns at being the current one and the previous one.
+		uint32_t m_uCurrent;
+		std::vector<typename VolumeType::VoxelType> m_vecVoxels[2];
+		std::vector<uint64_t> m_vecSolid[2];
+		std::vector<uint64_t> m_vecEmpty[2];
+
+		std::vector<uint64_t> m_vecFaces;
+	};
 
 	/// The CubicSurfaceExtractor creates a mesh in which each voxel appears to be rendered as a cube
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -273,143 +914,79 @@ namespace PolyVox
 		Timer timer;
 		result->clear();
 
-		//Used to avoid creating duplicate vertices.
-		Array<3, IndexAndMaterial<VolumeType> > m_previousSliceVertices(region.getUpperX() - region.getLowerX() + 2, region.getUpperY() - region.getLowerY() + 2, MaxVerticesPerPosition);
-		Array<3, IndexAndMaterial<VolumeType> > m_currentSliceVertices(region.getUpperX() - region.getLowerX() + 2, region.getUpperY() - region.getLowerY() + 2, MaxVerticesPerPosition);
+		CubicVertexTable<VolumeType> existingVertices;
 
-		//During extraction we create a number of different lists of quads. All the 
-		//quads in a given list are in the same plane and facing in the same direction.
-		std::vector< std::list<Quad> > m_vecQuads[NoOfFaces];
+		// Rather than creating a quad for every face and merging them afterwards, the faces are gathered into runs along each
+		// row and the rows of each plane are then covered with rectangles (see FaceRectFinder). The rows of x and y faces are
+		// stacked along z so their planes are only complete at the end, while the planes of z faces are complete after each
+		// slice. The face finder adds the runs to m_vecRuns, and each finished row is moved into the plane which it is part of.
+		const uint32_t uRegionWidth = region.getWidthInVoxels();
+		const uint32_t uRegionHeight = region.getHeightInVoxels();
+		const uint32_t uRegionDepth = region.getDepthInVoxels();
 
+		typedef std::vector< std::vector< FaceRun<VolumeType> > > PlaneRows;
+		PlaneRows m_vecRuns[NoOfFaces];
+		std::vector<PlaneRows> m_vecPlanes[NoOfFaces];
 
-		memset(m_previousSliceVertices.getRawData(), 0xff, m_previousSliceVertices.getNoOfElements() * sizeof(IndexAndMaterial<VolumeType>));
-		memset(m_currentSliceVertices.getRawData(), 0xff, m_currentSliceVertices.getNoOfElements() * sizeof(IndexAndMaterial<VolumeType>));
+		m_vecRuns[NegativeX].resize(uRegionWidth);
+		m_vecRuns[PositiveX].resize(uRegionWidth);
+		m_vecPlanes[NegativeX].resize(uRegionWidth, PlaneRows(uRegionDepth));
+		m_vecPlanes[PositiveX].resize(uRegionWidth, PlaneRows(uRegionDepth));
 
-		m_vecQuads[NegativeX].resize(region.getUpperX() - region.getLowerX() + 2);
-		m_vecQuads[PositiveX].resize(region.getUpperX() - region.getLowerX() + 2);
+		m_vecRuns[NegativeY].resize(1);
+		m_vecRuns[PositiveY].resize(1);
+		m_vecPlanes[NegativeY].resize(uRegionHeight, PlaneRows(uRegionDepth));
+		m_vecPlanes[PositiveY].resize(uRegionHeight, PlaneRows(uRegionDepth));
 
-		m_vecQuads[NegativeY].resize(region.getUpperY() - region.getLowerY() + 2);
-		m_vecQuads[PositiveY].resize(region.getUpperY() - region.getLowerY() + 2);
+		m_vecRuns[NegativeZ].resize(1);
+		m_vecRuns[PositiveZ].resize(1);
+		m_vecPlanes[NegativeZ].resize(1, PlaneRows(uRegionHeight));
+		m_vecPlanes[PositiveZ].resize(1, PlaneRows(uRegionHeight));
 
-		m_vecQuads[NegativeZ].resize(region.getUpperZ() - region.getLowerZ() + 2);
-		m_vecQuads[PositiveZ].resize(region.getUpperZ() - region.getLowerZ() + 2);
+		FaceRectFinder<VolumeType> rectFinder;
+		std::vector< FaceRect<VolumeType> > vecRects;
 
-		typename VolumeType::Sampler volumeSampler(volData);
+		CubicFaceFinder<VolumeType, IsQuadNeeded> faceFinder(volData, region, isQuadNeeded);
 
 		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
 		{
 			uint32_t regZ = z - region.getLowerZ();
 
+			faceFinder.beginSlice(z);
+
 			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y++)
 			{
 				uint32_t regY = y - region.getLowerY();
 
-				volumeSampler.setPosition(region.getLowerX(), y, z);
-
-				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
-				{
-					uint32_t regX = x - region.getLowerX();
-
-					typename VolumeType::VoxelType material; //Filled in by callback
-					typename VolumeType::VoxelType currentVoxel = volumeSampler.getVoxel();
-					typename VolumeType::VoxelType negXVoxel = volumeSampler.peekVoxel1nx0py0pz();
-					typename VolumeType::VoxelType negYVoxel = volumeSampler.peekVoxel0px1ny0pz();
-					typename VolumeType::VoxelType negZVoxel = volumeSampler.peekVoxel0px0py1nz();
-
-					// X
-					if (isQuadNeeded(currentVoxel, negXVoxel, material))
-					{
-						uint32_t v0 = addVertex(regX, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v1 = addVertex(regX, regY, regZ + 1, material, m_currentSliceVertices, result);
-						uint32_t v2 = addVertex(regX, regY + 1, regZ + 1, material, m_currentSliceVertices, result);
-						uint32_t v3 = addVertex(regX, regY + 1, regZ, material, m_previousSliceVertices, result);
-
-						m_vecQuads[NegativeX][regX].push_back(Quad(v0, v1, v2, v3));
-					}
+				faceFinder.findFacesInRow(y, z, m_vecRuns, bMergeQuads);
 
-					if (isQuadNeeded(negXVoxel, currentVoxel, material))
-					{
-						uint32_t v0 = addVertex(regX, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v1 = addVertex(regX, regY, regZ + 1, material, m_currentSliceVertices, result);
-						uint32_t v2 = addVertex(regX, regY + 1, regZ + 1, material, m_currentSliceVertices, result);
-						uint32_t v3 = addVertex(regX, regY + 1, regZ, material, m_previousSliceVertices, result);
-
-						m_vecQuads[PositiveX][regX].push_back(Quad(v0, v3, v2, v1));
-					}
-
-					// Y
-					if (isQuadNeeded(currentVoxel, negYVoxel, material))
-					{
-						uint32_t v0 = addVertex(regX, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v1 = addVertex(regX + 1, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v2 = addVertex(regX + 1, regY, regZ + 1, material, m_currentSliceVertices, result);
-						uint32_t v3 = addVertex(regX, regY, regZ + 1, material, m_currentSliceVertices, result);
-
-						m_vecQuads[NegativeY][regY].push_back(Quad(v0, v1, v2, v3));
-					}
-
-					if (isQuadNeeded(negYVoxel, currentVoxel, material))
-					{
-						uint32_t v0 = addVertex(regX, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v1 = addVertex(regX + 1, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v2 = addVertex(regX + 1, regY, regZ + 1, material, m_currentSliceVertices, result);
-						uint32_t v3 = addVertex(regX, regY, regZ + 1, material, m_currentSliceVertices, result);
-
-						m_vecQuads[PositiveY][regY].push_back(Quad(v0, v3, v2, v1));
-					}
-
-					// Z
-					if (isQuadNeeded(currentVoxel, negZVoxel, material))
-					{
-						uint32_t v0 = addVertex(regX, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v1 = addVertex(regX, regY + 1, regZ, material, m_previousSliceVertices, result);
-						uint32_t v2 = addVertex(regX + 1, regY + 1, regZ, material, m_previousSliceVertices, result);
-						uint32_t v3 = addVertex(regX + 1, regY, regZ, material, m_previousSliceVertices, result);
-
-						m_vecQuads[NegativeZ][regZ].push_back(Quad(v0, v1, v2, v3));
-					}
-
-					if (isQuadNeeded(negZVoxel, currentVoxel, material))
-					{
-						uint32_t v0 = addVertex(regX, regY, regZ, material, m_previousSliceVertices, result);
-						uint32_t v1 = addVertex(regX, regY + 1, regZ, material, m_previousSliceVertices, result);
-						uint32_t v2 = addVertex(regX + 1, regY + 1, regZ, material, m_previousSliceVertices, result);
-						uint32_t v3 = addVertex(regX + 1, regY, regZ, material, m_previousSliceVertices, result);
-
-						m_vecQuads[PositiveZ][regZ].push_back(Quad(v0, v3, v2, v1));
-					}
+				// The runs of y and z faces along this row are complete.
+				m_vecRuns[NegativeY][0].swap(m_vecPlanes[NegativeY][regY][regZ]);
+				m_vecRuns[PositiveY][0].swap(m_vecPlanes[PositiveY][regY][regZ]);
+				m_vecRuns[NegativeZ][0].swap(m_vecPlanes[NegativeZ][0][regY]);
+				m_vecRuns[PositiveZ][0].swap(m_vecPlanes[PositiveZ][0][regY]);
+			}
 
-					volumeSampler.movePositiveX();
-				}
+			// The runs of x faces along each column of this slice are now complete too.
+			for (uint32_t regX = 0; regX < uRegionWidth; regX++)
+			{
+				m_vecRuns[NegativeX][regX].swap(m_vecPlanes[NegativeX][regX][regZ]);
+				m_vecRuns[PositiveX][regX].swap(m_vecPlanes[PositiveX][regX][regZ]);
 			}
 
-			m_previousSliceVertices.swap(m_currentSliceVertices);
-			memset(m_currentSliceVertices.getRawData(), 0xff, m_currentSliceVertices.getNoOfElements() * sizeof(IndexAndMaterial<VolumeType>));
+			addFacePlane(NegativeZ, regZ, m_vecPlanes[NegativeZ][0], uRegionWidth, bMergeQuads, rectFinder, vecRects, existingVertices, result);
+			addFacePlane(PositiveZ, regZ, m_vecPlanes[PositiveZ][0], uRegionWidth, bMergeQuads, rectFinder, vecRects, existingVertices, result);
 		}
 
-		for (uint32_t uFace = 0; uFace < NoOfFaces; uFace++)
+		for (uint32_t regX = 0; regX < uRegionWidth; regX++)
 		{
-			std::vector< std::list<Quad> >& vecListQuads = m_vecQuads[uFace];
-
-			for (uint32_t slice = 0; slice < vecListQuads.size(); slice++)
-			{
-				std::list<Quad>& listQuads = vecListQuads[slice];
-
-				if (bMergeQuads)
-				{
-					//Repeatedly call this function until it returns
-					//false to indicate nothing more can be done.
-					while (performQuadMerging(listQuads, result)){}
-				}
-
-				typename std::list<Quad>::iterator iterEnd = listQuads.end();
-				for (typename std::list<Quad>::iterator quadIter = listQuads.begin(); quadIter != iterEnd; quadIter++)
-				{
-					Quad& quad = *quadIter;
-					result->addTriangle(quad.vertices[0], quad.vertices[1], quad.vertices[2]);
-					result->addTriangle(quad.vertices[0], quad.vertices[2], quad.vertices[3]);
-				}
-			}
+			addFacePlane(NegativeX, regX, m_vecPlanes[NegativeX][regX], uRegionHeight, bMergeQuads, rectFinder, vecRects, existingVertices, result);
+			addFacePlane(PositiveX, regX, m_vecPlanes[PositiveX][regX], uRegionHeight, bMergeQuads, rectFinder, vecRects, existingVertices, result);
+		}
+		for (uint32_t regY = 0; regY < uRegionHeight; regY++)
+		{
+			addFacePlane(NegativeY, regY, m_vecPlanes[NegativeY][regY], uRegionWidth, bMergeQuads, rectFinder, vecRects, existingVertices, result);
+			addFacePlane(PositiveY, regY, m_vecPlanes[PositiveY][regY], uRegionWidth, bMergeQuads, rectFinder, vecRects, existingVertices, result);
 		}
 
 		result->setOffset(region.getLowerCorner());
@@ -28,6 +28,7 @@
 #include "Impl/PlatformDefinitions.h"
 
 #include <cstdint>
+#include <type_traits>
 
 namespace PolyVox
 {
@@ -40,10 +41,18 @@ namespace PolyVox
 	/// geater than zero (typically indicating it is solid). Note that for
 	/// different behaviour users can create their own implementation and pass
 	/// it to extractCubicMesh().
+	///
+	/// For volumes of integer or floating point voxels the extractor does not
+	/// call operator() at all, but finds the faces with bitmasks which apply the
+	/// same criteria (see UsesOccupancyMasks). It knows to do this because of
+	/// the bUsesOccupancyMasks member, so if you specialise this class for one
+	/// of those voxel types your operator() is called as normal.
 	template<typename VoxelType>
 	class DefaultIsQuadNeeded
 	{
 	public:
+		static const bool bUsesOccupancyMasks = true;
+
 		bool operator()(VoxelType back, VoxelType front, VoxelType& materialToUse)
 		{
 			if ((back > 0) && (front == 0))
@@ -57,6 +66,27 @@ namespace PolyVox
 			}
 		}
 	};
+
+	/// Whether the cubic surface extractor may find faces with bitmasks instead
+	/// of calling the given IsQuadNeeded functor. A functor opts in by declaring
+	/// a static bUsesOccupancyMasks member which is true, and in doing so promises
+	/// to apply exactly the criteria of DefaultIsQuadNeeded. Functors without
+	/// the member (including specialisations of DefaultIsQuadNeeded) are always
+	/// called. The bitmasks are only used for integer and floating point voxels.
+	template<typename IsQuadNeeded>
+	struct UsesOccupancyMasks
+	{
+	private:
+		template<typename Functor>
+		static std::integral_constant<bool, Functor::bUsesOccupancyMasks> check(int);
+		template<typename Functor>
+		static std::false_type check(...);
+
+		typedef decltype(check<IsQuadNeeded>(0)) Result;
+
+	public:
+		static const bool value = Result::value;
+	};
 }
 
 #endif //__PolyVox_DefaultIsQuadNeeded_H__
\ No newline at end of file
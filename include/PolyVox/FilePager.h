@@ -84,7 +84,6 @@ namespace PolyVox
 		virtual void pageIn(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
 		{
 			POLYVOX_ASSERT(pChunk, "Attempting to page in NULL chunk");
-			POLYVOX_ASSERT(pChunk->getData(), "Chunk must have valid data");
 
 			std::stringstream ssFilename;
 			ssFilename << m_strFolderName << "/"
@@ -111,7 +110,21 @@ namespace PolyVox
 				pChunk->setData(buffer, fileSizeInBytes);
 				delete[] buffer;*/
 
-				fread(pChunk->getData(), sizeof(uint8_t), pChunk->getDataSizeInBytes(), pFile);
+				// Uniform chunks are stored as a single voxel.
+				fseek(pFile, 0L, SEEK_END);
+				long fileSizeInBytes = ftell(pFile);
+				fseek(pFile, 0L, SEEK_SET);
+
+				if (static_cast<size_t>(fileSizeInBytes) == sizeof(VoxelType))
+				{
+					VoxelType tUniformValue;
+					fread(&tUniformValue, sizeof(VoxelType), 1, pFile);
+					pChunk->setUniform(tUniformValue);
+				}
+				else
+				{
+					fread(pChunk->getData(), sizeof(uint8_t), pChunk->getDataSizeInBytes(), pFile);
+				}
 
 				if (ferror(pFile))
 				{
@@ -126,15 +139,13 @@ namespace PolyVox
 
 				// Just fill with zeros. This feels hacky... perhaps we should just throw
 				// an exception and let the calling code handle it and fill with zeros.
-				uint32_t noOfVoxels = region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels();
-				std::fill(pChunk->getData(), pChunk->getData() + noOfVoxels, VoxelType());
+				pChunk->setUniform(VoxelType());
 			}
 		}
 
 		virtual void pageOut(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
 		{
 			POLYVOX_ASSERT(pChunk, "Attempting to page out NULL chunk");
-			POLYVOX_ASSERT(pChunk->getData(), "Chunk must have valid data");
 
 			POLYVOX_LOG_TRACE("Paging out data for ", region);
 
@@ -158,7 +169,15 @@ namespace PolyVox
 			//The file has been created, so add it to the list to delete on shutdown.
 			m_vecCreatedFiles.push_back(filename);
 
-			fwrite(pChunk->getData(), sizeof(uint8_t), pChunk->getDataSizeInBytes(), pFile);
+			if (pChunk->isUniform())
+			{
+				VoxelType tUniformValue = pChunk->getUniformValue();
+				fwrite(&tUniformValue, sizeof(VoxelType), 1, pFile);
+			}
+			else
+			{
+				fwrite(pChunk->getData(), sizeof(uint8_t), pChunk->getDataSizeInBytes(), pFile);
+			}
 
 			if (ferror(pFile))
 			{
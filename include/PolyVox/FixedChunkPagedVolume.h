@@ -0,0 +1,83 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef __PolyVox_FixedChunkPagedVolume_H__
+#define __PolyVox_FixedChunkPagedVolume_H__
+
+#include "PagedVolume.h"
+
+#include "Impl/Utility.h"
+
+#include <cstdint>
+
+namespace PolyVox
+{
+	/**
+	 * A PagedVolume whose chunk side length is a template parameter rather than a constructor argument.
+	 *
+	 * Finding a voxel in a PagedVolume involves shifting and masking its position by amounts which depend on the chunk side
+	 * length, and the Sampler compares its position within the current chunk against the side length every time it moves. As
+	 * the side length is normally only known at run time these values have to be read from memory, which gets in the way of the
+	 * compiler's optimisations in tight loops. Here they are constants, so getVoxel(), setVoxel() and the Sampler compile down to
+	 * immediate shifts, masks and comparisons.
+	 *
+	 * In every other respect this is a PagedVolume. It is paged by the same Pagers, supports the same features, and can be passed
+	 * to anything which takes a PagedVolume (though calls through a PagedVolume pointer or reference use the run time versions of
+	 * the functions). Use the PagedVolume itself if the chunk side length has to be chosen at run time.
+	 */
+	template <typename VoxelType, uint16_t ChunkSideLength>
+	class FixedChunkPagedVolume : public PagedVolume<VoxelType>
+	{
+		static_assert((ChunkSideLength != 0) && ((ChunkSideLength & (ChunkSideLength - 1)) == 0), "Chunk side length must be a power of two.");
+		static_assert(ChunkSideLength <= 256, "Chunk side length cannot be more than 256.");
+
+	public:
+#ifndef SWIG
+		typedef typename PagedVolume<VoxelType>::template BasicSampler<ChunkSideLength> Sampler;
+#endif // SWIG
+
+		/// Constructor for creating a volume with the chunk side length given by the template parameter.
+		FixedChunkPagedVolume(typename PagedVolume<VoxelType>::Pager* pPager, uint32_t uTargetMemoryUsageInBytes = 256 * 1024 * 1024,
+			ChunkEvictionPolicy eEvictionPolicy = ChunkEvictionPolicies::LeastRecentlyUsed, bool bEnableConcurrentAccess = false);
+
+		/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+		VoxelType getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets a voxel at the position given by a 3D vector
+		VoxelType getVoxel(const Vector3DInt32& v3dPos) const;
+
+		/// Sets the voxel at the position given by <tt>x,y,z</tt> coordinates
+		void setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
+		/// Sets the voxel at the position given by a 3D vector
+		void setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue);
+
+	private:
+		static const uint8_t uChunkSideLengthPower = StaticLogBase2<ChunkSideLength>::value;
+		static const int32_t iChunkMask = ChunkSideLength - 1;
+	};
+}
+
+#include "FixedChunkPagedVolume.inl"
+
+#endif //__PolyVox_FixedChunkPagedVolume_H__
@@ -0,0 +1,85 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param pPager Called by PolyVox to load and unload data on demand.
+	/// \param uTargetMemoryUsageInBytes The upper limit to how much memory this volume should aim to use.
+	/// \param eEvictionPolicy How to choose which chunk is discarded when the memory limit is reached.
+	/// \param bEnableConcurrentAccess Allows the volume to be accessed from several threads at once.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint16_t ChunkSideLength>
+	FixedChunkPagedVolume<VoxelType, ChunkSideLength>::FixedChunkPagedVolume(typename PagedVolume<VoxelType>::Pager* pPager, uint32_t uTargetMemoryUsageInBytes, ChunkEvictionPolicy eEvictionPolicy, bool bEnableConcurrentAccess)
+		:PagedVolume<VoxelType>(pPager, uTargetMemoryUsageInBytes, ChunkSideLength, eEvictionPolicy, bEnableConcurrentAccess)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint16_t ChunkSideLength>
+	VoxelType FixedChunkPagedVolume<VoxelType, ChunkSideLength>::getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		return this->getVoxelInChunk(uXPos >> uChunkSideLengthPower, uYPos >> uChunkSideLengthPower, uZPos >> uChunkSideLengthPower,
+			static_cast<uint16_t>(uXPos & iChunkMask), static_cast<uint16_t>(uYPos & iChunkMask), static_cast<uint16_t>(uZPos & iChunkMask));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint16_t ChunkSideLength>
+	VoxelType FixedChunkPagedVolume<VoxelType, ChunkSideLength>::getVoxel(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos the \c x position of the voxel
+	/// \param uYPos the \c y position of the voxel
+	/// \param uZPos the \c z position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint16_t ChunkSideLength>
+	void FixedChunkPagedVolume<VoxelType, ChunkSideLength>::setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue)
+	{
+		this->setVoxelInChunk(uXPos >> uChunkSideLengthPower, uYPos >> uChunkSideLengthPower, uZPos >> uChunkSideLengthPower,
+			static_cast<uint16_t>(uXPos & iChunkMask), static_cast<uint16_t>(uYPos & iChunkMask), static_cast<uint16_t>(uZPos & iChunkMask), tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos the 3D position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint16_t ChunkSideLength>
+	void FixedChunkPagedVolume<VoxelType, ChunkSideLength>::setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue)
+	{
+		setVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
+	}
+}
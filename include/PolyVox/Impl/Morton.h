@@ -25,6 +25,8 @@
 #ifndef __PolyVox_Morton_H__
 #define __PolyVox_Morton_H__
 
+#include <cstdint>
+
 namespace PolyVox
 {
 	// Based on: http://www.forceflow.be/2013/10/07/morton-encodingdecoding-through-bit-interleaving-implementations/
@@ -0,0 +1,245 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_SlabPool_H__
+#define __PolyVox_SlabPool_H__
+
+#include "Assertions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace PolyVox
+{
+	/// A pool of fixed-size, cache-line-aligned memory blocks. The PagedVolume uses one of these for the voxel data of its chunks, so that
+	/// chunks being paged in and out do not continually allocate and free large buffers on the heap.
+	///
+	/// Blocks are carved out of slabs which are allocated as they are needed, up to the capacity given to the constructor. Freed blocks are
+	/// kept for reuse rather than being given back to the heap. If the pool is at capacity and has no free blocks then it falls back to
+	/// allocating a block on the heap, which is freed again as soon as it is deallocated. All functions are thread safe.
+	class SlabPool
+	{
+	public:
+		/// The alignment of every block handed out by the pool.
+		static const uint32_t uBlockAlignment = 64;
+
+		struct Statistics
+		{
+			uint64_t uNoOfHits; ///< Allocations which reused a block freed earlier.
+			uint64_t uNoOfMisses; ///< Allocations which needed fresh memory, either from a new slab or from the heap.
+			uint64_t uNoOfOverflows; ///< Misses which had to go to the heap because the pool was at capacity.
+			uint32_t uNoOfBlocksInUse; ///< Blocks currently allocated, including those from the heap.
+			uint32_t uNoOfBlocksReserved; ///< Blocks which have been carved out of slabs.
+		};
+
+		SlabPool(uint32_t uBlockSizeInBytes, uint32_t uCapacityInBlocks)
+			:m_uBlockSizeInBytes(roundUpToAlignment(uBlockSizeInBytes))
+			, m_uCapacityInBlocks(uCapacityInBlocks)
+			, m_uBlocksPerSlab(blocksPerSlab(m_uBlockSizeInBytes, uCapacityInBlocks))
+			, m_pFreeList(nullptr)
+			, m_pScratchMemory(new uint8_t[m_uBlockSizeInBytes + uBlockAlignment])
+			, m_pScratchBuffer(alignPointer(m_pScratchMemory.get()))
+			, m_bScratchBufferInUse(false)
+		{
+			POLYVOX_ASSERT(uBlockSizeInBytes > 0, "Block size must be greater than zero.");
+			m_statistics = Statistics();
+		}
+
+		~SlabPool()
+		{
+			POLYVOX_ASSERT(m_statistics.uNoOfBlocksInUse == 0, "Destroying a SlabPool while some of its blocks are still in use.");
+			for (auto iter = m_setOverflowBlocks.begin(); iter != m_setOverflowBlocks.end(); iter++)
+			{
+				freeAligned(*iter);
+			}
+		}
+
+		/// \return The size of each block, which is the requested size rounded up to a whole number of cache lines.
+		uint32_t getBlockSizeInBytes(void) const
+		{
+			return m_uBlockSizeInBytes;
+		}
+
+		void* allocate(void)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_statistics.uNoOfBlocksInUse++;
+
+			if (m_pFreeList)
+			{
+				m_statistics.uNoOfHits++;
+				FreeBlock* pBlock = m_pFreeList;
+				m_pFreeList = pBlock->pNext;
+				return pBlock;
+			}
+
+			m_statistics.uNoOfMisses++;
+
+			// Add another slab if we are still within our capacity.
+			if (m_statistics.uNoOfBlocksReserved < m_uCapacityInBlocks)
+			{
+				const uint32_t uNoOfBlocks = (std::min)(m_uBlocksPerSlab, m_uCapacityInBlocks - m_statistics.uNoOfBlocksReserved);
+				m_vecSlabs.emplace_back(new uint8_t[uNoOfBlocks * m_uBlockSizeInBytes + uBlockAlignment]);
+				uint8_t* pFirstBlock = alignPointer(m_vecSlabs.back().get());
+				m_statistics.uNoOfBlocksReserved += uNoOfBlocks;
+
+				// Keep the first block and put the rest on the free list, in order so that they are handed out in address order.
+				for (uint32_t uBlock = uNoOfBlocks - 1; uBlock > 0; uBlock--)
+				{
+					FreeBlock* pBlock = reinterpret_cast<FreeBlock*>(pFirstBlock + uBlock * m_uBlockSizeInBytes);
+					pBlock->pNext = m_pFreeList;
+					m_pFreeList = pBlock;
+				}
+				return pFirstBlock;
+			}
+
+			// Otherwise we have no choice but to go to the heap.
+			m_statistics.uNoOfOverflows++;
+			uint8_t* pBlock = allocateAligned(m_uBlockSizeInBytes);
+			m_setOverflowBlocks.insert(pBlock);
+			return pBlock;
+		}
+
+		void deallocate(void* pBlock)
+		{
+			if (!pBlock)
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			POLYVOX_ASSERT(m_statistics.uNoOfBlocksInUse > 0, "Deallocating more blocks than were allocated.");
+			m_statistics.uNoOfBlocksInUse--;
+
+			if (!m_setOverflowBlocks.empty())
+			{
+				auto iter = m_setOverflowBlocks.find(static_cast<uint8_t*>(pBlock));
+				if (iter != m_setOverflowBlocks.end())
+				{
+					m_setOverflowBlocks.erase(iter);
+					freeAligned(static_cast<uint8_t*>(pBlock));
+					return;
+				}
+			}
+
+			// Freed blocks go on the front of the list, so the next allocation gets the one most likely to still be in the cache.
+			FreeBlock* pFreeBlock = static_cast<FreeBlock*>(pBlock);
+			pFreeBlock->pNext = m_pFreeList;
+			m_pFreeList = pFreeBlock;
+		}
+
+		/// Provides a block for short-lived temporary use, such as reordering the voxels of a chunk. A single scratch buffer is kept
+		/// separately from the pool so that it is always available, but if it is already in use then a normal block is used instead.
+		void* acquireScratchBuffer(void)
+		{
+			if (m_bScratchBufferInUse.exchange(true))
+			{
+				return allocate();
+			}
+			return m_pScratchBuffer;
+		}
+
+		void releaseScratchBuffer(void* pBuffer)
+		{
+			if (pBuffer == m_pScratchBuffer)
+			{
+				m_bScratchBufferInUse = false;
+				return;
+			}
+
+			deallocate(pBuffer);
+		}
+
+		Statistics getStatistics(void) const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_statistics;
+		}
+
+	private:
+		// Free blocks form a singly linked list threaded through the blocks themselves.
+		struct FreeBlock
+		{
+			FreeBlock* pNext;
+		};
+
+		static uint32_t roundUpToAlignment(uint32_t uSizeInBytes)
+		{
+			return ((uSizeInBytes + uBlockAlignment - 1) / uBlockAlignment) * uBlockAlignment;
+		}
+
+		// Slabs of around 2Mb are big enough to avoid allocating too often, but small enough that a volume which never
+		// reaches its memory limit does not reserve much more than it needs.
+		static uint32_t blocksPerSlab(uint32_t uBlockSizeInBytes, uint32_t uCapacityInBlocks)
+		{
+			const uint32_t uTargetSlabSizeInBytes = 2 * 1024 * 1024;
+			const uint32_t uBlocksPerSlab = (std::max)(uTargetSlabSizeInBytes / uBlockSizeInBytes, static_cast<uint32_t>(1));
+			return (std::min)(uBlocksPerSlab, (std::max)(uCapacityInBlocks, static_cast<uint32_t>(1)));
+		}
+
+		static uint8_t* alignPointer(uint8_t* pMemory)
+		{
+			const uintptr_t uAddress = reinterpret_cast<uintptr_t>(pMemory);
+			return pMemory + ((uBlockAlignment - (uAddress % uBlockAlignment)) % uBlockAlignment);
+		}
+
+		// Heap blocks store the unaligned pointer just before the aligned block, so that it can be freed later.
+		static uint8_t* allocateAligned(uint32_t uSizeInBytes)
+		{
+			uint8_t* pMemory = new uint8_t[uSizeInBytes + uBlockAlignment + sizeof(uint8_t*)];
+			uint8_t* pBlock = alignPointer(pMemory + sizeof(uint8_t*));
+			std::memcpy(pBlock - sizeof(uint8_t*), &pMemory, sizeof(uint8_t*));
+			return pBlock;
+		}
+
+		static void freeAligned(uint8_t* pBlock)
+		{
+			uint8_t* pMemory;
+			std::memcpy(&pMemory, pBlock - sizeof(uint8_t*), sizeof(uint8_t*));
+			delete[] pMemory;
+		}
+
+		const uint32_t m_uBlockSizeInBytes;
+		const uint32_t m_uCapacityInBlocks;
+		const uint32_t m_uBlocksPerSlab;
+
+		mutable std::mutex m_mutex;
+		std::vector< std::unique_ptr<uint8_t[]> > m_vecSlabs;
+		std::unordered_set<uint8_t*> m_setOverflowBlocks;
+		FreeBlock* m_pFreeList;
+		Statistics m_statistics;
+
+		std::unique_ptr<uint8_t[]> m_pScratchMemory;
+		uint8_t* const m_pScratchBuffer;
+		std::atomic<bool> m_bScratchBufferInUse;
+	};
+}
+
+#endif //__PolyVox_SlabPool_H__
@@ -0,0 +1,126 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_ThreadRegistry_H__
+#define __PolyVox_ThreadRegistry_H__
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace PolyVox
+{
+	/// Gives each thread a small id the first time it asks for one, and takes it back when the thread exits. The lowest free id is
+	/// always handed out, so the ids stay below the largest number of threads which have been alive at once, however many threads
+	/// come and go over time. Ids start from one so that zero can be used to mean 'no thread'.
+	///
+	/// Objects which hold something on behalf of a thread (such as the per-thread chunk caches of a PagedVolume) can register a
+	/// Listener, which is called on the exiting thread just before its id is made available again.
+	class ThreadRegistry
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual ~Listener() {}
+
+			/// Called on a thread which is exiting. Other threads may be using the object at the same time.
+			virtual void onThreadExit(uint32_t uThreadId) = 0;
+		};
+
+		static uint32_t getCurrentThreadId(void)
+		{
+			thread_local ThreadId t_threadId;
+			return t_threadId.m_uId;
+		}
+
+		/// The listener must be removed again before it is destroyed.
+		static void addListener(Listener* pListener)
+		{
+			State& state = getState();
+			std::lock_guard<std::mutex> lock(state.m_mutex);
+			state.m_setListeners.insert(pListener);
+		}
+
+		/// Once this returns the listener will not be called again, and is not being called by any exiting thread.
+		static void removeListener(Listener* pListener)
+		{
+			State& state = getState();
+			std::lock_guard<std::mutex> lock(state.m_mutex);
+			state.m_setListeners.erase(pListener);
+		}
+
+	private:
+		struct State
+		{
+			std::mutex m_mutex;
+			std::vector<bool> m_vecIdsInUse; // Indexed by id minus one.
+			std::unordered_set<Listener*> m_setListeners;
+		};
+
+		// The thread_local instance of this claims an id when the thread first asks for it, and gives it back when the thread exits.
+		struct ThreadId
+		{
+			ThreadId()
+			{
+				State& state = getState();
+				std::lock_guard<std::mutex> lock(state.m_mutex);
+				uint32_t uIndex = 0;
+				while ((uIndex < state.m_vecIdsInUse.size()) && state.m_vecIdsInUse[uIndex])
+				{
+					uIndex++;
+				}
+				if (uIndex == state.m_vecIdsInUse.size())
+				{
+					state.m_vecIdsInUse.push_back(false);
+				}
+				state.m_vecIdsInUse[uIndex] = true;
+				m_uId = uIndex + 1;
+			}
+
+			~ThreadId()
+			{
+				State& state = getState();
+				std::lock_guard<std::mutex> lock(state.m_mutex);
+				for (auto iter = state.m_setListeners.begin(); iter != state.m_setListeners.end(); iter++)
+				{
+					(*iter)->onThreadExit(m_uId);
+				}
+				state.m_vecIdsInUse[m_uId - 1] = false;
+			}
+
+			uint32_t m_uId;
+		};
+
+		// Thread local objects are destroyed before static ones, so this outlives every ThreadId.
+		static State& getState(void)
+		{
+			static State s_state;
+			return s_state;
+		}
+	};
+}
+
+#endif //__PolyVox_ThreadRegistry_H__
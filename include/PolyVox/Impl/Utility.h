@@ -29,6 +29,10 @@
 
 #include <cstdint>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace PolyVox
 {
 	inline bool isPowerOf2(uint32_t uInput)
@@ -61,6 +65,20 @@ namespace PolyVox
 		return static_cast<uint8_t>(uResult - 1);
 	}
 
+	// Compile time equivalent of logBase2(), for inputs which are template parameters.
+	template <uint32_t uInput>
+	struct StaticLogBase2
+	{
+		static_assert((uInput != 0) && ((uInput & (uInput - 1)) == 0), "Input must be a power of two in order to compute the log.");
+		static const uint8_t value = 1 + StaticLogBase2<uInput / 2>::value;
+	};
+
+	template <>
+	struct StaticLogBase2<1>
+	{
+		static const uint8_t value = 0;
+	};
+
 	// http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
 	inline uint32_t upperPowerOfTwo(uint32_t v)
 	{
@@ -79,11 +97,36 @@ namespace PolyVox
 		return (r >= 0.0) ? static_cast<int32_t>(r) : static_cast<int32_t>(r - 1.0f);
 	}
 
+	inline int32_t divideRoundingDown(int32_t iNumerator, int32_t iDenominator)
+	{
+		return (iNumerator >= 0) ? iNumerator / iDenominator : -((-iNumerator - 1) / iDenominator) - 1;
+	}
+
 	inline int32_t roundToNearestInteger(float r)
 	{
 		return (r >= 0.0) ? static_cast<int32_t>(r + 0.5f) : static_cast<int32_t>(r - 0.5f);
 	}
 
+	// Gets the index of the lowest set bit. The input must not be zero.
+	inline uint32_t countTrailingZeros(uint64_t uInput)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long uIndex;
+		_BitScanForward64(&uIndex, uInput);
+		return static_cast<uint32_t>(uIndex);
+#elif defined(__GNUC__) || defined(__clang__)
+		return static_cast<uint32_t>(__builtin_ctzll(uInput));
+#else
+		uint32_t uResult = 0;
+		while ((uInput & 1) == 0)
+		{
+			uInput >>= 1;
+			uResult++;
+		}
+		return uResult;
+#endif
+	}
+
 	template <typename Type>
 	inline Type clamp(const Type& value, const Type& low, const Type& high)
 	{
@@ -0,0 +1,75 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_LZCompressor_H__
+#define __PolyVox_LZCompressor_H__
+
+#include "Compressor.h"
+
+namespace PolyVox
+{
+	/**
+	 * Performs compression of data using a simple and fast form of Lempel-Ziv (LZ77) compression.
+	 *
+	 * Unlike the RLECompressor, which can only make use of runs of identical values, this compressor replaces any sequence of
+	 * bytes which has already occurred (within the previous 64Kb) with a reference to the earlier copy. This means it also works
+	 * for voxel types which are bigger than a byte but only vary in some of their bytes, and for repeating patterns such as those
+	 * produced by layered terrain. A long run of identical values is stored as a reference which overlaps itself, so it is still
+	 * compressed about as well as by the RLECompressor.
+	 *
+	 * The data is stored as a sequence of literal bytes and back-references in a similar way to LZ4, and no entropy coding is
+	 * performed. This puts it firmly at the fast end of the speed/ratio trade-off, and it has no external dependencies. Unlike
+	 * the RLECompressor it works directly on bytes, so it is not a template.
+	 *
+	 * \sa Compressor
+	 */
+	class LZCompressor : public Compressor
+	{
+	public:
+		/// Constructor
+		LZCompressor();
+		/// Destructor
+		~LZCompressor();
+
+		// API documentation is in base class and gets inherited by Doxygen.
+		uint32_t getMaxCompressedSize(uint32_t uUncompressedInputSize);
+		uint32_t compress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength);
+		uint32_t decompress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength);
+
+	private:
+		static const uint32_t uMinMatchLength = 4;
+		static const uint32_t uMaxOffset = 65535;
+		static const uint32_t uHashTableSizePower = 12;
+
+		static uint32_t read32(const uint8_t* pData);
+		static uint32_t hash(uint32_t uValue);
+		// Writes the part of a length which did not fit in its four bits of the token.
+		static uint8_t* writeLengthExtension(uint32_t uLength, uint8_t* pDst, const uint8_t* pDstEnd);
+		static uint8_t* writeSequence(const uint8_t* pLiterals, uint32_t uNoOfLiterals, uint32_t uOffset, uint32_t uMatchLength, uint8_t* pDst, const uint8_t* pDstEnd);
+	};
+}
+
+#include "LZCompressor.inl"
+
+#endif //__PolyVox_LZCompressor_H__
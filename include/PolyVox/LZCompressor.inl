@@ -0,0 +1,223 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#include "Impl/ErrorHandling.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace PolyVox
+{
+	inline LZCompressor::LZCompressor()
+	{
+	}
+
+	inline LZCompressor::~LZCompressor()
+	{
+	}
+
+	inline uint32_t LZCompressor::getMaxCompressedSize(uint32_t uUncompressedInputSize)
+	{
+		// In the worst case there are no matches, and the data is stored as literals with a token
+		// and a length which grows by one byte for every 255 literals.
+		return uUncompressedInputSize + (uUncompressedInputSize / 255) + 16;
+	}
+
+	inline uint32_t LZCompressor::compress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength)
+	{
+		const uint8_t* pSrc = static_cast<const uint8_t*>(pSrcData);
+		const uint8_t* pSrcEnd = pSrc + uSrcLength;
+		uint8_t* pDst = static_cast<uint8_t*>(pDstData);
+		const uint8_t* pDstEnd = pDst + uDstLength;
+
+		// Positions of recent four byte sequences, indexed by their hash. Zero means empty,
+		// so the positions are stored plus one.
+		uint32_t auHashTable[1 << uHashTableSizePower];
+		std::memset(auHashTable, 0, sizeof(auHashTable));
+
+		const uint8_t* pLiterals = pSrc;
+		const uint8_t* pCurrent = pSrc;
+		while (pCurrent + uMinMatchLength <= pSrcEnd)
+		{
+			const uint32_t uValue = read32(pCurrent);
+			const uint32_t uHash = hash(uValue);
+			const uint32_t uCandidate = auHashTable[uHash];
+			auHashTable[uHash] = static_cast<uint32_t>(pCurrent - pSrc) + 1;
+
+			const uint8_t* pMatch = pSrc + uCandidate - 1;
+			if ((uCandidate == 0) || (pCurrent - pMatch > static_cast<ptrdiff_t>(uMaxOffset)) || (read32(pMatch) != uValue))
+			{
+				// Skip ahead faster the longer we go without a match, so that incompressible data does not take too long.
+				pCurrent += 1 + ((pCurrent - pLiterals) >> 6);
+				continue;
+			}
+
+			// Extend the match as far as possible. It may overlap the data it is matching, which is how runs are compressed.
+			const uint8_t* pMatchEnd = pCurrent + uMinMatchLength;
+			while ((pMatchEnd < pSrcEnd) && (*pMatchEnd == pMatch[pMatchEnd - pCurrent]))
+			{
+				pMatchEnd++;
+			}
+
+			pDst = writeSequence(pLiterals, static_cast<uint32_t>(pCurrent - pLiterals), static_cast<uint32_t>(pCurrent - pMatch), static_cast<uint32_t>(pMatchEnd - pCurrent), pDst, pDstEnd);
+			pCurrent = pMatchEnd;
+			pLiterals = pCurrent;
+		}
+
+		// Whatever is left is stored as literals, without a match.
+		pDst = writeSequence(pLiterals, static_cast<uint32_t>(pSrcEnd - pLiterals), 0, 0, pDst, pDstEnd);
+
+		return static_cast<uint32_t>(pDst - static_cast<uint8_t*>(pDstData));
+	}
+
+	inline uint32_t LZCompressor::decompress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength)
+	{
+		const uint8_t* pSrc = static_cast<const uint8_t*>(pSrcData);
+		const uint8_t* pSrcEnd = pSrc + uSrcLength;
+		uint8_t* pDstStart = static_cast<uint8_t*>(pDstData);
+		uint8_t* pDst = pDstStart;
+		uint8_t* pDstEnd = pDst + uDstLength;
+
+		while (pSrc < pSrcEnd)
+		{
+			const uint8_t uToken = *pSrc++;
+
+			// Literals
+			uint32_t uNoOfLiterals = uToken >> 4;
+			if (uNoOfLiterals == 15)
+			{
+				uint8_t uExtension;
+				do
+				{
+					POLYVOX_THROW_IF(pSrc >= pSrcEnd, std::runtime_error, "Compressed data is corrupt.");
+					uExtension = *pSrc++;
+					uNoOfLiterals += uExtension;
+				} while (uExtension == 255);
+			}
+			POLYVOX_THROW_IF(uNoOfLiterals > static_cast<uint32_t>(pSrcEnd - pSrc), std::runtime_error, "Compressed data is corrupt.");
+			POLYVOX_THROW_IF(uNoOfLiterals > static_cast<uint32_t>(pDstEnd - pDst), std::length_error, "Insufficient space in destination buffer.");
+			std::memcpy(pDst, pSrc, uNoOfLiterals);
+			pSrc += uNoOfLiterals;
+			pDst += uNoOfLiterals;
+
+			// The last sequence has no match.
+			if (pSrc == pSrcEnd)
+			{
+				break;
+			}
+
+			// Match
+			POLYVOX_THROW_IF(pSrcEnd - pSrc < 2, std::runtime_error, "Compressed data is corrupt.");
+			const uint32_t uOffset = pSrc[0] | (pSrc[1] << 8);
+			pSrc += 2;
+			POLYVOX_THROW_IF((uOffset == 0) || (uOffset > static_cast<uint32_t>(pDst - pDstStart)), std::runtime_error, "Compressed data is corrupt.");
+
+			uint32_t uMatchLength = (uToken & 0x0F);
+			if (uMatchLength == 15)
+			{
+				uint8_t uExtension;
+				do
+				{
+					POLYVOX_THROW_IF(pSrc >= pSrcEnd, std::runtime_error, "Compressed data is corrupt.");
+					uExtension = *pSrc++;
+					uMatchLength += uExtension;
+				} while (uExtension == 255);
+			}
+			uMatchLength += uMinMatchLength;
+			POLYVOX_THROW_IF(uMatchLength > static_cast<uint32_t>(pDstEnd - pDst), std::length_error, "Insufficient space in destination buffer.");
+
+			// The match can overlap the output, so it has to be copied a byte at a time.
+			const uint8_t* pMatch = pDst - uOffset;
+			for (uint32_t uByte = 0; uByte < uMatchLength; uByte++)
+			{
+				pDst[uByte] = pMatch[uByte];
+			}
+			pDst += uMatchLength;
+		}
+
+		return static_cast<uint32_t>(pDst - pDstStart);
+	}
+
+	inline uint32_t LZCompressor::read32(const uint8_t* pData)
+	{
+		uint32_t uValue;
+		std::memcpy(&uValue, pData, sizeof(uValue));
+		return uValue;
+	}
+
+	inline uint32_t LZCompressor::hash(uint32_t uValue)
+	{
+		// Knuth's multiplicative hash, keeping the top bits as they depend on all of the input.
+		return (uValue * 2654435761u) >> (32 - uHashTableSizePower);
+	}
+
+	inline uint8_t* LZCompressor::writeLengthExtension(uint32_t uLength, uint8_t* pDst, const uint8_t* pDstEnd)
+	{
+		for (uLength -= 15; ; uLength -= 255)
+		{
+			POLYVOX_THROW_IF(pDst >= pDstEnd, std::length_error, "Insufficient space in destination buffer.");
+			if (uLength < 255)
+			{
+				*pDst++ = static_cast<uint8_t>(uLength);
+				return pDst;
+			}
+			*pDst++ = 255;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Writes a token, the literals, and the match (if the match length is not zero).
+	////////////////////////////////////////////////////////////////////////////////
+	inline uint8_t* LZCompressor::writeSequence(const uint8_t* pLiterals, uint32_t uNoOfLiterals, uint32_t uOffset, uint32_t uMatchLength, uint8_t* pDst, const uint8_t* pDstEnd)
+	{
+		const uint32_t uStoredMatchLength = (uMatchLength > 0) ? uMatchLength - uMinMatchLength : 0;
+
+		POLYVOX_THROW_IF(pDst >= pDstEnd, std::length_error, "Insufficient space in destination buffer.");
+		uint8_t* pToken = pDst++;
+		*pToken = static_cast<uint8_t>(((uNoOfLiterals < 15) ? uNoOfLiterals : 15) << 4);
+		if (uNoOfLiterals >= 15)
+		{
+			pDst = writeLengthExtension(uNoOfLiterals, pDst, pDstEnd);
+		}
+
+		POLYVOX_THROW_IF(uNoOfLiterals > static_cast<uint32_t>(pDstEnd - pDst), std::length_error, "Insufficient space in destination buffer.");
+		std::memcpy(pDst, pLiterals, uNoOfLiterals);
+		pDst += uNoOfLiterals;
+
+		if (uMatchLength > 0)
+		{
+			POLYVOX_THROW_IF(pDstEnd - pDst < 2, std::length_error, "Insufficient space in destination buffer.");
+			*pDst++ = static_cast<uint8_t>(uOffset & 0xFF);
+			*pDst++ = static_cast<uint8_t>(uOffset >> 8);
+
+			*pToken |= static_cast<uint8_t>((uStoredMatchLength < 15) ? uStoredMatchLength : 15);
+			if (uStoredMatchLength >= 15)
+			{
+				pDst = writeLengthExtension(uStoredMatchLength, pDst, pDstEnd);
+			}
+		}
+
+		return pDst;
+	}
+}
@@ -25,9 +25,10 @@
 #ifndef __PolyVox_LowPassFilter_H__
 #define __PolyVox_LowPassFilter_H__
 
-#include "Impl/IteratorController.h"
-
 #include "Region.h"
+#include "RegionView.h"
+
+#include <vector>
 
 namespace PolyVox
 {
@@ -54,6 +55,10 @@ namespace PolyVox
 
 		//Kernel size
 		uint32_t m_uKernelSize;
+
+		//Scratch space, kept between calls to avoid reallocating it.
+		RegionView<typename SrcVolumeType::VoxelType> m_viewSrc;
+		std::vector<typename DstVolumeType::VoxelType> m_vecDstVoxels;
 	};
 
 }//namespace PolyVox
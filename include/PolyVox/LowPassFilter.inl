@@ -22,6 +22,8 @@
 * SOFTWARE.
 *******************************************************************************/
 
+#include <vector>
+
 namespace PolyVox
 {
 	/**
@@ -50,207 +52,163 @@ namespace PolyVox
 		{
 			POLYVOX_THROW(std::invalid_argument, "Kernel size must be odd");
 		}
+
+		//Each source voxel is filtered into the destination voxel at the same offset
+		if (m_regSrc.getDimensionsInVoxels() != m_regDst.getDimensionsInVoxels())
+		{
+			POLYVOX_THROW(std::invalid_argument, "Source and destination regions must have the same dimensions");
+		}
 	}
 
 	template< typename SrcVolumeType, typename DstVolumeType, typename AccumulationType>
 	void LowPassFilter<SrcVolumeType, DstVolumeType, AccumulationType>::execute()
 	{
-		int32_t iSrcMinX = m_regSrc.getLowerX();
-		int32_t iSrcMinY = m_regSrc.getLowerY();
-		int32_t iSrcMinZ = m_regSrc.getLowerZ();
+		typedef typename SrcVolumeType::VoxelType SrcVoxelType;
+		typedef typename DstVolumeType::VoxelType DstVoxelType;
 
-		int32_t iSrcMaxX = m_regSrc.getUpperX();
-		int32_t iSrcMaxY = m_regSrc.getUpperY();
-		int32_t iSrcMaxZ = m_regSrc.getUpperZ();
+		// Stage the source region (plus a one voxel border for the neighbours) in one go, rather than
+		// making 27 lookups in the volume for every voxel.
+		m_viewSrc.stage(m_pVolSrc, m_regSrc, 1);
 
-		int32_t iDstMinX = m_regDst.getLowerX();
-		int32_t iDstMinY = m_regDst.getLowerY();
-		int32_t iDstMinZ = m_regDst.getLowerZ();
+		const int32_t iSrcWidth = m_viewSrc.getYStride();
+		const int32_t iSrcSliceSize = m_viewSrc.getZStride();
+		const SrcVoxelType* pSrcVoxels = m_viewSrc.getData();
 
-		//int32_t iDstMaxX = m_regDst.getUpperX();
-		//int32_t iDstMaxY = m_regDst.getUpperY();
-		//int32_t iDstMaxZ = m_regDst.getUpperZ();
+		const int32_t iWidth = m_regSrc.getWidthInVoxels();
+		const int32_t iHeight = m_regSrc.getHeightInVoxels();
+		const int32_t iDepth = m_regSrc.getDepthInVoxels();
 
-		typename SrcVolumeType::Sampler srcSampler(m_pVolSrc);
+		m_vecDstVoxels.resize(iWidth * iHeight * iDepth);
 
-		for (int32_t iSrcZ = iSrcMinZ, iDstZ = iDstMinZ; iSrcZ <= iSrcMaxZ; iSrcZ++, iDstZ++)
+		for (int32_t z = 0; z < iDepth; z++)
 		{
-			for (int32_t iSrcY = iSrcMinY, iDstY = iDstMinY; iSrcY <= iSrcMaxY; iSrcY++, iDstY++)
+			for (int32_t y = 0; y < iHeight; y++)
 			{
-				for (int32_t iSrcX = iSrcMinX, iDstX = iDstMinX; iSrcX <= iSrcMaxX; iSrcX++, iDstX++)
+				for (int32_t x = 0; x < iWidth; x++)
 				{
 					AccumulationType tSrcVoxel(0);
-					srcSampler.setPosition(iSrcX, iSrcY, iSrcZ);
-
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx1ny1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx1ny0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx1ny1pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx0py1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx0py0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx0py1pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx1py1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx1py0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1nx1py1pz());
 
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px1ny1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px1ny0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px1ny1pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px0py1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px0py0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px0py1pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px1py1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px1py0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel0px1py1pz());
-
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px1ny1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px1ny0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px1ny1pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px0py1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px0py0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px0py1pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px1py1nz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px1py0pz());
-					tSrcVoxel += static_cast<AccumulationType>(srcSampler.peekVoxel1px1py1pz());
+					// The staged region is offset by one, so (x,y,z) is the lower corner of this voxel's neighbourhood.
+					for (int32_t iOffsetZ = 0; iOffsetZ < 3; iOffsetZ++)
+					{
+						for (int32_t iOffsetY = 0; iOffsetY < 3; iOffsetY++)
+						{
+							const SrcVoxelType* pSrcRow = pSrcVoxels + x + (y + iOffsetY) * iSrcWidth + (z + iOffsetZ) * iSrcSliceSize;
+							tSrcVoxel += static_cast<AccumulationType>(pSrcRow[0]);
+							tSrcVoxel += static_cast<AccumulationType>(pSrcRow[1]);
+							tSrcVoxel += static_cast<AccumulationType>(pSrcRow[2]);
+						}
+					}
 
 					tSrcVoxel /= 27;
 
-					//tSrcVoxel.setDensity(uDensity);
-					m_pVolDst->setVoxel(iSrcX, iSrcY, iSrcZ, static_cast<typename DstVolumeType::VoxelType>(tSrcVoxel));
+					m_vecDstVoxels[x + y * iWidth + z * iWidth * iHeight] = static_cast<DstVoxelType>(tSrcVoxel);
 				}
 			}
 		}
+
+		writeVolumeRegion(m_pVolDst, m_regDst, m_vecDstVoxels.data());
 	}
 
 	template< typename SrcVolumeType, typename DstVolumeType, typename AccumulationType>
 	void LowPassFilter<SrcVolumeType, DstVolumeType, AccumulationType>::executeSAT()
 	{
-		const uint32_t border = (m_uKernelSize - 1) / 2;
+		typedef typename SrcVolumeType::VoxelType SrcVoxelType;
+		typedef typename DstVolumeType::VoxelType DstVoxelType;
+
+		const int32_t border = (m_uKernelSize - 1) / 2;
+
+		m_viewSrc.stage(m_pVolSrc, m_regSrc, static_cast<uint16_t>(border));
+		const SrcVoxelType* pSrcVoxels = m_viewSrc.getData();
 
-		Vector3DInt32 satLowerCorner = m_regSrc.getLowerCorner() - Vector3DInt32(border, border, border);
-		Vector3DInt32 satUpperCorner = m_regSrc.getUpperCorner() + Vector3DInt32(border, border, border);
+		const int32_t iSrcWidth = m_viewSrc.getStagedRegion().getWidthInVoxels();
+		const int32_t iSrcHeight = m_viewSrc.getStagedRegion().getHeightInVoxels();
+		const int32_t iSrcDepth = m_viewSrc.getStagedRegion().getDepthInVoxels();
 
-		//Use floats for the SAT volume to ensure it works with negative
-		//densities and with both integral and floating point input volumes.
-		RawVolume<AccumulationType> satVolume(Region(satLowerCorner, satUpperCorner));
+		// The summed area table has an extra plane of zeros before the first voxel in each direction, so that the
+		// sums for voxels next to the edge of the expanded region do not need special handling. Using the
+		// AccumulationType ensures it works with negative densities and with both integral and floating point input.
+		const int32_t iSatWidth = iSrcWidth + 1;
+		const int32_t iSatSliceSize = iSatWidth * (iSrcHeight + 1);
+		std::vector<AccumulationType> vecSat(iSatSliceSize * (iSrcDepth + 1), AccumulationType(0));
 
-		//Clear to zeros (necessary?)
-		//FIXME - use Volume::fill() method. Implemented in base class as below
-		//but with optimised implementations in subclasses?
-		for (int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
+		//Build SAT in three passes
+		for (int32_t z = 1; z <= iSrcDepth; z++)
 		{
-			for (int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
+			for (int32_t y = 1; y <= iSrcHeight; y++)
 			{
-				for (int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
+				const SrcVoxelType* pSrcRow = pSrcVoxels + (y - 1) * iSrcWidth + (z - 1) * iSrcWidth * iSrcHeight;
+				AccumulationType* pSatRow = &vecSat[y * iSatWidth + z * iSatSliceSize];
+				for (int32_t x = 1; x <= iSrcWidth; x++)
 				{
-					satVolume.setVoxel(x, y, z, 0);
+					pSatRow[x] = pSatRow[x - 1] + static_cast<AccumulationType>(pSrcRow[x - 1]);
 				}
 			}
 		}
 
-		typename RawVolume<AccumulationType>::Sampler satVolumeIter(&satVolume);
-
-		IteratorController<typename RawVolume<AccumulationType>::Sampler> satIterCont;
-		satIterCont.m_regValid = Region(satLowerCorner, satUpperCorner);
-		satIterCont.m_Iter = &satVolumeIter;
-		satIterCont.reset();
-
-		typename SrcVolumeType::Sampler srcVolumeIter(m_pVolSrc);
-
-		IteratorController<typename SrcVolumeType::Sampler> srcIterCont;
-		srcIterCont.m_regValid = Region(satLowerCorner, satUpperCorner);
-		srcIterCont.m_Iter = &srcVolumeIter;
-		srcIterCont.reset();
-
-		do
+		for (int32_t z = 1; z <= iSrcDepth; z++)
 		{
-			AccumulationType previousSum = static_cast<AccumulationType>(satVolumeIter.peekVoxel1nx0py0pz());
-			AccumulationType currentVal = static_cast<AccumulationType>(srcVolumeIter.getVoxel());
-
-			satVolumeIter.setVoxel(previousSum + currentVal);
-
-			srcIterCont.moveForward();
-
-		} while (satIterCont.moveForward());
-
-		//Build SAT in three passes
-		/*for(int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
-		{
-		for(int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
-		{
-		for(int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
-		{
-		AccumulationType previousSum = static_cast<AccumulationType>(satVolume.getVoxel(x-1,y,z));
-		AccumulationType currentVal = static_cast<AccumulationType>(m_pVolSrc->getVoxel(x,y,z));
-
-		satVolume.setVoxel(x,y,z,previousSum + currentVal);
-		}
-		}
-		}*/
-
-		for (int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
-		{
-			for (int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
+			for (int32_t y = 1; y <= iSrcHeight; y++)
 			{
-				for (int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
+				for (int32_t x = 1; x <= iSrcWidth; x++)
 				{
-					AccumulationType previousSum = static_cast<AccumulationType>(satVolume.getVoxel(x, y - 1, z));
-					AccumulationType currentSum = static_cast<AccumulationType>(satVolume.getVoxel(x, y, z));
-
-					satVolume.setVoxel(x, y, z, previousSum + currentSum);
+					const int32_t iIndex = x + y * iSatWidth + z * iSatSliceSize;
+					vecSat[iIndex] = vecSat[iIndex - iSatWidth] + vecSat[iIndex];
 				}
 			}
 		}
 
-		for (int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
+		for (int32_t z = 1; z <= iSrcDepth; z++)
 		{
-			for (int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
+			for (int32_t y = 1; y <= iSrcHeight; y++)
 			{
-				for (int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
+				for (int32_t x = 1; x <= iSrcWidth; x++)
 				{
-					AccumulationType previousSum = static_cast<AccumulationType>(satVolume.getVoxel(x, y, z - 1));
-					AccumulationType currentSum = static_cast<AccumulationType>(satVolume.getVoxel(x, y, z));
-
-					satVolume.setVoxel(x, y, z, previousSum + currentSum);
+					const int32_t iIndex = x + y * iSatWidth + z * iSatSliceSize;
+					vecSat[iIndex] = vecSat[iIndex - iSatSliceSize] + vecSat[iIndex];
 				}
 			}
 		}
 
 		//Now compute the average
-		const Vector3DInt32& v3dDstLowerCorner = m_regDst.getLowerCorner();
-		const Vector3DInt32& v3dDstUpperCorner = m_regDst.getUpperCorner();
+		const int32_t iWidth = m_regSrc.getWidthInVoxels();
+		const int32_t iHeight = m_regSrc.getHeightInVoxels();
+		const int32_t iDepth = m_regSrc.getDepthInVoxels();
 
-		const Vector3DInt32& v3dSrcLowerCorner = m_regSrc.getLowerCorner();
+		const uint32_t sideLength = border * 2 + 1;
+		const int32_t satUpperX = sideLength;
+		const int32_t satUpperY = sideLength * iSatWidth;
+		const int32_t satUpperZ = sideLength * iSatSliceSize;
 
-		for (int32_t iDstZ = v3dDstLowerCorner.getZ(), iSrcZ = v3dSrcLowerCorner.getZ(); iDstZ <= v3dDstUpperCorner.getZ(); iDstZ++, iSrcZ++)
+		m_vecDstVoxels.resize(iWidth * iHeight * iDepth);
+
+		for (int32_t z = 0; z < iDepth; z++)
 		{
-			for (int32_t iDstY = v3dDstLowerCorner.getY(), iSrcY = v3dSrcLowerCorner.getY(); iDstY <= v3dDstUpperCorner.getY(); iDstY++, iSrcY++)
+			for (int32_t y = 0; y < iHeight; y++)
 			{
-				for (int32_t iDstX = v3dDstLowerCorner.getX(), iSrcX = v3dSrcLowerCorner.getX(); iDstX <= v3dDstUpperCorner.getX(); iDstX++, iSrcX++)
+				for (int32_t x = 0; x < iWidth; x++)
 				{
-					int32_t satLowerX = iSrcX - border - 1;
-					int32_t satLowerY = iSrcY - border - 1;
-					int32_t satLowerZ = iSrcZ - border - 1;
-
-					int32_t satUpperX = iSrcX + border;
-					int32_t satUpperY = iSrcY + border;
-					int32_t satUpperZ = iSrcZ + border;
-
-					AccumulationType a = satVolume.getVoxel(satLowerX, satLowerY, satLowerZ);
-					AccumulationType b = satVolume.getVoxel(satUpperX, satLowerY, satLowerZ);
-					AccumulationType c = satVolume.getVoxel(satLowerX, satUpperY, satLowerZ);
-					AccumulationType d = satVolume.getVoxel(satUpperX, satUpperY, satLowerZ);
-					AccumulationType e = satVolume.getVoxel(satLowerX, satLowerY, satUpperZ);
-					AccumulationType f = satVolume.getVoxel(satUpperX, satLowerY, satUpperZ);
-					AccumulationType g = satVolume.getVoxel(satLowerX, satUpperY, satUpperZ);
-					AccumulationType h = satVolume.getVoxel(satUpperX, satUpperY, satUpperZ);
+					// Thanks to the extra plane of zeros, the table entry just before this voxel's kernel
+					// is at (x,y,z) and the one at the end of it is a whole kernel further on.
+					const int32_t satLower = x + y * iSatWidth + z * iSatSliceSize;
+
+					AccumulationType a = vecSat[satLower];
+					AccumulationType b = vecSat[satLower + satUpperX];
+					AccumulationType c = vecSat[satLower + satUpperY];
+					AccumulationType d = vecSat[satLower + satUpperX + satUpperY];
+					AccumulationType e = vecSat[satLower + satUpperZ];
+					AccumulationType f = vecSat[satLower + satUpperX + satUpperZ];
+					AccumulationType g = vecSat[satLower + satUpperY + satUpperZ];
+					AccumulationType h = vecSat[satLower + satUpperX + satUpperY + satUpperZ];
 
 					AccumulationType sum = h + c - d - g - f - a + b + e;
-					uint32_t sideLength = border * 2 + 1;
 					AccumulationType average = sum / (sideLength*sideLength*sideLength);
 
-					m_pVolDst->setVoxel(iDstX, iDstY, iDstZ, static_cast<typename DstVolumeType::VoxelType>(average));
+					m_vecDstVoxels[x + y * iWidth + z * iWidth * iHeight] = static_cast<DstVoxelType>(average);
 				}
 			}
 		}
+
+		writeVolumeRegion(m_pVolDst, m_regDst, m_vecDstVoxels.data());
 	}
 }
@@ -0,0 +1,444 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_MappedFilePager_H__
+#define __PolyVox_MappedFilePager_H__
+
+#include "Impl/PlatformDefinitions.h"
+
+#include "BufferLayout.h"
+#include "PagedVolume.h"
+#include "Region.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PolyVox
+{
+	/**
+	 * An implementation of Pager which pages chunks in directly from a memory-mapped volume file, without copying them.
+	 *
+	 * The file is built in advance by writeVolumeFile(), which stores every chunk of the volume uncompressed, in the same
+	 * (Morton) order which the chunks use in memory, and aligned to a page boundary. Paging in a chunk then consists of
+	 * nothing more than pointing the chunk at its data within the mapping (see PagedVolume::Chunk::setExternalData()), and
+	 * it is the operating system which loads the data from disk as it is accessed and discards it again under memory pressure.
+	 * This makes it well suited to large, mostly read-only data sets such as terrain.
+	 *
+	 * The file is mapped copy-on-write, so writing to a voxel gives the affected memory page a private copy and the file itself
+	 * is never changed. Because the copy is made by the operating system the chunk's data does not move, so samplers and pinned
+	 * regions which point into it remain valid. When a modified chunk is paged out its data is copied into memory held by the
+	 * pager, and any later page in of that chunk is served from the copy. These modifications are lost when the pager is
+	 * destroyed, so use a different pager (or a volume of your own) if they need to be saved.
+	 *
+	 * Chunks which lie outside the file are paged in as uniform chunks of the default voxel value. The volume must use the same
+	 * chunk side length as the file. As with the FilePager the data is in native byte order, so the files are not portable
+	 * between platforms with different endianness.
+	 */
+	template <typename VoxelType>
+	class MappedFilePager : public PagedVolume<VoxelType>::Pager
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t uNoOfChunksMapped; ///< Chunks which were paged in by pointing them at the mapping.
+			uint64_t uNoOfChunksCopied; ///< Chunks which were paged in from modifications held by the pager.
+			uint64_t uNoOfChunksReleased; ///< Chunks which no longer use the mapping.
+		};
+
+		/// Constructor
+		/// \param strFilename A file previously written by writeVolumeFile().
+		MappedFilePager(const std::string& strFilename)
+			:PagedVolume<VoxelType>::Pager()
+			, m_pMapping(nullptr)
+			, m_uMappingSizeInBytes(0)
+#if defined(_WIN32)
+			, m_hFile(INVALID_HANDLE_VALUE)
+			, m_hFileMapping(NULL)
+#endif
+		{
+			m_statistics = Statistics();
+
+			mapFile(strFilename);
+
+			FileHeader header;
+			POLYVOX_THROW_IF(m_uMappingSizeInBytes < sizeof(header), std::runtime_error, "File is too small to be a PolyVox mapped volume file.");
+			std::memcpy(&header, m_pMapping, sizeof(header));
+			if ((std::memcmp(header.acMagic, "PVMM", 4) != 0) || (header.uVersion != uFileFormatVersion) || (header.uVoxelSizeInBytes != sizeof(VoxelType)))
+			{
+				unmapFile();
+				POLYVOX_THROW(std::runtime_error, "File is not a PolyVox mapped volume file for this voxel type.");
+			}
+
+			m_header = header;
+			if (getDataOffset() + getChunkSizeInBytes() * header.uWidthInChunks * header.uHeightInChunks * header.uDepthInChunks > m_uMappingSizeInBytes)
+			{
+				unmapFile();
+				POLYVOX_THROW(std::runtime_error, "Mapped volume file is truncated.");
+			}
+		}
+
+		/// Destructor
+		virtual ~MappedFilePager()
+		{
+			POLYVOX_LOG_WARNING_IF(!m_mapMappedChunkCounts.empty(), "Destroying a MappedFilePager while chunks still point into its mapping.");
+			unmapFile();
+		}
+
+		/// Writes the given region of a volume to a file which can be used by a MappedFilePager. The region is rounded out to a whole
+		/// number of chunks, and any voxels outside it are also read from the volume.
+		/// \param strFilename The file to write, which is replaced if it already exists.
+		/// \param pVolume The volume to read from.
+		/// \param region The part of the volume to write.
+		/// \param uChunkSideLength The chunk side length of the PagedVolume which will use the file.
+		template <typename VolumeType>
+		static void writeVolumeFile(const std::string& strFilename, VolumeType* pVolume, const Region& region, uint16_t uChunkSideLength = 32)
+		{
+			POLYVOX_THROW_IF(!pVolume, std::invalid_argument, "Volume must not be null.");
+			POLYVOX_THROW_IF(!region.isValid(), std::invalid_argument, "Region must be valid.");
+			POLYVOX_THROW_IF((uChunkSideLength == 0) || ((uChunkSideLength & (uChunkSideLength - 1)) != 0), std::invalid_argument, "Chunk side length must be a power of two.");
+
+			const int32_t iSideLength = uChunkSideLength;
+
+			FileHeader header;
+			std::memcpy(header.acMagic, "PVMM", 4);
+			header.uVersion = uFileFormatVersion;
+			header.uChunkSideLength = uChunkSideLength;
+			header.uVoxelSizeInBytes = sizeof(VoxelType);
+			header.iLowerChunkX = floorDivide(region.getLowerX(), iSideLength);
+			header.iLowerChunkY = floorDivide(region.getLowerY(), iSideLength);
+			header.iLowerChunkZ = floorDivide(region.getLowerZ(), iSideLength);
+			header.uWidthInChunks = floorDivide(region.getUpperX(), iSideLength) - header.iLowerChunkX + 1;
+			header.uHeightInChunks = floorDivide(region.getUpperY(), iSideLength) - header.iLowerChunkY + 1;
+			header.uDepthInChunks = floorDivide(region.getUpperZ(), iSideLength) - header.iLowerChunkZ + 1;
+
+			// FIXME - This should be replaced by C++ style IO, but currently this causes problems with
+			// the gameplay-cubiquity integration. See: https://github.com/blackberry/GamePlay/issues/919
+			FILE* pFile = fopen(strFilename.c_str(), "wb");
+			POLYVOX_THROW_IF(!pFile, std::runtime_error, "Unable to create mapped volume file.");
+
+			// The header is padded out to a whole page, so that every chunk starts on a page boundary.
+			std::vector<uint8_t> vecHeader(uDataAlignment, 0);
+			std::memcpy(vecHeader.data(), &header, sizeof(header));
+			bool bSuccess = fwrite(vecHeader.data(), 1, vecHeader.size(), pFile) == vecHeader.size();
+
+			std::vector<VoxelType> vecChunkData(iSideLength * iSideLength * iSideLength);
+			for (uint32_t uZ = 0; bSuccess && (uZ < header.uDepthInChunks); uZ++)
+			{
+				for (uint32_t uY = 0; bSuccess && (uY < header.uHeightInChunks); uY++)
+				{
+					for (uint32_t uX = 0; bSuccess && (uX < header.uWidthInChunks); uX++)
+					{
+						Vector3DInt32 v3dLower(header.iLowerChunkX + static_cast<int32_t>(uX), header.iLowerChunkY + static_cast<int32_t>(uY), header.iLowerChunkZ + static_cast<int32_t>(uZ));
+						v3dLower *= iSideLength;
+						Region regChunk(v3dLower, v3dLower + Vector3DInt32(iSideLength - 1, iSideLength - 1, iSideLength - 1));
+
+						pVolume->readRegion(regChunk, vecChunkData.data(), BufferLayout::morton());
+						bSuccess = fwrite(vecChunkData.data(), sizeof(VoxelType), vecChunkData.size(), pFile) == vecChunkData.size();
+					}
+				}
+			}
+
+			const bool bClosed = fclose(pFile) == 0;
+			POLYVOX_THROW_IF(!bSuccess || !bClosed, std::runtime_error, "Error writing to mapped volume file.");
+		}
+
+		virtual void pageIn(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
+		{
+			POLYVOX_ASSERT(pChunk, "Attempting to page in NULL chunk");
+			POLYVOX_THROW_IF(static_cast<uint32_t>(region.getWidthInVoxels()) != m_header.uChunkSideLength, std::invalid_argument,
+				"Volume chunk side length does not match that of the mapped file.");
+
+			const ChunkKey key = getChunkKey(region);
+
+			// Chunks which have been modified are served from the pager's own copy.
+			auto iterModified = m_mapModifiedChunks.find(key);
+			if (iterModified != m_mapModifiedChunks.end())
+			{
+				POLYVOX_LOG_TRACE("Paging in data for ", region, " from modified copy");
+				const std::vector<VoxelType>& vecData = iterModified->second;
+				if (vecData.size() == 1)
+				{
+					pChunk->setUniform(vecData[0]);
+				}
+				else
+				{
+					std::memcpy(pChunk->getData(), vecData.data(), pChunk->getDataSizeInBytes());
+				}
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_statistics.uNoOfChunksCopied++;
+				return;
+			}
+
+			VoxelType* pData = getMappedData(key);
+			if (!pData)
+			{
+				POLYVOX_LOG_TRACE("No data found for ", region, " during paging in.");
+				pChunk->setUniform(VoxelType());
+				return;
+			}
+
+			POLYVOX_LOG_TRACE("Mapping data for ", region);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_mapMappedChunkCounts[key]++;
+				m_statistics.uNoOfChunksMapped++;
+			}
+			pChunk->setExternalData(pData);
+		}
+
+		virtual void pageOut(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
+		{
+			POLYVOX_ASSERT(pChunk, "Attempting to page out NULL chunk");
+
+			POLYVOX_LOG_TRACE("Paging out data for ", region);
+
+			// Uniform chunks are stored as a single voxel.
+			std::vector<VoxelType>& vecData = m_mapModifiedChunks[getChunkKey(region)];
+			if (pChunk->isUniform())
+			{
+				vecData.assign(1, pChunk->getUniformValue());
+			}
+			else
+			{
+				const VoxelType* pData = pChunk->getData();
+				vecData.assign(pData, pData + pChunk->getDataSizeInBytes() / sizeof(VoxelType));
+			}
+		}
+
+		virtual void releaseExternalData(const Region& region, VoxelType* pData)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_statistics.uNoOfChunksReleased++;
+
+			// Two chunks can briefly share the same data when several threads page in the same chunk, so the memory
+			// is only handed back to the operating system once the last of them has finished with it.
+			auto iter = m_mapMappedChunkCounts.find(getChunkKey(region));
+			POLYVOX_ASSERT(iter != m_mapMappedChunkCounts.end(), "Releasing data which was never mapped.");
+			if (--(iter->second) > 0)
+			{
+				return;
+			}
+			m_mapMappedChunkCounts.erase(iter);
+
+#if !defined(_WIN32)
+			// Any pages which were written to now hold private copies. The chunk has already been paged out if it was modified,
+			// so these can be dropped, and the mapping then refers to the file again. Only whole pages inside the chunk are dropped.
+			const uintptr_t uPageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+			const uintptr_t uBegin = reinterpret_cast<uintptr_t>(pData);
+			const uintptr_t uEnd = uBegin + getChunkSizeInBytes();
+			const uintptr_t uFirstPage = ((uBegin + uPageSize - 1) / uPageSize) * uPageSize;
+			const uintptr_t uLastPage = (uEnd / uPageSize) * uPageSize;
+			if (uLastPage > uFirstPage)
+			{
+				POLYVOX_LOG_WARNING_IF(madvise(reinterpret_cast<void*>(uFirstPage), uLastPage - uFirstPage, MADV_DONTNEED) != 0, "Failed to release mapped chunk data.");
+			}
+#else
+			// Windows cannot discard the private copies without unmapping the whole view, so they are kept until the pager is destroyed.
+			(void)pData;
+#endif
+		}
+
+		/// \return The region of the volume which is stored in the file, which is a whole number of chunks.
+		Region getEnclosingRegion(void) const
+		{
+			const int32_t iSideLength = m_header.uChunkSideLength;
+			Vector3DInt32 v3dLower(m_header.iLowerChunkX, m_header.iLowerChunkY, m_header.iLowerChunkZ);
+			Vector3DInt32 v3dUpper = v3dLower + Vector3DInt32(m_header.uWidthInChunks, m_header.uHeightInChunks, m_header.uDepthInChunks);
+			return Region(v3dLower * iSideLength, v3dUpper * iSideLength - Vector3DInt32(1, 1, 1));
+		}
+
+		Statistics getStatistics(void) const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_statistics;
+		}
+
+	private:
+		typedef std::tuple<int32_t, int32_t, int32_t> ChunkKey;
+
+		struct FileHeader
+		{
+			char acMagic[4];
+			uint32_t uVersion;
+			uint32_t uChunkSideLength;
+			uint32_t uVoxelSizeInBytes;
+			int32_t iLowerChunkX;
+			int32_t iLowerChunkY;
+			int32_t iLowerChunkZ;
+			uint32_t uWidthInChunks;
+			uint32_t uHeightInChunks;
+			uint32_t uDepthInChunks;
+		};
+
+		static const uint32_t uFileFormatVersion = 1;
+
+		// Chunk data starts at this offset, which is a multiple of the page size on all common platforms.
+		static const uint32_t uDataAlignment = 65536;
+
+		static int32_t floorDivide(int32_t iValue, int32_t iDivisor)
+		{
+			return (iValue >= 0) ? (iValue / iDivisor) : -((-iValue + iDivisor - 1) / iDivisor);
+		}
+
+		ChunkKey getChunkKey(const Region& region) const
+		{
+			const int32_t iSideLength = region.getWidthInVoxels();
+			return ChunkKey(floorDivide(region.getLowerX(), iSideLength), floorDivide(region.getLowerY(), iSideLength), floorDivide(region.getLowerZ(), iSideLength));
+		}
+
+		uint64_t getChunkSizeInBytes(void) const
+		{
+			const uint64_t uSideLength = m_header.uChunkSideLength;
+			return uSideLength * uSideLength * uSideLength * sizeof(VoxelType);
+		}
+
+		uint64_t getDataOffset(void) const
+		{
+			return uDataAlignment;
+		}
+
+		// Chunks are stored with x varying fastest. Returns null if the chunk is not in the file.
+		VoxelType* getMappedData(const ChunkKey& key) const
+		{
+			const int64_t iX = static_cast<int64_t>(std::get<0>(key)) - m_header.iLowerChunkX;
+			const int64_t iY = static_cast<int64_t>(std::get<1>(key)) - m_header.iLowerChunkY;
+			const int64_t iZ = static_cast<int64_t>(std::get<2>(key)) - m_header.iLowerChunkZ;
+			if ((iX < 0) || (iY < 0) || (iZ < 0) || (iX >= m_header.uWidthInChunks) || (iY >= m_header.uHeightInChunks) || (iZ >= m_header.uDepthInChunks))
+			{
+				return nullptr;
+			}
+
+			const uint64_t uIndex = static_cast<uint64_t>(iX) + static_cast<uint64_t>(iY) * m_header.uWidthInChunks + static_cast<uint64_t>(iZ) * m_header.uWidthInChunks * m_header.uHeightInChunks;
+			return reinterpret_cast<VoxelType*>(m_pMapping + getDataOffset() + uIndex * getChunkSizeInBytes());
+		}
+
+		void mapFile(const std::string& strFilename)
+		{
+#if defined(_WIN32)
+			m_hFile = CreateFileA(strFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			POLYVOX_THROW_IF(m_hFile == INVALID_HANDLE_VALUE, std::runtime_error, "Unable to open mapped volume file.");
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(m_hFile, &fileSize) || (fileSize.QuadPart == 0))
+			{
+				unmapFile();
+				POLYVOX_THROW(std::runtime_error, "Unable to map volume file.");
+			}
+			m_uMappingSizeInBytes = static_cast<uint64_t>(fileSize.QuadPart);
+
+			// Copy-on-write access means writes go to private pages rather than to the file.
+			m_hFileMapping = CreateFileMappingA(m_hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+			m_pMapping = m_hFileMapping ? static_cast<uint8_t*>(MapViewOfFile(m_hFileMapping, FILE_MAP_COPY, 0, 0, 0)) : nullptr;
+			if (!m_pMapping)
+			{
+				unmapFile();
+				POLYVOX_THROW(std::runtime_error, "Unable to map volume file.");
+			}
+#else
+			const int iFile = open(strFilename.c_str(), O_RDONLY);
+			POLYVOX_THROW_IF(iFile < 0, std::runtime_error, "Unable to open mapped volume file.");
+
+			struct stat fileStatus;
+			void* pMapping = MAP_FAILED;
+			if ((fstat(iFile, &fileStatus) == 0) && (fileStatus.st_size > 0))
+			{
+				m_uMappingSizeInBytes = static_cast<uint64_t>(fileStatus.st_size);
+
+				// A private mapping means writes go to private pages rather than to the file.
+				pMapping = mmap(nullptr, static_cast<size_t>(m_uMappingSizeInBytes), PROT_READ | PROT_WRITE, MAP_PRIVATE, iFile, 0);
+			}
+
+			// The mapping stays valid after the file is closed.
+			close(iFile);
+			POLYVOX_THROW_IF(pMapping == MAP_FAILED, std::runtime_error, "Unable to map volume file.");
+			m_pMapping = static_cast<uint8_t*>(pMapping);
+#endif
+		}
+
+		void unmapFile(void)
+		{
+#if defined(_WIN32)
+			if (m_pMapping)
+			{
+				UnmapViewOfFile(m_pMapping);
+			}
+			if (m_hFileMapping)
+			{
+				CloseHandle(m_hFileMapping);
+				m_hFileMapping = NULL;
+			}
+			if (m_hFile != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(m_hFile);
+				m_hFile = INVALID_HANDLE_VALUE;
+			}
+#else
+			if (m_pMapping)
+			{
+				munmap(m_pMapping, static_cast<size_t>(m_uMappingSizeInBytes));
+			}
+#endif
+			m_pMapping = nullptr;
+		}
+
+		uint8_t* m_pMapping;
+		uint64_t m_uMappingSizeInBytes;
+#if defined(_WIN32)
+		HANDLE m_hFile;
+		HANDLE m_hFileMapping;
+#endif
+
+		FileHeader m_header;
+
+		// Copies of the chunks which have been modified and paged out. Only accessed by pageIn() and pageOut(), which are serialised.
+		std::map< ChunkKey, std::vector<VoxelType> > m_mapModifiedChunks;
+
+		// The number of chunks currently pointing at each part of the mapping, which is also used by releaseExternalData().
+		mutable std::mutex m_mutex;
+		std::map<ChunkKey, uint32_t> m_mapMappedChunkCounts;
+		Statistics m_statistics;
+	};
+}
+
+#endif //__PolyVox_MappedFilePager_H__
@@ -31,6 +31,7 @@
 #include "Array.h"
 #include "DefaultMarchingCubesController.h"
 #include "Mesh.h"
+#include "RegionView.h"
 #include "Vertex.h"
 
 namespace PolyVox
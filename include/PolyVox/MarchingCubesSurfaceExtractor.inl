@@ -301,20 +301,25 @@ namespace PolyVox
 		Array<2, Vector3DInt32> pIndices(uRegionWidthInVoxels, uRegionHeightInVoxels);
 		Array<2, Vector3DInt32> pPreviousIndices(uRegionWidthInVoxels, uRegionHeightInVoxels);
 
+		// Every cell reads its corner voxels and their neighbours (for the gradients) many times over, so the region and a one
+		// voxel border are staged into a linear block first. The samplers below then read from this without any bounds checks.
+		RegionView<typename VolumeType::VoxelType> view;
+		view.stage(volData, region, 1);
+
 		// A sampler pointing at the beginning of the region, which gets incremented to always point at the beginning of a slice.
-		typename VolumeType::Sampler startOfSlice(volData);
+		typename RegionView<typename VolumeType::VoxelType>::Sampler startOfSlice(&view);
 		startOfSlice.setPosition(region.getLowerX(), region.getLowerY(), region.getLowerZ());
 
 		for (uint32_t uZRegSpace = 0; uZRegSpace < uRegionDepthInVoxels; uZRegSpace++)
 		{
 			// A sampler pointing at the beginning of the slice, which gets incremented to always point at the beginning of a row.
-			typename VolumeType::Sampler startOfRow = startOfSlice;
+			typename RegionView<typename VolumeType::VoxelType>::Sampler startOfRow = startOfSlice;
 
 			for (uint32_t uYRegSpace = 0; uYRegSpace < uRegionHeightInVoxels; uYRegSpace++)
 			{
 				// Copying a sampler which is already pointing at the correct location seems (slightly) faster than
 				// calling setPosition(). Therefore we make use of 'startOfRow' and 'startOfSlice' to reset the sampler.
-				typename VolumeType::Sampler sampler = startOfRow;
+				typename RegionView<typename VolumeType::VoxelType>::Sampler sampler = startOfRow;
 
 				for (uint32_t uXRegSpace = 0; uXRegSpace < uRegionWidthInVoxels; uXRegSpace++)
 				{
@@ -26,21 +26,48 @@
 #define __PolyVox_PagedVolume_H__
 
 #include "BaseVolume.h"
+#include "Compressor.h"
+#include "Impl/SlabPool.h"
+#include "Impl/ThreadRegistry.h"
+#include "Impl/Utility.h"
 #include "Region.h"
 #include "Vector.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <limits>
 #include <cstdlib> //For abort()
 #include <cstring> //For memcpy
+#include <deque>
+#include <future>
 #include <unordered_map>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <stdexcept> //For invalid_argument
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace PolyVox
 {
+	namespace ChunkEvictionPolicies
+	{
+		/**
+		 * Determines how a PagedVolume chooses which chunk to discard when it needs to make space for a new one.
+		 */
+		enum ChunkEvictionPolicy
+		{
+			LeastRecentlyUsed, ///< Discard the chunk which has gone longest without being accessed.
+			Clock ///< Approximate LRU with a 'second chance' clock hand, which makes accessing a resident chunk slightly cheaper.
+		};
+	}
+	typedef ChunkEvictionPolicies::ChunkEvictionPolicy ChunkEvictionPolicy;
+
 	/// This class provide a volume implementation which avoids storing all the data in memory at all times. Instead it breaks the volume
 	/// down into a set of chunks and moves these into and out of memory on demand. This means it is much more memory efficient than the
 	/// RawVolume, but may also be slower and is more complicated We encourage uses to work with RawVolume initially, and then switch to
@@ -53,10 +80,53 @@ namespace PolyVox
 	///
 	/// A consequence of this paging approach is that (unlike the RawVolume) the PagedVolume does not need to have a predefined size. After
 	/// the volume has been created you can begin acessing voxels anywhere in space and the required data will be created automatically.
+	///
+	/// By default the PagedVolume must only be accessed from a single thread, because even reading a voxel can cause chunks to be
+	/// paged in and out. If the volume is constructed with concurrent access enabled then it may instead be read and written from
+	/// several threads at once (for example, to extract meshes for several regions in parallel). In this mode the chunks are spread
+	/// over a number of independently locked shards, each thread keeps its own record of the chunk it last accessed, and a chunk
+	/// which a Sampler is pointing into is never evicted. Calls to the Pager are serialised so it does not have to be thread safe.
+	/// Note that individual voxel reads and writes are not atomic with respect to each other, so a thread reading a voxel which
+	/// another thread is writing may see either value (or, for complex voxel types, a mixture). Writing a new value into a uniform
+	/// chunk (see Pager) allocates its voxel data, and this counts as a write to every voxel in the chunk.
+	///
+	/// Samplers pin the chunks they are using. A Sampler may be destroyed after the volume it was created from (in which case it
+	/// simply has nothing left to release), but it must not be used once the volume has gone. The same applies to copies of it.
+	///
+	/// A Snapshot of part of the volume can be taken with snapshot(), to be read (for example, by mesh extraction on another thread)
+	/// while the volume itself continues to be edited. Taking a snapshot does not copy the voxel data. Instead it is shared between
+	/// the snapshot and the volume, and a chunk only makes its own copy if it is written to while a snapshot still needs the original.
+	///
+	/// The volume keeps track of which chunks have been written to, so that an application can find out which parts of its meshes
+	/// (or other derived data) are out of date. Call markVersion() after updating them, and later pass the result to
+	/// getModifiedRegionsSince() to get the regions which have been written to in the meantime. The record of these writes is kept
+	/// until it is discarded with discardChangesUpTo().
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
 	class PagedVolume : public BaseVolume<VoxelType>
 	{
+	private:
+		// The contents of a chunk as captured by a Snapshot. Full voxel data is shared with the chunk it was taken from until that
+		// chunk is next written to (see Chunk::detachSharedData()), and is freed when the last reference to it goes. Uniform and
+		// palette chunks are small, so they are just copied.
+		struct SharedChunkData
+		{
+			SharedChunkData();
+			~SharedChunkData();
+
+			VoxelType getVoxelAtIndex(uint32_t uIndex) const;
+
+			// Null for a uniform or palette chunk. If the pool is null then the data was allocated on the heap.
+			VoxelType* m_pData;
+			SlabPool* m_pDataPool;
+
+			VoxelType m_tUniformValue;
+
+			std::vector<VoxelType> m_vecPalette;
+			std::vector<uint8_t> m_vecPaletteIndices;
+			uint8_t m_uPaletteIndexBitsPower;
+		};
+
 	public:
 		/// The PagedVolume stores it data as a set of Chunk instances which can be loaded and unloaded as memory requirements dictate.
 		class Chunk;
@@ -71,9 +141,18 @@ namespace PolyVox
 			Chunk(Vector3DInt32 v3dPosition, uint16_t uSideLength, Pager* pPager = nullptr);
 			~Chunk();
 
-			VoxelType* getData(void) const;
+			VoxelType* getData(void);
 			uint32_t getDataSizeInBytes(void) const;
 
+			bool isUniform(void) const;
+			VoxelType getUniformValue(void) const;
+			void setUniform(VoxelType tValue);
+
+			bool hasExternalData(void) const;
+			void setExternalData(VoxelType* pData);
+
+			bool hasPalette(void) const;
+
 			VoxelType getVoxel(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos) const;
 			VoxelType getVoxel(const Vector3DUint16& v3dPos) const;
 
@@ -84,27 +163,111 @@ namespace PolyVox
 			void changeMortonOrderingToLinear(void);
 
 		private:
+			// Allows the volume to create a chunk without paging in its data, when it has another source for it.
+			// Also allows the volume to supply a pool for the voxel data, and to request palette storage.
+			Chunk(Vector3DInt32 v3dPosition, uint16_t uSideLength, Pager* pPager, SlabPool* pDataPool, bool bPageIn, bool bUsePalette = false);
+
 			/// Private copy constructor to prevent accisdental copying
 			Chunk(const Chunk& /*rhs*/) {};
 
 			/// Private assignment operator to prevent accisdental copying
 			Chunk& operator=(const Chunk& /*rhs*/) {};
 
-			// This is updated by the PagedVolume and used to discard the least recently used chunks.
-			uint32_t m_uChunkLastAccessed;
+			// All resident chunks are kept in a circular list which the PagedVolume uses to decide which chunk to discard next.
+			// With the LRU policy the list is kept in order of access, while with the clock policy the order is just the order
+			// of insertion and the 'referenced' flag gives recently accessed chunks a second chance.
+			Chunk* m_pPrevInEvictionList;
+			Chunk* m_pNextInEvictionList;
+			bool m_bReferenced;
+
+			// The number of samplers (or other users) currently relying on this chunk staying in memory. Chunks
+			// with a non-zero pin count are never evicted.
+			std::atomic<uint32_t> m_uPinCount;
 
 			// This is so we can tell whether a uncompressed chunk has to be recompressed and whether
 			// a compressed chunk has to be paged back to disk, or whether they can just be discarded.
 			bool m_bDataModified;
 
-			uint32_t calculateSizeInBytes(void);
+			// Gives the data to the pager if it has been modified since it was paged in (or last paged out).
+			void pageOutIfModified(void);
+
+			// The first version gives the memory currently used by the voxel data (which may be less than a full chunk), while the
+			// second gives the memory used by the voxel data of a full chunk.
+			uint32_t calculateSizeInBytes(void) const;
 			static uint32_t calculateSizeInBytes(uint32_t uSideLength);
 
+			// Keeps the volume's record of the memory used by resident chunks up to date after the storage has changed.
+			void updateSizeInBytes(void);
+
+			// The voxels covered by the chunk.
+			Region calculateRegion(void) const;
+
+			// Gives a uniform chunk its own voxel data, optionally filled with the uniform value.
+			void allocateData(bool bFillWithUniformValue);
+			void freeData(void);
+
+			// A temporary buffer the size of the voxel data, for reordering the voxels.
+			VoxelType* acquireScratchData(void);
+			void releaseScratchData(VoxelType* pScratchData);
+
+			// Reads a voxel given its Morton index, whichever way the chunk is stored. This is the fast path used by samplers.
+			VoxelType getVoxelAtIndex(uint32_t uIndex) const;
+
+			// Operations on palette storage. The chunk is converted to full voxel data if it ends up with more than 256 values.
+			uint8_t getPaletteIndex(uint32_t uIndex) const;
+			void setPaletteIndex(uint32_t uIndex, uint8_t uPaletteIndex);
+			void setPaletteVoxel(uint32_t uIndex, VoxelType tValue);
+			void setPaletteIndexBitsPower(uint8_t uIndexBitsPower);
+			void convertPaletteToData(void);
+			void freePalette(void);
+			// Switches a chunk with full voxel data to the uniform or palette representation if it has few enough distinct values.
+			// This must not be done while a Sampler may be pointing into the data.
+			void compactData(void);
+
+			// Gives a Snapshot the current contents of the chunk, sharing the voxel data if nothing else could be pointing into it.
+			std::shared_ptr<const SharedChunkData> shareData(void);
+			// Makes the voxel data writable again after shareData(). It is taken back if no Snapshot still holds it, or copied if one does.
+			void detachSharedData(void);
+
+			// Uniform chunks (where every voxel has the same value) have no voxel data, just the single value. The data
+			// is only allocated when it is first needed, which is usually when a different value is written to the chunk.
 			VoxelType* m_tData;
+			VoxelType m_tUniformValue;
+
+			// Palette chunks also have no voxel data. Instead they have a table of the distinct values in the chunk, and every
+			// voxel is stored as an index into the table. The indices are packed into 1, 2, 4, or 8 bits (given as a power of two)
+			// depending on the size of the table, and are in the same Morton order as the voxel data. A chunk only uses a palette
+			// if the volume asked it to, and the palette is empty for any other kind of chunk.
+			std::vector<VoxelType> m_vecPalette;
+			std::vector<uint8_t> m_vecPaletteIndices;
+			uint8_t m_uPaletteIndexBitsPower;
+			bool m_bUsePalette;
+
+			// Where the volume keeps track of the memory used by resident chunks, and this chunk's contribution to it. This is
+			// only used in palette mode, where chunks are of different sizes, and is null while the chunk is not resident.
+			uint32_t* m_pResidentSizeInBytes;
+			uint32_t m_uSizeInBytes;
+			bool m_bPagingIn;
 			uint16_t m_uSideLength;
 			uint8_t m_uSideLengthPower;
 			Pager* m_pPager;
 
+			// Where the voxel data comes from. If this is null then it is allocated on the heap.
+			SlabPool* m_pDataPool;
+
+			// Set while the voxel data is shared with one or more Snapshots, in which case it must not be written to (or freed) by the
+			// chunk. Samplers do not point into shared data, as it is replaced by a copy if it is written to while still in use.
+			std::shared_ptr<SharedChunkData> m_pSharedData;
+			// Reading the data to page it out does not need the chunk to stop sharing it.
+			bool m_bPagingOut;
+
+			// The version at which the chunk was last written to, if it has been written to since it was paged in. This saves the
+			// volume from updating its change journal on every write.
+			std::atomic<uint64_t> m_uVersion;
+
+			// Whether the voxel data belongs to the pager (see setExternalData()) rather than to the chunk.
+			bool m_bExternalData;
+
 			// Note: Do we really need to store this position here as well as in the block maps?
 			Vector3DInt32 m_v3dChunkSpacePosition;
 		};
@@ -113,10 +276,31 @@ namespace PolyVox
 		* Users can override this class and provide an instance of the derived class to the PagedVolume constructor. This derived class
 		* could then perform tasks such as compression and decompression of the data, and read/writing it to a file, database, network,
 		* or other storage as appropriate. See FilePager for a simple example of such a derived class.
+		*
+		* Many chunks (such as those containing only air) hold a single value. When paging in such a chunk the Pager should call
+		* Chunk::setUniform() rather than writing every voxel through Chunk::getData(), as the chunk then does not need to allocate
+		* any voxel data at all. Similarly, the Pager can check Chunk::isUniform() when paging out to store the chunk more compactly.
+		* If the volume uses palette storage then a chunk may also be paged out with Chunk::hasPalette() set, in which case calling
+		* Chunk::getData() expands it back to full voxel data.
+		*
+		* A Pager which already has the voxels of a chunk in memory in the right format (such as in a memory-mapped file) can avoid
+		* copying them by passing them to Chunk::setExternalData(). They are handed back through releaseExternalData() once the chunk
+		* has finished with them. See MappedFilePager for an example.
+		*
+		* When the volume has several chunks to page in or out at once (such as in prefetch() or flushAll()) it passes them to
+		* pageInBatch() or pageOutBatch(). By default these just call pageIn() or pageOut() for each chunk, but a Pager backed by
+		* a database or pack file can override them to share the cost of seeking, transactions or decompression setup.
 		*/
 		class Pager
 		{
 		public:
+			/// A chunk and the region of the volume it covers.
+			struct BatchEntry
+			{
+				Region region;
+				Chunk* pChunk;
+			};
+
 			/// Constructor
 			Pager() {};
 			/// Destructor
@@ -124,6 +308,223 @@ namespace PolyVox
 
 			virtual void pageIn(const Region& region, Chunk* pChunk) = 0;
 			virtual void pageOut(const Region& region, Chunk* pChunk) = 0;
+
+			/// Pages in several chunks. The entries are sorted into Morton order of their chunk positions, so that chunks which are
+			/// close together in the volume (and so probably in storage) are next to each other in the batch.
+			virtual void pageInBatch(const std::vector<BatchEntry>& vecEntries)
+			{
+				for (auto iter = vecEntries.begin(); iter != vecEntries.end(); iter++)
+				{
+					pageIn(iter->region, iter->pChunk);
+				}
+			}
+
+			/// Pages out several chunks. The entries are sorted in the same way as for pageInBatch().
+			virtual void pageOutBatch(const std::vector<BatchEntry>& vecEntries)
+			{
+				for (auto iter = vecEntries.begin(); iter != vecEntries.end(); iter++)
+				{
+					pageOut(iter->region, iter->pChunk);
+				}
+			}
+
+			/// Called when a chunk which was given data through Chunk::setExternalData() no longer needs it. If the chunk was
+			/// modified then pageOut() will already have been called. Unlike pageIn() and pageOut() this is not serialised with
+			/// other calls to the Pager, so an implementation must be thread safe.
+			virtual void releaseExternalData(const Region& /*region*/, VoxelType* /*pData*/) {};
+		};
+
+		/**
+		* Returned by PagedVolume::prefetchAsync() to track the progress of a background prefetch. The request is complete once every
+		* chunk in the region has either been paged in or skipped because the request was cancelled. If the Pager throws an exception
+		* while servicing the request then the remaining chunks are still processed, and the first exception is passed on by the future.
+		*/
+		class PrefetchRequest
+		{
+			friend class PagedVolume;
+
+		public:
+			/// Stops any chunks which have not been paged in yet from being paged in.
+			void cancel(void);
+			/// Whether cancel() has been called.
+			bool isCancelled(void) const;
+			/// Whether all chunks have been processed.
+			bool isComplete(void) const;
+			/// Blocks until all chunks have been processed.
+			void wait(void) const;
+			/// A future which becomes ready once all chunks have been processed.
+			std::shared_future<void> getFuture(void) const;
+
+		private:
+			PrefetchRequest(uint32_t uNoOfChunks);
+
+			// Called by the worker threads as each chunk is paged in (or skipped).
+			void chunkDone(std::exception_ptr pException = nullptr);
+
+			std::atomic<bool> m_bCancelled;
+			std::atomic<uint32_t> m_uNoOfChunksRemaining;
+			std::mutex m_mutex;
+			std::exception_ptr m_pException;
+			std::promise<void> m_promise;
+			std::shared_future<void> m_future;
+		};
+
+		/**
+		* Returned by PagedVolume::pinRegion(). While this object exists none of the chunks overlapping the region can be evicted, so any
+		* Sampler or pointer into them remains valid. Pinned chunks still count towards the memory limit, and if every chunk is pinned then
+		* the volume has no choice but to exceed it (see PagedVolume::getNoOfChunkLimitOverruns()). Note that flushAll() still pages out
+		* the data of pinned chunks, and that a PinnedRegion must not outlive the volume which created it.
+		*/
+		class PinnedRegion
+		{
+			friend class PagedVolume;
+
+		public:
+			/// Creates an empty object which does not pin anything.
+			PinnedRegion();
+			PinnedRegion(PinnedRegion&& rhs);
+			~PinnedRegion();
+
+			PinnedRegion& operator=(PinnedRegion&& rhs);
+
+			/// The region which was passed to PagedVolume::pinRegion().
+			const Region& getRegion(void) const;
+			/// The number of chunks which are being kept in memory.
+			uint32_t getNoOfChunks(void) const;
+			/// Unpins the chunks early. The object is then empty.
+			void release(void);
+
+		private:
+			PinnedRegion(const PagedVolume<VoxelType>* pVolume, const Region& region);
+
+			PinnedRegion(const PinnedRegion&) = delete;
+			PinnedRegion& operator=(const PinnedRegion&) = delete;
+
+			const PagedVolume<VoxelType>* m_pVolume;
+			Region m_region;
+			std::vector<Chunk*> m_vecChunks;
+		};
+
+		/**
+		* Returned by PagedVolume::snapshot(). This is a read-only copy of the chunks overlapping a region, as they were when the
+		* snapshot was taken. Copying it is cheap, and it can be read with its Sampler (and so passed to the surface extractors and
+		* other algorithms) from any thread, while the volume is being modified. Voxels outside of the chunks which were captured
+		* read as the default voxel value.
+		*
+		* The voxel data is shared with the volume rather than copied, and a chunk only copies its data if it is written to while a
+		* snapshot is still holding it. The memory is freed when the last snapshot holding it is destroyed, and this must happen
+		* before the volume which created the snapshot is destroyed.
+		*/
+		class Snapshot : public BaseVolume<VoxelType>
+		{
+			friend class PagedVolume;
+
+		public:
+#ifndef SWIG
+#if defined(_MSC_VER)
+			class Sampler : public BaseVolume<VoxelType>::Sampler< Snapshot > //This line works on VS2010
+#else
+			class Sampler : public BaseVolume<VoxelType>::template Sampler< Snapshot > //This line works on GCC
+#endif
+			{
+			public:
+				Sampler(Snapshot* volume);
+
+				inline VoxelType getVoxel(void) const;
+
+				void setPosition(const Vector3DInt32& v3dNewPos);
+				void setPosition(int32_t xPos, int32_t yPos, int32_t zPos);
+
+				void movePositiveX(void);
+				void movePositiveY(void);
+				void movePositiveZ(void);
+
+				void moveNegativeX(void);
+				void moveNegativeY(void);
+				void moveNegativeZ(void);
+
+				inline VoxelType peekVoxel1nx1ny1nz(void) const;
+				inline VoxelType peekVoxel1nx1ny0pz(void) const;
+				inline VoxelType peekVoxel1nx1ny1pz(void) const;
+				inline VoxelType peekVoxel1nx0py1nz(void) const;
+				inline VoxelType peekVoxel1nx0py0pz(void) const;
+				inline VoxelType peekVoxel1nx0py1pz(void) const;
+				inline VoxelType peekVoxel1nx1py1nz(void) const;
+				inline VoxelType peekVoxel1nx1py0pz(void) const;
+				inline VoxelType peekVoxel1nx1py1pz(void) const;
+
+				inline VoxelType peekVoxel0px1ny1nz(void) const;
+				inline VoxelType peekVoxel0px1ny0pz(void) const;
+				inline VoxelType peekVoxel0px1ny1pz(void) const;
+				inline VoxelType peekVoxel0px0py1nz(void) const;
+				inline VoxelType peekVoxel0px0py0pz(void) const;
+				inline VoxelType peekVoxel0px0py1pz(void) const;
+				inline VoxelType peekVoxel0px1py1nz(void) const;
+				inline VoxelType peekVoxel0px1py0pz(void) const;
+				inline VoxelType peekVoxel0px1py1pz(void) const;
+
+				inline VoxelType peekVoxel1px1ny1nz(void) const;
+				inline VoxelType peekVoxel1px1ny0pz(void) const;
+				inline VoxelType peekVoxel1px1ny1pz(void) const;
+				inline VoxelType peekVoxel1px0py1nz(void) const;
+				inline VoxelType peekVoxel1px0py0pz(void) const;
+				inline VoxelType peekVoxel1px0py1pz(void) const;
+				inline VoxelType peekVoxel1px1py1nz(void) const;
+				inline VoxelType peekVoxel1px1py0pz(void) const;
+				inline VoxelType peekVoxel1px1py1pz(void) const;
+
+			private:
+				// Reads a voxel relative to the current position, from the current chunk if it is inside it or from the snapshot if not.
+				VoxelType peekVoxel(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const;
+
+				// The chunk containing the current position, or null if it is outside the snapshot. The snapshot keeps it alive.
+				const SharedChunkData* m_pCurrentChunk;
+
+				uint16_t m_uXPosInChunk;
+				uint16_t m_uYPosInChunk;
+				uint16_t m_uZPosInChunk;
+
+				uint16_t m_uChunkSideLengthMinusOne;
+			};
+#endif // SWIG
+
+			/// Creates an empty snapshot, in which every voxel has the default value.
+			Snapshot();
+			Snapshot(const Snapshot& rhs);
+			~Snapshot();
+
+			Snapshot& operator=(const Snapshot& rhs);
+
+			/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+			VoxelType getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+			/// Gets a voxel at the position given by a 3D vector
+			VoxelType getVoxel(const Vector3DInt32& v3dPos) const;
+
+			/// The region which was passed to PagedVolume::snapshot().
+			const Region& getRegion(void) const;
+			/// Snapshots of a volume are numbered in the order they were taken, starting from one. An empty snapshot has version zero.
+			uint64_t getVersion(void) const;
+			/// The number of chunks captured by the snapshot.
+			uint32_t getNoOfChunks(void) const;
+
+		private:
+			Snapshot(const Region& region, const Region& regChunks, uint16_t uChunkSideLength, uint64_t uVersion);
+
+			// Finds the chunk containing a voxel, or returns null if it is outside the snapshot.
+			const SharedChunkData* getChunk(int32_t iXPos, int32_t iYPos, int32_t iZPos) const;
+
+			Region m_region;
+			// The chunks overlapping the region, in chunk space.
+			Region m_regChunks;
+
+			// In the same order as a linear buffer covering m_regChunks.
+			std::vector< std::shared_ptr<const SharedChunkData> > m_vecChunks;
+
+			uint16_t m_uChunkSideLength;
+			uint8_t m_uChunkSideLengthPower;
+			int32_t m_iChunkMask;
+
+			uint64_t m_uVersion;
 		};
 
 		//There seems to be some descrepency between Visual Studio and GCC about how the following class should be declared.
@@ -133,16 +534,25 @@ namespace PolyVox
 		//in the future
 		//typedef Volume<VoxelType> VolumeOfVoxelType; //Workaround for GCC/VS2010 differences.
 		//class Sampler : public VolumeOfVoxelType::template Sampler< PagedVolume<VoxelType> >
+		//
+		//The chunk side length can optionally be given as a template parameter, in which case it must match that of the volume. The
+		//shifts and boundary checks then use constants which the compiler can fold into the code, rather than values read from the
+		//sampler and the volume. A value of zero (as used by the Sampler typedef) means the side length is only known at run time.
+		//See FixedChunkPagedVolume, whose Sampler makes use of this.
 #ifndef SWIG
+		template <uint16_t ChunkSideLength>
 #if defined(_MSC_VER)
-		class Sampler : public BaseVolume<VoxelType>::Sampler< PagedVolume<VoxelType> > //This line works on VS2010
+		class BasicSampler : public BaseVolume<VoxelType>::Sampler< PagedVolume<VoxelType> > //This line works on VS2010
 #else
-		class Sampler : public BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> > //This line works on GCC
+		class BasicSampler : public BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> > //This line works on GCC
 #endif
 		{
 		public:
-			Sampler(PagedVolume<VoxelType>* volume);
-			~Sampler();
+			BasicSampler(PagedVolume<VoxelType>* volume);
+			BasicSampler(const BasicSampler& rhs);
+			~BasicSampler();
+
+			BasicSampler& operator=(const BasicSampler& rhs);
 
 			inline VoxelType getVoxel(void) const;
 
@@ -189,7 +599,34 @@ namespace PolyVox
 			inline VoxelType peekVoxel1px1py1pz(void) const;
 
 		private:
-			//Other current position information
+			// Reads a voxel of the current chunk relative to the current position, for when the chunk was uniform on entering it.
+			VoxelType peekChunk(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const;
+
+			// Reads a voxel relative to the current position which lies in one of the neighbouring chunks.
+			VoxelType peekNeighbourChunk(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const;
+
+			// Makes the given chunk the current one, passing on the pins of any neighbouring chunks which are still neighbours.
+			void moveToChunk(int32_t iXChunk, int32_t iYChunk, int32_t iZChunk);
+
+			// Releases all of the neighbouring chunks.
+			void releaseNeighbourChunks(void);
+
+			// Releases the pins on the current and neighbouring chunks, unless the volume (and so the chunks) no longer exists.
+			void releaseAllChunks(void);
+
+			// Shared with the volume, which clears it when it is destroyed.
+			std::shared_ptr< std::atomic<bool> > m_pVolumeExists;
+
+			// The chunk containing the current position. The sampler holds a pin on it so that it cannot be evicted.
+			Chunk* m_pCurrentChunk;
+
+			// The 26 chunks surrounding the current one, indexed by (x + 1) + (y + 1) * 3 + (z + 1) * 9 where x, y and z are the
+			// offsets (-1, 0 or 1) of the neighbour. Peeks which cross a chunk face would otherwise have to go through the volume,
+			// which means a hash lookup and disturbing its last accessed chunk. The entries are filled in (and pinned) the first
+			// time a peek needs them, and are passed along as we move from chunk to chunk. The middle entry is never used.
+			mutable std::array<Chunk*, 27> m_arrayNeighbourChunks;
+
+			//Other current position information. This is null if the current chunk was uniform when we entered it.
 			VoxelType* mCurrentVoxel;
 
 			uint16_t m_uXPosInChunk;
@@ -200,13 +637,26 @@ namespace PolyVox
 			// We could provide one manually, but it's currently unused so there is no real test for if it works. I'm putting
 			// together a new release at the moment so I'd rathern not make 'risky' changes.
 			uint16_t m_uChunkSideLengthMinusOne;
+
+			// These are constants when the chunk side length is a template parameter, and are otherwise read at run time.
+			uint16_t getChunkSideLengthMinusOne(void) const
+			{
+				return (ChunkSideLength != 0) ? static_cast<uint16_t>(ChunkSideLength - 1) : m_uChunkSideLengthMinusOne;
+			}
+			uint8_t getChunkSideLengthPower(void) const
+			{
+				return (ChunkSideLength != 0) ? StaticLogBase2<(ChunkSideLength != 0) ? ChunkSideLength : 1>::value : this->mVolume->m_uChunkSideLengthPower;
+			}
 		};
 
+		typedef BasicSampler<0> Sampler;
+
 #endif // SWIG
 
 	public:
 		/// Constructor for creating a fixed size volume.
-		PagedVolume(Pager* pPager, uint32_t uTargetMemoryUsageInBytes = 256 * 1024 * 1024, uint16_t uChunkSideLength = 32);
+		PagedVolume(Pager* pPager, uint32_t uTargetMemoryUsageInBytes = 256 * 1024 * 1024, uint16_t uChunkSideLength = 32,
+			ChunkEvictionPolicy eEvictionPolicy = ChunkEvictionPolicies::LeastRecentlyUsed, bool bEnableConcurrentAccess = false);
 		/// Destructor
 		~PagedVolume();
 
@@ -220,13 +670,46 @@ namespace PolyVox
 		/// Sets the voxel at the position given by a 3D vector
 		void setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue);
 
+		/// Copies all the voxels in a region into a buffer, one chunk at a time
+		void readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout = BufferLayout()) const;
+		/// Copies all the voxels in a region from a buffer, one chunk at a time
+		void writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout = BufferLayout());
+
 		/// Tries to ensure that the voxels within the specified Region are loaded into memory.
 		void prefetch(Region regPrefetch);
+		/// Starts loading the voxels within the specified Region into memory on background threads.
+		std::shared_ptr<PrefetchRequest> prefetchAsync(Region regPrefetch, int32_t iPriority = 0);
+		/// Prevents the chunks overlapping the specified Region from being evicted until the returned object is destroyed.
+		PinnedRegion pinRegion(const Region& regPin);
+		/// Captures the chunks overlapping the specified Region, so that they can be read while the volume continues to be modified.
+		Snapshot snapshot(const Region& regSnapshot);
 		/// Removes all voxels from memory
 		void flushAll();
 
+		/// Controls whether modified chunks are paged out on a background thread.
+		void setWriteBehindEnabled(bool bEnabled);
+		/// Allows evicted chunks to be kept in memory in compressed form.
+		void setCompressedTier(Compressor* pCompressor, uint32_t uTargetMemoryUsageInBytes = 64 * 1024 * 1024);
+		/// Controls whether chunks with few distinct values store them as a palette, so that more chunks fit in memory.
+		void setPaletteStorageEnabled(bool bEnabled);
+
 		/// Calculates approximatly how many bytes of memory the volume is currently using.
 		uint32_t calculateSizeInBytes(void);
+		/// Calculates how many bytes of memory are being used by compressed chunks.
+		uint32_t calculateCompressedSizeInBytes(void);
+		/// Gets statistics on how often chunk data could be reused rather than allocated.
+		SlabPool::Statistics getChunkDataPoolStatistics(void) const;
+		/// Gets the number of chunks which are currently pinned by samplers, PinnedRegions, or other threads.
+		uint32_t getNoOfPinnedChunks(void) const;
+		/// Gets the number of times a chunk has been added while the volume was full and every chunk was pinned.
+		uint64_t getNoOfChunkLimitOverruns(void) const;
+
+		/// Ends the current version, so that later writes are given a new one, and returns it for use with getModifiedRegionsSince().
+		uint64_t markVersion(void);
+		/// Gets the regions which have been written to since the given version, optionally in units of the given size.
+		std::vector<Region> getModifiedRegionsSince(uint64_t uVersion, uint32_t uRegionSideLength = 0, bool bIncludeNeighbours = false) const;
+		/// Forgets the chunks which have not been written to since the given version.
+		void discardChangesUpTo(uint64_t uVersion);
 
 	protected:
 		/// Copy constructor
@@ -235,32 +718,310 @@ namespace PolyVox
 		/// Assignment operator
 		PagedVolume& operator=(const PagedVolume& rhs);
 
+		/// Gets a voxel given the position of its chunk and its position within that chunk
+		VoxelType getVoxelInChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, uint16_t uXOffset, uint16_t uYOffset, uint16_t uZOffset) const;
+		/// Sets a voxel given the position of its chunk and its position within that chunk
+		void setVoxelInChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, uint16_t uXOffset, uint16_t uYOffset, uint16_t uZOffset, VoxelType tValue);
+
 	private:
+		// The chunk hash table is split into a number of shards, each of which holds the chunks whose positions hash to it and
+		// is responsible for evicting them. A volume normally has just one shard, but in concurrent mode it has several (each
+		// with its own lock) so that threads working on different chunks rarely contend with each other.
+		//
+		// Within a shard, chunks are stored in an array which is used as a hash-table. Conventional wisdom is that such a
+		// hash-table should not be more than half full to avoid conflicts, so the array is sized to twice the number of chunks
+		// the shard is allowed to hold. Collisions are resolved by linear probing, and chunks are removed by shifting later
+		// members of the probe sequence backwards (rather than by leaving 'tombstones'). This means an empty slot always
+		// terminates a search, so looking up a chunk which is not resident costs about the same as looking up one which is.
+		struct ChunkShard
+		{
+			ChunkShard()
+				:m_uChunkArrayMask(0)
+				, m_uChunkCount(0)
+				, m_uChunkCountLimit(0)
+				, m_uSizeInBytes(0)
+				, m_uSizeLimitInBytes(0)
+				, m_pEvictionListHead(nullptr)
+			{
+			}
+
+			std::mutex m_mutex;
+
+			std::unique_ptr< std::unique_ptr< Chunk >[] > m_arrayChunks;
+			uint32_t m_uChunkArrayMask;
+
+			// The number of chunks currently held in the chunk array. Tracking this means we never have to scan the array to count them.
+			uint32_t m_uChunkCount;
+			uint32_t m_uChunkCountLimit;
+
+			// In palette mode chunks vary in size, so the memory used by the chunks in the shard is tracked as well as their number.
+			uint32_t m_uSizeInBytes;
+			uint32_t m_uSizeLimitInBytes;
+
+			// For the LRU policy this is the most recently used chunk (so its predecessor is the least recently used one),
+			// while for the clock policy it is the clock hand (so its predecessor is the chunk which will be examined last).
+			Chunk* m_pEvictionListHead;
+		};
+
+		// In concurrent mode each thread gets its own equivalent of the 'last accessed chunk' cache. The chunk in a slot is
+		// pinned, so the owning thread can access it without taking any locks. A thread claims the slot matching its id (see
+		// ThreadRegistry) the first time it accesses the volume, and gives it up again when it exits. Threads which cannot claim
+		// a slot (because more threads than there are slots are using the volume at once) just take the locking path instead.
+		struct ThreadCacheSlot
+		{
+			ThreadCacheSlot()
+				:m_uOwnerThreadId(0)
+				, m_iChunkX(0)
+				, m_iChunkY(0)
+				, m_iChunkZ(0)
+				, m_pChunk(nullptr)
+			{
+			}
+
+			std::atomic<uint32_t> m_uOwnerThreadId;
+			int32_t m_iChunkX;
+			int32_t m_iChunkY;
+			int32_t m_iChunkZ;
+			Chunk* m_pChunk;
+		};
+
+		// Sets the chunk limits from the target memory usage, and creates empty shards to match.
+		void createShards(void);
+		// Whether chunks must be evicted from the shard before the given number of new chunks can be added.
+		bool isShardFull(const ChunkShard& shard, uint32_t uNoOfNewChunks) const;
+
 		bool canReuseLastAccessedChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const;
 		Chunk* getChunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
 
+		// Finds or creates a chunk and pins it, in a way which is safe in concurrent mode. Every call must be matched by releaseChunk().
+		Chunk* acquireChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const;
+		// Adds another pin to a chunk which is already pinned, or (with the relevant shard locked) to one which is not.
+		void pinChunk(Chunk* pChunk) const;
+		void releaseChunk(Chunk* pChunk) const;
+
+		// Records that a chunk is being written to, for getModifiedRegionsSince(). This is cheap unless it is the first write to the
+		// chunk since markVersion() was last called.
+		void recordWrite(Chunk* pChunk) const;
+		void recordWriteInJournal(Chunk* pChunk, uint64_t uVersion) const;
+
+		// Copy the part of a region which lies in a single (pinned) chunk to or from a buffer laid out for the whole region.
+		bool isWholeChunkBlock(const Region& regPart, const Region& regBuffer, const BufferLayout& layout) const;
+		void readChunkPart(Chunk* pChunk, const Region& regPart, const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const;
+		void writeChunkPart(Chunk* pChunk, const Region& regPart, const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout);
+
+		// Gets the chunk for a voxel access in concurrent mode, via the calling thread's cache slot if it has one. If the returned
+		// chunk had to be pinned specially for this access then bMustRelease is set, and the caller must release it afterwards.
+		Chunk* getChunkForCurrentThread(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, bool& bMustRelease) const;
+		// Called by the ThreadRegistry on a thread which is exiting, to release its cache slot.
+		void releaseThreadCacheSlot(uint32_t uThreadId);
+
+		struct ThreadExitListener : public ThreadRegistry::Listener
+		{
+			ThreadExitListener(PagedVolume<VoxelType>* pVolume)
+				:m_pVolume(pVolume)
+			{
+			}
+
+			virtual void onThreadExit(uint32_t uThreadId)
+			{
+				m_pVolume->releaseThreadCacheSlot(uThreadId);
+			}
+
+			PagedVolume<VoxelType>* m_pVolume;
+		};
+
+		// Removes all chunks from the volume. Unless bIncludePinned is set, pinned chunks are kept but have their data paged out.
+		void removeAllChunks(bool bIncludePinned);
+
+		// A single chunk waiting to be paged in by the prefetch threads. Higher priorities are serviced
+		// first, and within a priority the chunks are serviced in the order they were requested.
+		struct PrefetchWorkItem
+		{
+			bool operator<(const PrefetchWorkItem& rhs) const
+			{
+				return (iPriority < rhs.iPriority) || ((iPriority == rhs.iPriority) && (uSequenceNumber > rhs.uSequenceNumber));
+			}
+
+			int32_t iPriority;
+			uint64_t uSequenceNumber;
+			std::shared_ptr<PrefetchRequest> pRequest;
+			int32_t iChunkX;
+			int32_t iChunkY;
+			int32_t iChunkZ;
+		};
+
+		void startPrefetchThreads(void);
+		void stopPrefetchThreads(void);
+		void runPrefetchThread(void);
+		// Pages in the chunk (if it is not already resident) without holding the shard lock while the Pager runs.
+		void prefetchChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ);
+		// As above, but for several chunks at once. Those which have to come from the Pager are paged in as a single batch.
+		void prefetchChunks(const Vector3DInt32* pChunkPositions, uint32_t uNoOfChunks);
+		// Publishes a chunk which was created by prefetchChunks(), unless a copy has appeared in the meantime.
+		void insertPrefetchedChunk(std::unique_ptr< Chunk >& pChunk, uint32_t uNoOfModifiedChunksPagedOut);
+
+		// Locks the mutex only if the volume is in concurrent mode, otherwise returns a lock which does not own anything.
+		std::unique_lock<std::mutex> lockIfConcurrent(std::mutex& mutex) const;
+		// Locks the pager mutex if the pager can be called from more than one thread (in concurrent mode or with write-behind enabled).
+		std::unique_lock<std::mutex> lockPager(void) const;
+
+		// Creates a chunk, either by taking it back from the page-out queue or by paging it in. Must not be called with the pager
+		// lock held. If requested, the count of modified chunks paged out is recorded at the point the data was obtained.
+		Chunk* createChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, uint32_t* pNoOfModifiedChunksPagedOut = nullptr) const;
+		// The parts of createChunk() which look for the chunk in memory. The first is called without the pager lock, and the second
+		// with it. The first clears pNoOfModifiedChunksPagedOut if the count has already been recorded.
+		Chunk* takeEvictedChunk(const Vector3DInt32& v3dChunkPos, uint32_t*& pNoOfModifiedChunksPagedOut) const;
+		Chunk* takeQueuedPageOutWithPagerLock(const Vector3DInt32& v3dChunkPos, uint32_t* pNoOfModifiedChunksPagedOut) const;
+
+		// Batched paging. Chunks are sorted into Morton order of their positions before being passed to the pager.
+		static const uint32_t uMaxNoOfChunksPerBatch = 64;
+		static bool isBeforeInMortonOrder(const Vector3DInt32& v3dLhs, const Vector3DInt32& v3dRhs);
+		// Passes modified chunks to Pager::pageOutBatch(), after which they are no longer modified. Must be called with the pager lock held.
+		void pageOutBatch(std::vector<Chunk*>& vecChunks) const;
+		// The batched equivalent of pageOutChunk(). The vector is emptied.
+		void pageOutChunks(std::vector< std::unique_ptr< Chunk > >& vecChunks) const;
+
+		// Write-behind support. Modified chunks which are evicted are put on a queue (replacing any older copy of the same chunk) and
+		// paged out by a background thread. The pager lock is always taken before the page-out queue lock.
+		struct ChunkPositionHasher
+		{
+			std::size_t operator()(const Vector3DInt32& v3dPos) const
+			{
+				return hashChunkPosition(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+			}
+		};
+		bool queuePageOut(std::unique_ptr< Chunk >& pChunk) const;
+		// Pages out a modified chunk, either by putting it on the page-out queue or by destroying it (which pages it out immediately).
+		void pageOutChunk(std::unique_ptr< Chunk >& pChunk) const;
+		// Removes the chunk from the page-out queue if it is there, optionally recording the count of chunks paged out while doing so.
+		Chunk* takeQueuedPageOut(const Vector3DInt32& v3dChunkPos, uint32_t* pNoOfModifiedChunksPagedOut) const;
+		// Takes everything off the page-out queue, and pages it out as a batch (with the pager lock held).
+		bool takeQueuedPageOuts(std::vector< std::unique_ptr< Chunk > >& vecChunks) const;
+		void pageOutQueuedChunks(std::vector< std::unique_ptr< Chunk > >& vecChunks) const;
+		void drainPageOutQueue(void) const;
+		void runPageOutThread(void);
+		void stopPageOutThread(void);
+
+		// Operations on the chunk hash table. Those which take a shard assume the caller holds its lock (in concurrent mode).
+		static uint32_t hashChunkPosition(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ);
+		ChunkShard& getShard(uint32_t uHash) const;
+		Chunk* findOrCreateChunk(ChunkShard& shard, uint32_t uHash, int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const;
+		uint32_t findChunkIndex(const ChunkShard& shard, uint32_t uHash, int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const;
+		void insertChunk(ChunkShard& shard, uint32_t uHash, Chunk* pChunk) const;
+		// If a vector is given then a modified chunk which is not compressed is added to it, rather than being paged out straight away.
+		void eraseChunk(ChunkShard& shard, uint32_t uIndex, bool bCompress = true, std::vector< std::unique_ptr< Chunk > >* pVecChunksToPageOut = nullptr) const;
+
+		struct CompressedChunk
+		{
+			std::vector<uint8_t> vecData;
+			bool bDataModified;
+			bool bUniform;
+			std::list<Vector3DInt32>::iterator iterPosition;
+		};
+		typedef std::unordered_map<Vector3DInt32, CompressedChunk, ChunkPositionHasher> CompressedChunkMap;
+
+		// Operations on the compressed tier. Evicted chunks are compressed into this (if it is enabled), and chunks are evicted
+		// from it in least recently used order once it exceeds its memory limit.
+		void compressChunk(std::unique_ptr< Chunk >& pChunk) const;
+		Chunk* takeCompressedChunk(const Vector3DInt32& v3dChunkPos, uint32_t* pNoOfModifiedChunksPagedOut) const;
+		Chunk* decompressChunk(typename CompressedChunkMap::iterator iter) const;
+		// Removes the least recently added chunks from the compressed tier (paging them out if necessary) until it is within the given size.
+		void removeCompressedChunks(uint32_t uTargetSizeInBytes) const;
+
+		// Operations on the eviction list of a shard.
+		void linkChunk(ChunkShard& shard, Chunk* pChunk) const;
+		void unlinkChunk(ChunkShard& shard, Chunk* pChunk) const;
+		void touchChunk(ChunkShard& shard, Chunk* pChunk) const;
+		bool evictChunk(ChunkShard& shard) const;
+
 		// Storing these properties individually has proved to be faster than keeping
 		// them in a Vector3DInt32 as it avoids constructions and comparison overheads.
 		// They are also at the start of the class in the hope that they will be pulled
 		// into cache - I've got no idea if this actually makes a difference.
+		// These are not used in concurrent mode, where each thread has a ThreadCacheSlot instead.
 		mutable int32_t m_v3dLastAccessedChunkX = 0;
 		mutable int32_t m_v3dLastAccessedChunkY = 0;
 		mutable int32_t m_v3dLastAccessedChunkZ = 0;
 		mutable Chunk* m_pLastAccessedChunk = nullptr;
 
-		mutable uint32_t m_uTimestamper = 0;
-
 		uint32_t m_uChunkCountLimit = 0;
+		uint32_t m_uTargetMemoryUsageInBytes;
+
+		ChunkEvictionPolicy m_eEvictionPolicy;
+
+		// Whether new chunks are stored as palettes where possible (see setPaletteStorageEnabled()).
+		bool m_bPaletteStorageEnabled;
+
+		bool m_bConcurrentAccess;
+
+		// The shards, of which there is a power-of-two number. The shard for a chunk is selected by the upper bits of its hash
+		// (while the lower bits choose the position within the shard) hence the shift rather than a mask.
+		std::unique_ptr< ChunkShard[] > m_arrayShards;
+		uint32_t m_uNoOfShards;
+		uint32_t m_uShardShift;
+
+		static const uint32_t uNoOfThreadCacheSlots = 64;
+		std::unique_ptr< ThreadCacheSlot[] > m_arrayThreadCacheSlots;
+		std::unique_ptr< ThreadExitListener > m_pThreadExitListener;
+
+		// Shared with every Sampler, so that one which outlives the volume knows not to release its pins.
+		std::shared_ptr< std::atomic<bool> > m_pExists;
+
+		// Serialises calls to the pager in concurrent mode. This lock may be taken while holding a shard lock, but never the other way around.
+		mutable std::mutex m_pagerMutex;
+
+		// Counts the modified chunks which have been paged out. A prefetch thread which pages a chunk in without holding the shard lock
+		// uses this to detect that the data it was given might have been superseded before the chunk could be made visible.
+		mutable std::atomic<uint32_t> m_uNoOfModifiedChunksPagedOut;
+
+		// Statistics about pinning, which are only updated when a chunk's pin count goes to or from zero.
+		mutable std::atomic<uint32_t> m_uNoOfPinnedChunks;
+		mutable std::atomic<uint64_t> m_uNoOfChunkLimitOverruns;
+
+		// The number of snapshots which have been taken, which is also the version of the most recent one.
+		std::atomic<uint64_t> m_uNoOfSnapshots;
+
+		// Change tracking. Writes are stamped with the current version, which moves on every time markVersion() is called. The journal
+		// holds the last version at which each chunk was written to, and is kept even when the chunk itself is evicted. It therefore
+		// grows by an entry for every chunk which is ever written to, until discardChangesUpTo() removes the older entries.
+		std::atomic<uint64_t> m_uVersion;
+		mutable std::unordered_map<Vector3DInt32, uint64_t, ChunkPositionHasher> m_mapChunkVersions;
+		mutable std::mutex m_journalMutex;
+
+		// Because calls to the pager are serialised there is little to gain from a large number of prefetch threads. Two means that
+		// one can be running the pager while the other is doing everything else.
+		static const uint32_t uNoOfPrefetchThreads = 2;
+		std::vector<std::thread> m_vecPrefetchThreads;
+		std::priority_queue<PrefetchWorkItem> m_queuePrefetchWork;
+		std::mutex m_prefetchMutex;
+		std::condition_variable m_prefetchCondition;
+		uint64_t m_uNoOfPrefetchItemsQueued;
+		bool m_bStopPrefetchThreads;
+
+		// The page-out queue. Chunks are written in the order they were first queued, but the map is the authority
+		// on what is actually waiting to be written (a position can be taken back out of the map by a read).
+		bool m_bWriteBehindEnabled;
+		mutable std::unordered_map<Vector3DInt32, std::unique_ptr< Chunk >, ChunkPositionHasher> m_mapPendingPageOuts;
+		mutable std::deque<Vector3DInt32> m_queuePendingPageOuts;
+		mutable std::mutex m_pageOutMutex;
+		mutable std::condition_variable m_pageOutCondition;
+		std::thread m_pageOutThread;
+		bool m_bStopPageOutThread;
+
+		// The compressed tier. The list is in order of insertion, which is the same as least recently used order because a chunk
+		// is removed from the tier as soon as it is accessed.
+		Compressor* m_pCompressor;
+		uint32_t m_uCompressedTierLimitInBytes;
+		mutable uint32_t m_uCompressedTierSizeInBytes;
+		mutable CompressedChunkMap m_mapCompressedChunks;
+		mutable std::list<Vector3DInt32> m_listCompressedChunks;
+		mutable std::vector<uint8_t> m_vecCompressionBuffer;
+		mutable std::mutex m_compressedTierMutex;
 
-		// Chunks are stored in the following array which is used as a hash-table. Conventional wisdom is that such a hash-table
-		// should not be more than half full to avoid conflicts, and a practical chunk size seems to be 64^3. With this configuration
-		// there can be up to 32768*64^3 = 8 gigavoxels (with each voxel perhaps being many bytes). This should effectively make use 
-		// of even high end machines. Of course, the user can choose to limit the memory usage in which case much less of the chunk 
-		// array will actually be used. None-the-less, we have chosen to use a fixed size array (rather than a vector) as it appears to 
-		// be slightly faster (probably due to the extra pointer indirection in a vector?) and the actual size of this array should
-		// just be 1Mb or so.
-		static const uint32_t uChunkArraySize = 65536;
-		mutable std::unique_ptr< Chunk > m_arrayChunks[uChunkArraySize];
+		// The voxel data of the chunks is allocated from here. This is declared after everything which can hold a chunk, but the
+		// destructor removes all chunks anyway. It is null for voxel types which need destroying, as the pool does not construct
+		// or destroy the voxels.
+		std::unique_ptr<SlabPool> m_pChunkDataPool;
 
 		// The size of the chunks
 		uint16_t m_uChunkSideLength;
@@ -273,6 +1034,9 @@ namespace PolyVox
 
 #include "PagedVolume.inl"
 #include "PagedVolumeChunk.inl"
+#include "PagedVolumePinnedRegion.inl"
+#include "PagedVolumePrefetchRequest.inl"
 #include "PagedVolumeSampler.inl"
+#include "PagedVolumeSnapshot.inl"
 
 #endif //__PolyVox_PagedVolume_H__
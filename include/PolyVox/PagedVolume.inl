@@ -23,6 +23,7 @@
 *******************************************************************************/
 
 #include "Impl/ErrorHandling.h"
+#include "Impl/Utility.h"
 
 #include <algorithm>
 #include <limits>
@@ -34,10 +35,31 @@ namespace PolyVox
 	/// \param pPager Called by PolyVox to load and unload data on demand.
 	/// \param uTargetMemoryUsageInBytes The upper limit to how much memory this PagedVolume should aim to use.
 	/// \param uChunkSideLength The size of the chunks making up the volume. Small chunks will compress/decompress faster, but there will also be more of them meaning voxel access could be slower.
+	/// \param eEvictionPolicy How to choose which chunk is discarded when the memory limit is reached. Both policies run in constant time.
+	/// \param bEnableConcurrentAccess Allows the volume to be accessed from several threads at once, at the cost of some locking when moving between chunks.
 	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
-	PagedVolume<VoxelType>::PagedVolume(Pager* pPager, uint32_t uTargetMemoryUsageInBytes, uint16_t uChunkSideLength)
+	PagedVolume<VoxelType>::PagedVolume(Pager* pPager, uint32_t uTargetMemoryUsageInBytes, uint16_t uChunkSideLength, ChunkEvictionPolicy eEvictionPolicy, bool bEnableConcurrentAccess)
 		:BaseVolume<VoxelType>()
+		, m_uTargetMemoryUsageInBytes(uTargetMemoryUsageInBytes)
+		, m_eEvictionPolicy(eEvictionPolicy)
+		, m_bPaletteStorageEnabled(false)
+		, m_bConcurrentAccess(bEnableConcurrentAccess)
+		, m_uNoOfShards(1)
+		, m_uShardShift(0)
+		, m_pExists(std::make_shared< std::atomic<bool> >(true))
+		, m_uNoOfModifiedChunksPagedOut(0)
+		, m_uNoOfPinnedChunks(0)
+		, m_uNoOfChunkLimitOverruns(0)
+		, m_uNoOfSnapshots(0)
+		, m_uVersion(1)
+		, m_uNoOfPrefetchItemsQueued(0)
+		, m_bStopPrefetchThreads(false)
+		, m_bWriteBehindEnabled(false)
+		, m_bStopPageOutThread(false)
+		, m_pCompressor(nullptr)
+		, m_uCompressedTierLimitInBytes(0)
+		, m_uCompressedTierSizeInBytes(0)
 		, m_uChunkSideLength(uChunkSideLength)
 		, m_pPager(pPager)
 	{
@@ -53,21 +75,21 @@ namespace PolyVox
 			// Use to perform modulo by bit operations
 			m_iChunkMask = m_uChunkSideLength - 1;
 
-			// Calculate the number of chunks based on the memory limit and the size of each chunk.
-			uint32_t uChunkSizeInBytes = PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(m_uChunkSideLength);
-			m_uChunkCountLimit = uTargetMemoryUsageInBytes / uChunkSizeInBytes;
+			if (m_bConcurrentAccess)
+			{
+				m_arrayThreadCacheSlots.reset(new ThreadCacheSlot[uNoOfThreadCacheSlots]);
+				m_pThreadExitListener.reset(new ThreadExitListener(this));
+				ThreadRegistry::addListener(m_pThreadExitListener.get());
+			}
 
-			// Enforce sensible limits on the number of chunks.
-			const uint32_t uMinPracticalNoOfChunks = 32; // Enough to make sure a chunks and it's neighbours can be loaded, with a few to spare.
-			const uint32_t uMaxPracticalNoOfChunks = uChunkArraySize / 2; // A hash table should only become half-full to avoid too many clashes.
-			POLYVOX_LOG_WARNING_IF(m_uChunkCountLimit < uMinPracticalNoOfChunks, "Requested memory usage limit of ",
-				uTargetMemoryUsageInBytes / (1024 * 1024), "Mb is too low and cannot be adhered to.");
-			m_uChunkCountLimit = (std::max)(m_uChunkCountLimit, uMinPracticalNoOfChunks);
-			m_uChunkCountLimit = (std::min)(m_uChunkCountLimit, uMaxPracticalNoOfChunks);
+			createShards();
 
-			// Inform the user about the chosen memory configuration.
-			POLYVOX_LOG_DEBUG("Memory usage limit for volume now set to ", (m_uChunkCountLimit * uChunkSizeInBytes) / (1024 * 1024),
-				"Mb (", m_uChunkCountLimit, " chunks of ", uChunkSizeInBytes / 1024, "Kb each).");
+			// The chunk data pool has room for all the resident chunks plus a full page-out queue, though the slabs are only allocated as they are needed.
+			if (std::is_trivially_destructible<VoxelType>::value)
+			{
+				const uint32_t uChunkSizeInBytes = PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(m_uChunkSideLength);
+				m_pChunkDataPool.reset(new SlabPool(uChunkSizeInBytes, m_uChunkCountLimit + m_uChunkCountLimit / 4));
+			}
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -89,7 +111,25 @@ namespace PolyVox
 	template <typename VoxelType>
 	PagedVolume<VoxelType>::~PagedVolume()
 	{
+		// Outstanding prefetches are abandoned rather than completed.
+		stopPrefetchThreads();
+
 		flushAll();
+
+		// From here on, exiting threads leave the caches alone.
+		if (m_pThreadExitListener)
+		{
+			ThreadRegistry::removeListener(m_pThreadExitListener.get());
+		}
+
+		// Anything left over is pinned by a Sampler which is still alive, or by another thread's cache (and no other thread should
+		// be accessing a volume while it is destroyed). Either way, it has to go. Samplers find out that their pins are gone when
+		// they are destroyed.
+		m_pExists->store(false);
+		removeAllChunks(true);
+
+		// Removing the pinned chunks may have queued some more page-outs, which the writer thread completes before it exits.
+		stopPageOutThread();
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -124,9 +164,7 @@ namespace PolyVox
 		const uint16_t yOffset = static_cast<uint16_t>(uYPos & m_iChunkMask);
 		const uint16_t zOffset = static_cast<uint16_t>(uZPos & m_iChunkMask);
 
-		auto pChunk = canReuseLastAccessedChunk(chunkX, chunkY, chunkZ) ? m_pLastAccessedChunk : getChunk(chunkX, chunkY, chunkZ);
-
-		return pChunk->getVoxel(xOffset, yOffset, zOffset);
+		return getVoxelInChunk(chunkX, chunkY, chunkZ, xOffset, yOffset, zOffset);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -157,9 +195,7 @@ namespace PolyVox
 		const uint16_t yOffset = static_cast<uint16_t>(uYPos - (chunkY << m_uChunkSideLengthPower));
 		const uint16_t zOffset = static_cast<uint16_t>(uZPos - (chunkZ << m_uChunkSideLengthPower));
 
-		auto pChunk = canReuseLastAccessedChunk(chunkX, chunkY, chunkZ) ? m_pLastAccessedChunk : getChunk(chunkX, chunkY, chunkZ);
-
-		pChunk->setVoxel(xOffset, yOffset, zOffset, tValue);
+		setVoxelInChunk(chunkX, chunkY, chunkZ, xOffset, yOffset, zOffset, tValue);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -172,6 +208,135 @@ namespace PolyVox
 		setVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// This does the work of getVoxel() once the position has been split into a chunk and an offset within it, which
+	/// lets classes which know the chunk side length at compile time do the splitting themselves.
+	/// \param iChunkX The \c x position of the chunk
+	/// \param iChunkY The \c y position of the chunk
+	/// \param iChunkZ The \c z position of the chunk
+	/// \param uXOffset The \c x position of the voxel within the chunk
+	/// \param uYOffset The \c y position of the voxel within the chunk
+	/// \param uZOffset The \c z position of the voxel within the chunk
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::getVoxelInChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, uint16_t uXOffset, uint16_t uYOffset, uint16_t uZOffset) const
+	{
+		if (m_bConcurrentAccess)
+		{
+			bool bMustRelease = false;
+			auto pChunk = getChunkForCurrentThread(iChunkX, iChunkY, iChunkZ, bMustRelease);
+			VoxelType tValue = pChunk->getVoxel(uXOffset, uYOffset, uZOffset);
+			if (bMustRelease)
+			{
+				releaseChunk(pChunk);
+			}
+			return tValue;
+		}
+
+		auto pChunk = canReuseLastAccessedChunk(iChunkX, iChunkY, iChunkZ) ? m_pLastAccessedChunk : getChunk(iChunkX, iChunkY, iChunkZ);
+
+		return pChunk->getVoxel(uXOffset, uYOffset, uZOffset);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This does the work of setVoxel() once the position has been split into a chunk and an offset within it.
+	/// \param iChunkX The \c x position of the chunk
+	/// \param iChunkY The \c y position of the chunk
+	/// \param iChunkZ The \c z position of the chunk
+	/// \param uXOffset The \c x position of the voxel within the chunk
+	/// \param uYOffset The \c y position of the voxel within the chunk
+	/// \param uZOffset The \c z position of the voxel within the chunk
+	/// \param tValue the value to which the voxel will be set
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::setVoxelInChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, uint16_t uXOffset, uint16_t uYOffset, uint16_t uZOffset, VoxelType tValue)
+	{
+		if (m_bConcurrentAccess)
+		{
+			bool bMustRelease = false;
+			auto pChunk = getChunkForCurrentThread(iChunkX, iChunkY, iChunkZ, bMustRelease);
+			recordWrite(pChunk);
+			pChunk->setVoxel(uXOffset, uYOffset, uZOffset, tValue);
+			if (bMustRelease)
+			{
+				releaseChunk(pChunk);
+			}
+			return;
+		}
+
+		auto pChunk = canReuseLastAccessedChunk(iChunkX, iChunkY, iChunkZ) ? m_pLastAccessedChunk : getChunk(iChunkX, iChunkY, iChunkZ);
+
+		recordWrite(pChunk);
+		pChunk->setVoxel(uXOffset, uYOffset, uZOffset, tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The region is processed one chunk at a time, with each chunk being pinned only while it is being copied. This is much faster
+	/// than calling getVoxel() for every position, as each chunk is looked up just once and voxels are copied a row at a time. Uniform
+	/// chunks are copied without touching any voxel data. The region does not have to be aligned to chunk boundaries, but if it is and
+	/// the buffer has a Morton layout then the data of each chunk is copied as a single block.
+	///
+	/// \param regRead The region to copy
+	/// \param pDstBuffer The buffer to copy into, which must hold at least layout.getRequiredBufferSize(regRead) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const
+	{
+		layout.validate(regRead);
+		POLYVOX_THROW_IF(pDstBuffer == nullptr, std::invalid_argument, "Destination buffer must not be null.");
+
+		for (int32_t z = regRead.getLowerZ() >> m_uChunkSideLengthPower; z <= regRead.getUpperZ() >> m_uChunkSideLengthPower; z++)
+		{
+			for (int32_t y = regRead.getLowerY() >> m_uChunkSideLengthPower; y <= regRead.getUpperY() >> m_uChunkSideLengthPower; y++)
+			{
+				for (int32_t x = regRead.getLowerX() >> m_uChunkSideLengthPower; x <= regRead.getUpperX() >> m_uChunkSideLengthPower; x++)
+				{
+					Region regPart(x << m_uChunkSideLengthPower, y << m_uChunkSideLengthPower, z << m_uChunkSideLengthPower,
+						((x + 1) << m_uChunkSideLengthPower) - 1, ((y + 1) << m_uChunkSideLengthPower) - 1, ((z + 1) << m_uChunkSideLengthPower) - 1);
+					regPart.cropTo(regRead);
+
+					Chunk* pChunk = acquireChunk(x, y, z);
+					readChunkPart(pChunk, regPart, regRead, pDstBuffer, layout);
+					releaseChunk(pChunk);
+				}
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Like readRegion(), this works one chunk at a time. Writing a uniform chunk's own value back to it leaves the chunk unchanged (and
+	/// uniform), and a chunk which is completely overwritten does not have its existing contents filled in first.
+	///
+	/// \param regWrite The region to copy
+	/// \param pSrcBuffer The buffer to copy from, which must hold at least layout.getRequiredBufferSize(regWrite) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout)
+	{
+		layout.validate(regWrite);
+		POLYVOX_THROW_IF(pSrcBuffer == nullptr, std::invalid_argument, "Source buffer must not be null.");
+
+		for (int32_t z = regWrite.getLowerZ() >> m_uChunkSideLengthPower; z <= regWrite.getUpperZ() >> m_uChunkSideLengthPower; z++)
+		{
+			for (int32_t y = regWrite.getLowerY() >> m_uChunkSideLengthPower; y <= regWrite.getUpperY() >> m_uChunkSideLengthPower; y++)
+			{
+				for (int32_t x = regWrite.getLowerX() >> m_uChunkSideLengthPower; x <= regWrite.getUpperX() >> m_uChunkSideLengthPower; x++)
+				{
+					Region regPart(x << m_uChunkSideLengthPower, y << m_uChunkSideLengthPower, z << m_uChunkSideLengthPower,
+						((x + 1) << m_uChunkSideLengthPower) - 1, ((y + 1) << m_uChunkSideLengthPower) - 1, ((z + 1) << m_uChunkSideLengthPower) - 1);
+					regPart.cropTo(regWrite);
+
+					Chunk* pChunk = acquireChunk(x, y, z);
+					writeChunkPart(pChunk, regPart, regWrite, pSrcBuffer, layout);
+					releaseChunk(pChunk);
+				}
+			}
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// Note that if the memory usage limit is not large enough to support the region this function will only load part of the region. In this case it is undefined which parts will actually be loaded. If all the voxels in the given region are already loaded, this function will not do anything. Other voxels might be unloaded to make space for the new voxels.
 	/// \param regPrefetch The Region of voxels to prefetch into memory.
@@ -198,138 +363,363 @@ namespace PolyVox
 		POLYVOX_LOG_WARNING_IF(uNoOfChunks > m_uChunkCountLimit, "Attempting to prefetch more than the maximum number of chunks (this will cause thrashing).");
 		uNoOfChunks = (std::min)(uNoOfChunks, m_uChunkCountLimit);
 
-		// Loops over the specified positions and touch the corresponding chunks.
-		for (int32_t x = v3dStart.getX(); x <= v3dEnd.getX(); x++)
+		// Visit the chunks in Morton order, which is the order the pager is given them in anyway. Any beyond
+		// the limit would only evict chunks which were prefetched earlier, so they are left out.
+		std::vector<Vector3DInt32> vecChunkPositions;
+		vecChunkPositions.reserve(region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels());
+		for (int32_t z = v3dStart.getZ(); z <= v3dEnd.getZ(); z++)
 		{
 			for (int32_t y = v3dStart.getY(); y <= v3dEnd.getY(); y++)
 			{
-				for (int32_t z = v3dStart.getZ(); z <= v3dEnd.getZ(); z++)
+				for (int32_t x = v3dStart.getX(); x <= v3dEnd.getX(); x++)
 				{
-					getChunk(x, y, z);
+					vecChunkPositions.push_back(Vector3DInt32(x, y, z));
 				}
 			}
 		}
+		std::sort(vecChunkPositions.begin(), vecChunkPositions.end(), &PagedVolume<VoxelType>::isBeforeInMortonOrder);
+
+		// The chunks are paged in a batch at a time. Batches are kept well within the memory limit, as every chunk
+		// in a batch has to be in memory at once.
+		const uint32_t uNoOfChunksPerBatch = (std::max)((std::min)(m_uChunkCountLimit / 2, static_cast<uint32_t>(uMaxNoOfChunksPerBatch)), static_cast<uint32_t>(1));
+		for (uint32_t uFirstChunk = 0; uFirstChunk < uNoOfChunks; uFirstChunk += uNoOfChunksPerBatch)
+		{
+			prefetchChunks(&vecChunkPositions[uFirstChunk], (std::min)(uNoOfChunksPerBatch, uNoOfChunks - uFirstChunk));
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	/// Removes all voxels from memory, and calls dataOverflowHandler() to ensure the application has a chance to store the data.
+	/// Normally a chunk which is evicted is paged out (if it has been modified) and then discarded, so the next time it is needed it
+	/// has to be paged back in. With a compressed tier, evicted chunks are instead compressed and kept in memory until the tier itself
+	/// reaches its memory limit, at which point the least recently evicted chunks are paged out as usual. Accessing a chunk in the
+	/// compressed tier decompresses it back into a normal chunk. For data with plenty of uniform areas (such as typical terrain) this
+	/// allows many more chunks to be kept in memory than would otherwise be possible, without paying the cost of the pager.
+	///
+	/// The memory used by the compressed tier is separate from (and in addition to) the limit given to the volume's constructor. Calls
+	/// to the compressor are serialised. This function should not be called while other threads are accessing the volume.
+	///
+	/// \param pCompressor The compressor to use, such as an RLECompressor. Pass null to disable the compressed tier. The volume does
+	/// not take ownership and the compressor must remain valid until the tier is disabled or the volume is destroyed.
+	/// \param uTargetMemoryUsageInBytes The maximum amount of memory to use for compressed chunks.
 	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::flushAll()
+	void PagedVolume<VoxelType>::setCompressedTier(Compressor* pCompressor, uint32_t uTargetMemoryUsageInBytes)
 	{
-		// Clear this pointer as all chunks are about to be removed.
-		m_pLastAccessedChunk = nullptr;
-
-		// Erase all the most recently used chunks.
-		for (uint32_t uIndex = 0; uIndex < uChunkArraySize; uIndex++)
+		// Anything already compressed was compressed with the old compressor.
+		if (pCompressor != m_pCompressor)
 		{
-			m_arrayChunks[uIndex] = nullptr;
+			removeCompressedChunks(0);
 		}
+
+		m_pCompressor = pCompressor;
+		m_uCompressedTierLimitInBytes = uTargetMemoryUsageInBytes;
+		removeCompressedChunks(m_uCompressedTierLimitInBytes);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// Many voxel types can represent far more values than are ever found in a single chunk. For example, a chunk of terrain may only
+	/// contain a handful of materials. With palette storage enabled, each chunk which has at most 256 distinct values stores just those
+	/// values in a table (the palette), and each voxel as an index into the table using only as many bits as it needs. A chunk with two
+	/// values therefore uses one bit per voxel, and one with up to sixteen uses four bits per voxel. Chunks are converted when they are
+	/// paged in, and writing new values to a chunk makes the palette (and the indices) grow as needed. A chunk which ends up with more
+	/// than 256 values is stored as normal, as is one whose data is asked for by Chunk::getData().
+	///
+	/// The memory limit given to the constructor then applies to the memory actually used by the chunks, so more of them fit in memory
+	/// and less paging is needed. Reading voxels from palette chunks is slightly slower than from normal chunks, but samplers decode them
+	/// directly rather than going through the volume.
+	///
+	/// Palette storage cannot be used with concurrent access, as a palette may be reallocated while it grows. Changing the setting flushes
+	/// the volume, and is not possible while any chunks are pinned.
+	///
+	/// \param bEnabled Whether new chunks should use palette storage where possible.
+	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
-	bool PagedVolume<VoxelType>::canReuseLastAccessedChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const
+	void PagedVolume<VoxelType>::setPaletteStorageEnabled(bool bEnabled)
 	{
-		return ((iChunkX == m_v3dLastAccessedChunkX) &&
-			(iChunkY == m_v3dLastAccessedChunkY) &&
-			(iChunkZ == m_v3dLastAccessedChunkZ) &&
-			(m_pLastAccessedChunk));
+		if (bEnabled == m_bPaletteStorageEnabled)
+		{
+			return;
+		}
+
+		POLYVOX_THROW_IF(bEnabled && m_bConcurrentAccess, std::logic_error, "Palette storage cannot be used with concurrent access.");
+
+		// The chunk limits depend on how the chunks are stored, so the shards have to be recreated.
+		flushAll();
+		POLYVOX_THROW_IF(m_arrayShards[0].m_uChunkCount > 0, std::logic_error, "Cannot change the chunk storage while chunks are pinned.");
+
+		m_bPaletteStorageEnabled = bEnabled;
+		createShards();
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// This is similar to prefetch(), but returns immediately and leaves the chunks to be paged in by a small pool of background threads
+	/// (which is created the first time this function is called). Each chunk only becomes visible to other threads once the Pager has
+	/// finished filling it, so there is no need to wait for the request to complete before accessing the volume. However, accessing a
+	/// chunk before its turn comes will simply page it in on the accessing thread.
+	///
+	/// The volume must have been constructed with concurrent access enabled, as the background threads access it at the same time as
+	/// the calling thread. Requests with a higher priority are serviced before those with a lower one, and cancelling a request which
+	/// is no longer needed (e.g. because the camera has moved on) stops its remaining chunks from being paged in.
+	///
+	/// \param regPrefetch The Region of voxels to prefetch into memory.
+	/// \param iPriority The priority of this request relative to others which are still outstanding.
+	/// \return An object which can be used to wait for or cancel the request.
+	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
-	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::getChunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const
+	std::shared_ptr<typename PagedVolume<VoxelType>::PrefetchRequest> PagedVolume<VoxelType>::prefetchAsync(Region regPrefetch, int32_t iPriority)
 	{
-		Chunk* pChunk = nullptr;
+		POLYVOX_THROW_IF(!m_bConcurrentAccess, std::logic_error, "Asynchronous prefetching requires a volume with concurrent access enabled.");
+
+		// Convert the start and end positions into chunk space coordinates
+		Vector3DInt32 v3dStart;
+		for (int i = 0; i < 3; i++)
+		{
+			v3dStart.setElement(i, regPrefetch.getLowerCorner().getElement(i) >> m_uChunkSideLengthPower);
+		}
+
+		Vector3DInt32 v3dEnd;
+		for (int i = 0; i < 3; i++)
+		{
+			v3dEnd.setElement(i, regPrefetch.getUpperCorner().getElement(i) >> m_uChunkSideLengthPower);
+		}
+
+		Region region(v3dStart, v3dEnd);
+		uint32_t uNoOfChunks = static_cast<uint32_t>(region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels());
+		POLYVOX_LOG_WARNING_IF(uNoOfChunks > m_uChunkCountLimit, "Attempting to prefetch more than the maximum number of chunks (this will cause thrashing).");
+
+		// The constructor is private, so make_shared() cannot be used here.
+		std::shared_ptr<PrefetchRequest> pRequest(new PrefetchRequest(uNoOfChunks));
 
-		// We generate a 16-bit hash here and assume this matches the range available in the chunk
-		// array. The assert here is just to make sure we take care if change this in the future.
-		static_assert(uChunkArraySize == 65536, "Chunk array size has changed, check if the hash calculation needs updating.");
-		// Extract the lower five bits from each position component.
-		const uint32_t uChunkXLowerBits = static_cast<uint32_t>(uChunkX & 0x1F);
-		const uint32_t uChunkYLowerBits = static_cast<uint32_t>(uChunkY & 0x1F);
-		const uint32_t uChunkZLowerBits = static_cast<uint32_t>(uChunkZ & 0x1F);
-		// Combine then to form a 15-bit hash of the position. Also shift by one to spread the values out in the whole 16-bit space.
-		const uint32_t iPosisionHash = (((uChunkXLowerBits)) | ((uChunkYLowerBits) << 5) | ((uChunkZLowerBits) << 10) << 1);
-
-		// Starting at the position indicated by the hash, and then search through the whole array looking for a chunk with the correct
-		// position. In most cases we expect to find it in the first place we look. Note that this algorithm is slow in the case that
-		// the chunk is not found because the whole array has to be searched, but in this case we are going to have to page the data in
-		// from an external source which is likely to be slow anyway.
-		uint32_t iIndex = iPosisionHash;
-		do
-		{
-			if (m_arrayChunks[iIndex])
-			{
-				Vector3DInt32& entryPos = m_arrayChunks[iIndex]->m_v3dChunkSpacePosition;
-				if (entryPos.getX() == uChunkX && entryPos.getY() == uChunkY && entryPos.getZ() == uChunkZ)
+		std::lock_guard<std::mutex> prefetchLock(m_prefetchMutex);
+		if (m_vecPrefetchThreads.empty())
+		{
+			startPrefetchThreads();
+		}
+
+		for (int32_t x = v3dStart.getX(); x <= v3dEnd.getX(); x++)
+		{
+			for (int32_t y = v3dStart.getY(); y <= v3dEnd.getY(); y++)
+			{
+				for (int32_t z = v3dStart.getZ(); z <= v3dEnd.getZ(); z++)
 				{
-					pChunk = m_arrayChunks[iIndex].get();
-					pChunk->m_uChunkLastAccessed = ++m_uTimestamper;
-					break;
+					PrefetchWorkItem workItem;
+					workItem.iPriority = iPriority;
+					workItem.uSequenceNumber = m_uNoOfPrefetchItemsQueued++;
+					workItem.pRequest = pRequest;
+					workItem.iChunkX = x;
+					workItem.iChunkY = y;
+					workItem.iChunkZ = z;
+					m_queuePrefetchWork.push(workItem);
 				}
 			}
+		}
+		m_prefetchCondition.notify_all();
+
+		return pRequest;
+	}
 
-			iIndex++;
-			iIndex %= uChunkArraySize;
-		} while (iIndex != iPosisionHash); // Keep searching until we get back to our start position.
+	////////////////////////////////////////////////////////////////////////////////
+	/// Pins every chunk which overlaps the given region, paging them in if necessary. This is useful when a pointer or Sampler into
+	/// the volume needs to stay valid even though other code (or another thread, in concurrent mode) may be paging chunks in.
+	/// \param regPin The region of voxels to keep in memory. It cannot cover more chunks than the memory limit allows.
+	/// \return An object which keeps the chunks pinned until it is destroyed or released.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::PinnedRegion PagedVolume<VoxelType>::pinRegion(const Region& regPin)
+	{
+		// Convert the start and end positions into chunk space coordinates
+		Vector3DInt32 v3dStart;
+		for (int i = 0; i < 3; i++)
+		{
+			v3dStart.setElement(i, regPin.getLowerCorner().getElement(i) >> m_uChunkSideLengthPower);
+		}
 
-		// If we still haven't found the chunk then it's time to create a new one and page it in from disk.
-		if (!pChunk)
+		Vector3DInt32 v3dEnd;
+		for (int i = 0; i < 3; i++)
 		{
-			// The chunk was not found so we will create a new one.
-			Vector3DInt32 v3dChunkPos(uChunkX, uChunkY, uChunkZ);
-			pChunk = new PagedVolume<VoxelType>::Chunk(v3dChunkPos, m_uChunkSideLength, m_pPager);
-			pChunk->m_uChunkLastAccessed = ++m_uTimestamper; // Important, as we may soon delete the oldest chunk
+			v3dEnd.setElement(i, regPin.getUpperCorner().getElement(i) >> m_uChunkSideLengthPower);
+		}
 
-			// Store the chunk at the appropriate place in out chunk array. Ideally this place is
-			// given by the hash, otherwise we do a linear search for the next available location
-			// We always expect to find a free place because we aim to keep the array only half full.
-			uint32_t iIndex = iPosisionHash;
-			bool bInsertedSucessfully = false;
-			do
+		// Pinning more chunks than can be held would just guarantee that the limit is exceeded.
+		Region region(v3dStart, v3dEnd);
+		const uint64_t uNoOfChunks = static_cast<uint64_t>(region.getWidthInVoxels()) * region.getHeightInVoxels() * region.getDepthInVoxels();
+		POLYVOX_THROW_IF(uNoOfChunks > m_uChunkCountLimit, std::invalid_argument, "Cannot pin more chunks than the memory usage limit allows.");
+
+		PinnedRegion pinnedRegion(this, regPin);
+		pinnedRegion.m_vecChunks.reserve(static_cast<std::size_t>(uNoOfChunks));
+		for (int32_t x = v3dStart.getX(); x <= v3dEnd.getX(); x++)
+		{
+			for (int32_t y = v3dStart.getY(); y <= v3dEnd.getY(); y++)
 			{
-				if (m_arrayChunks[iIndex] == nullptr)
+				for (int32_t z = v3dStart.getZ(); z <= v3dEnd.getZ(); z++)
 				{
-					m_arrayChunks[iIndex] = std::move(std::unique_ptr< Chunk >(pChunk));
-					bInsertedSucessfully = true;
-					break;
+					pinnedRegion.m_vecChunks.push_back(acquireChunk(x, y, z));
 				}
+			}
+		}
+		return pinnedRegion;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Captures every chunk which overlaps the given region, paging them in if necessary. The chunks are only pinned while they are
+	/// being captured, so the region can be larger than the memory limit allows, but the snapshot keeps the voxel data of any chunks
+	/// which are evicted in memory until it is destroyed. Taking a snapshot counts as reading the region, so in concurrent mode it must
+	/// not be done while another thread is writing to it.
+	/// \param regSnapshot The region of voxels to capture.
+	/// \return A read-only view of the region, which can be used from any thread while this volume continues to be modified.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Snapshot PagedVolume<VoxelType>::snapshot(const Region& regSnapshot)
+	{
+		POLYVOX_THROW_IF(!regSnapshot.isValid(), std::invalid_argument, "Cannot take a snapshot of an invalid region.");
+
+		Region regChunks(regSnapshot.getLowerX() >> m_uChunkSideLengthPower, regSnapshot.getLowerY() >> m_uChunkSideLengthPower, regSnapshot.getLowerZ() >> m_uChunkSideLengthPower,
+			regSnapshot.getUpperX() >> m_uChunkSideLengthPower, regSnapshot.getUpperY() >> m_uChunkSideLengthPower, regSnapshot.getUpperZ() >> m_uChunkSideLengthPower);
 
-				iIndex++;
-				iIndex %= uChunkArraySize;
-			} while (iIndex != iPosisionHash); // Keep searching until we get back to our start position.
-
-			// This should never really happen unless we are failing to keep our number of active chunks
-			// significantly under the target amount. Perhaps if chunks are 'pinned' for threading purposes?
-			POLYVOX_THROW_IF(!bInsertedSucessfully, std::logic_error, "No space in chunk array for new chunk.");
-
-			// As we have added a chunk we may have exceeded our target chunk limit. Search through the array to
-			// determine how many chunks we have, as well as finding the oldest timestamp. Note that this is potentially
-			// wasteful and we may instead wish to track how many chunks we have and/or delete a chunk at random (or
-			// just check e.g. 10 and delete the oldest of those) but we'll see if this is a bottleneck first. Paging
-			// the data in is probably more expensive.
-			uint32_t uChunkCount = 0;
-			uint32_t uOldestChunkIndex = 0;
-			uint32_t uOldestChunkTimestamp = std::numeric_limits<uint32_t>::max();
-			for (uint32_t uIndex = 0; uIndex < uChunkArraySize; uIndex++)
-			{
-				if (m_arrayChunks[uIndex])
+		Snapshot snapshot(regSnapshot, regChunks, m_uChunkSideLength, ++m_uNoOfSnapshots);
+		snapshot.m_vecChunks.reserve(static_cast<std::size_t>(regChunks.getWidthInVoxels()) * regChunks.getHeightInVoxels() * regChunks.getDepthInVoxels());
+		for (int32_t z = regChunks.getLowerZ(); z <= regChunks.getUpperZ(); z++)
+		{
+			for (int32_t y = regChunks.getLowerY(); y <= regChunks.getUpperY(); y++)
+			{
+				for (int32_t x = regChunks.getLowerX(); x <= regChunks.getUpperX(); x++)
 				{
-					uChunkCount++;
-					if (m_arrayChunks[uIndex]->m_uChunkLastAccessed < uOldestChunkTimestamp)
-					{
-						uOldestChunkTimestamp = m_arrayChunks[uIndex]->m_uChunkLastAccessed;
-						uOldestChunkIndex = uIndex;
-					}
+					Chunk* pChunk = acquireChunk(x, y, z);
+					snapshot.m_vecChunks.push_back(pChunk->shareData());
+					releaseChunk(pChunk);
 				}
 			}
+		}
+		return snapshot;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Removes all voxels from memory, and calls Pager::pageOutBatch() to ensure the application has a chance to store the data. Chunks which are
+	/// currently in use by a Sampler or PinnedRegion (or, in concurrent mode, cached by another thread) are kept in memory, but any changes to them are still
+	/// paged out. In concurrent mode this should not be called while other threads are modifying the volume.
+	///
+	/// If write-behind is enabled then this also acts as a barrier, in that it does not return until every chunk which was waiting to be
+	/// paged out has been given to the Pager.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::flushAll()
+	{
+		removeAllChunks(false);
+		removeCompressedChunks(0);
+		drainPageOutQueue();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// By default a modified chunk is paged out as soon as it is evicted, which means that any call which causes an eviction (even a simple
+	/// getVoxel()) may have to wait for the Pager to write the data. With write-behind enabled, evicted chunks are instead put on a queue and
+	/// paged out by a background thread. Evicting the same chunk again before it has been written simply replaces the queued copy, and
+	/// accessing a chunk which is still queued takes it back off the queue rather than paging in data which is out of date.
+	///
+	/// The queue is limited to a quarter of the chunks the volume can hold, and beyond that evicted chunks are paged out immediately as usual.
+	/// Note that the Pager will be called from the background thread, though never from two threads at once. Disabling write-behind waits
+	/// for the queue to be emptied. This function should not be called while other threads are accessing the volume.
+	///
+	/// \param bEnabled Whether modified chunks should be paged out in the background.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::setWriteBehindEnabled(bool bEnabled)
+	{
+		if (bEnabled == m_bWriteBehindEnabled)
+		{
+			return;
+		}
+
+		if (bEnabled)
+		{
+			m_bWriteBehindEnabled = true;
+			m_bStopPageOutThread = false;
+			m_pageOutThread = std::thread(&PagedVolume<VoxelType>::runPageOutThread, this);
+		}
+		else
+		{
+			stopPageOutThread();
+			m_bWriteBehindEnabled = false;
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::createShards(void)
+	{
+		// Calculate the number of chunks based on the memory limit and the size of each chunk. Palette chunks can be much smaller than
+		// normal ones (down to one bit per voxel), and in this case the number of chunks only limits the size of the hash table. The
+		// memory used by the chunks is tracked separately.
+		const uint32_t uChunkSizeInBytes = PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(m_uChunkSideLength);
+		const uint32_t uMinChunkSizeInBytes = m_bPaletteStorageEnabled ? (std::max)(uChunkSizeInBytes / static_cast<uint32_t>(sizeof(VoxelType) * 8), 1u) : uChunkSizeInBytes;
+		m_uChunkCountLimit = m_uTargetMemoryUsageInBytes / uMinChunkSizeInBytes;
 
-			// Check if we have too many chunks, and delete the oldest if so.
-			if (uChunkCount > m_uChunkCountLimit)
+		// Enforce sensible limits on the number of chunks.
+		const uint32_t uMinPracticalNoOfChunks = 32; // Enough to make sure a chunks and it's neighbours can be loaded, with a few to spare.
+		const uint32_t uMaxPracticalNoOfChunks = 32768; // Keeps the hash tables a reasonable size.
+		POLYVOX_LOG_WARNING_IF(m_uChunkCountLimit < uMinPracticalNoOfChunks, "Requested memory usage limit of ",
+			m_uTargetMemoryUsageInBytes / (1024 * 1024), "Mb is too low and cannot be adhered to.");
+		m_uChunkCountLimit = (std::max)(m_uChunkCountLimit, uMinPracticalNoOfChunks);
+		m_uChunkCountLimit = (std::min)(m_uChunkCountLimit, uMaxPracticalNoOfChunks);
+
+		// In concurrent mode we split the chunks over several shards, but not so many that each shard becomes too small to be useful.
+		m_uNoOfShards = 1;
+		if (m_bConcurrentAccess)
+		{
+			const uint32_t uMaxNoOfShards = 16;
+			m_uNoOfShards = uMaxNoOfShards;
+			while ((m_uNoOfShards > 1) && (m_uChunkCountLimit / m_uNoOfShards < uMinPracticalNoOfChunks))
 			{
-				m_arrayChunks[uOldestChunkIndex] = nullptr;
+				m_uNoOfShards /= 2;
 			}
 		}
+		m_uShardShift = 32 - logBase2(m_uNoOfShards);
+
+		// Each shard gets an equal share of the chunk limit, and a hash table which is twice the size of that share.
+		m_arrayShards.reset(new ChunkShard[m_uNoOfShards]);
+		for (uint32_t uShard = 0; uShard < m_uNoOfShards; uShard++)
+		{
+			ChunkShard& shard = m_arrayShards[uShard];
+			shard.m_uChunkCountLimit = m_uChunkCountLimit / m_uNoOfShards;
+			shard.m_uSizeLimitInBytes = (std::max)(m_uTargetMemoryUsageInBytes / m_uNoOfShards, uChunkSizeInBytes * uMinPracticalNoOfChunks);
+			const uint32_t uChunkArraySize = upperPowerOfTwo(shard.m_uChunkCountLimit * 2);
+			shard.m_arrayChunks.reset(new std::unique_ptr< Chunk >[uChunkArraySize]);
+			shard.m_uChunkArrayMask = uChunkArraySize - 1;
+		}
+
+		// Inform the user about the chosen memory configuration.
+		POLYVOX_LOG_DEBUG("Memory usage limit for volume now set to ", (m_uChunkCountLimit * uMinChunkSizeInBytes) / (1024 * 1024),
+			"Mb (", m_uChunkCountLimit, " chunks of at least ", uMinChunkSizeInBytes / 1024, "Kb each).");
+	}
+
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::isShardFull(const ChunkShard& shard, uint32_t uNoOfNewChunks) const
+	{
+		if (shard.m_uChunkCount + uNoOfNewChunks > shard.m_uChunkCountLimit)
+		{
+			return true;
+		}
+
+		// A new chunk has all of its voxel data until it has been paged in and converted to a palette, so we always leave room for
+		// one full chunk. A batch of new chunks may take the volume over its limit for a moment, until they have all been converted.
+		return m_bPaletteStorageEnabled &&
+			(shard.m_uSizeInBytes + PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(m_uChunkSideLength) > shard.m_uSizeLimitInBytes);
+	}
+
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::canReuseLastAccessedChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const
+	{
+		return ((iChunkX == m_v3dLastAccessedChunkX) &&
+			(iChunkY == m_v3dLastAccessedChunkY) &&
+			(iChunkZ == m_v3dLastAccessedChunkZ) &&
+			(m_pLastAccessedChunk));
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::getChunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const
+	{
+		POLYVOX_ASSERT(!m_bConcurrentAccess, "getChunk() cannot be used in concurrent mode.");
+
+		const uint32_t uHash = hashChunkPosition(uChunkX, uChunkY, uChunkZ);
+		Chunk* pChunk = findOrCreateChunk(getShard(uHash), uHash, uChunkX, uChunkY, uChunkZ);
 
 		m_pLastAccessedChunk = pChunk;
 		m_v3dLastAccessedChunkX = uChunkX;
@@ -339,24 +729,1614 @@ namespace PolyVox
 		return pChunk;
 	}
 
-	////////////////////////////////////////////////////////////////////////////////
-	/// Calculate the memory usage of the volume.
-	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
-	uint32_t PagedVolume<VoxelType>::calculateSizeInBytes(void)
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::acquireChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const
 	{
-		uint32_t uChunkCount = 0;
-		for (uint32_t uIndex = 0; uIndex < uChunkArraySize; uIndex++)
+		Chunk* pChunk = nullptr;
+		if (m_bConcurrentAccess)
 		{
-			if (m_arrayChunks[uIndex])
-			{
-				uChunkCount++;
-			}
+			// The chunk must be pinned before the shard is unlocked, otherwise it could be evicted before we get a chance to use it.
+			const uint32_t uHash = hashChunkPosition(iChunkX, iChunkY, iChunkZ);
+			ChunkShard& shard = getShard(uHash);
+			std::lock_guard<std::mutex> shardLock(shard.m_mutex);
+			pChunk = findOrCreateChunk(shard, uHash, iChunkX, iChunkY, iChunkZ);
+			pinChunk(pChunk);
+		}
+		else
+		{
+			pChunk = canReuseLastAccessedChunk(iChunkX, iChunkY, iChunkZ) ? m_pLastAccessedChunk : getChunk(iChunkX, iChunkY, iChunkZ);
+			pinChunk(pChunk);
+		}
+		return pChunk;
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::pinChunk(Chunk* pChunk) const
+	{
+		if (pChunk->m_uPinCount++ == 0)
+		{
+			m_uNoOfPinnedChunks++;
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::releaseChunk(Chunk* pChunk) const
+	{
+		// No lock is needed here. Once the count reaches zero the chunk may be evicted, but we are no longer using it.
+		POLYVOX_ASSERT(pChunk->m_uPinCount > 0, "Attempting to release a chunk which is not pinned.");
+		if (--pChunk->m_uPinCount == 0)
+		{
+			m_uNoOfPinnedChunks--;
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::recordWrite(Chunk* pChunk) const
+	{
+		const uint64_t uVersion = m_uVersion.load(std::memory_order_relaxed);
+		if (pChunk->m_uVersion.load(std::memory_order_relaxed) != uVersion)
+		{
+			recordWriteInJournal(pChunk, uVersion);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::recordWriteInJournal(Chunk* pChunk, uint64_t uVersion) const
+	{
+		auto journalLock = lockIfConcurrent(m_journalMutex);
+		uint64_t& uJournalVersion = m_mapChunkVersions[pChunk->m_v3dChunkSpacePosition];
+		uJournalVersion = (std::max)(uJournalVersion, uVersion);
+		pChunk->m_uVersion.store(uVersion, std::memory_order_relaxed);
+	}
+
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::isWholeChunkBlock(const Region& regPart, const Region& regBuffer, const BufferLayout& layout) const
+	{
+		// Morton codes of positions within a chunk only use the low bits, so if the buffer's region is aligned to the chunk grid then
+		// every chunk it covers completely occupies one contiguous block of the buffer, in exactly the order the chunk stores it.
+		return (layout.getOrder() == BufferOrders::Morton) &&
+			(regPart.getWidthInVoxels() == m_uChunkSideLength) && (regPart.getHeightInVoxels() == m_uChunkSideLength) && (regPart.getDepthInVoxels() == m_uChunkSideLength) &&
+			((regBuffer.getLowerX() & m_iChunkMask) == 0) && ((regBuffer.getLowerY() & m_iChunkMask) == 0) && ((regBuffer.getLowerZ() & m_iChunkMask) == 0);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::readChunkPart(Chunk* pChunk, const Region& regPart, const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const
+	{
+		const uint32_t uChunkX = regPart.getLowerX() & m_iChunkMask;
+		const uint32_t uChunkY = regPart.getLowerY() & m_iChunkMask;
+		const uint32_t uChunkZ = regPart.getLowerZ() & m_iChunkMask;
+		const uint32_t uBufferX = regPart.getLowerX() - regRead.getLowerX();
+		const uint32_t uBufferY = regPart.getLowerY() - regRead.getLowerY();
+		const uint32_t uBufferZ = regPart.getLowerZ() - regRead.getLowerZ();
+		const uint32_t uWidth = regPart.getWidthInVoxels();
+		const uint32_t uHeight = regPart.getHeightInVoxels();
+		const uint32_t uDepth = regPart.getDepthInVoxels();
+		const bool bLinear = (layout.getOrder() == BufferOrders::Linear);
+
+		if (pChunk->isUniform())
+		{
+			const VoxelType tUniformValue = pChunk->m_tUniformValue;
+			for (uint32_t z = 0; z < uDepth; z++)
+			{
+				for (uint32_t y = 0; y < uHeight; y++)
+				{
+					if (bLinear)
+					{
+						VoxelType* pDstRow = pDstBuffer + layout.getIndex(regRead, uBufferX, uBufferY + y, uBufferZ + z);
+						std::fill(pDstRow, pDstRow + uWidth, tUniformValue);
+					}
+					else
+					{
+						const uint32_t uBufferYZ = morton256_y[uBufferY + y] | morton256_z[uBufferZ + z];
+						for (uint32_t x = 0; x < uWidth; x++)
+						{
+							pDstBuffer[morton256_x[uBufferX + x] | uBufferYZ] = tUniformValue;
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		// Palette chunks are decoded one voxel at a time.
+		if (pChunk->hasPalette())
+		{
+			for (uint32_t z = 0; z < uDepth; z++)
+			{
+				for (uint32_t y = 0; y < uHeight; y++)
+				{
+					const uint32_t uChunkYZ = morton256_y[uChunkY + y] | morton256_z[uChunkZ + z];
+					if (bLinear)
+					{
+						VoxelType* pDstRow = pDstBuffer + layout.getIndex(regRead, uBufferX, uBufferY + y, uBufferZ + z);
+						for (uint32_t x = 0; x < uWidth; x++)
+						{
+							pDstRow[x] = pChunk->m_vecPalette[pChunk->getPaletteIndex(morton256_x[uChunkX + x] | uChunkYZ)];
+						}
+					}
+					else
+					{
+						const uint32_t uBufferYZ = morton256_y[uBufferY + y] | morton256_z[uBufferZ + z];
+						for (uint32_t x = 0; x < uWidth; x++)
+						{
+							pDstBuffer[morton256_x[uBufferX + x] | uBufferYZ] = pChunk->m_vecPalette[pChunk->getPaletteIndex(morton256_x[uChunkX + x] | uChunkYZ)];
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		const VoxelType* pChunkData = pChunk->m_tData;
+		if (isWholeChunkBlock(regPart, regRead, layout))
+		{
+			std::copy(pChunkData, pChunkData + uWidth * uHeight * uDepth, pDstBuffer + layout.getIndex(regRead, uBufferX, uBufferY, uBufferZ));
+			return;
+		}
+
+		for (uint32_t z = 0; z < uDepth; z++)
+		{
+			for (uint32_t y = 0; y < uHeight; y++)
+			{
+				const uint32_t uChunkYZ = morton256_y[uChunkY + y] | morton256_z[uChunkZ + z];
+				if (bLinear)
+				{
+					VoxelType* pDstRow = pDstBuffer + layout.getIndex(regRead, uBufferX, uBufferY + y, uBufferZ + z);
+					for (uint32_t x = 0; x < uWidth; x++)
+					{
+						pDstRow[x] = pChunkData[morton256_x[uChunkX + x] | uChunkYZ];
+					}
+				}
+				else
+				{
+					const uint32_t uBufferYZ = morton256_y[uBufferY + y] | morton256_z[uBufferZ + z];
+					for (uint32_t x = 0; x < uWidth; x++)
+					{
+						pDstBuffer[morton256_x[uBufferX + x] | uBufferYZ] = pChunkData[morton256_x[uChunkX + x] | uChunkYZ];
+					}
+				}
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::writeChunkPart(Chunk* pChunk, const Region& regPart, const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout)
+	{
+		const uint32_t uChunkX = regPart.getLowerX() & m_iChunkMask;
+		const uint32_t uChunkY = regPart.getLowerY() & m_iChunkMask;
+		const uint32_t uChunkZ = regPart.getLowerZ() & m_iChunkMask;
+		const uint32_t uBufferX = regPart.getLowerX() - regWrite.getLowerX();
+		const uint32_t uBufferY = regPart.getLowerY() - regWrite.getLowerY();
+		const uint32_t uBufferZ = regPart.getLowerZ() - regWrite.getLowerZ();
+		const uint32_t uWidth = regPart.getWidthInVoxels();
+		const uint32_t uHeight = regPart.getHeightInVoxels();
+		const uint32_t uDepth = regPart.getDepthInVoxels();
+		const bool bLinear = (layout.getOrder() == BufferOrders::Linear);
+
+		// This is counted as a change even if it turns out that no voxels are changed, as it would be by setVoxel().
+		recordWrite(pChunk);
+
+		if (pChunk->isUniform())
+		{
+			// Writing the value the chunk already holds changes nothing, and we can avoid giving the chunk any voxel data.
+			bool bChangesChunk = false;
+			for (uint32_t z = 0; (z < uDepth) && !bChangesChunk; z++)
+			{
+				for (uint32_t y = 0; (y < uHeight) && !bChangesChunk; y++)
+				{
+					for (uint32_t x = 0; (x < uWidth) && !bChangesChunk; x++)
+					{
+						bChangesChunk = !(pSrcBuffer[layout.getIndex(regWrite, uBufferX + x, uBufferY + y, uBufferZ + z)] == pChunk->m_tUniformValue);
+					}
+				}
+			}
+
+			if (!bChangesChunk)
+			{
+				return;
+			}
+
+			// The existing value only needs filling in if some of it will survive.
+			const bool bWholeChunk = (uWidth == m_uChunkSideLength) && (uHeight == m_uChunkSideLength) && (uDepth == m_uChunkSideLength);
+			pChunk->allocateData(!bWholeChunk);
+		}
+		else if (pChunk->hasPalette())
+		{
+			// It is simplest to write into the full voxel data, and convert back to a palette afterwards.
+			pChunk->convertPaletteToData();
+		}
+		else
+		{
+			pChunk->detachSharedData();
+		}
+
+		VoxelType* pChunkData = pChunk->m_tData;
+		pChunk->m_bDataModified = true;
+
+		if (isWholeChunkBlock(regPart, regWrite, layout))
+		{
+			const VoxelType* pSrcBlock = pSrcBuffer + layout.getIndex(regWrite, uBufferX, uBufferY, uBufferZ);
+			std::copy(pSrcBlock, pSrcBlock + uWidth * uHeight * uDepth, pChunkData);
+		}
+		else
+		{
+			for (uint32_t z = 0; z < uDepth; z++)
+			{
+				for (uint32_t y = 0; y < uHeight; y++)
+				{
+					const uint32_t uChunkYZ = morton256_y[uChunkY + y] | morton256_z[uChunkZ + z];
+					if (bLinear)
+					{
+						const VoxelType* pSrcRow = pSrcBuffer + layout.getIndex(regWrite, uBufferX, uBufferY + y, uBufferZ + z);
+						for (uint32_t x = 0; x < uWidth; x++)
+						{
+							pChunkData[morton256_x[uChunkX + x] | uChunkYZ] = pSrcRow[x];
+						}
+					}
+					else
+					{
+						const uint32_t uBufferYZ = morton256_y[uBufferY + y] | morton256_z[uBufferZ + z];
+						for (uint32_t x = 0; x < uWidth; x++)
+						{
+							pChunkData[morton256_x[uChunkX + x] | uChunkYZ] = pSrcBuffer[morton256_x[uBufferX + x] | uBufferYZ];
+						}
+					}
+				}
+			}
+		}
+
+		// In palette mode the chunk can be converted back, as long as the pin we hold is the only one (so no Sampler is pointing into the data).
+		if (pChunk->m_bUsePalette && (pChunk->m_uPinCount <= 1))
+		{
+			pChunk->compactData();
+		}
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::getChunkForCurrentThread(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, bool& bMustRelease) const
+	{
+		const uint32_t uThreadId = ThreadRegistry::getCurrentThreadId();
+		ThreadCacheSlot& slot = m_arrayThreadCacheSlots[uThreadId % uNoOfThreadCacheSlots];
+
+		// Claim the slot if nobody else has. Only the owning thread ever touches the rest of the slot's contents.
+		uint32_t uOwnerThreadId = slot.m_uOwnerThreadId.load(std::memory_order_acquire);
+		if (uOwnerThreadId == 0)
+		{
+			slot.m_uOwnerThreadId.compare_exchange_strong(uOwnerThreadId, uThreadId, std::memory_order_acq_rel);
+			uOwnerThreadId = slot.m_uOwnerThreadId.load(std::memory_order_acquire);
+		}
+
+		if (uOwnerThreadId != uThreadId)
+		{
+			// Another thread owns this slot, so we have to pin the chunk just for the duration of this access.
+			bMustRelease = true;
+			return acquireChunk(iChunkX, iChunkY, iChunkZ);
+		}
+
+		bMustRelease = false;
+		if (slot.m_pChunk && (slot.m_iChunkX == iChunkX) && (slot.m_iChunkY == iChunkY) && (slot.m_iChunkZ == iChunkZ))
+		{
+			return slot.m_pChunk;
+		}
+
+		// Pin the new chunk before releasing the old one, in case they are the same.
+		Chunk* pChunk = acquireChunk(iChunkX, iChunkY, iChunkZ);
+		if (slot.m_pChunk)
+		{
+			releaseChunk(slot.m_pChunk);
+		}
+		slot.m_pChunk = pChunk;
+		slot.m_iChunkX = iChunkX;
+		slot.m_iChunkY = iChunkY;
+		slot.m_iChunkZ = iChunkZ;
+		return pChunk;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The exiting thread's id may be handed to a new thread straight away, so the slot must be left empty and unclaimed.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::releaseThreadCacheSlot(uint32_t uThreadId)
+	{
+		ThreadCacheSlot& slot = m_arrayThreadCacheSlots[uThreadId % uNoOfThreadCacheSlots];
+		if (slot.m_uOwnerThreadId.load(std::memory_order_acquire) == uThreadId)
+		{
+			if (slot.m_pChunk)
+			{
+				releaseChunk(slot.m_pChunk);
+				slot.m_pChunk = nullptr;
+			}
+			slot.m_uOwnerThreadId.store(0, std::memory_order_release);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::removeAllChunks(bool bIncludePinned)
+	{
+		// Clear this pointer as the chunks are about to be removed.
+		m_pLastAccessedChunk = nullptr;
+
+		// The calling thread's cache can always be cleared. Other threads' caches are only cleared when everything is
+		// being removed, as in that case we know there should not be any other threads still using the volume.
+		if (m_bConcurrentAccess)
+		{
+			for (uint32_t uSlot = 0; uSlot < uNoOfThreadCacheSlots; uSlot++)
+			{
+				ThreadCacheSlot& slot = m_arrayThreadCacheSlots[uSlot];
+				if ((bIncludePinned || (slot.m_uOwnerThreadId == ThreadRegistry::getCurrentThreadId())) && slot.m_pChunk)
+				{
+					releaseChunk(slot.m_pChunk);
+					slot.m_pChunk = nullptr;
+				}
+			}
+		}
+
+		for (uint32_t uShard = 0; uShard < m_uNoOfShards; uShard++)
+		{
+			ChunkShard& shard = m_arrayShards[uShard];
+			auto shardLock = lockIfConcurrent(shard.m_mutex);
+
+			// Erasing a chunk may move another one back into the slot we just looked at, so only advance when nothing was erased.
+			std::vector< std::unique_ptr< Chunk > > vecErasedChunks;
+			std::vector<Chunk*> vecPinnedChunks;
+			uint32_t uIndex = 0;
+			while (uIndex <= shard.m_uChunkArrayMask)
+			{
+				Chunk* pChunk = shard.m_arrayChunks[uIndex].get();
+				if (pChunk && (bIncludePinned || (pChunk->m_uPinCount == 0)))
+				{
+					eraseChunk(shard, uIndex, false, &vecErasedChunks);
+					continue;
+				}
+
+				if (pChunk && pChunk->m_bDataModified)
+				{
+					vecPinnedChunks.push_back(pChunk);
+				}
+				uIndex++;
+			}
+
+			// The modified chunks are paged out as a batch. This is done before the shard is unlocked, so that nobody
+			// can page in an older copy of one of them in the meantime.
+			if (!vecPinnedChunks.empty())
+			{
+				auto pagerLock = lockPager();
+				pageOutBatch(vecPinnedChunks);
+				m_uNoOfModifiedChunksPagedOut += static_cast<uint32_t>(vecPinnedChunks.size());
+			}
+			pageOutChunks(vecErasedChunks);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Should be called with the prefetch mutex held.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::startPrefetchThreads(void)
+	{
+		for (uint32_t uThread = 0; uThread < uNoOfPrefetchThreads; uThread++)
+		{
+			m_vecPrefetchThreads.emplace_back(&PagedVolume<VoxelType>::runPrefetchThread, this);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::stopPrefetchThreads(void)
+	{
+		{
+			std::lock_guard<std::mutex> prefetchLock(m_prefetchMutex);
+			m_bStopPrefetchThreads = true;
+
+			// Anything still queued is treated as cancelled, so that nobody waiting on a request is left waiting forever.
+			while (!m_queuePrefetchWork.empty())
+			{
+				const PrefetchWorkItem& workItem = m_queuePrefetchWork.top();
+				workItem.pRequest->cancel();
+				workItem.pRequest->chunkDone();
+				m_queuePrefetchWork.pop();
+			}
+		}
+		m_prefetchCondition.notify_all();
+
+		for (std::thread& thread : m_vecPrefetchThreads)
+		{
+			thread.join();
+		}
+		m_vecPrefetchThreads.clear();
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::runPrefetchThread(void)
+	{
+		for (;;)
+		{
+			PrefetchWorkItem workItem;
+			{
+				std::unique_lock<std::mutex> prefetchLock(m_prefetchMutex);
+				m_prefetchCondition.wait(prefetchLock, [this]() { return m_bStopPrefetchThreads || !m_queuePrefetchWork.empty(); });
+				if (m_bStopPrefetchThreads)
+				{
+					return;
+				}
+
+				workItem = m_queuePrefetchWork.top();
+				m_queuePrefetchWork.pop();
+			}
+
+			std::exception_ptr pException = nullptr;
+			if (!workItem.pRequest->isCancelled())
+			{
+				try
+				{
+					prefetchChunk(workItem.iChunkX, workItem.iChunkY, workItem.iChunkZ);
+				}
+				catch (...)
+				{
+					pException = std::current_exception();
+				}
+			}
+			workItem.pRequest->chunkDone(pException);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::prefetchChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ)
+	{
+		const Vector3DInt32 v3dChunkPos(iChunkX, iChunkY, iChunkZ);
+		prefetchChunks(&v3dChunkPos, 1);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::prefetchChunks(const Vector3DInt32* pChunkPositions, uint32_t uNoOfChunks)
+	{
+		// Nothing to do for chunks which are already resident, other than treating this as an access for the purpose of eviction.
+		std::vector<Vector3DInt32> vecMissingChunkPositions;
+		for (uint32_t uChunk = 0; uChunk < uNoOfChunks; uChunk++)
+		{
+			const Vector3DInt32& v3dPos = pChunkPositions[uChunk];
+			const uint32_t uHash = hashChunkPosition(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+			ChunkShard& shard = getShard(uHash);
+
+			auto shardLock = lockIfConcurrent(shard.m_mutex);
+			uint32_t uIndex = findChunkIndex(shard, uHash, v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+			if (uIndex <= shard.m_uChunkArrayMask)
+			{
+				touchChunk(shard, shard.m_arrayChunks[uIndex].get());
+			}
+			else
+			{
+				vecMissingChunkPositions.push_back(v3dPos);
+			}
+		}
+
+		if (vecMissingChunkPositions.empty())
+		{
+			return;
+		}
+
+		// Make space for the new chunks first, as findOrCreateChunk() does, so that the volume does not go over its limit while
+		// they are being paged in. This also means that (without other threads) inserting them does not evict anything, which
+		// would make the count of modified chunks paged out change and force them down the slow path below.
+		std::vector<uint32_t> vecNoOfNewChunksPerShard(m_uNoOfShards, 0);
+		for (auto iter = vecMissingChunkPositions.begin(); iter != vecMissingChunkPositions.end(); iter++)
+		{
+			const uint32_t uHash = hashChunkPosition(iter->getX(), iter->getY(), iter->getZ());
+			vecNoOfNewChunksPerShard[&getShard(uHash) - m_arrayShards.get()]++;
+		}
+		for (uint32_t uShard = 0; uShard < m_uNoOfShards; uShard++)
+		{
+			ChunkShard& shard = m_arrayShards[uShard];
+			auto shardLock = lockIfConcurrent(shard.m_mutex);
+			while ((vecNoOfNewChunksPerShard[uShard] > 0) && isShardFull(shard, vecNoOfNewChunksPerShard[uShard]))
+			{
+				if (!evictChunk(shard))
+				{
+					break;
+				}
+			}
+		}
+
+		// Page the chunks in without holding the shard locks, so that other threads can carry on using the shards in the meantime.
+		// Those which were evicted recently may still be in memory, and the rest are given to the pager as a single batch.
+		std::vector< std::unique_ptr< Chunk > > vecChunks(vecMissingChunkPositions.size());
+		std::vector<uint32_t> vecNoOfModifiedChunksPagedOut(vecMissingChunkPositions.size(), 0);
+		std::vector<uint32_t*> vecCountPointers(vecMissingChunkPositions.size());
+		for (uint32_t uChunk = 0; uChunk < vecChunks.size(); uChunk++)
+		{
+			vecCountPointers[uChunk] = &vecNoOfModifiedChunksPagedOut[uChunk];
+			vecChunks[uChunk].reset(takeEvictedChunk(vecMissingChunkPositions[uChunk], vecCountPointers[uChunk]));
+		}
+
+		{
+			auto pagerLock = lockPager();
+			std::vector<typename Pager::BatchEntry> vecBatch;
+			for (uint32_t uChunk = 0; uChunk < vecChunks.size(); uChunk++)
+			{
+				if (!vecChunks[uChunk])
+				{
+					vecChunks[uChunk].reset(takeQueuedPageOutWithPagerLock(vecMissingChunkPositions[uChunk], vecCountPointers[uChunk]));
+				}
+				if (!vecChunks[uChunk])
+				{
+					Chunk* pChunk = new PagedVolume<VoxelType>::Chunk(vecMissingChunkPositions[uChunk], m_uChunkSideLength, m_pPager, m_pChunkDataPool.get(), false, m_bPaletteStorageEnabled);
+					vecChunks[uChunk].reset(pChunk);
+
+					// The Pager is about to overwrite any data it asks for, so there is no need to fill it.
+					pChunk->m_bPagingIn = true;
+					typename Pager::BatchEntry entry = { pChunk->calculateRegion(), pChunk };
+					vecBatch.push_back(entry);
+				}
+			}
+
+			if (!vecBatch.empty())
+			{
+				try
+				{
+					m_pPager->pageInBatch(vecBatch);
+				}
+				catch (...)
+				{
+					// The chunks are only partly paged in, so they must not be paged out again when they are destroyed.
+					for (auto iter = vecBatch.begin(); iter != vecBatch.end(); iter++)
+					{
+						iter->pChunk->m_bPagingIn = false;
+						iter->pChunk->m_bDataModified = false;
+					}
+					throw;
+				}
+
+				for (auto iter = vecBatch.begin(); iter != vecBatch.end(); iter++)
+				{
+					iter->pChunk->m_bPagingIn = false;
+					iter->pChunk->m_bDataModified = false;
+					if (m_bPaletteStorageEnabled)
+					{
+						iter->pChunk->compactData();
+					}
+				}
+			}
+		}
+
+		for (uint32_t uChunk = 0; uChunk < vecChunks.size(); uChunk++)
+		{
+			insertPrefetchedChunk(vecChunks[uChunk], vecNoOfModifiedChunksPagedOut[uChunk]);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::insertPrefetchedChunk(std::unique_ptr< Chunk >& pChunk, uint32_t uNoOfModifiedChunksPagedOut)
+	{
+		const Vector3DInt32& v3dPos = pChunk->m_v3dChunkSpacePosition;
+		const int32_t iChunkX = v3dPos.getX();
+		const int32_t iChunkY = v3dPos.getY();
+		const int32_t iChunkZ = v3dPos.getZ();
+		const uint32_t uHash = hashChunkPosition(iChunkX, iChunkY, iChunkZ);
+		ChunkShard& shard = getShard(uHash);
+
+		// Another thread may have paged in the same chunk while we were working, in which case we discard ours
+		// (it is unmodified, so this does not call the pager). If a modified chunk has been paged out in the meantime then it
+		// may have been this one, and our copy could be out of date. This is rare, so we just fall back on the normal path. A
+		// chunk which was taken back from the page-out queue is always the latest version, so is not affected by either case.
+		auto shardLock = lockIfConcurrent(shard.m_mutex);
+		if (findChunkIndex(shard, uHash, iChunkX, iChunkY, iChunkZ) <= shard.m_uChunkArrayMask)
+		{
+			POLYVOX_ASSERT(!pChunk->m_bDataModified, "A chunk taken back from the page-out queue should not already be resident.");
+			pChunk.reset();
+			return;
+		}
+		if (!pChunk->m_bDataModified && (uNoOfModifiedChunksPagedOut != m_uNoOfModifiedChunksPagedOut))
+		{
+			pChunk.reset();
+			findOrCreateChunk(shard, uHash, iChunkX, iChunkY, iChunkZ);
+			return;
+		}
+
+		while (isShardFull(shard, 1))
+		{
+			if (!evictChunk(shard))
+			{
+				POLYVOX_LOG_WARNING("All chunks are pinned, so the memory usage limit cannot be respected.");
+				m_uNoOfChunkLimitOverruns++;
+				break;
+			}
+		}
+		insertChunk(shard, uHash, pChunk.release());
+	}
+
+	template <typename VoxelType>
+	std::unique_lock<std::mutex> PagedVolume<VoxelType>::lockIfConcurrent(std::mutex& mutex) const
+	{
+		return m_bConcurrentAccess ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+	}
+
+	template <typename VoxelType>
+	std::unique_lock<std::mutex> PagedVolume<VoxelType>::lockPager(void) const
+	{
+		return (m_bConcurrentAccess || m_bWriteBehindEnabled) ? std::unique_lock<std::mutex>(m_pagerMutex) : std::unique_lock<std::mutex>();
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::createChunk(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ, uint32_t* pNoOfModifiedChunksPagedOut) const
+	{
+		Vector3DInt32 v3dChunkPos(iChunkX, iChunkY, iChunkZ);
+
+		Chunk* pChunk = takeEvictedChunk(v3dChunkPos, pNoOfModifiedChunksPagedOut);
+		if (pChunk)
+		{
+			return pChunk;
+		}
+
+		auto pagerLock = lockPager();
+		pChunk = takeQueuedPageOutWithPagerLock(v3dChunkPos, pNoOfModifiedChunksPagedOut);
+		if (pChunk)
+		{
+			return pChunk;
+		}
+
+		return new PagedVolume<VoxelType>::Chunk(v3dChunkPos, m_uChunkSideLength, m_pPager, m_pChunkDataPool.get(), true, m_bPaletteStorageEnabled);
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::takeEvictedChunk(const Vector3DInt32& v3dChunkPos, uint32_t*& pNoOfModifiedChunksPagedOut) const
+	{
+		// Chunks in the compressed tier are the most recently evicted, so are the most likely to be needed again. Anything
+		// which enters the compressed tier is counted when it does so, so when the tier is enabled this is the place to
+		// record how many chunks have been paged out. Anything which moves on to the page-out queue or the pager after
+		// this point will also be counted, so there is no need to record the count again.
+		if (m_pCompressor)
+		{
+			Chunk* pChunk = takeCompressedChunk(v3dChunkPos, pNoOfModifiedChunksPagedOut);
+			if (pChunk)
+			{
+				return pChunk;
+			}
+			pNoOfModifiedChunksPagedOut = nullptr;
+		}
+
+		// Check the page-out queue next. If the chunk is there then we can have it back without waiting for the pager. Note
+		// that a chunk only leaves the queue (other than this way) while the pager lock is held, so if it is not found we
+		// know that any write of it has either finished or will do so before we get the pager lock.
+		if (m_bWriteBehindEnabled)
+		{
+			return takeQueuedPageOut(v3dChunkPos, nullptr);
+		}
+
+		return nullptr;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Should be called with the pager lock held.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::takeQueuedPageOutWithPagerLock(const Vector3DInt32& v3dChunkPos, uint32_t* pNoOfModifiedChunksPagedOut) const
+	{
+		// Check again with the pager lock held, in case the chunk was queued in the meantime. That can only happen if another thread
+		// had it resident, which is only possible when prefetching (which is why the count of chunks paged out is recorded here).
+		if (m_bWriteBehindEnabled)
+		{
+			return takeQueuedPageOut(v3dChunkPos, pNoOfModifiedChunksPagedOut);
+		}
+
+		if (pNoOfModifiedChunksPagedOut)
+		{
+			*pNoOfModifiedChunksPagedOut = m_uNoOfModifiedChunksPagedOut;
+		}
+		return nullptr;
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::pageOutChunk(std::unique_ptr< Chunk >& pChunk) const
+	{
+		if (m_bWriteBehindEnabled && queuePageOut(pChunk))
+		{
+			return;
+		}
+
+		// The lock is declared first so that it is released last.
+		std::unique_lock<std::mutex> pagerLock = lockPager();
+		std::unique_ptr< Chunk > pChunkToPageOut = std::move(pChunk);
+		m_uNoOfModifiedChunksPagedOut++;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Compares two chunk positions by the Morton code which would be formed by interleaving the bits of their coordinates (with x in
+	/// the lowest bit), but without actually forming it. The axis on which the positions differ in the most significant bit decides
+	/// the order. The sign bits are flipped so that negative coordinates come before positive ones.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::isBeforeInMortonOrder(const Vector3DInt32& v3dLhs, const Vector3DInt32& v3dRhs)
+	{
+		uint32_t uDecidingLhs = 0;
+		uint32_t uDecidingRhs = 0;
+		uint32_t uDecidingDifference = 0;
+
+		// Going from z to x means that in a tie for the most significant bit the higher axis wins, as it does in the Morton code.
+		for (int i = 2; i >= 0; i--)
+		{
+			const uint32_t uLhs = static_cast<uint32_t>(v3dLhs.getElement(i)) ^ 0x80000000u;
+			const uint32_t uRhs = static_cast<uint32_t>(v3dRhs.getElement(i)) ^ 0x80000000u;
+			const uint32_t uDifference = uLhs ^ uRhs;
+
+			// True if the highest set bit of uDifference is above that of uDecidingDifference.
+			if ((uDecidingDifference < uDifference) && (uDecidingDifference < (uDecidingDifference ^ uDifference)))
+			{
+				uDecidingLhs = uLhs;
+				uDecidingRhs = uRhs;
+				uDecidingDifference = uDifference;
+			}
+		}
+
+		return uDecidingLhs < uDecidingRhs;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Should be called with the pager lock held. The chunks are sorted into Morton order.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::pageOutBatch(std::vector<Chunk*>& vecChunks) const
+	{
+		std::sort(vecChunks.begin(), vecChunks.end(), [](const Chunk* pLhs, const Chunk* pRhs)
+		{
+			return isBeforeInMortonOrder(pLhs->m_v3dChunkSpacePosition, pRhs->m_v3dChunkSpacePosition);
+		});
+
+		std::vector<typename Pager::BatchEntry> vecBatch;
+		vecBatch.reserve(vecChunks.size());
+		for (auto iter = vecChunks.begin(); iter != vecChunks.end(); iter++)
+		{
+			POLYVOX_ASSERT((*iter)->m_bDataModified, "Only modified chunks should be paged out.");
+			typename Pager::BatchEntry entry = { (*iter)->calculateRegion(), *iter };
+			vecBatch.push_back(entry);
+		}
+
+		if (!vecBatch.empty())
+		{
+			m_pPager->pageOutBatch(vecBatch);
+		}
+
+		// The pager now has the latest data, so there is no need to page them out again unless they change.
+		for (auto iter = vecChunks.begin(); iter != vecChunks.end(); iter++)
+		{
+			(*iter)->m_bDataModified = false;
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::pageOutChunks(std::vector< std::unique_ptr< Chunk > >& vecChunks) const
+	{
+		// Anything which fits on the page-out queue is left to the writer thread, which batches up whatever it finds there.
+		if (m_bWriteBehindEnabled)
+		{
+			for (auto iter = vecChunks.begin(); iter != vecChunks.end(); iter++)
+			{
+				queuePageOut(*iter);
+			}
+			vecChunks.erase(std::remove(vecChunks.begin(), vecChunks.end(), nullptr), vecChunks.end());
+		}
+
+		if (vecChunks.empty())
+		{
+			return;
+		}
+
+		// The lock is declared first so that it is released last.
+		std::unique_lock<std::mutex> pagerLock = lockPager();
+		std::vector< std::unique_ptr< Chunk > > vecChunksToPageOut(std::move(vecChunks));
+		vecChunks.clear();
+
+		std::vector<Chunk*> vecBatch;
+		for (auto iter = vecChunksToPageOut.begin(); iter != vecChunksToPageOut.end(); iter++)
+		{
+			vecBatch.push_back(iter->get());
+		}
+		pageOutBatch(vecBatch);
+		m_uNoOfModifiedChunksPagedOut += static_cast<uint32_t>(vecBatch.size());
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::takeQueuedPageOut(const Vector3DInt32& v3dChunkPos, uint32_t* pNoOfModifiedChunksPagedOut) const
+	{
+		std::lock_guard<std::mutex> pageOutLock(m_pageOutMutex);
+		if (pNoOfModifiedChunksPagedOut)
+		{
+			*pNoOfModifiedChunksPagedOut = m_uNoOfModifiedChunksPagedOut;
+		}
+
+		auto iter = m_mapPendingPageOuts.find(v3dChunkPos);
+		if (iter == m_mapPendingPageOuts.end())
+		{
+			return nullptr;
+		}
+
+		// It keeps its modified flag, so it will be queued again when it is next evicted. Its position stays in the
+		// FIFO, but the writer ignores positions which are no longer in the map.
+		Chunk* pChunk = iter->second.release();
+		m_mapPendingPageOuts.erase(iter);
+		return pChunk;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return Whether the chunk was queued. If not (because the queue is full) then the caller is still responsible for paging it out.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::queuePageOut(std::unique_ptr< Chunk >& pChunk) const
+	{
+		std::lock_guard<std::mutex> pageOutLock(m_pageOutMutex);
+
+		auto iter = m_mapPendingPageOuts.find(pChunk->m_v3dChunkSpacePosition);
+		if (iter != m_mapPendingPageOuts.end())
+		{
+			// Coalesce with the copy which is already queued. That copy is out of date so must not be paged out.
+			iter->second->m_bDataModified = false;
+			iter->second = std::move(pChunk);
+		}
+		else
+		{
+			const std::size_t uMaxNoOfPendingPageOuts = m_uChunkCountLimit / 4;
+			if (m_mapPendingPageOuts.size() >= uMaxNoOfPendingPageOuts)
+			{
+				return false;
+			}
+
+			m_queuePendingPageOuts.push_back(pChunk->m_v3dChunkSpacePosition);
+			m_mapPendingPageOuts[pChunk->m_v3dChunkSpacePosition] = std::move(pChunk);
+		}
+
+		m_uNoOfModifiedChunksPagedOut++;
+		m_pageOutCondition.notify_one();
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Pages out everything on the queue from the calling thread, and waits for the writer thread to finish anything it is working on.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::drainPageOutQueue(void) const
+	{
+		if (!m_bWriteBehindEnabled)
+		{
+			return;
+		}
+
+		// The writer thread holds the pager lock while it pages out, so once we have it nothing can be in progress.
+		std::lock_guard<std::mutex> pagerLock(m_pagerMutex);
+		std::vector< std::unique_ptr< Chunk > > vecChunks;
+		while (takeQueuedPageOuts(vecChunks))
+		{
+			// Other threads can carry on queuing and reclaiming chunks while these are written.
+			pageOutQueuedChunks(vecChunks);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Moves everything on the page-out queue into the given vector, in the order it was queued.
+	/// \return Whether anything was taken.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::takeQueuedPageOuts(std::vector< std::unique_ptr< Chunk > >& vecChunks) const
+	{
+		std::lock_guard<std::mutex> pageOutLock(m_pageOutMutex);
+		while (!m_queuePendingPageOuts.empty())
+		{
+			auto iter = m_mapPendingPageOuts.find(m_queuePendingPageOuts.front());
+			m_queuePendingPageOuts.pop_front();
+			if (iter != m_mapPendingPageOuts.end())
+			{
+				vecChunks.push_back(std::move(iter->second));
+				m_mapPendingPageOuts.erase(iter);
+			}
+		}
+		return !vecChunks.empty();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Should be called with the pager lock held. Chunks taken from the page-out queue have already been counted, and any which are no
+	/// longer modified (because a newer copy was queued) are simply discarded. The vector is emptied.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::pageOutQueuedChunks(std::vector< std::unique_ptr< Chunk > >& vecChunks) const
+	{
+		std::vector< std::unique_ptr< Chunk > > vecChunksToPageOut(std::move(vecChunks));
+		vecChunks.clear();
+
+		std::vector<Chunk*> vecBatch;
+		for (auto iter = vecChunksToPageOut.begin(); iter != vecChunksToPageOut.end(); iter++)
+		{
+			if ((*iter)->m_bDataModified)
+			{
+				vecBatch.push_back(iter->get());
+			}
+		}
+		pageOutBatch(vecBatch);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::runPageOutThread(void)
+	{
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> pageOutLock(m_pageOutMutex);
+				m_pageOutCondition.wait(pageOutLock, [this]() { return m_bStopPageOutThread || !m_queuePendingPageOuts.empty(); });
+				if (m_bStopPageOutThread)
+				{
+					return;
+				}
+			}
+
+			// The queue lock has to be released while the pager lock is taken, as the pager lock must always be taken first. Someone
+			// else may have emptied the queue in the meantime, in which case there is nothing to do this time round. Everything
+			// which has been queued is written as one batch.
+			std::lock_guard<std::mutex> pagerLock(m_pagerMutex);
+			std::vector< std::unique_ptr< Chunk > > vecChunks;
+			if (takeQueuedPageOuts(vecChunks))
+			{
+				pageOutQueuedChunks(vecChunks);
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::stopPageOutThread(void)
+	{
+		if (!m_pageOutThread.joinable())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> pageOutLock(m_pageOutMutex);
+			m_bStopPageOutThread = true;
+		}
+		m_pageOutCondition.notify_all();
+		m_pageOutThread.join();
+
+		// Anything the thread did not get round to is written now.
+		drainPageOutQueue();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Mixes the three components of a chunk position into a 32-bit hash. The components are reinterpreted as unsigned values
+	/// before mixing so negative chunk positions are handled naturally, and the final avalanche step (taken from MurmurHash3)
+	/// ensures that both the low bits (which select a slot) and the high bits (which select a shard) depend on every input bit.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t PagedVolume<VoxelType>::hashChunkPosition(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ)
+	{
+		uint32_t uHash = static_cast<uint32_t>(iChunkX) * 0x8da6b343u;
+		uHash ^= static_cast<uint32_t>(iChunkY) * 0xd8163841u;
+		uHash ^= static_cast<uint32_t>(iChunkZ) * 0xcb1ab31fu;
+
+		uHash ^= uHash >> 16;
+		uHash *= 0x85ebca6bu;
+		uHash ^= uHash >> 13;
+		uHash *= 0xc2b2ae35u;
+		uHash ^= uHash >> 16;
+		return uHash;
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::ChunkShard& PagedVolume<VoxelType>::getShard(uint32_t uHash) const
+	{
+		// A shift by 32 is undefined, so the single shard case is handled explicitly.
+		return m_arrayShards[(m_uNoOfShards == 1) ? 0 : (uHash >> m_uShardShift)];
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::findOrCreateChunk(ChunkShard& shard, uint32_t uHash, int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const
+	{
+		// Because the hash table is never more than half full and has no tombstones, this search only has to
+		// look at a couple of slots before it either finds the chunk or hits an empty slot which proves it is absent.
+		uint32_t uIndex = findChunkIndex(shard, uHash, iChunkX, iChunkY, iChunkZ);
+		if (uIndex <= shard.m_uChunkArrayMask)
+		{
+			Chunk* pChunk = shard.m_arrayChunks[uIndex].get();
+			touchChunk(shard, pChunk);
+			return pChunk;
+		}
+
+		// Make space for the new chunk first, so that we never hold more chunks than the limit allows. If every chunk
+		// is pinned then this is not possible, and we have no choice but to exceed the limit for now.
+		while (isShardFull(shard, 1))
+		{
+			if (!evictChunk(shard))
+			{
+				POLYVOX_LOG_WARNING("All chunks are pinned, so the memory usage limit cannot be respected.");
+				m_uNoOfChunkLimitOverruns++;
+				break;
+			}
+		}
+
+		// The chunk was not found so we will create a new one, which will page in its data.
+		Chunk* pChunk = createChunk(iChunkX, iChunkY, iChunkZ);
+
+		insertChunk(shard, uHash, pChunk);
+		return pChunk;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The index of the chunk in the shard's chunk array, or a value greater than the array mask if the chunk is not resident.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t PagedVolume<VoxelType>::findChunkIndex(const ChunkShard& shard, uint32_t uHash, int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ) const
+	{
+		uint32_t uIndex = uHash & shard.m_uChunkArrayMask;
+		while (shard.m_arrayChunks[uIndex])
+		{
+			const Vector3DInt32& entryPos = shard.m_arrayChunks[uIndex]->m_v3dChunkSpacePosition;
+			if (entryPos.getX() == iChunkX && entryPos.getY() == iChunkY && entryPos.getZ() == iChunkZ)
+			{
+				return uIndex;
+			}
+
+			uIndex = (uIndex + 1) & shard.m_uChunkArrayMask;
+		}
+
+		return shard.m_uChunkArrayMask + 1;
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::insertChunk(ChunkShard& shard, uint32_t uHash, Chunk* pChunk) const
+	{
+		// This should never really happen unless we are failing to keep our number of active chunks
+		// significantly under the target amount, such as when too many chunks have been pinned.
+		POLYVOX_THROW_IF(shard.m_uChunkCount >= shard.m_uChunkArrayMask, std::logic_error, "No space in chunk array for new chunk.");
+
+		// Store the chunk at the appropriate place in out chunk array. Ideally this place is given by
+		// the hash, otherwise we use the next available location. Keeping at least one slot empty
+		// guarantees that this search terminates.
+		uint32_t uIndex = uHash & shard.m_uChunkArrayMask;
+		while (shard.m_arrayChunks[uIndex])
+		{
+			uIndex = (uIndex + 1) & shard.m_uChunkArrayMask;
+		}
+
+		shard.m_arrayChunks[uIndex].reset(pChunk);
+		shard.m_uChunkCount++;
+
+		// In palette mode the chunk keeps the shard's record of its memory usage up to date while it is resident.
+		if (m_bPaletteStorageEnabled)
+		{
+			pChunk->updateSizeInBytes();
+			shard.m_uSizeInBytes += pChunk->m_uSizeInBytes;
+			pChunk->m_pResidentSizeInBytes = &shard.m_uSizeInBytes;
+		}
+
+		linkChunk(shard, pChunk);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::eraseChunk(ChunkShard& shard, uint32_t uIndex, bool bCompress, std::vector< std::unique_ptr< Chunk > >* pVecChunksToPageOut) const
+	{
+		POLYVOX_ASSERT(shard.m_arrayChunks[uIndex], "Attempting to erase a chunk which does not exist.");
+
+		// Take ownership of the chunk but don't destroy it until the table has been repaired, as destroying
+		// it may page it out and we want the table to be valid if that throws.
+		std::unique_ptr< Chunk > pErasedChunk = std::move(shard.m_arrayChunks[uIndex]);
+		shard.m_uChunkCount--;
+
+		if (pErasedChunk->m_pResidentSizeInBytes)
+		{
+			shard.m_uSizeInBytes -= pErasedChunk->m_uSizeInBytes;
+			pErasedChunk->m_pResidentSizeInBytes = nullptr;
+		}
+
+		unlinkChunk(shard, pErasedChunk.get());
+
+		if (!m_bConcurrentAccess && (m_pLastAccessedChunk == pErasedChunk.get()))
+		{
+			m_pLastAccessedChunk = nullptr;
+		}
+
+		// Walk forwards over the rest of the probe sequence and move back any chunk which would no longer be found now that
+		// there is a hole in front of it. A chunk can only be moved back if its ideal position is not between the hole and
+		// its current position (taking wrap-around into account).
+		uint32_t uHole = uIndex;
+		uint32_t uNext = (uHole + 1) & shard.m_uChunkArrayMask;
+		while (shard.m_arrayChunks[uNext])
+		{
+			const Vector3DInt32& v3dPos = shard.m_arrayChunks[uNext]->m_v3dChunkSpacePosition;
+			const uint32_t uIdeal = hashChunkPosition(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ()) & shard.m_uChunkArrayMask;
+			const uint32_t uDistanceToIdeal = (uNext - uIdeal) & shard.m_uChunkArrayMask;
+			const uint32_t uDistanceToHole = (uNext - uHole) & shard.m_uChunkArrayMask;
+			if (uDistanceToIdeal >= uDistanceToHole)
+			{
+				shard.m_arrayChunks[uHole] = std::move(shard.m_arrayChunks[uNext]);
+				uHole = uNext;
+			}
+
+			uNext = (uNext + 1) & shard.m_uChunkArrayMask;
+		}
+
+		if (bCompress && m_pCompressor)
+		{
+			compressChunk(pErasedChunk);
+			removeCompressedChunks(m_uCompressedTierLimitInBytes);
+		}
+		else if (pErasedChunk->m_bDataModified)
+		{
+			if (pVecChunksToPageOut)
+			{
+				pVecChunksToPageOut->push_back(std::move(pErasedChunk));
+			}
+			else
+			{
+				pageOutChunk(pErasedChunk);
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::compressChunk(std::unique_ptr< Chunk >& pChunk) const
+	{
+		auto compressedTierLock = lockIfConcurrent(m_compressedTierMutex);
+
+		// A uniform chunk is stored as just its value, without going through the compressor.
+		const uint32_t uUncompressedSize = pChunk->getDataSizeInBytes();
+		uint32_t uCompressedSize = 0;
+		if (pChunk->isUniform())
+		{
+			const VoxelType tUniformValue = pChunk->getUniformValue();
+			const uint8_t* pUniformValue = reinterpret_cast<const uint8_t*>(&tUniformValue);
+			m_vecCompressionBuffer.assign(pUniformValue, pUniformValue + sizeof(VoxelType));
+			uCompressedSize = sizeof(VoxelType);
+		}
+		else
+		{
+			m_vecCompressionBuffer.resize(m_pCompressor->getMaxCompressedSize(uUncompressedSize));
+			uCompressedSize = m_pCompressor->compress(pChunk->getData(), uUncompressedSize, m_vecCompressionBuffer.data(), static_cast<uint32_t>(m_vecCompressionBuffer.size()));
+		}
+
+		// Some data (such as noise) does not compress. There is no point keeping it in the compressed tier, so it is treated as a normal eviction.
+		if (uCompressedSize >= uUncompressedSize)
+		{
+			if (pChunk->m_bDataModified)
+			{
+				pageOutChunk(pChunk);
+			}
+			pChunk.reset();
+			return;
+		}
+
+		const Vector3DInt32 v3dChunkPos = pChunk->m_v3dChunkSpacePosition;
+		POLYVOX_ASSERT(m_mapCompressedChunks.find(v3dChunkPos) == m_mapCompressedChunks.end(), "Chunk is already in the compressed tier.");
+
+		CompressedChunk& compressedChunk = m_mapCompressedChunks[v3dChunkPos];
+		compressedChunk.vecData.assign(m_vecCompressionBuffer.begin(), m_vecCompressionBuffer.begin() + uCompressedSize);
+		compressedChunk.bDataModified = pChunk->m_bDataModified;
+		compressedChunk.bUniform = pChunk->isUniform();
+		compressedChunk.iterPosition = m_listCompressedChunks.insert(m_listCompressedChunks.end(), v3dChunkPos);
+		m_uCompressedTierSizeInBytes += uCompressedSize;
+
+		// The data now lives in the compressed tier, so the chunk must not page itself out.
+		if (pChunk->m_bDataModified)
+		{
+			m_uNoOfModifiedChunksPagedOut++;
+			pChunk->m_bDataModified = false;
+		}
+		pChunk.reset();
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::takeCompressedChunk(const Vector3DInt32& v3dChunkPos, uint32_t* pNoOfModifiedChunksPagedOut) const
+	{
+		auto compressedTierLock = lockIfConcurrent(m_compressedTierMutex);
+		if (pNoOfModifiedChunksPagedOut)
+		{
+			*pNoOfModifiedChunksPagedOut = m_uNoOfModifiedChunksPagedOut;
+		}
+
+		auto iter = m_mapCompressedChunks.find(v3dChunkPos);
+		if (iter == m_mapCompressedChunks.end())
+		{
+			return nullptr;
+		}
+
+		return decompressChunk(iter);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Should be called with the compressed tier lock held.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Chunk* PagedVolume<VoxelType>::decompressChunk(typename CompressedChunkMap::iterator iter) const
+	{
+		// The chunk gets its data from the compressed tier rather than the pager.
+		std::unique_ptr< Chunk > pChunk(new PagedVolume<VoxelType>::Chunk(iter->first, m_uChunkSideLength, m_pPager, m_pChunkDataPool.get(), false, m_bPaletteStorageEnabled));
+		const std::vector<uint8_t>& vecData = iter->second.vecData;
+		if (iter->second.bUniform)
+		{
+			VoxelType tUniformValue;
+			std::memcpy(&tUniformValue, vecData.data(), sizeof(VoxelType));
+			pChunk->setUniform(tUniformValue);
+		}
+		else
+		{
+			// The data is about to be overwritten, so there is no need to fill it first.
+			pChunk->allocateData(false);
+			m_pCompressor->decompress(vecData.data(), static_cast<uint32_t>(vecData.size()), pChunk->m_tData, pChunk->getDataSizeInBytes());
+			if (m_bPaletteStorageEnabled)
+			{
+				pChunk->compactData();
+			}
+		}
+		pChunk->m_bDataModified = iter->second.bDataModified;
+
+		m_uCompressedTierSizeInBytes -= static_cast<uint32_t>(vecData.size());
+		m_listCompressedChunks.erase(iter->second.iterPosition);
+		m_mapCompressedChunks.erase(iter);
+		return pChunk.release();
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::removeCompressedChunks(uint32_t uTargetSizeInBytes) const
+	{
+		auto compressedTierLock = lockIfConcurrent(m_compressedTierMutex);
+		std::vector< std::unique_ptr< Chunk > > vecEvictedChunks;
+		while (!m_listCompressedChunks.empty() && (m_uCompressedTierSizeInBytes > uTargetSizeInBytes))
+		{
+			auto iter = m_mapCompressedChunks.find(m_listCompressedChunks.front());
+			const bool bDataModified = iter->second.bDataModified;
+			std::unique_ptr< Chunk > pEvictedChunk(decompressChunk(iter));
+			if (bDataModified)
+			{
+				vecEvictedChunks.push_back(std::move(pEvictedChunk));
+			}
+
+			// Evicting a single chunk usually makes enough space, but when many are evicted at once (as when flushing) they are
+			// paged out in batches. The batches are limited in size as the chunks have been decompressed.
+			if (vecEvictedChunks.size() >= static_cast<std::size_t>(uMaxNoOfChunksPerBatch))
+			{
+				pageOutChunks(vecEvictedChunks);
+			}
+		}
+		pageOutChunks(vecEvictedChunks);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::linkChunk(ChunkShard& shard, Chunk* pChunk) const
+	{
+		if (!shard.m_pEvictionListHead)
+		{
+			pChunk->m_pPrevInEvictionList = pChunk;
+			pChunk->m_pNextInEvictionList = pChunk;
+			shard.m_pEvictionListHead = pChunk;
+			return;
+		}
+
+		// Insert the chunk in front of the head, which is the end of the list as far as eviction is concerned.
+		pChunk->m_pNextInEvictionList = shard.m_pEvictionListHead;
+		pChunk->m_pPrevInEvictionList = shard.m_pEvictionListHead->m_pPrevInEvictionList;
+		pChunk->m_pPrevInEvictionList->m_pNextInEvictionList = pChunk;
+		shard.m_pEvictionListHead->m_pPrevInEvictionList = pChunk;
+
+		// For LRU the new chunk is the most recently used so it becomes the head. For the clock policy the
+		// hand stays where it is, meaning the new chunk is the last one it will reach on its current sweep.
+		if (m_eEvictionPolicy == ChunkEvictionPolicies::LeastRecentlyUsed)
+		{
+			shard.m_pEvictionListHead = pChunk;
+		}
+		else
+		{
+			pChunk->m_bReferenced = true;
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::unlinkChunk(ChunkShard& shard, Chunk* pChunk) const
+	{
+		if (pChunk->m_pNextInEvictionList == pChunk)
+		{
+			// This was the only chunk in the list.
+			shard.m_pEvictionListHead = nullptr;
+		}
+		else
+		{
+			if (shard.m_pEvictionListHead == pChunk)
+			{
+				shard.m_pEvictionListHead = pChunk->m_pNextInEvictionList;
+			}
+
+			pChunk->m_pPrevInEvictionList->m_pNextInEvictionList = pChunk->m_pNextInEvictionList;
+			pChunk->m_pNextInEvictionList->m_pPrevInEvictionList = pChunk->m_pPrevInEvictionList;
+		}
+
+		pChunk->m_pPrevInEvictionList = nullptr;
+		pChunk->m_pNextInEvictionList = nullptr;
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::touchChunk(ChunkShard& shard, Chunk* pChunk) const
+	{
+		if (m_eEvictionPolicy == ChunkEvictionPolicies::LeastRecentlyUsed)
+		{
+			// Move the chunk to the most recently used position.
+			if (pChunk != shard.m_pEvictionListHead)
+			{
+				unlinkChunk(shard, pChunk);
+				linkChunk(shard, pChunk);
+			}
+		}
+		else
+		{
+			// Just give the chunk a second chance next time the clock hand reaches it.
+			pChunk->m_bReferenced = true;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Pinned chunks are skipped over. There are normally only a handful of these so eviction is still effectively constant time.
+	/// \return Whether a chunk could be evicted, which is only false if every chunk in the shard is pinned.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::evictChunk(ChunkShard& shard) const
+	{
+		if (!shard.m_pEvictionListHead)
+		{
+			return false;
+		}
+
+		Chunk* pVictim = nullptr;
+		if (m_eEvictionPolicy == ChunkEvictionPolicies::LeastRecentlyUsed)
+		{
+			// The least recently used chunk is the one before the head, so search backwards from there.
+			Chunk* pCandidate = shard.m_pEvictionListHead->m_pPrevInEvictionList;
+			for (uint32_t uCount = 0; uCount < shard.m_uChunkCount; uCount++)
+			{
+				if (pCandidate->m_uPinCount == 0)
+				{
+					pVictim = pCandidate;
+					break;
+				}
+				pCandidate = pCandidate->m_pPrevInEvictionList;
+			}
+		}
+		else
+		{
+			// Advance the clock hand until it reaches a chunk which has not been referenced since it was last visited,
+			// clearing the flags as it goes. Each flag is cleared at most once per access so this is amortised constant
+			// time. Two full sweeps are enough to clear every flag, so if we still haven't found a victim after that
+			// then every chunk must be pinned.
+			for (uint32_t uCount = 0; uCount < shard.m_uChunkCount * 2; uCount++)
+			{
+				Chunk* pCandidate = shard.m_pEvictionListHead;
+				shard.m_pEvictionListHead = pCandidate->m_pNextInEvictionList;
+
+				if (pCandidate->m_uPinCount == 0)
+				{
+					if (!pCandidate->m_bReferenced)
+					{
+						pVictim = pCandidate;
+						break;
+					}
+					pCandidate->m_bReferenced = false;
+				}
+			}
+		}
+
+		if (!pVictim)
+		{
+			return false;
+		}
+
+		const Vector3DInt32& v3dPos = pVictim->m_v3dChunkSpacePosition;
+		const uint32_t uHash = hashChunkPosition(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+		eraseChunk(shard, findChunkIndex(shard, uHash, v3dPos.getX(), v3dPos.getY(), v3dPos.getZ()));
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Calculate the memory usage of the compressed tier (which is included in the value returned by calculateSizeInBytes()).
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t PagedVolume<VoxelType>::calculateCompressedSizeInBytes(void)
+	{
+		auto compressedTierLock = lockIfConcurrent(m_compressedTierMutex);
+		return m_uCompressedTierSizeInBytes;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The voxel data of chunks is kept in a pool which is sized to suit the memory limit of the volume, so that paging chunks in
+	/// and out can reuse the data of evicted chunks rather than going back to the heap. A high proportion of misses suggests
+	/// that more chunks are resident than the memory limit allows (for example, because they are pinned by samplers).
+	/// The statistics are all zero for voxel types which need destroying, as their data is not pooled.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	SlabPool::Statistics PagedVolume<VoxelType>::getChunkDataPoolStatistics(void) const
+	{
+		return m_pChunkDataPool ? m_pChunkDataPool->getStatistics() : SlabPool::Statistics();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Chunks are pinned by Samplers (for the chunk they are currently in), by PinnedRegions, and in concurrent mode by the
+	/// record each thread keeps of the chunk it last accessed.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t PagedVolume<VoxelType>::getNoOfPinnedChunks(void) const
+	{
+		return m_uNoOfPinnedChunks;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Pinned chunks cannot be evicted, so if every chunk is pinned when another one is needed then the volume has to exceed its memory
+	/// limit. It returns to the limit as soon as enough chunks are unpinned and more are paged in. A non-zero value here means that
+	/// either the memory limit is too small for the way the volume is being used, or that pins are being held for too long.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint64_t PagedVolume<VoxelType>::getNoOfChunkLimitOverruns(void) const
+	{
+		return m_uNoOfChunkLimitOverruns;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// A typical use is to call this after rebuilding the meshes for the volume, and to pass the result to getModifiedRegionsSince()
+	/// when it is time to rebuild them again. Writes which are made from other threads while this is being called may be counted
+	/// either before or after the returned version.
+	/// \return A number which is greater than that returned by any earlier call, and less than the version of any later writes.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint64_t PagedVolume<VoxelType>::markVersion(void)
+	{
+		// Writes are stamped with the current version, so returning it and moving on means that later writes have a greater one.
+		return m_uVersion++;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Changes are tracked a chunk at a time, so the regions returned cover whole chunks even if only a single voxel was written. Writes
+	/// through setVoxel() and writeRegion() are counted, even if they did not change the value of any voxel, but direct changes to a
+	/// chunk's data (such as by a Pager) are not.
+	///
+	/// If a region size is given then the modified chunks are instead converted into regions of that size, aligned to multiples of it,
+	/// so that they match the regions which an application extracts its meshes from. Surface extractors also look at the voxels next to
+	/// the region being extracted (see the documentation of the CubicSurfaceExtractor), so a voxel on the face of a region can affect the
+	/// mesh of the neighbouring region. Setting bIncludeNeighbours grows each modified chunk by one voxel in every direction before it is
+	/// converted, so that these neighbouring regions are also returned.
+	///
+	/// \param uVersion A value previously returned by markVersion(), or zero to get every region which has been written to (and which
+	/// has not since been discarded with discardChangesUpTo()).
+	/// \param uRegionSideLength The side length of the regions to return, or zero to return the regions of the chunks themselves.
+	/// \param bIncludeNeighbours Whether to include the regions whose extraction may be affected by voxels just outside of them.
+	/// \return The modified regions, each of which is only included once, in Morton order of their positions.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	std::vector<Region> PagedVolume<VoxelType>::getModifiedRegionsSince(uint64_t uVersion, uint32_t uRegionSideLength, bool bIncludeNeighbours) const
+	{
+		std::vector<Vector3DInt32> vecChunkPositions;
+		{
+			auto journalLock = lockIfConcurrent(m_journalMutex);
+			for (auto iter = m_mapChunkVersions.begin(); iter != m_mapChunkVersions.end(); iter++)
+			{
+				if (iter->second > uVersion)
+				{
+					vecChunkPositions.push_back(iter->first);
+				}
+			}
+		}
+
+		// Without a region size the chunks are returned as they are (though grown if requested).
+		if (uRegionSideLength == 0)
+		{
+			std::sort(vecChunkPositions.begin(), vecChunkPositions.end(), &PagedVolume<VoxelType>::isBeforeInMortonOrder);
+
+			std::vector<Region> vecRegions;
+			vecRegions.reserve(vecChunkPositions.size());
+			for (auto iter = vecChunkPositions.begin(); iter != vecChunkPositions.end(); iter++)
+			{
+				Region regChunk(*iter * static_cast<int32_t>(m_uChunkSideLength), *iter * static_cast<int32_t>(m_uChunkSideLength) + Vector3DInt32(m_iChunkMask, m_iChunkMask, m_iChunkMask));
+				if (bIncludeNeighbours)
+				{
+					regChunk.grow(1);
+				}
+				vecRegions.push_back(regChunk);
+			}
+			return vecRegions;
+		}
+
+		const int32_t iRegionSideLength = static_cast<int32_t>(uRegionSideLength);
+		std::vector<Vector3DInt32> vecRegionPositions;
+		for (auto iter = vecChunkPositions.begin(); iter != vecChunkPositions.end(); iter++)
+		{
+			Region regChunk(*iter * static_cast<int32_t>(m_uChunkSideLength), *iter * static_cast<int32_t>(m_uChunkSideLength) + Vector3DInt32(m_iChunkMask, m_iChunkMask, m_iChunkMask));
+			if (bIncludeNeighbours)
+			{
+				regChunk.grow(1);
+			}
+
+			for (int32_t z = divideRoundingDown(regChunk.getLowerZ(), iRegionSideLength); z <= divideRoundingDown(regChunk.getUpperZ(), iRegionSideLength); z++)
+			{
+				for (int32_t y = divideRoundingDown(regChunk.getLowerY(), iRegionSideLength); y <= divideRoundingDown(regChunk.getUpperY(), iRegionSideLength); y++)
+				{
+					for (int32_t x = divideRoundingDown(regChunk.getLowerX(), iRegionSideLength); x <= divideRoundingDown(regChunk.getUpperX(), iRegionSideLength); x++)
+					{
+						vecRegionPositions.push_back(Vector3DInt32(x, y, z));
+					}
+				}
+			}
+		}
+
+		// Neighbouring chunks often fall into the same region.
+		std::sort(vecRegionPositions.begin(), vecRegionPositions.end(), &PagedVolume<VoxelType>::isBeforeInMortonOrder);
+		vecRegionPositions.erase(std::unique(vecRegionPositions.begin(), vecRegionPositions.end()), vecRegionPositions.end());
+
+		std::vector<Region> vecRegions;
+		vecRegions.reserve(vecRegionPositions.size());
+		for (auto iter = vecRegionPositions.begin(); iter != vecRegionPositions.end(); iter++)
+		{
+			vecRegions.push_back(Region(*iter * iRegionSideLength, *iter * iRegionSideLength + Vector3DInt32(iRegionSideLength - 1, iRegionSideLength - 1, iRegionSideLength - 1)));
+		}
+		return vecRegions;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The volume keeps an entry for every chunk which has been written to, so that it can report changes since any earlier version.
+	/// An application which no longer needs to ask about changes at or before a version can call this to free the entries of chunks
+	/// which have not been written to since then. Later calls to getModifiedRegionsSince() with that version or any later one are not
+	/// affected, but calls with an earlier version will no longer include those chunks.
+	/// \param uVersion A value previously returned by markVersion().
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::discardChangesUpTo(uint64_t uVersion)
+	{
+		auto journalLock = lockIfConcurrent(m_journalMutex);
+		for (auto iter = m_mapChunkVersions.begin(); iter != m_mapChunkVersions.end();)
+		{
+			// A chunk which is still stamped with one of these versions will be added back to the journal when it is next written to,
+			// because the current version is always greater.
+			if (iter->second <= uVersion)
+			{
+				iter = m_mapChunkVersions.erase(iter);
+			}
+			else
+			{
+				iter++;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Calculate the memory usage of the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t PagedVolume<VoxelType>::calculateSizeInBytes(void)
+	{
+		uint32_t uChunkCount = 0;
+		for (uint32_t uShard = 0; uShard < m_uNoOfShards; uShard++)
+		{
+			auto shardLock = lockIfConcurrent(m_arrayShards[uShard].m_mutex);
+			uChunkCount += m_arrayShards[uShard].m_uChunkCount;
+		}
+
+		// Chunks waiting to be paged out are still using memory.
+		if (m_bWriteBehindEnabled)
+		{
+			std::lock_guard<std::mutex> pageOutLock(m_pageOutMutex);
+			uChunkCount += static_cast<uint32_t>(m_mapPendingPageOuts.size());
+		}
+
+		// In palette mode the chunks are of different sizes, and the shards keep track of the total.
+		if (m_bPaletteStorageEnabled)
+		{
+			uint32_t uSizeInBytes = 0;
+			for (uint32_t uShard = 0; uShard < m_uNoOfShards; uShard++)
+			{
+				uSizeInBytes += m_arrayShards[uShard].m_uSizeInBytes;
+			}
+
+			if (m_bWriteBehindEnabled)
+			{
+				std::lock_guard<std::mutex> pageOutLock(m_pageOutMutex);
+				for (auto iter = m_mapPendingPageOuts.begin(); iter != m_mapPendingPageOuts.end(); iter++)
+				{
+					uSizeInBytes += iter->second->calculateSizeInBytes();
+				}
+			}
+
+			return uSizeInBytes + calculateCompressedSizeInBytes();
 		}
 
 		// Note: We disregard the size of the other class members as they are likely to be very small compared to the size of the
 		// allocated voxel data. This also keeps the reported size as a power of two, which makes other memory calculations easier.
-		return PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(m_uChunkSideLength) * uChunkCount;
+		return PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(m_uChunkSideLength) * uChunkCount + calculateCompressedSizeInBytes();
 	}
 }
 
@@ -29,12 +29,31 @@ namespace PolyVox
 {
 	template <typename VoxelType>
 	PagedVolume<VoxelType>::Chunk::Chunk(Vector3DInt32 v3dPosition, uint16_t uSideLength, Pager* pPager)
-		:m_uChunkLastAccessed(0)
+		:Chunk(v3dPosition, uSideLength, pPager, nullptr, true)
+	{
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::Chunk::Chunk(Vector3DInt32 v3dPosition, uint16_t uSideLength, Pager* pPager, SlabPool* pDataPool, bool bPageIn, bool bUsePalette)
+		:m_pPrevInEvictionList(nullptr)
+		, m_pNextInEvictionList(nullptr)
+		, m_bReferenced(false)
+		, m_uPinCount(0)
 		, m_bDataModified(true)
 		, m_tData(0)
+		, m_tUniformValue()
+		, m_uPaletteIndexBitsPower(0)
+		, m_bUsePalette(bUsePalette)
+		, m_pResidentSizeInBytes(nullptr)
+		, m_uSizeInBytes(0)
+		, m_bPagingIn(false)
 		, m_uSideLength(0)
 		, m_uSideLengthPower(0)
 		, m_pPager(pPager)
+		, m_pDataPool(pDataPool)
+		, m_bPagingOut(false)
+		, m_uVersion(0)
+		, m_bExternalData(false)
 		, m_v3dChunkSpacePosition(v3dPosition)
 	{
 		POLYVOX_ASSERT(m_pPager, "No valid pager supplied to chunk constructor.");
@@ -44,21 +63,24 @@ namespace PolyVox
 		m_uSideLength = uSideLength;
 		m_uSideLengthPower = logBase2(uSideLength);
 
-		// Allocate the data
-		const uint32_t uNoOfVoxels = m_uSideLength * m_uSideLength * m_uSideLength;
-		m_tData = new VoxelType[uNoOfVoxels];
+		// No data is allocated yet. The chunk starts off uniform, and the Pager can either keep it that way
+		// by calling setUniform() or cause the data to be allocated by calling getData().
 
 		// Pass the chunk to the Pager to give it a chance to initialise it with any data
-		// From the coordinates of the chunk we deduce the coordinates of the contained voxels.
-		Vector3DInt32 v3dLower = m_v3dChunkSpacePosition * static_cast<int32_t>(m_uSideLength);
-		Vector3DInt32 v3dUpper = v3dLower + Vector3DInt32(m_uSideLength - 1, m_uSideLength - 1, m_uSideLength - 1);
-		Region reg(v3dLower, v3dUpper);
+		Region reg = calculateRegion();
 
 		// A valid pager is normally present - this check is mostly to ease unit testing.
-		if (m_pPager)
+		if (m_pPager && bPageIn)
 		{
-			// Page the data in
+			// Page the data in. The Pager is about to overwrite any data it asks for, so there is no need to fill it.
+			m_bPagingIn = true;
 			m_pPager->pageIn(reg, this);
+			m_bPagingIn = false;
+
+			if (m_bUsePalette)
+			{
+				compactData();
+			}
 		}
 
 		// We'll use this later to decide if data needs to be paged out again.
@@ -67,24 +89,47 @@ namespace PolyVox
 
 	template <typename VoxelType>
 	PagedVolume<VoxelType>::Chunk::~Chunk()
+	{
+		pageOutIfModified();
+
+		freeData();
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::pageOutIfModified(void)
 	{
 		if (m_bDataModified && m_pPager)
 		{
-			// From the coordinates of the chunk we deduce the coordinates of the contained voxels.
-			Vector3DInt32 v3dLower = m_v3dChunkSpacePosition * static_cast<int32_t>(m_uSideLength);
-			Vector3DInt32 v3dUpper = v3dLower + Vector3DInt32(m_uSideLength - 1, m_uSideLength - 1, m_uSideLength - 1);
-
 			// Page the data out
-			m_pPager->pageOut(Region(v3dLower, v3dUpper), this);
+			m_bPagingOut = true;
+			m_pPager->pageOut(calculateRegion(), this);
+			m_bPagingOut = false;
 		}
 
-		delete[] m_tData;
-		m_tData = 0;
+		// The pager now has the latest data, so there is no need to page it out again unless it changes.
+		m_bDataModified = false;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// Calling this on a uniform chunk allocates its voxel data, so Pagers should check isUniform() first where possible. Similarly,
+	/// calling it on a chunk which is stored as a palette converts the chunk to full voxel data. The data may be written to, so if it
+	/// is shared with a Snapshot then the chunk may have to make its own copy first (except when it is called from Pager::pageOut()).
+	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
-	VoxelType* PagedVolume<VoxelType>::Chunk::getData(void) const
+	VoxelType* PagedVolume<VoxelType>::Chunk::getData(void)
 	{
+		if (hasPalette())
+		{
+			convertPaletteToData();
+		}
+		else if (!m_tData)
+		{
+			allocateData(!m_bPagingIn);
+		}
+		else if (!m_bPagingOut)
+		{
+			detachSharedData();
+		}
 		return m_tData;
 	}
 
@@ -94,6 +139,163 @@ namespace PolyVox
 		return m_uSideLength * m_uSideLength * m_uSideLength * sizeof(VoxelType);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return Whether every voxel in the chunk has the same value, in which case the chunk has no voxel data.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::Chunk::isUniform(void) const
+	{
+		return (m_tData == 0) && !hasPalette();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The value of every voxel in the chunk. Only meaningful if isUniform() returns true.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Chunk::getUniformValue(void) const
+	{
+		POLYVOX_ASSERT(isUniform(), "Chunk is not uniform.");
+		return m_tUniformValue;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Sets every voxel in the chunk to the given value and frees the voxel data. This is intended to be
+	/// called by a Pager from pageIn(), and must not be called while a Sampler is pointing into the chunk.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::setUniform(VoxelType tValue)
+	{
+		POLYVOX_ASSERT(m_uPinCount == 0, "Cannot make a chunk uniform while it is in use.");
+
+		freeData();
+		freePalette();
+		m_tUniformValue = tValue;
+		updateSizeInBytes();
+
+		this->m_bDataModified = true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return Whether the chunk's voxel data belongs to the Pager, as a result of setExternalData().
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::Chunk::hasExternalData(void) const
+	{
+		return m_bExternalData;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Makes the chunk use voxel data which belongs to the Pager (such as part of a memory-mapped file) rather than allocating and
+	/// filling its own. The data must be in the same (Morton) order as that returned by getData(), and must remain valid until the
+	/// chunk passes it back to Pager::releaseExternalData(). Any changes to the voxels are made directly to this data, so it must
+	/// be writable, and a Pager which needs to keep the original should provide copy-on-write memory. Like setUniform(), this is
+	/// intended to be called by a Pager from pageIn().
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::setExternalData(VoxelType* pData)
+	{
+		POLYVOX_ASSERT(pData, "External data must not be null.");
+		POLYVOX_ASSERT(m_uPinCount == 0, "Cannot change the data of a chunk while it is in use.");
+
+		freeData();
+		freePalette();
+		m_tData = pData;
+		m_bExternalData = true;
+		updateSizeInBytes();
+
+		this->m_bDataModified = true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return Whether the chunk is stored as a palette (see PagedVolume::setPaletteStorageEnabled()). Such a chunk has no voxel data of
+	/// its own until getData() is called, so a Pager may prefer to read it with getVoxel() instead.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::Chunk::hasPalette(void) const
+	{
+		return !m_vecPaletteIndices.empty();
+	}
+
+	template <typename VoxelType>
+	Region PagedVolume<VoxelType>::Chunk::calculateRegion(void) const
+	{
+		// From the coordinates of the chunk we deduce the coordinates of the contained voxels.
+		Vector3DInt32 v3dLower = m_v3dChunkSpacePosition * static_cast<int32_t>(m_uSideLength);
+		Vector3DInt32 v3dUpper = v3dLower + Vector3DInt32(m_uSideLength - 1, m_uSideLength - 1, m_uSideLength - 1);
+		return Region(v3dLower, v3dUpper);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::allocateData(bool bFillWithUniformValue)
+	{
+		const uint32_t uNoOfVoxels = m_uSideLength * m_uSideLength * m_uSideLength;
+		if (m_pDataPool)
+		{
+			// The pool is only used for voxel types which do not need destroying, so it is safe to treat the block as voxels.
+			m_tData = static_cast<VoxelType*>(m_pDataPool->allocate());
+		}
+		else
+		{
+			m_tData = new VoxelType[uNoOfVoxels];
+		}
+
+		if (bFillWithUniformValue)
+		{
+			std::fill(m_tData, m_tData + uNoOfVoxels, m_tUniformValue);
+		}
+
+		updateSizeInBytes();
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::freeData(void)
+	{
+		if (m_pSharedData)
+		{
+			// The data belongs to the snapshots now, and the last of them to go will free it.
+			m_pSharedData.reset();
+		}
+		else if (m_bExternalData)
+		{
+			// The data belongs to the pager, so it is just handed back.
+			if (m_pPager)
+			{
+				m_pPager->releaseExternalData(calculateRegion(), m_tData);
+			}
+			m_bExternalData = false;
+		}
+		else if (m_pDataPool)
+		{
+			m_pDataPool->deallocate(m_tData);
+		}
+		else
+		{
+			delete[] m_tData;
+		}
+		m_tData = 0;
+
+		updateSizeInBytes();
+	}
+
+	template <typename VoxelType>
+	VoxelType* PagedVolume<VoxelType>::Chunk::acquireScratchData(void)
+	{
+		return m_pDataPool ? static_cast<VoxelType*>(m_pDataPool->acquireScratchBuffer()) : new VoxelType[m_uSideLength * m_uSideLength * m_uSideLength];
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::releaseScratchData(VoxelType* pScratchData)
+	{
+		if (m_pDataPool)
+		{
+			m_pDataPool->releaseScratchBuffer(pScratchData);
+		}
+		else
+		{
+			delete[] pScratchData;
+		}
+	}
+
 	template <typename VoxelType>
 	VoxelType PagedVolume<VoxelType>::Chunk::getVoxel(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos) const
 	{
@@ -102,11 +304,8 @@ namespace PolyVox
 		POLYVOX_ASSERT(uXPos < m_uSideLength, "Supplied position is outside of the chunk");
 		POLYVOX_ASSERT(uYPos < m_uSideLength, "Supplied position is outside of the chunk");
 		POLYVOX_ASSERT(uZPos < m_uSideLength, "Supplied position is outside of the chunk");
-		POLYVOX_ASSERT(m_tData, "No uncompressed data - chunk must be decompressed before accessing voxels.");
 
-		uint32_t index = morton256_x[uXPos] | morton256_y[uYPos] | morton256_z[uZPos];
-
-		return m_tData[index];
+		return getVoxelAtIndex(morton256_x[uXPos] | morton256_y[uYPos] | morton256_z[uZPos]);
 	}
 
 	template <typename VoxelType>
@@ -115,6 +314,17 @@ namespace PolyVox
 		return getVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
 	}
 
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Chunk::getVoxelAtIndex(uint32_t uIndex) const
+	{
+		if (m_tData)
+		{
+			return m_tData[uIndex];
+		}
+
+		return hasPalette() ? m_vecPalette[getPaletteIndex(uIndex)] : m_tUniformValue;
+	}
+
 	template <typename VoxelType>
 	void PagedVolume<VoxelType>::Chunk::setVoxel(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos, VoxelType tValue)
 	{
@@ -123,10 +333,38 @@ namespace PolyVox
 		POLYVOX_ASSERT(uXPos < m_uSideLength, "Supplied position is outside of the chunk");
 		POLYVOX_ASSERT(uYPos < m_uSideLength, "Supplied position is outside of the chunk");
 		POLYVOX_ASSERT(uZPos < m_uSideLength, "Supplied position is outside of the chunk");
-		POLYVOX_ASSERT(m_tData, "No uncompressed data - chunk must be decompressed before accessing voxels.");
 
 		uint32_t index = morton256_x[uXPos] | morton256_y[uYPos] | morton256_z[uZPos];
 
+		// A uniform chunk only needs its own data once it stops being uniform. In palette mode it becomes a palette chunk instead.
+		if (!m_tData)
+		{
+			if (hasPalette())
+			{
+				setPaletteVoxel(index, tValue);
+				return;
+			}
+
+			if (tValue == m_tUniformValue)
+			{
+				return;
+			}
+
+			if (m_bUsePalette)
+			{
+				m_vecPalette.assign(1, m_tUniformValue);
+				setPaletteIndexBitsPower(0);
+				setPaletteVoxel(index, tValue);
+				return;
+			}
+
+			allocateData(true);
+		}
+		else if (m_pSharedData)
+		{
+			detachSharedData();
+		}
+
 		m_tData[index] = tValue;
 
 		this->m_bDataModified = true;
@@ -139,8 +377,19 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	uint32_t PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(void)
+	uint32_t PagedVolume<VoxelType>::Chunk::calculateSizeInBytes(void) const
 	{
+		if (hasPalette())
+		{
+			return static_cast<uint32_t>(m_vecPaletteIndices.size() + m_vecPalette.capacity() * sizeof(VoxelType));
+		}
+
+		// Uniform chunks and those with external data do not have any voxel data which belongs to the volume.
+		if (!m_tData || m_bExternalData)
+		{
+			return 0;
+		}
+
 		// Call through to the static version
 		return calculateSizeInBytes(m_uSideLength);
 	}
@@ -161,7 +410,15 @@ namespace PolyVox
 	template <typename VoxelType>
 	void PagedVolume<VoxelType>::Chunk::changeLinearOrderingToMorton(void)
 	{
-		VoxelType* pTempBuffer = new VoxelType[m_uSideLength * m_uSideLength * m_uSideLength];
+		// The ordering makes no difference to a uniform chunk. A palette chunk is always in Morton order, so this
+		// must be working on the raw data and we expand it first.
+		if (isUniform())
+		{
+			return;
+		}
+		getData();
+
+		VoxelType* pTempBuffer = acquireScratchData();
 
 		// We should prehaps restructure this loop. From: https://fgiesen.wordpress.com/2011/01/17/texture-tiling-and-swizzling/
 		//
@@ -188,7 +445,7 @@ namespace PolyVox
 
 		std::memcpy(m_tData, pTempBuffer, getDataSizeInBytes());
 
-		delete[] pTempBuffer;
+		releaseScratchData(pTempBuffer);
 	}
 
 	// Like the above function, this is provided fot easing backwards compatibility. In Cubiquity we have some
@@ -196,7 +453,13 @@ namespace PolyVox
 	template <typename VoxelType>
 	void PagedVolume<VoxelType>::Chunk::changeMortonOrderingToLinear(void)
 	{
-		VoxelType* pTempBuffer = new VoxelType[m_uSideLength * m_uSideLength * m_uSideLength];
+		if (isUniform())
+		{
+			return;
+		}
+		getData();
+
+		VoxelType* pTempBuffer = acquireScratchData();
 		for (uint16_t z = 0; z < m_uSideLength; z++)
 		{
 			for (uint16_t y = 0; y < m_uSideLength; y++)
@@ -212,6 +475,288 @@ namespace PolyVox
 
 		std::memcpy(m_tData, pTempBuffer, getDataSizeInBytes());
 
-		delete[] pTempBuffer;
+		releaseScratchData(pTempBuffer);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The voxel data is only shared if the chunk is not pinned by anything other than the caller, as otherwise a Sampler could
+	/// already be pointing into it and would not notice if the chunk later moved to a copy. Data which belongs to the Pager (see
+	/// setExternalData()) is always copied, as the Pager can take it back as soon as the chunk is evicted.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	std::shared_ptr<const typename PagedVolume<VoxelType>::SharedChunkData> PagedVolume<VoxelType>::Chunk::shareData(void)
+	{
+		if (m_pSharedData)
+		{
+			return m_pSharedData;
+		}
+
+		std::shared_ptr<SharedChunkData> pSharedData = std::make_shared<SharedChunkData>();
+		if (hasPalette())
+		{
+			pSharedData->m_vecPalette = m_vecPalette;
+			pSharedData->m_vecPaletteIndices = m_vecPaletteIndices;
+			pSharedData->m_uPaletteIndexBitsPower = m_uPaletteIndexBitsPower;
+		}
+		else if (!m_tData)
+		{
+			pSharedData->m_tUniformValue = m_tUniformValue;
+		}
+		else if (m_bExternalData || (m_uPinCount > 1))
+		{
+			const uint32_t uNoOfVoxels = m_uSideLength * m_uSideLength * m_uSideLength;
+			pSharedData->m_pDataPool = m_pDataPool;
+			pSharedData->m_pData = m_pDataPool ? static_cast<VoxelType*>(m_pDataPool->allocate()) : new VoxelType[uNoOfVoxels];
+			std::copy(m_tData, m_tData + uNoOfVoxels, pSharedData->m_pData);
+		}
+		else
+		{
+			pSharedData->m_pData = m_tData;
+			pSharedData->m_pDataPool = m_pDataPool;
+			m_pSharedData = pSharedData;
+		}
+		return pSharedData;
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::detachSharedData(void)
+	{
+		if (!m_pSharedData)
+		{
+			return;
+		}
+
+		if (m_pSharedData.use_count() == 1)
+		{
+			// Every snapshot which held the data has gone, so it can be taken back without copying. The fence ensures
+			// that any reads made by the snapshots (possibly on other threads) are complete before we start writing.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			m_pSharedData->m_pData = nullptr;
+		}
+		else
+		{
+			const VoxelType* pSharedVoxels = m_pSharedData->m_pData;
+			allocateData(false);
+			std::copy(pSharedVoxels, pSharedVoxels + m_uSideLength * m_uSideLength * m_uSideLength, m_tData);
+		}
+
+		m_pSharedData.reset();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Keeps the size which is reported to the owning shard (if any) up to date. Should be called whenever the storage changes.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::updateSizeInBytes(void)
+	{
+		uint32_t uNewSizeInBytes = calculateSizeInBytes();
+		if (m_pResidentSizeInBytes)
+		{
+			*m_pResidentSizeInBytes = *m_pResidentSizeInBytes - m_uSizeInBytes + uNewSizeInBytes;
+		}
+		m_uSizeInBytes = uNewSizeInBytes;
+	}
+
+	// The palette indices are packed into bytes with 1, 2, 4, or 8 bits per voxel (i.e. 2^m_uPaletteIndexBitsPower bits). This
+	// keeps the indices aligned so that none of them span two bytes, and means they can be found with just shifts and masks.
+	template <typename VoxelType>
+	uint8_t PagedVolume<VoxelType>::Chunk::getPaletteIndex(uint32_t uIndex) const
+	{
+		const uint32_t uBitPos = uIndex << m_uPaletteIndexBitsPower;
+		const uint32_t uMask = (1u << (1u << m_uPaletteIndexBitsPower)) - 1u;
+		return static_cast<uint8_t>((m_vecPaletteIndices[uBitPos >> 3] >> (uBitPos & 7)) & uMask);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::setPaletteIndex(uint32_t uIndex, uint8_t uPaletteIndex)
+	{
+		const uint32_t uBitPos = uIndex << m_uPaletteIndexBitsPower;
+		const uint32_t uShift = uBitPos & 7;
+		const uint32_t uMask = (1u << (1u << m_uPaletteIndexBitsPower)) - 1u;
+		uint8_t& uByte = m_vecPaletteIndices[uBitPos >> 3];
+		uByte = static_cast<uint8_t>((uByte & ~(uMask << uShift)) | ((uPaletteIndex & uMask) << uShift));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Changes the number of bits used by each palette index, re-encoding any existing indices. If the chunk does not yet have any
+	/// indices then they are all initialised to zero (the first palette entry).
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::setPaletteIndexBitsPower(uint8_t uBitsPower)
+	{
+		POLYVOX_ASSERT(uBitsPower <= 3, "Palette indices cannot be more than eight bits");
+
+		const uint32_t uNoOfVoxels = m_uSideLength * m_uSideLength * m_uSideLength;
+		const uint32_t uNoOfBytes = (std::max)((uNoOfVoxels << uBitsPower) >> 3, 1u);
+
+		if (m_vecPaletteIndices.empty())
+		{
+			m_vecPaletteIndices.assign(uNoOfBytes, 0);
+			m_uPaletteIndexBitsPower = uBitsPower;
+			return;
+		}
+
+		std::vector<uint8_t> vecOldIndices(uNoOfBytes, 0);
+		vecOldIndices.swap(m_vecPaletteIndices);
+		const uint8_t uOldBitsPower = m_uPaletteIndexBitsPower;
+		const uint32_t uOldMask = (1u << (1u << uOldBitsPower)) - 1u;
+
+		m_uPaletteIndexBitsPower = uBitsPower;
+		for (uint32_t uIndex = 0; uIndex < uNoOfVoxels; uIndex++)
+		{
+			const uint32_t uBitPos = uIndex << uOldBitsPower;
+			setPaletteIndex(uIndex, static_cast<uint8_t>((vecOldIndices[uBitPos >> 3] >> (uBitPos & 7)) & uOldMask));
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Writes a voxel into a chunk which is stored as a palette. The palette (and the size of the indices) grows as required, and if
+	/// it would need more than 256 entries then the chunk is converted back to full voxel data.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::setPaletteVoxel(uint32_t uIndex, VoxelType tValue)
+	{
+		if (m_vecPalette[getPaletteIndex(uIndex)] == tValue)
+		{
+			return;
+		}
+
+		this->m_bDataModified = true;
+
+		uint32_t uPaletteIndex = 0;
+		while ((uPaletteIndex < m_vecPalette.size()) && !(m_vecPalette[uPaletteIndex] == tValue))
+		{
+			uPaletteIndex++;
+		}
+
+		if (uPaletteIndex == m_vecPalette.size())
+		{
+			if (uPaletteIndex == 256)
+			{
+				convertPaletteToData();
+				m_tData[uIndex] = tValue;
+				return;
+			}
+
+			// The current index size cannot address another entry, so move to the next one up.
+			if (uPaletteIndex == (1u << (1u << m_uPaletteIndexBitsPower)))
+			{
+				setPaletteIndexBitsPower(m_uPaletteIndexBitsPower + 1);
+			}
+
+			m_vecPalette.push_back(tValue);
+		}
+
+		setPaletteIndex(uIndex, static_cast<uint8_t>(uPaletteIndex));
+		updateSizeInBytes();
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::convertPaletteToData(void)
+	{
+		POLYVOX_ASSERT(hasPalette(), "Chunk does not have a palette to convert");
+
+		allocateData(false);
+
+		const uint32_t uNoOfVoxels = m_uSideLength * m_uSideLength * m_uSideLength;
+		for (uint32_t uIndex = 0; uIndex < uNoOfVoxels; uIndex++)
+		{
+			m_tData[uIndex] = m_vecPalette[getPaletteIndex(uIndex)];
+		}
+
+		freePalette();
+		updateSizeInBytes();
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::freePalette(void)
+	{
+		std::vector<VoxelType>().swap(m_vecPalette);
+		std::vector<uint8_t>().swap(m_vecPaletteIndices);
+		m_uPaletteIndexBitsPower = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Converts full voxel data into the smallest available representation, which is either a uniform chunk or a palette with
+	/// indices of 1, 2, 4, or 8 bits. Data with more than 256 different values (or owned by the Pager) is left as it is. This
+	/// does not count as a modification, and must not be called while a sampler may be pointing into the chunk's data.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Chunk::compactData(void)
+	{
+		if (!m_tData || m_bExternalData)
+		{
+			return;
+		}
+
+		const uint32_t uNoOfVoxels = m_uSideLength * m_uSideLength * m_uSideLength;
+
+		// Neighbouring voxels are usually the same, so checking against the last value avoids most of the palette searches.
+		std::vector<VoxelType> vecPalette(1, m_tData[0]);
+		uint32_t uLastPaletteIndex = 0;
+		for (uint32_t uIndex = 1; uIndex < uNoOfVoxels; uIndex++)
+		{
+			if (m_tData[uIndex] == vecPalette[uLastPaletteIndex])
+			{
+				continue;
+			}
+
+			uLastPaletteIndex = 0;
+			while ((uLastPaletteIndex < vecPalette.size()) && !(vecPalette[uLastPaletteIndex] == m_tData[uIndex]))
+			{
+				uLastPaletteIndex++;
+			}
+
+			if (uLastPaletteIndex == vecPalette.size())
+			{
+				if (vecPalette.size() == 256)
+				{
+					return;
+				}
+				vecPalette.push_back(m_tData[uIndex]);
+			}
+		}
+
+		if (vecPalette.size() == 1)
+		{
+			m_tUniformValue = vecPalette[0];
+			freeData();
+			return;
+		}
+
+		uint8_t uBitsPower = 3;
+		if (vecPalette.size() <= 2)
+		{
+			uBitsPower = 0;
+		}
+		else if (vecPalette.size() <= 4)
+		{
+			uBitsPower = 1;
+		}
+		else if (vecPalette.size() <= 16)
+		{
+			uBitsPower = 2;
+		}
+
+		m_vecPalette.swap(vecPalette);
+		m_vecPalette.shrink_to_fit();
+		setPaletteIndexBitsPower(uBitsPower);
+
+		uLastPaletteIndex = 0;
+		for (uint32_t uIndex = 0; uIndex < uNoOfVoxels; uIndex++)
+		{
+			if (!(m_tData[uIndex] == m_vecPalette[uLastPaletteIndex]))
+			{
+				uLastPaletteIndex = 0;
+				while (!(m_vecPalette[uLastPaletteIndex] == m_tData[uIndex]))
+				{
+					uLastPaletteIndex++;
+				}
+			}
+			setPaletteIndex(uIndex, static_cast<uint8_t>(uLastPaletteIndex));
+		}
+
+		// This also updates the size.
+		freeData();
 	}
 }
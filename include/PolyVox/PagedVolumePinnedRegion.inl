@@ -0,0 +1,95 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::PinnedRegion::PinnedRegion()
+		:m_pVolume(nullptr)
+	{
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::PinnedRegion::PinnedRegion(const PagedVolume<VoxelType>* pVolume, const Region& region)
+		:m_pVolume(pVolume)
+		, m_region(region)
+	{
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::PinnedRegion::PinnedRegion(PinnedRegion&& rhs)
+		:m_pVolume(rhs.m_pVolume)
+		, m_region(rhs.m_region)
+		, m_vecChunks(std::move(rhs.m_vecChunks))
+	{
+		rhs.m_pVolume = nullptr;
+		rhs.m_vecChunks.clear();
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::PinnedRegion::~PinnedRegion()
+	{
+		release();
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::PinnedRegion& PagedVolume<VoxelType>::PinnedRegion::operator=(PinnedRegion&& rhs)
+	{
+		if (this != &rhs)
+		{
+			release();
+
+			m_pVolume = rhs.m_pVolume;
+			m_region = rhs.m_region;
+			m_vecChunks = std::move(rhs.m_vecChunks);
+
+			rhs.m_pVolume = nullptr;
+			rhs.m_vecChunks.clear();
+		}
+		return *this;
+	}
+
+	template <typename VoxelType>
+	const Region& PagedVolume<VoxelType>::PinnedRegion::getRegion(void) const
+	{
+		return m_region;
+	}
+
+	template <typename VoxelType>
+	uint32_t PagedVolume<VoxelType>::PinnedRegion::getNoOfChunks(void) const
+	{
+		return static_cast<uint32_t>(m_vecChunks.size());
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::PinnedRegion::release(void)
+	{
+		for (auto iter = m_vecChunks.begin(); iter != m_vecChunks.end(); iter++)
+		{
+			m_pVolume->releaseChunk(*iter);
+		}
+		m_vecChunks.clear();
+		m_pVolume = nullptr;
+	}
+}
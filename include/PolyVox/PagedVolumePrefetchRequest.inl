@@ -0,0 +1,98 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::PrefetchRequest::PrefetchRequest(uint32_t uNoOfChunks)
+		:m_bCancelled(false)
+		, m_uNoOfChunksRemaining(uNoOfChunks)
+		, m_pException(nullptr)
+	{
+		m_future = m_promise.get_future().share();
+
+		// An empty request is complete straight away.
+		if (uNoOfChunks == 0)
+		{
+			m_promise.set_value();
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::PrefetchRequest::cancel(void)
+	{
+		m_bCancelled = true;
+	}
+
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::PrefetchRequest::isCancelled(void) const
+	{
+		return m_bCancelled;
+	}
+
+	template <typename VoxelType>
+	bool PagedVolume<VoxelType>::PrefetchRequest::isComplete(void) const
+	{
+		return m_uNoOfChunksRemaining == 0;
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::PrefetchRequest::wait(void) const
+	{
+		m_future.wait();
+	}
+
+	template <typename VoxelType>
+	std::shared_future<void> PagedVolume<VoxelType>::PrefetchRequest::getFuture(void) const
+	{
+		return m_future;
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::PrefetchRequest::chunkDone(std::exception_ptr pException)
+	{
+		if (pException)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_pException)
+			{
+				m_pException = pException;
+			}
+		}
+
+		POLYVOX_ASSERT(m_uNoOfChunksRemaining > 0, "More chunks have been processed than were requested.");
+		if (--m_uNoOfChunksRemaining == 0)
+		{
+			// This was the last chunk, so no other thread can be touching the exception now.
+			if (m_pException)
+			{
+				m_promise.set_exception(m_pException);
+			}
+			else
+			{
+				m_promise.set_value();
+			}
+		}
+	}
+}
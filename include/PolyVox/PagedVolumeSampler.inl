@@ -25,11 +25,11 @@
 #include <array>
 
 #define CAN_GO_NEG_X(val) (val > 0)
-#define CAN_GO_POS_X(val)  (val < this->m_uChunkSideLengthMinusOne)
+#define CAN_GO_POS_X(val)  (val < this->getChunkSideLengthMinusOne())
 #define CAN_GO_NEG_Y(val) (val > 0)
-#define CAN_GO_POS_Y(val)  (val < this->m_uChunkSideLengthMinusOne)
+#define CAN_GO_POS_Y(val)  (val < this->getChunkSideLengthMinusOne())
 #define CAN_GO_NEG_Z(val) (val > 0)
-#define CAN_GO_POS_Z(val)  (val < this->m_uChunkSideLengthMinusOne)
+#define CAN_GO_POS_Z(val)  (val < this->getChunkSideLengthMinusOne())
 
 #define NEG_X_DELTA (-(deltaX[this->m_uXPosInChunk-1]))
 #define POS_X_DELTA (deltaX[this->m_uXPosInChunk])
@@ -47,53 +47,258 @@ namespace PolyVox
 	static const std::array<int32_t, 256> deltaZ = { 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 112348, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 898780, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 112348, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 7190236, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 112348, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 898780, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 112348, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4, 14044, 4, 28, 4, 220, 4, 28, 4, 1756, 4, 28, 4, 220, 4, 28, 4 };
 
 	template <typename VoxelType>
-	PagedVolume<VoxelType>::Sampler::Sampler(PagedVolume<VoxelType>* volume)
-		:BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >(volume), m_uChunkSideLengthMinusOne(volume->m_uChunkSideLength - 1)
+	template <uint16_t ChunkSideLength>
+	PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::BasicSampler(PagedVolume<VoxelType>* volume)
+		:BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >(volume)
+		, m_pVolumeExists(volume->m_pExists)
+		, m_pCurrentChunk(nullptr)
+		, mCurrentVoxel(nullptr)
+		, m_uXPosInChunk(0)
+		, m_uYPosInChunk(0)
+		, m_uZPosInChunk(0)
+		, m_uChunkSideLengthMinusOne(volume->m_uChunkSideLength - 1)
 	{
+		m_arrayNeighbourChunks.fill(nullptr);
+		POLYVOX_THROW_IF((ChunkSideLength != 0) && (volume->m_uChunkSideLength != ChunkSideLength), std::invalid_argument,
+			"Sampler chunk side length does not match that of the volume.");
 	}
 
 	template <typename VoxelType>
-	PagedVolume<VoxelType>::Sampler::~Sampler()
+	template <uint16_t ChunkSideLength>
+	PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::BasicSampler(const BasicSampler& rhs)
+		:BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >(rhs)
+		, m_pVolumeExists(rhs.m_pVolumeExists)
+		, m_pCurrentChunk(rhs.m_pCurrentChunk)
+		, mCurrentVoxel(rhs.mCurrentVoxel)
+		, m_uXPosInChunk(rhs.m_uXPosInChunk)
+		, m_uYPosInChunk(rhs.m_uYPosInChunk)
+		, m_uZPosInChunk(rhs.m_uZPosInChunk)
+		, m_uChunkSideLengthMinusOne(rhs.m_uChunkSideLengthMinusOne)
 	{
+		// The copy starts without any neighbouring chunks, and finds them again if it needs them.
+		m_arrayNeighbourChunks.fill(nullptr);
+
+		// The copy needs its own pin, as the two samplers may go on to release it at different times.
+		if (m_pCurrentChunk)
+		{
+			this->mVolume->pinChunk(m_pCurrentChunk);
+		}
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::getVoxel(void) const
+	template <uint16_t ChunkSideLength>
+	PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::~BasicSampler()
 	{
-		return *mCurrentVoxel;
+		releaseAllChunks();
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	template <uint16_t ChunkSideLength>
+	typename PagedVolume<VoxelType>::template BasicSampler<ChunkSideLength>& PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::operator=(const BasicSampler& rhs)
+	{
+		// Pin the new chunk before releasing the old one, in case they are the same.
+		if (rhs.m_pCurrentChunk)
+		{
+			rhs.mVolume->pinChunk(rhs.m_pCurrentChunk);
+		}
+		releaseAllChunks();
+
+		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::operator=(rhs);
+		m_pVolumeExists = rhs.m_pVolumeExists;
+		m_pCurrentChunk = rhs.m_pCurrentChunk;
+		mCurrentVoxel = rhs.mCurrentVoxel;
+		m_uXPosInChunk = rhs.m_uXPosInChunk;
+		m_uYPosInChunk = rhs.m_uYPosInChunk;
+		m_uZPosInChunk = rhs.m_uZPosInChunk;
+		m_uChunkSideLengthMinusOne = rhs.m_uChunkSideLengthMinusOne;
+		return *this;
+	}
+
+	template <typename VoxelType>
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::getVoxel(void) const
+	{
+		return mCurrentVoxel ? *mCurrentVoxel : peekChunk(0, 0, 0);
+	}
+
+	template <typename VoxelType>
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::setPosition(const Vector3DInt32& v3dNewPos)
 	{
 		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
 	{
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::setPosition(xPos, yPos, zPos);
 
 		// Then we update the voxel pointer
-		const int32_t uXChunk = this->mXPosInVolume >> this->mVolume->m_uChunkSideLengthPower;
-		const int32_t uYChunk = this->mYPosInVolume >> this->mVolume->m_uChunkSideLengthPower;
-		const int32_t uZChunk = this->mZPosInVolume >> this->mVolume->m_uChunkSideLengthPower;
+		const int32_t uXChunk = this->mXPosInVolume >> this->getChunkSideLengthPower();
+		const int32_t uYChunk = this->mYPosInVolume >> this->getChunkSideLengthPower();
+		const int32_t uZChunk = this->mZPosInVolume >> this->getChunkSideLengthPower();
 
-		m_uXPosInChunk = static_cast<uint16_t>(this->mXPosInVolume - (uXChunk << this->mVolume->m_uChunkSideLengthPower));
-		m_uYPosInChunk = static_cast<uint16_t>(this->mYPosInVolume - (uYChunk << this->mVolume->m_uChunkSideLengthPower));
-		m_uZPosInChunk = static_cast<uint16_t>(this->mZPosInVolume - (uZChunk << this->mVolume->m_uChunkSideLengthPower));
+		m_uXPosInChunk = static_cast<uint16_t>(this->mXPosInVolume - (uXChunk << this->getChunkSideLengthPower()));
+		m_uYPosInChunk = static_cast<uint16_t>(this->mYPosInVolume - (uYChunk << this->getChunkSideLengthPower()));
+		m_uZPosInChunk = static_cast<uint16_t>(this->mZPosInVolume - (uZChunk << this->getChunkSideLengthPower()));
 
 		uint32_t uVoxelIndexInChunk = morton256_x[m_uXPosInChunk] | morton256_y[m_uYPosInChunk] | morton256_z[m_uZPosInChunk];
 
-		auto pCurrentChunk = this->mVolume->canReuseLastAccessedChunk(uXChunk, uYChunk, uZChunk) ?
-			this->mVolume->m_pLastAccessedChunk : this->mVolume->getChunk(uXChunk, uYChunk, uZChunk);
+		// The sampler keeps the current chunk pinned, so that it is not evicted (or, in concurrent mode, evicted by another thread) while
+		// we are pointing into it. We only need to go back to the volume if we have moved into a different chunk.
+		const bool bSameChunk = m_pCurrentChunk &&
+			(m_pCurrentChunk->m_v3dChunkSpacePosition.getX() == uXChunk) &&
+			(m_pCurrentChunk->m_v3dChunkSpacePosition.getY() == uYChunk) &&
+			(m_pCurrentChunk->m_v3dChunkSpacePosition.getZ() == uZChunk);
+		if (!bSameChunk)
+		{
+			moveToChunk(uXChunk, uYChunk, uZChunk);
+		}
+
+		// Uniform and palette chunks have no data to point into, so reads go through the chunk instead (see peekChunk()). The same
+		// goes for data shared with a Snapshot, as the chunk replaces it with a copy if it is written to while the snapshot holds it.
+		mCurrentVoxel = (m_pCurrentChunk->m_tData && !m_pCurrentChunk->m_pSharedData) ? m_pCurrentChunk->m_tData + uVoxelIndexInChunk : nullptr;
+	}
+
+	template <typename VoxelType>
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekChunk(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const
+	{
+		// If the chunk is still uniform this just returns its value, and if it is a palette chunk the voxel is decoded from
+		// the palette. Otherwise someone has written to it since we entered it, and the chunk can find the voxel in its newly
+		// allocated data.
+		return m_pCurrentChunk->getVoxelAtIndex(morton256_x[m_uXPosInChunk + iXOffset] | morton256_y[m_uYPosInChunk + iYOffset] | morton256_z[m_uZPosInChunk + iZOffset]);
+	}
+
+	template <typename VoxelType>
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekNeighbourChunk(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const
+	{
+		// Work out which chunk the voxel is in, relative to the current one. The offsets are never more than one voxel.
+		const int32_t iXPos = m_uXPosInChunk + iXOffset;
+		const int32_t iYPos = m_uYPosInChunk + iYOffset;
+		const int32_t iZPos = m_uZPosInChunk + iZOffset;
+		const int32_t iXChunkOffset = (iXPos < 0) ? -1 : ((iXPos > this->getChunkSideLengthMinusOne()) ? 1 : 0);
+		const int32_t iYChunkOffset = (iYPos < 0) ? -1 : ((iYPos > this->getChunkSideLengthMinusOne()) ? 1 : 0);
+		const int32_t iZChunkOffset = (iZPos < 0) ? -1 : ((iZPos > this->getChunkSideLengthMinusOne()) ? 1 : 0);
+
+		Chunk*& pChunk = m_arrayNeighbourChunks[(iXChunkOffset + 1) + (iYChunkOffset + 1) * 3 + (iZChunkOffset + 1) * 9];
+		if (!pChunk)
+		{
+			const Vector3DInt32& v3dCurrentChunk = m_pCurrentChunk->m_v3dChunkSpacePosition;
+			pChunk = this->mVolume->acquireChunk(v3dCurrentChunk.getX() + iXChunkOffset, v3dCurrentChunk.getY() + iYChunkOffset, v3dCurrentChunk.getZ() + iZChunkOffset);
+		}
+
+		// The chunk side length is a power of two, so masking wraps the position around into the neighbouring chunk.
+		const uint16_t uMask = this->getChunkSideLengthMinusOne();
+		return pChunk->getVoxelAtIndex(morton256_x[iXPos & uMask] | morton256_y[iYPos & uMask] | morton256_z[iZPos & uMask]);
+	}
+
+	template <typename VoxelType>
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::moveToChunk(int32_t iXChunk, int32_t iYChunk, int32_t iZChunk)
+	{
+		const int32_t iXDelta = m_pCurrentChunk ? iXChunk - m_pCurrentChunk->m_v3dChunkSpacePosition.getX() : 2;
+		const int32_t iYDelta = m_pCurrentChunk ? iYChunk - m_pCurrentChunk->m_v3dChunkSpacePosition.getY() : 2;
+		const int32_t iZDelta = m_pCurrentChunk ? iZChunk - m_pCurrentChunk->m_v3dChunkSpacePosition.getZ() : 2;
+
+		if ((std::abs(iXDelta) > 1) || (std::abs(iYDelta) > 1) || (std::abs(iZDelta) > 1))
+		{
+			// Pin the new chunk before releasing the old one, in case they are the same.
+			auto pNewChunk = this->mVolume->acquireChunk(iXChunk, iYChunk, iZChunk);
+			releaseNeighbourChunks();
+			if (m_pCurrentChunk)
+			{
+				this->mVolume->releaseChunk(m_pCurrentChunk);
+			}
+			m_pCurrentChunk = pNewChunk;
+			return;
+		}
+
+		// We have moved into one of the neighbouring chunks (as samplers usually do). The chunks which are next to both the old and the
+		// new chunk keep their pins and just move to their new place in the table, and the old chunk becomes one of the neighbours. This
+		// saves having to find them all again when the kernel next reaches a chunk face.
+		std::array<Chunk*, 27> arrayOldChunks = m_arrayNeighbourChunks;
+		arrayOldChunks[13] = m_pCurrentChunk;
+		m_arrayNeighbourChunks.fill(nullptr);
+		m_pCurrentChunk = nullptr;
 
-		mCurrentVoxel = pCurrentChunk->m_tData + uVoxelIndexInChunk;
+		for (int32_t iZ = -1; iZ <= 1; iZ++)
+		{
+			for (int32_t iY = -1; iY <= 1; iY++)
+			{
+				for (int32_t iX = -1; iX <= 1; iX++)
+				{
+					Chunk* pChunk = arrayOldChunks[(iX + 1) + (iY + 1) * 3 + (iZ + 1) * 9];
+					if (!pChunk)
+					{
+						continue;
+					}
+
+					const int32_t iNewX = iX - iXDelta;
+					const int32_t iNewY = iY - iYDelta;
+					const int32_t iNewZ = iZ - iZDelta;
+					if ((std::abs(iNewX) > 1) || (std::abs(iNewY) > 1) || (std::abs(iNewZ) > 1))
+					{
+						this->mVolume->releaseChunk(pChunk);
+					}
+					else if ((iNewX == 0) && (iNewY == 0) && (iNewZ == 0))
+					{
+						m_pCurrentChunk = pChunk;
+					}
+					else
+					{
+						m_arrayNeighbourChunks[(iNewX + 1) + (iNewY + 1) * 3 + (iNewZ + 1) * 9] = pChunk;
+					}
+				}
+			}
+		}
+
+		if (!m_pCurrentChunk)
+		{
+			m_pCurrentChunk = this->mVolume->acquireChunk(iXChunk, iYChunk, iZChunk);
+		}
+	}
+
+	template <typename VoxelType>
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::releaseNeighbourChunks(void)
+	{
+		for (Chunk*& pChunk : m_arrayNeighbourChunks)
+		{
+			if (pChunk)
+			{
+				this->mVolume->releaseChunk(pChunk);
+				pChunk = nullptr;
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::releaseAllChunks(void)
+	{
+		// The volume destroys every chunk when it is destroyed, pinned or not, so in that case there is nothing to release.
+		if (!m_pVolumeExists->load())
+		{
+			m_arrayNeighbourChunks.fill(nullptr);
+			m_pCurrentChunk = nullptr;
+			return;
+		}
+
+		releaseNeighbourChunks();
+		if (m_pCurrentChunk)
+		{
+			this->mVolume->releaseChunk(m_pCurrentChunk);
+			m_pCurrentChunk = nullptr;
+		}
 	}
 
 	template <typename VoxelType>
-	bool PagedVolume<VoxelType>::Sampler::setVoxel(VoxelType tValue)
+	template <uint16_t ChunkSideLength>
+	bool PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::setVoxel(VoxelType tValue)
 	{
 		//Need to think what effect this has on any existing iterators.
 		POLYVOX_THROW(not_implemented, "This function cannot be used on PagedVolume samplers.");
@@ -101,7 +306,8 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::movePositiveX(void)
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::movePositiveX(void)
 	{
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::movePositiveX();
@@ -110,7 +316,10 @@ namespace PolyVox
 		if (CAN_GO_POS_X(this->m_uXPosInChunk))
 		{
 			//No need to compute new chunk.
-			mCurrentVoxel += POS_X_DELTA;
+			if (mCurrentVoxel)
+			{
+				mCurrentVoxel += POS_X_DELTA;
+			}
 			this->m_uXPosInChunk++;
 		}
 		else
@@ -121,7 +330,8 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::movePositiveY(void)
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::movePositiveY(void)
 	{
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::movePositiveY();
@@ -130,7 +340,10 @@ namespace PolyVox
 		if (CAN_GO_POS_Y(this->m_uYPosInChunk))
 		{
 			//No need to compute new chunk.
-			mCurrentVoxel += POS_Y_DELTA;
+			if (mCurrentVoxel)
+			{
+				mCurrentVoxel += POS_Y_DELTA;
+			}
 			this->m_uYPosInChunk++;
 		}
 		else
@@ -141,7 +354,8 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::movePositiveZ(void)
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::movePositiveZ(void)
 	{
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::movePositiveZ();
@@ -150,7 +364,10 @@ namespace PolyVox
 		if (CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
 			//No need to compute new chunk.
-			mCurrentVoxel += POS_Z_DELTA;
+			if (mCurrentVoxel)
+			{
+				mCurrentVoxel += POS_Z_DELTA;
+			}
 			this->m_uZPosInChunk++;
 		}
 		else
@@ -161,7 +378,8 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::moveNegativeX(void)
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::moveNegativeX(void)
 	{
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::moveNegativeX();
@@ -170,7 +388,10 @@ namespace PolyVox
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk))
 		{
 			//No need to compute new chunk.
-			mCurrentVoxel += NEG_X_DELTA;
+			if (mCurrentVoxel)
+			{
+				mCurrentVoxel += NEG_X_DELTA;
+			}
 			this->m_uXPosInChunk--;
 		}
 		else
@@ -181,7 +402,8 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::moveNegativeY(void)
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::moveNegativeY(void)
 	{
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::moveNegativeY();
@@ -190,7 +412,10 @@ namespace PolyVox
 		if (CAN_GO_NEG_Y(this->m_uYPosInChunk))
 		{
 			//No need to compute new chunk.
-			mCurrentVoxel += NEG_Y_DELTA;
+			if (mCurrentVoxel)
+			{
+				mCurrentVoxel += NEG_Y_DELTA;
+			}
 			this->m_uYPosInChunk--;
 		}
 		else
@@ -201,7 +426,8 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	void PagedVolume<VoxelType>::Sampler::moveNegativeZ(void)
+	template <uint16_t ChunkSideLength>
+	void PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::moveNegativeZ(void)
 	{
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< PagedVolume<VoxelType> >::moveNegativeZ();
@@ -210,7 +436,10 @@ namespace PolyVox
 		if (CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
 			//No need to compute new chunk.
-			mCurrentVoxel += NEG_Z_DELTA;
+			if (mCurrentVoxel)
+			{
+				mCurrentVoxel += NEG_Z_DELTA;
+			}
 			this->m_uZPosInChunk--;
 		}
 		else
@@ -221,273 +450,300 @@ namespace PolyVox
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx1ny1nz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_NEG_Y(this->m_uYPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA) : peekChunk(-1, -1, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume - 1, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(-1, -1, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx1ny0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx1ny0pz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_NEG_Y(this->m_uYPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + NEG_Y_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + NEG_Y_DELTA) : peekChunk(-1, -1, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume - 1, this->mZPosInVolume);
+		return peekNeighbourChunk(-1, -1, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx1ny1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx1ny1pz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_NEG_Y(this->m_uYPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA) : peekChunk(-1, -1, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume - 1, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(-1, -1, 1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx0py1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx0py1nz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + NEG_Z_DELTA) : peekChunk(-1, 0, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(-1, 0, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx0py0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx0py0pz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA) : peekChunk(-1, 0, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume, this->mZPosInVolume);
+		return peekNeighbourChunk(-1, 0, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx0py1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx0py1pz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + POS_Z_DELTA) : peekChunk(-1, 0, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(-1, 0, 1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx1py1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx1py1nz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_POS_Y(this->m_uYPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA) : peekChunk(-1, 1, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume + 1, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(-1, 1, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx1py0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx1py0pz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_POS_Y(this->m_uYPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + POS_Y_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + POS_Y_DELTA) : peekChunk(-1, 1, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume + 1, this->mZPosInVolume);
+		return peekNeighbourChunk(-1, 1, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1nx1py1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1nx1py1pz(void) const
 	{
 		if (CAN_GO_NEG_X(this->m_uXPosInChunk) && CAN_GO_POS_Y(this->m_uYPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_X_DELTA + POS_Y_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_X_DELTA + POS_Y_DELTA + POS_Z_DELTA) : peekChunk(-1, 1, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume + 1, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(-1, 1, 1);
 	}
 
 	//////////////////////////////////////////////////////////////////////////
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px1ny1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px1ny1nz(void) const
 	{
 		if (CAN_GO_NEG_Y(this->m_uYPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_Y_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_Y_DELTA + NEG_Z_DELTA) : peekChunk(0, -1, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume - 1, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(0, -1, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px1ny0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px1ny0pz(void) const
 	{
 		if (CAN_GO_NEG_Y(this->m_uYPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_Y_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_Y_DELTA) : peekChunk(0, -1, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume - 1, this->mZPosInVolume);
+		return peekNeighbourChunk(0, -1, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px1ny1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px1ny1pz(void) const
 	{
 		if (CAN_GO_NEG_Y(this->m_uYPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_Y_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_Y_DELTA + POS_Z_DELTA) : peekChunk(0, -1, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume - 1, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(0, -1, 1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px0py1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px0py1nz(void) const
 	{
 		if (CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + NEG_Z_DELTA) : peekChunk(0, 0, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(0, 0, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px0py0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px0py0pz(void) const
 	{
-		return *mCurrentVoxel;
+		return mCurrentVoxel ? *mCurrentVoxel : peekChunk(0, 0, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px0py1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px0py1pz(void) const
 	{
 		if (CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_Z_DELTA) : peekChunk(0, 0, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(0, 0, 1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px1py1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px1py1nz(void) const
 	{
 		if (CAN_GO_POS_Y(this->m_uYPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_Y_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_Y_DELTA + NEG_Z_DELTA) : peekChunk(0, 1, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume + 1, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(0, 1, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px1py0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px1py0pz(void) const
 	{
 		if (CAN_GO_POS_Y(this->m_uYPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_Y_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_Y_DELTA) : peekChunk(0, 1, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume + 1, this->mZPosInVolume);
+		return peekNeighbourChunk(0, 1, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel0px1py1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel0px1py1pz(void) const
 	{
 		if (CAN_GO_POS_Y(this->m_uYPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_Y_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_Y_DELTA + POS_Z_DELTA) : peekChunk(0, 1, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume + 1, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(0, 1, 1);
 	}
 
 	//////////////////////////////////////////////////////////////////////////
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px1ny1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px1ny1nz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_NEG_Y(this->m_uYPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + NEG_Y_DELTA + NEG_Z_DELTA) : peekChunk(1, -1, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume - 1, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(1, -1, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px1ny0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px1ny0pz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_NEG_Y(this->m_uYPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + NEG_Y_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + NEG_Y_DELTA) : peekChunk(1, -1, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume - 1, this->mZPosInVolume);
+		return peekNeighbourChunk(1, -1, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px1ny1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px1ny1pz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_NEG_Y(this->m_uYPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + NEG_Y_DELTA + POS_Z_DELTA) : peekChunk(1, -1, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume - 1, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(1, -1, 1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px0py1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px0py1nz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + NEG_Z_DELTA) : peekChunk(1, 0, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(1, 0, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px0py0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px0py0pz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA) : peekChunk(1, 0, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume, this->mZPosInVolume);
+		return peekNeighbourChunk(1, 0, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px0py1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px0py1pz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + POS_Z_DELTA) : peekChunk(1, 0, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(1, 0, 1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px1py1nz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px1py1nz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_POS_Y(this->m_uYPosInChunk) && CAN_GO_NEG_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + POS_Y_DELTA + NEG_Z_DELTA) : peekChunk(1, 1, -1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume + 1, this->mZPosInVolume - 1);
+		return peekNeighbourChunk(1, 1, -1);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px1py0pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px1py0pz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_POS_Y(this->m_uYPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + POS_Y_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + POS_Y_DELTA) : peekChunk(1, 1, 0);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume + 1, this->mZPosInVolume);
+		return peekNeighbourChunk(1, 1, 0);
 	}
 
 	template <typename VoxelType>
-	VoxelType PagedVolume<VoxelType>::Sampler::peekVoxel1px1py1pz(void) const
+	template <uint16_t ChunkSideLength>
+	VoxelType PagedVolume<VoxelType>::BasicSampler<ChunkSideLength>::peekVoxel1px1py1pz(void) const
 	{
 		if (CAN_GO_POS_X(this->m_uXPosInChunk) && CAN_GO_POS_Y(this->m_uYPosInChunk) && CAN_GO_POS_Z(this->m_uZPosInChunk))
 		{
-			return *(mCurrentVoxel + POS_X_DELTA + POS_Y_DELTA + POS_Z_DELTA);
+			return mCurrentVoxel ? *(mCurrentVoxel + POS_X_DELTA + POS_Y_DELTA + POS_Z_DELTA) : peekChunk(1, 1, 1);
 		}
-		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume + 1, this->mZPosInVolume + 1);
+		return peekNeighbourChunk(1, 1, 1);
 	}
 }
 
@@ -0,0 +1,503 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#include "Impl/Morton.h"
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::SharedChunkData::SharedChunkData()
+		:m_pData(nullptr)
+		, m_pDataPool(nullptr)
+		, m_tUniformValue()
+		, m_uPaletteIndexBitsPower(0)
+	{
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::SharedChunkData::~SharedChunkData()
+	{
+		if (m_pDataPool)
+		{
+			m_pDataPool->deallocate(m_pData);
+		}
+		else
+		{
+			delete[] m_pData;
+		}
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::SharedChunkData::getVoxelAtIndex(uint32_t uIndex) const
+	{
+		if (m_pData)
+		{
+			return m_pData[uIndex];
+		}
+
+		if (m_vecPaletteIndices.empty())
+		{
+			return m_tUniformValue;
+		}
+
+		// The same packing as Chunk::getPaletteIndex().
+		const uint32_t uBitPos = uIndex << m_uPaletteIndexBitsPower;
+		const uint32_t uMask = (1u << (1u << m_uPaletteIndexBitsPower)) - 1u;
+		return m_vecPalette[(m_vecPaletteIndices[uBitPos >> 3] >> (uBitPos & 7)) & uMask];
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::Snapshot::Snapshot()
+		:BaseVolume<VoxelType>()
+		, m_region(0, 0, 0, 0, 0, 0)
+		, m_regChunks(0, 0, 0, -1, -1, -1)
+		, m_uChunkSideLength(1)
+		, m_uChunkSideLengthPower(0)
+		, m_iChunkMask(0)
+		, m_uVersion(0)
+	{
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::Snapshot::Snapshot(const Region& region, const Region& regChunks, uint16_t uChunkSideLength, uint64_t uVersion)
+		:BaseVolume<VoxelType>()
+		, m_region(region)
+		, m_regChunks(regChunks)
+		, m_uChunkSideLength(uChunkSideLength)
+		, m_uChunkSideLengthPower(logBase2(uChunkSideLength))
+		, m_iChunkMask(uChunkSideLength - 1)
+		, m_uVersion(uVersion)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Unlike copying a volume, this is cheap as the copy shares the chunks of the original.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::Snapshot::Snapshot(const Snapshot& rhs)
+		:BaseVolume<VoxelType>()
+		, m_region(rhs.m_region)
+		, m_regChunks(rhs.m_regChunks)
+		, m_vecChunks(rhs.m_vecChunks)
+		, m_uChunkSideLength(rhs.m_uChunkSideLength)
+		, m_uChunkSideLengthPower(rhs.m_uChunkSideLengthPower)
+		, m_iChunkMask(rhs.m_iChunkMask)
+		, m_uVersion(rhs.m_uVersion)
+	{
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::Snapshot::~Snapshot()
+	{
+	}
+
+	template <typename VoxelType>
+	typename PagedVolume<VoxelType>::Snapshot& PagedVolume<VoxelType>::Snapshot::operator=(const Snapshot& rhs)
+	{
+		m_region = rhs.m_region;
+		m_regChunks = rhs.m_regChunks;
+		m_vecChunks = rhs.m_vecChunks;
+		m_uChunkSideLength = rhs.m_uChunkSideLength;
+		m_uChunkSideLengthPower = rhs.m_uChunkSideLengthPower;
+		m_iChunkMask = rhs.m_iChunkMask;
+		m_uVersion = rhs.m_uVersion;
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value, or the default value if the position is outside the chunks captured by the snapshot.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		const SharedChunkData* pChunk = getChunk(uXPos, uYPos, uZPos);
+		if (!pChunk)
+		{
+			return VoxelType();
+		}
+
+		return pChunk->getVoxelAtIndex(morton256_x[uXPos & m_iChunkMask] | morton256_y[uYPos & m_iChunkMask] | morton256_z[uZPos & m_iChunkMask]);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value, or the default value if the position is outside the chunks captured by the snapshot.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::getVoxel(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	template <typename VoxelType>
+	const Region& PagedVolume<VoxelType>::Snapshot::getRegion(void) const
+	{
+		return m_region;
+	}
+
+	template <typename VoxelType>
+	uint64_t PagedVolume<VoxelType>::Snapshot::getVersion(void) const
+	{
+		return m_uVersion;
+	}
+
+	template <typename VoxelType>
+	uint32_t PagedVolume<VoxelType>::Snapshot::getNoOfChunks(void) const
+	{
+		return static_cast<uint32_t>(m_vecChunks.size());
+	}
+
+	template <typename VoxelType>
+	const typename PagedVolume<VoxelType>::SharedChunkData* PagedVolume<VoxelType>::Snapshot::getChunk(int32_t iXPos, int32_t iYPos, int32_t iZPos) const
+	{
+		const int32_t iChunkX = iXPos >> m_uChunkSideLengthPower;
+		const int32_t iChunkY = iYPos >> m_uChunkSideLengthPower;
+		const int32_t iChunkZ = iZPos >> m_uChunkSideLengthPower;
+		if (!m_regChunks.containsPoint(iChunkX, iChunkY, iChunkZ))
+		{
+			return nullptr;
+		}
+
+		const uint32_t uIndex = (iChunkX - m_regChunks.getLowerX()) +
+			(iChunkY - m_regChunks.getLowerY()) * m_regChunks.getWidthInVoxels() +
+			(iChunkZ - m_regChunks.getLowerZ()) * m_regChunks.getWidthInVoxels() * m_regChunks.getHeightInVoxels();
+		return m_vecChunks[uIndex].get();
+	}
+
+	template <typename VoxelType>
+	PagedVolume<VoxelType>::Snapshot::Sampler::Sampler(Snapshot* volume)
+		:BaseVolume<VoxelType>::template Sampler< Snapshot >(volume)
+		, m_pCurrentChunk(nullptr)
+		, m_uXPosInChunk(0)
+		, m_uYPosInChunk(0)
+		, m_uZPosInChunk(0)
+		, m_uChunkSideLengthMinusOne(volume->m_uChunkSideLength - 1)
+	{
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::getVoxel(void) const
+	{
+		return peekVoxel(0, 0, 0);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	{
+		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	{
+		// Base version updates position and validity flags.
+		BaseVolume<VoxelType>::template Sampler< Snapshot >::setPosition(xPos, yPos, zPos);
+
+		m_pCurrentChunk = this->mVolume->getChunk(xPos, yPos, zPos);
+		m_uXPosInChunk = static_cast<uint16_t>(xPos & this->mVolume->m_iChunkMask);
+		m_uYPosInChunk = static_cast<uint16_t>(yPos & this->mVolume->m_iChunkMask);
+		m_uZPosInChunk = static_cast<uint16_t>(zPos & this->mVolume->m_iChunkMask);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const
+	{
+		// The casts make negative positions wrap around, so that a single comparison detects leaving the chunk in either direction.
+		const uint32_t uXPos = static_cast<uint32_t>(m_uXPosInChunk + iXOffset);
+		const uint32_t uYPos = static_cast<uint32_t>(m_uYPosInChunk + iYOffset);
+		const uint32_t uZPos = static_cast<uint32_t>(m_uZPosInChunk + iZOffset);
+		if (m_pCurrentChunk && (uXPos <= m_uChunkSideLengthMinusOne) && (uYPos <= m_uChunkSideLengthMinusOne) && (uZPos <= m_uChunkSideLengthMinusOne))
+		{
+			return m_pCurrentChunk->getVoxelAtIndex(morton256_x[uXPos] | morton256_y[uYPos] | morton256_z[uZPos]);
+		}
+		return this->mVolume->getVoxel(this->mXPosInVolume + iXOffset, this->mYPosInVolume + iYOffset, this->mZPosInVolume + iZOffset);
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::movePositiveX(void)
+	{
+		// Base version updates position and validity flags.
+		BaseVolume<VoxelType>::template Sampler< Snapshot >::movePositiveX();
+
+		if (m_uXPosInChunk < m_uChunkSideLengthMinusOne)
+		{
+			m_uXPosInChunk++;
+		}
+		else
+		{
+			//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::movePositiveY(void)
+	{
+		// Base version updates position and validity flags.
+		BaseVolume<VoxelType>::template Sampler< Snapshot >::movePositiveY();
+
+		if (m_uYPosInChunk < m_uChunkSideLengthMinusOne)
+		{
+			m_uYPosInChunk++;
+		}
+		else
+		{
+			//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::movePositiveZ(void)
+	{
+		// Base version updates position and validity flags.
+		BaseVolume<VoxelType>::template Sampler< Snapshot >::movePositiveZ();
+
+		if (m_uZPosInChunk < m_uChunkSideLengthMinusOne)
+		{
+			m_uZPosInChunk++;
+		}
+		else
+		{
+			//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::moveNegativeX(void)
+	{
+		// Base version updates position and validity flags.
+		BaseVolume<VoxelType>::template Sampler< Snapshot >::moveNegativeX();
+
+		if (m_uXPosInChunk > 0)
+		{
+			m_uXPosInChunk--;
+		}
+		else
+		{
+			//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::moveNegativeY(void)
+	{
+		// Base version updates position and validity flags.
+		BaseVolume<VoxelType>::template Sampler< Snapshot >::moveNegativeY();
+
+		if (m_uYPosInChunk > 0)
+		{
+			m_uYPosInChunk--;
+		}
+		else
+		{
+			//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void PagedVolume<VoxelType>::Snapshot::Sampler::moveNegativeZ(void)
+	{
+		// Base version updates position and validity flags.
+		BaseVolume<VoxelType>::template Sampler< Snapshot >::moveNegativeZ();
+
+		if (m_uZPosInChunk > 0)
+		{
+			m_uZPosInChunk--;
+		}
+		else
+		{
+			//We've hit the chunk boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx1ny1nz(void) const
+	{
+		return peekVoxel(-1, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx1ny0pz(void) const
+	{
+		return peekVoxel(-1, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx1ny1pz(void) const
+	{
+		return peekVoxel(-1, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx0py1nz(void) const
+	{
+		return peekVoxel(-1, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx0py0pz(void) const
+	{
+		return peekVoxel(-1, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx0py1pz(void) const
+	{
+		return peekVoxel(-1, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx1py1nz(void) const
+	{
+		return peekVoxel(-1, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx1py0pz(void) const
+	{
+		return peekVoxel(-1, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1nx1py1pz(void) const
+	{
+		return peekVoxel(-1, 1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px1ny1nz(void) const
+	{
+		return peekVoxel(0, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px1ny0pz(void) const
+	{
+		return peekVoxel(0, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px1ny1pz(void) const
+	{
+		return peekVoxel(0, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px0py1nz(void) const
+	{
+		return peekVoxel(0, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px0py0pz(void) const
+	{
+		return peekVoxel(0, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px0py1pz(void) const
+	{
+		return peekVoxel(0, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px1py1nz(void) const
+	{
+		return peekVoxel(0, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px1py0pz(void) const
+	{
+		return peekVoxel(0, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel0px1py1pz(void) const
+	{
+		return peekVoxel(0, 1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px1ny1nz(void) const
+	{
+		return peekVoxel(1, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px1ny0pz(void) const
+	{
+		return peekVoxel(1, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px1ny1pz(void) const
+	{
+		return peekVoxel(1, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px0py1nz(void) const
+	{
+		return peekVoxel(1, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px0py0pz(void) const
+	{
+		return peekVoxel(1, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px0py1pz(void) const
+	{
+		return peekVoxel(1, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px1py1nz(void) const
+	{
+		return peekVoxel(1, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px1py0pz(void) const
+	{
+		return peekVoxel(1, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType PagedVolume<VoxelType>::Snapshot::Sampler::peekVoxel1px1py1pz(void) const
+	{
+		return peekVoxel(1, 1, 1);
+	}
+}
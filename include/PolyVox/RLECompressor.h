@@ -0,0 +1,70 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef __PolyVox_RLECompressor_H__
+#define __PolyVox_RLECompressor_H__
+
+#include "Compressor.h"
+
+namespace PolyVox
+{
+	/**
+	 * Performs compression of data using Run Length Encoding (RLE).
+	 *
+	 * This compressor is designed for voxel data which contains long runs of the same value. Minecraft-style terrain and other
+	 * cubic-style terrains are likely to fall under this category, whereas density fields for Marching Cubes terrain will not. Please
+	 * see the following article if you want more details of how RLE compression works: http://en.wikipedia.org/wiki/Run-length_encoding
+	 *
+	 * The data is stored as a sequence of (value, length) pairs. The ValueType should normally be the voxel type and the LengthType
+	 * should be an unsigned integer type, which limits the length of a single run (longer runs are simply split). Note that the voxels
+	 * in a PagedVolume chunk are stored in Morton order, which keeps voxels which are close in space close in memory and so tends to
+	 * produce long runs for terrain-like data.
+	 *
+	 * \sa Compressor
+	 */
+	template<typename ValueType, typename LengthType>
+	class RLECompressor : public Compressor
+	{
+		struct Run
+		{
+			ValueType value;
+			LengthType length;
+		};
+	public:
+		/// Constructor
+		RLECompressor();
+		/// Destructor
+		~RLECompressor();
+
+		// API documentation is in base class and gets inherited by Doxygen.
+		uint32_t getMaxCompressedSize(uint32_t uUncompressedInputSize);
+		uint32_t compress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength);
+		uint32_t decompress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength);
+	};
+}
+
+#include "RLECompressor.inl"
+
+#endif //__PolyVox_RLECompressor_H__
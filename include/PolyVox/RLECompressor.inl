@@ -0,0 +1,146 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include "Impl/ErrorHandling.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace PolyVox
+{
+	template<typename ValueType, typename LengthType>
+	RLECompressor<ValueType, LengthType>::RLECompressor()
+	{
+	}
+
+	template<typename ValueType, typename LengthType>
+	RLECompressor<ValueType, LengthType>::~RLECompressor()
+	{
+	}
+
+	template<typename ValueType, typename LengthType>
+	uint32_t RLECompressor<ValueType, LengthType>::getMaxCompressedSize(uint32_t uUncompressedInputSize)
+	{
+		// In the worst case we will have a seperate Run (of length one) for each element of the input data.
+		return (uUncompressedInputSize / sizeof(ValueType)) * sizeof(Run);
+	}
+
+	template<typename ValueType, typename LengthType>
+	uint32_t RLECompressor<ValueType, LengthType>::compress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength)
+	{
+		POLYVOX_THROW_IF(uSrcLength % sizeof(ValueType) != 0, std::length_error, "Source length must be a integer multiple of the ValueType size");
+
+		// Lengths provided are in bytes, so convert them to be in terms of our types.
+		uSrcLength /= sizeof(ValueType);
+		uDstLength /= sizeof(Run);
+
+		// Get data pointers in the appropriate type
+		const ValueType* pSrcDataAsType = reinterpret_cast<const ValueType*>(pSrcData);
+		Run* pDstDataAsRun = reinterpret_cast<Run*>(pDstData);
+
+		// Pointers to just past the end of the data
+		const ValueType* pSrcDataEnd = pSrcDataAsType + uSrcLength;
+		Run* pDstDataEnd = pDstDataAsRun + uDstLength;
+
+		// Counter for the output length
+		uint32_t uDstLengthInBytes = 0;
+
+		// Read the first element of the source and set up the first run based on it.
+		if (uSrcLength > 0)
+		{
+			POLYVOX_THROW_IF(uDstLength == 0, std::length_error, "Insufficient space in destination buffer.");
+
+			pDstDataAsRun->value = *pSrcDataAsType;
+			pSrcDataAsType++;
+			pDstDataAsRun->length = 1;
+			uDstLengthInBytes += sizeof(Run);
+		}
+
+		// Now loop over the rest of the source data.
+		while (pSrcDataAsType < pSrcDataEnd)
+		{
+			// If the value is the same as the current run (and we have not
+			// reached the maximum run length) then extend the current run.
+			if ((*pSrcDataAsType == pDstDataAsRun->value) && (pDstDataAsRun->length < (std::numeric_limits<LengthType>::max)()))
+			{
+				pDstDataAsRun->length++;
+			}
+			// Otherwise we need to start a new Run.
+			else
+			{
+				pDstDataAsRun++;
+
+				// Check if we have enough space in the destination buffer.
+				POLYVOX_THROW_IF(pDstDataAsRun >= pDstDataEnd, std::length_error, "Insufficient space in destination buffer.");
+
+				// Create the new run.
+				pDstDataAsRun->value = *pSrcDataAsType;
+				pDstDataAsRun->length = 1;
+				uDstLengthInBytes += sizeof(Run);
+			}
+
+			pSrcDataAsType++;
+		}
+
+		return uDstLengthInBytes;
+	}
+
+	template<typename ValueType, typename LengthType>
+	uint32_t RLECompressor<ValueType, LengthType>::decompress(const void* pSrcData, uint32_t uSrcLength, void* pDstData, uint32_t uDstLength)
+	{
+		POLYVOX_THROW_IF(uSrcLength % sizeof(Run) != 0, std::length_error, "Source length must be a integer multiple of the Run size");
+
+		// Lengths provided are in bytes, so convert them to be in terms of our types.
+		uSrcLength /= sizeof(Run);
+		uDstLength /= sizeof(ValueType);
+
+		// Get data pointers in the appropriate type
+		const Run* pSrcDataAsRun = reinterpret_cast<const Run*>(pSrcData);
+		ValueType* pDstDataAsType = reinterpret_cast<ValueType*>(pDstData);
+
+		// Pointers to just past the end of the data
+		const Run* pSrcDataEnd = pSrcDataAsRun + uSrcLength;
+		ValueType* pDstDataEnd = pDstDataAsType + uDstLength;
+
+		// Counter for the output length
+		uint32_t uDstLengthInBytes = 0;
+
+		while (pSrcDataAsRun < pSrcDataEnd)
+		{
+			// Check if we have enough space in the destination buffer.
+			POLYVOX_THROW_IF(pDstDataAsType + pSrcDataAsRun->length > pDstDataEnd, std::length_error, "Insufficient space in destination buffer.");
+
+			// Write the run into the destination
+			std::fill(pDstDataAsType, pDstDataAsType + pSrcDataAsRun->length, pSrcDataAsRun->value);
+			pDstDataAsType += pSrcDataAsRun->length;
+
+			uDstLengthInBytes += pSrcDataAsRun->length * sizeof(ValueType);
+			pSrcDataAsRun++;
+		}
+
+		return uDstLengthInBytes;
+	}
+}
@@ -29,10 +29,17 @@
 #include "Region.h"
 #include "Vector.h"
 
+#include <algorithm>
 #include <cstdlib> //For abort()
 #include <limits>
 #include <memory>
+#include <new>
 #include <stdexcept> //For invalid_argument
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
 
 namespace PolyVox
 {
@@ -41,6 +48,13 @@ namespace PolyVox
 	 *
 	 * This class is less memory-efficient than the PagedVolume, but it is the simplest possible
 	 * volume implementation which makes it useful for debugging and getting started with PolyVox.
+	 *
+	 * The volume can optionally be given an 'apron', which is a border of extra voxels around the outside of the array which
+	 * are kept set to the border value. A Sampler whose neighbours all lie within the array (including the apron) can read
+	 * them directly rather than checking each one against the edges of the volume, so with an apron of at least one voxel
+	 * the surface extractors and filters never have to take the slow path. Larger aprons also cover regions which extend
+	 * some way outside the volume. Note that each peek still tests a single flag to choose between the direct read and
+	 * the slow path, but that flag is only recalculated when the sampler moves.
 	 */
 	template <typename VoxelType>
 	class RawVolume : public BaseVolume<VoxelType>
@@ -111,8 +125,12 @@ namespace PolyVox
 			inline VoxelType peekVoxel1px1py1pz(void) const;
 
 		private:
+			// Updates the validity flags for one axis.
+			void updateValidityInX(void);
+			void updateValidityInY(void);
+			void updateValidityInZ(void);
 
-			//Other current position information
+			//Other current position information. This is null if the current position is outside the volume's data (including the apron).
 			VoxelType* mCurrentVoxel;
 
 			//Whether the current position is inside the volume
@@ -120,12 +138,19 @@ namespace PolyVox
 			bool m_bIsCurrentPositionValidInX;
 			bool m_bIsCurrentPositionValidInY;
 			bool m_bIsCurrentPositionValidInZ;
+
+			//Whether all the neighbours of the current position are inside the volume's data (including the apron), in which case
+			//the peek functions can read them directly. This is the only test made by each peek.
+			bool m_bCanPeekInX;
+			bool m_bCanPeekInY;
+			bool m_bCanPeekInZ;
+			bool m_bCanPeek;
 		};
 #endif // SWIG
 
 	public:
 		/// Constructor for creating a fixed size volume.
-		RawVolume(const Region& regValid);
+		RawVolume(const Region& regValid, uint16_t uApronSize = 0, bool bUseHugePages = false);
 
 		/// Destructor
 		~RawVolume();
@@ -134,6 +159,8 @@ namespace PolyVox
 		VoxelType getBorderValue(void) const;
 		/// Gets a Region representing the extents of the Volume.
 		const Region& getEnclosingRegion(void) const;
+		/// Gets the number of voxels of border value which are stored around the outside of the volume.
+		uint16_t getApronSize(void) const;
 
 		/// Gets the width of the volume in voxels.
 		int32_t getWidth(void) const;
@@ -154,6 +181,11 @@ namespace PolyVox
 		/// Sets the voxel at the position given by a 3D vector
 		void setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue);
 
+		/// Copies all the voxels in a region into a buffer
+		void readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout = BufferLayout()) const;
+		/// Copies all the voxels in a region from a buffer
+		void writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout = BufferLayout());
+
 		/// Calculates approximatly how many bytes of memory the volume is currently using.
 		uint32_t calculateSizeInBytes(void);
 
@@ -167,14 +199,41 @@ namespace PolyVox
 	private:
 		void initialise(const Region& regValidRegion);
 
+		// Allocates and frees the memory holding the voxel data (including the apron).
+		void allocateData(void);
+		void freeData(void);
+
+		// Sets every voxel of the apron to the border value.
+		void fillApron(void);
+
+		// Gets the offset of a voxel from the start of the volume's data.
+		int32_t getVoxelIndex(int32_t iXPos, int32_t iYPos, int32_t iZPos) const;
+
 		//The size of the volume
 		Region m_regValidRegion;
 
+		//The size of the volume's data, which is the valid region grown by the apron.
+		Region m_regDataRegion;
+
+		//The width of the apron
+		uint16_t m_uApronSize;
+
+		//The distance between voxels which are next to each other in y and in z.
+		int32_t m_iYStride;
+		int32_t m_iZStride;
+
 		//The border value
 		VoxelType m_tBorderValue;
 
-		//The voxel data
+		//The voxel data. This points at the voxel in the lower corner of the volume, which is not the start of the allocation if
+		//there is an apron.
 		VoxelType* m_pData;
+
+		//The memory holding the voxel data, and whether it was mapped (so that huge pages could be requested) rather than taken from the heap.
+		uint8_t* m_pAllocation;
+		size_t m_uAllocationSizeInBytes;
+		bool m_bUseHugePages;
+		bool m_bAllocationIsMapped;
 	};
 }
 
@@ -27,17 +27,30 @@ namespace PolyVox
 	////////////////////////////////////////////////////////////////////////////////
 	/// This constructor creates a volume with a fixed size which is specified as a parameter.
 	/// \param regValid Specifies the minimum and maximum valid voxel positions.
+	/// \param uApronSize The number of voxels of border value to store around the outside of the volume. Samplers can
+	/// read the neighbours of any position within <tt>uApronSize - 1</tt> voxels of the volume without checking them
+	/// against the edges, so an apron of one voxel is enough for the surface extractors.
+	/// \param bUseHugePages Asks the operating system to back large volumes with huge pages, which reduces the number of
+	/// TLB misses when accessing them. This is only a hint, and currently only has an effect on Linux.
 	////////////////////////////////////////////////////////////////////////////////
 	template <typename VoxelType>
-	RawVolume<VoxelType>::RawVolume(const Region& regValid)
+	RawVolume<VoxelType>::RawVolume(const Region& regValid, uint16_t uApronSize, bool bUseHugePages)
 		:BaseVolume<VoxelType>()
 		, m_regValidRegion(regValid)
+		, m_uApronSize(uApronSize)
+		, m_iYStride(0)
+		, m_iZStride(0)
 		, m_tBorderValue()
+		, m_pData(nullptr)
+		, m_pAllocation(nullptr)
+		, m_uAllocationSizeInBytes(0)
+		, m_bUseHugePages(bUseHugePages)
+		, m_bAllocationIsMapped(false)
 	{
-			this->setBorderValue(VoxelType());
-
 			//Create a volume of the right size.
 			initialise(regValid);
+
+			this->setBorderValue(VoxelType());
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -59,8 +72,7 @@ namespace PolyVox
 	template <typename VoxelType>
 	RawVolume<VoxelType>::~RawVolume()
 	{
-		delete[] m_pData;
-		m_pData = 0;
+		freeData();
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -96,6 +108,15 @@ namespace PolyVox
 		return m_regValidRegion;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The number of voxels of border value stored around the outside of the volume, as given to the constructor.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint16_t RawVolume<VoxelType>::getApronSize(void) const
+	{
+		return m_uApronSize;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// \return The width of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g. 0 to 63 then the width is 64.
 	/// \sa getHeight(), getDepth()
@@ -139,17 +160,7 @@ namespace PolyVox
 	{
 		if (this->m_regValidRegion.containsPoint(uXPos, uYPos, uZPos))
 		{
-			const Region& regValidRegion = this->m_regValidRegion;
-			int32_t iLocalXPos = uXPos - regValidRegion.getLowerX();
-			int32_t iLocalYPos = uYPos - regValidRegion.getLowerY();
-			int32_t iLocalZPos = uZPos - regValidRegion.getLowerZ();
-
-			return m_pData
-				[
-					iLocalXPos +
-					iLocalYPos * this->getWidth() +
-					iLocalZPos * this->getWidth() * this->getHeight()
-				];
+			return m_pData[getVoxelIndex(uXPos, uYPos, uZPos)];
 		}
 		else
 		{
@@ -176,6 +187,7 @@ namespace PolyVox
 	void RawVolume<VoxelType>::setBorderValue(const VoxelType& tBorder)
 	{
 		m_tBorderValue = tBorder;
+		fillApron();
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -192,17 +204,7 @@ namespace PolyVox
 			POLYVOX_THROW(std::out_of_range, "Position is outside valid region");
 		}
 
-		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
-		int32_t iLocalXPos = uXPos - v3dLowerCorner.getX();
-		int32_t iLocalYPos = uYPos - v3dLowerCorner.getY();
-		int32_t iLocalZPos = uZPos - v3dLowerCorner.getZ();
-
-		m_pData
-			[
-				iLocalXPos +
-				iLocalYPos * this->getWidth() +
-				iLocalZPos * this->getWidth() * this->getHeight()
-			] = tValue;
+		m_pData[getVoxelIndex(uXPos, uYPos, uZPos)] = tValue;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -215,6 +217,111 @@ namespace PolyVox
 		setVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// Voxels are copied a row at a time, which is much faster than calling getVoxel() for every position. The region may extend
+	/// outside the volume, in which case the corresponding parts of the buffer are filled with the border value.
+	/// \param regRead The region to copy
+	/// \param pDstBuffer The buffer to copy into, which must hold at least layout.getRequiredBufferSize(regRead) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const
+	{
+		layout.validate(regRead);
+		POLYVOX_THROW_IF(pDstBuffer == nullptr, std::invalid_argument, "Destination buffer must not be null.");
+
+		const Region& regValidRegion = this->m_regValidRegion;
+		const bool bLinear = (layout.getOrder() == BufferOrders::Linear);
+
+		// The part of each row which lies inside the volume, relative to the start of the row.
+		const int32_t iInsideBegin = (std::max)(regValidRegion.getLowerX() - regRead.getLowerX(), 0);
+		const int32_t iInsideEnd = (std::min)(regValidRegion.getUpperX() - regRead.getLowerX() + 1, regRead.getWidthInVoxels());
+		const int32_t iWidth = regRead.getWidthInVoxels();
+		// The offset of the start of the region's rows from the start of the volume's rows.
+		const int32_t iSrcOffset = regRead.getLowerX() - regValidRegion.getLowerX();
+
+		for (int32_t z = regRead.getLowerZ(); z <= regRead.getUpperZ(); z++)
+		{
+			const uint32_t uBufferZ = z - regRead.getLowerZ();
+			for (int32_t y = regRead.getLowerY(); y <= regRead.getUpperY(); y++)
+			{
+				const uint32_t uBufferY = y - regRead.getLowerY();
+
+				const VoxelType* pSrcRow = nullptr;
+				if (regValidRegion.containsPointInY(y) && regValidRegion.containsPointInZ(z) && (iInsideBegin < iInsideEnd))
+				{
+					pSrcRow = m_pData + getVoxelIndex(regValidRegion.getLowerX(), y, z);
+				}
+
+				if (bLinear)
+				{
+					VoxelType* pDstRow = pDstBuffer + layout.getIndex(regRead, 0, uBufferY, uBufferZ);
+					if (pSrcRow)
+					{
+						std::fill(pDstRow, pDstRow + iInsideBegin, m_tBorderValue);
+						std::copy(pSrcRow + iSrcOffset + iInsideBegin, pSrcRow + iSrcOffset + iInsideEnd, pDstRow + iInsideBegin);
+						std::fill(pDstRow + iInsideEnd, pDstRow + iWidth, m_tBorderValue);
+					}
+					else
+					{
+						std::fill(pDstRow, pDstRow + iWidth, m_tBorderValue);
+					}
+				}
+				else
+				{
+					const uint32_t uBufferYZ = morton256_y[uBufferY] | morton256_z[uBufferZ];
+					for (int32_t x = 0; x < iWidth; x++)
+					{
+						const bool bInside = pSrcRow && (x >= iInsideBegin) && (x < iInsideEnd);
+						pDstBuffer[morton256_x[x] | uBufferYZ] = bInside ? pSrcRow[iSrcOffset + x] : m_tBorderValue;
+					}
+				}
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Voxels are copied a row at a time, which is much faster than calling setVoxel() for every position.
+	/// \param regWrite The region to copy, which must lie within the volume
+	/// \param pSrcBuffer The buffer to copy from, which must hold at least layout.getRequiredBufferSize(regWrite) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout)
+	{
+		layout.validate(regWrite);
+		POLYVOX_THROW_IF(pSrcBuffer == nullptr, std::invalid_argument, "Source buffer must not be null.");
+		POLYVOX_THROW_IF(!this->m_regValidRegion.containsRegion(regWrite), std::out_of_range, "Region is outside valid region");
+
+		const bool bLinear = (layout.getOrder() == BufferOrders::Linear);
+		const int32_t iWidth = regWrite.getWidthInVoxels();
+
+		for (int32_t z = regWrite.getLowerZ(); z <= regWrite.getUpperZ(); z++)
+		{
+			const uint32_t uBufferZ = z - regWrite.getLowerZ();
+			for (int32_t y = regWrite.getLowerY(); y <= regWrite.getUpperY(); y++)
+			{
+				const uint32_t uBufferY = y - regWrite.getLowerY();
+
+				VoxelType* pDstRow = m_pData + getVoxelIndex(regWrite.getLowerX(), y, z);
+
+				if (bLinear)
+				{
+					const VoxelType* pSrcRow = pSrcBuffer + layout.getIndex(regWrite, 0, uBufferY, uBufferZ);
+					std::copy(pSrcRow, pSrcRow + iWidth, pDstRow);
+				}
+				else
+				{
+					const uint32_t uBufferYZ = morton256_y[uBufferY] | morton256_z[uBufferZ];
+					for (int32_t x = 0; x < iWidth; x++)
+					{
+						pDstRow[x] = pSrcBuffer[morton256_x[x] | uBufferYZ];
+					}
+				}
+			}
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// This function should probably be made internal...
 	////////////////////////////////////////////////////////////////////////////////
@@ -236,11 +343,133 @@ namespace PolyVox
 			POLYVOX_THROW(std::invalid_argument, "Volume depth must be greater than zero.");
 		}
 
-		//Create the data
-		m_pData = new VoxelType[this->getWidth() * this->getHeight()* this->getDepth()];
+		// The data covers the apron as well as the volume itself.
+		m_regDataRegion = regValidRegion;
+		m_regDataRegion.grow(m_uApronSize);
+		m_iYStride = m_regDataRegion.getWidthInVoxels();
+		m_iZStride = m_regDataRegion.getWidthInVoxels() * m_regDataRegion.getHeightInVoxels();
+
+		//Create the data, which is cleared to zeros
+		allocateData();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The data is aligned to a cache line. If huge pages were requested and the volume is big enough to fill at least one
+	/// of them then the memory is mapped directly rather than taken from the heap, so that it can be backed by huge pages.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::allocateData(void)
+	{
+		const size_t uDataAlignment = 64;
+		const size_t uHugePageSizeInBytes = 2 * 1024 * 1024;
+
+		const size_t uNoOfVoxels = static_cast<size_t>(m_iZStride) * m_regDataRegion.getDepthInVoxels();
+		const size_t uDataSizeInBytes = uNoOfVoxels * sizeof(VoxelType);
+
+		uint8_t* pVoxels = nullptr;
+#if !defined(_WIN32)
+		if (m_bUseHugePages && (uDataSizeInBytes >= uHugePageSizeInBytes))
+		{
+			// Mapped memory is page aligned, so it is already aligned to a cache line.
+			m_uAllocationSizeInBytes = uDataSizeInBytes;
+			void* pMapping = mmap(nullptr, m_uAllocationSizeInBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (pMapping != MAP_FAILED)
+			{
+#if defined(MADV_HUGEPAGE)
+				POLYVOX_LOG_WARNING_IF(madvise(pMapping, m_uAllocationSizeInBytes, MADV_HUGEPAGE) != 0, "Huge pages are not available for the volume data.");
+#endif
+				m_pAllocation = static_cast<uint8_t*>(pMapping);
+				m_bAllocationIsMapped = true;
+				pVoxels = m_pAllocation;
+			}
+			else
+			{
+				POLYVOX_LOG_WARNING("Unable to map memory for the volume data, so the heap will be used instead.");
+			}
+		}
+#endif
+
+		if (!pVoxels)
+		{
+			m_uAllocationSizeInBytes = uDataSizeInBytes + uDataAlignment;
+			m_pAllocation = new uint8_t[m_uAllocationSizeInBytes];
+			m_bAllocationIsMapped = false;
+			const uintptr_t uAddress = reinterpret_cast<uintptr_t>(m_pAllocation);
+			pVoxels = m_pAllocation + ((uDataAlignment - (uAddress % uDataAlignment)) % uDataAlignment);
+		}
 
 		// Clear to zeros
-		std::fill(m_pData, m_pData + this->getWidth() * this->getHeight()* this->getDepth(), VoxelType());
+		VoxelType* pFirstVoxel = reinterpret_cast<VoxelType*>(pVoxels);
+		std::uninitialized_fill_n(pFirstVoxel, uNoOfVoxels, VoxelType());
+
+		m_pData = pFirstVoxel + (m_uApronSize + m_uApronSize * m_iYStride + m_uApronSize * m_iZStride);
+	}
+
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::freeData(void)
+	{
+		if (!m_pAllocation)
+		{
+			return;
+		}
+
+		VoxelType* pFirstVoxel = m_pData + getVoxelIndex(m_regDataRegion.getLowerX(), m_regDataRegion.getLowerY(), m_regDataRegion.getLowerZ());
+		const size_t uNoOfVoxels = static_cast<size_t>(m_iZStride) * m_regDataRegion.getDepthInVoxels();
+		for (size_t uVoxel = 0; uVoxel < uNoOfVoxels; uVoxel++)
+		{
+			pFirstVoxel[uVoxel].~VoxelType();
+		}
+
+#if !defined(_WIN32)
+		if (m_bAllocationIsMapped)
+		{
+			munmap(m_pAllocation, m_uAllocationSizeInBytes);
+		}
+		else
+#endif
+		{
+			delete[] m_pAllocation;
+		}
+
+		m_pAllocation = nullptr;
+		m_pData = nullptr;
+	}
+
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::fillApron(void)
+	{
+		if ((m_uApronSize == 0) || (!m_pData))
+		{
+			return;
+		}
+
+		const Region& regValidRegion = this->m_regValidRegion;
+		for (int32_t z = m_regDataRegion.getLowerZ(); z <= m_regDataRegion.getUpperZ(); z++)
+		{
+			for (int32_t y = m_regDataRegion.getLowerY(); y <= m_regDataRegion.getUpperY(); y++)
+			{
+				VoxelType* pRow = m_pData + getVoxelIndex(m_regDataRegion.getLowerX(), y, z);
+				if (regValidRegion.containsPointInY(y) && regValidRegion.containsPointInZ(z))
+				{
+					// Only the ends of rows which pass through the volume are part of the apron.
+					std::fill(pRow, pRow + m_uApronSize, m_tBorderValue);
+					std::fill(pRow + m_uApronSize + this->getWidth(), pRow + m_iYStride, m_tBorderValue);
+				}
+				else
+				{
+					std::fill(pRow, pRow + m_iYStride, m_tBorderValue);
+				}
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	int32_t RawVolume<VoxelType>::getVoxelIndex(int32_t iXPos, int32_t iYPos, int32_t iZPos) const
+	{
+		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+		return (iXPos - v3dLowerCorner.getX()) +
+			(iYPos - v3dLowerCorner.getY()) * m_iYStride +
+			(iZPos - v3dLowerCorner.getZ()) * m_iZStride;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -249,7 +478,7 @@ namespace PolyVox
 	template <typename VoxelType>
 	uint32_t RawVolume<VoxelType>::calculateSizeInBytes(void)
 	{
-		return this->getWidth() * this->getHeight() * this->getDepth() * sizeof(VoxelType);
+		return static_cast<uint32_t>(static_cast<size_t>(m_iZStride) * m_regDataRegion.getDepthInVoxels() * sizeof(VoxelType));
 	}
 }
 
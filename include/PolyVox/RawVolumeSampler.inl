@@ -22,13 +22,6 @@
 * SOFTWARE.
 *******************************************************************************/
 
-#define CAN_GO_NEG_X(val) (val > this->mVolume->getEnclosingRegion().getLowerX())
-#define CAN_GO_POS_X(val) (val < this->mVolume->getEnclosingRegion().getUpperX())
-#define CAN_GO_NEG_Y(val) (val > this->mVolume->getEnclosingRegion().getLowerY())
-#define CAN_GO_POS_Y(val) (val < this->mVolume->getEnclosingRegion().getUpperY())
-#define CAN_GO_NEG_Z(val) (val > this->mVolume->getEnclosingRegion().getLowerZ())
-#define CAN_GO_POS_Z(val) (val < this->mVolume->getEnclosingRegion().getUpperZ())
-
 namespace PolyVox
 {
 	template <typename VoxelType>
@@ -38,6 +31,10 @@ namespace PolyVox
 		, m_bIsCurrentPositionValidInX(false)
 		, m_bIsCurrentPositionValidInY(false)
 		, m_bIsCurrentPositionValidInZ(false)
+		, m_bCanPeekInX(false)
+		, m_bCanPeekInY(false)
+		, m_bCanPeekInZ(false)
+		, m_bCanPeek(false)
 	{
 	}
 
@@ -49,7 +46,8 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::getVoxel(void) const
 	{
-		if (this->isCurrentPositionValid())
+		// The apron holds the border value, so we only need to go through the volume if we are outside of it.
+		if (mCurrentVoxel)
 		{
 			return *mCurrentVoxel;
 		}
@@ -77,23 +75,14 @@ namespace PolyVox
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< RawVolume<VoxelType> >::setPosition(xPos, yPos, zPos);
 
-		m_bIsCurrentPositionValidInX = this->mVolume->getEnclosingRegion().containsPointInX(xPos);
-		m_bIsCurrentPositionValidInY = this->mVolume->getEnclosingRegion().containsPointInY(yPos);
-		m_bIsCurrentPositionValidInZ = this->mVolume->getEnclosingRegion().containsPointInZ(zPos);
+		updateValidityInX();
+		updateValidityInY();
+		updateValidityInZ();
 
-		// Then we update the voxel pointer
-		if (this->isCurrentPositionValid())
+		// Then we update the voxel pointer. This can point into the apron as well as the volume itself.
+		if (this->mVolume->m_regDataRegion.containsPoint(xPos, yPos, zPos))
 		{
-			const Vector3DInt32& v3dLowerCorner = this->mVolume->m_regValidRegion.getLowerCorner();
-			int32_t iLocalXPos = xPos - v3dLowerCorner.getX();
-			int32_t iLocalYPos = yPos - v3dLowerCorner.getY();
-			int32_t iLocalZPos = zPos - v3dLowerCorner.getZ();
-
-			const int32_t uVoxelIndex = iLocalXPos +
-				iLocalYPos * this->mVolume->getWidth() +
-				iLocalZPos * this->mVolume->getWidth() * this->mVolume->getHeight();
-
-			mCurrentVoxel = this->mVolume->m_pData + uVoxelIndex;
+			mCurrentVoxel = this->mVolume->m_pData + this->mVolume->getVoxelIndex(xPos, yPos, zPos);
 		}
 		else
 		{
@@ -119,18 +108,17 @@ namespace PolyVox
 	template <typename VoxelType>
 	void RawVolume<VoxelType>::Sampler::movePositiveX(void)
 	{
-		// We'll need this in a moment...
-		bool bIsOldPositionValid = this->isCurrentPositionValid();
+		// If the old position had both of its neighbours in x inside the volume's data then so does the new one.
+		const bool bCouldPeekInX = m_bCanPeekInX;
 
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< RawVolume<VoxelType> >::movePositiveX();
 
-		m_bIsCurrentPositionValidInX = this->mVolume->getEnclosingRegion().containsPointInX(this->mXPosInVolume);
-
 		// Then we update the voxel pointer
-		if (this->isCurrentPositionValid() && bIsOldPositionValid)
+		if (mCurrentVoxel && bCouldPeekInX)
 		{
 			++mCurrentVoxel;
+			updateValidityInX();
 		}
 		else
 		{
@@ -141,18 +129,17 @@ namespace PolyVox
 	template <typename VoxelType>
 	void RawVolume<VoxelType>::Sampler::movePositiveY(void)
 	{
-		// We'll need this in a moment...
-		bool bIsOldPositionValid = this->isCurrentPositionValid();
+		// If the old position had both of its neighbours in y inside the volume's data then so does the new one.
+		const bool bCouldPeekInY = m_bCanPeekInY;
 
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< RawVolume<VoxelType> >::movePositiveY();
 
-		m_bIsCurrentPositionValidInY = this->mVolume->getEnclosingRegion().containsPointInY(this->mYPosInVolume);
-
 		// Then we update the voxel pointer
-		if (this->isCurrentPositionValid() && bIsOldPositionValid)
+		if (mCurrentVoxel && bCouldPeekInY)
 		{
-			mCurrentVoxel += this->mVolume->getWidth();
+			mCurrentVoxel += this->mVolume->m_iYStride;
+			updateValidityInY();
 		}
 		else
 		{
@@ -163,18 +150,17 @@ namespace PolyVox
 	template <typename VoxelType>
 	void RawVolume<VoxelType>::Sampler::movePositiveZ(void)
 	{
-		// We'll need this in a moment...
-		bool bIsOldPositionValid = this->isCurrentPositionValid();
+		// If the old position had both of its neighbours in z inside the volume's data then so does the new one.
+		const bool bCouldPeekInZ = m_bCanPeekInZ;
 
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< RawVolume<VoxelType> >::movePositiveZ();
 
-		m_bIsCurrentPositionValidInZ = this->mVolume->getEnclosingRegion().containsPointInZ(this->mZPosInVolume);
-
 		// Then we update the voxel pointer
-		if (this->isCurrentPositionValid() && bIsOldPositionValid)
+		if (mCurrentVoxel && bCouldPeekInZ)
 		{
-			mCurrentVoxel += this->mVolume->getWidth() * this->mVolume->getHeight();
+			mCurrentVoxel += this->mVolume->m_iZStride;
+			updateValidityInZ();
 		}
 		else
 		{
@@ -185,18 +171,17 @@ namespace PolyVox
 	template <typename VoxelType>
 	void RawVolume<VoxelType>::Sampler::moveNegativeX(void)
 	{
-		// We'll need this in a moment...
-		bool bIsOldPositionValid = this->isCurrentPositionValid();
+		// If the old position had both of its neighbours in x inside the volume's data then so does the new one.
+		const bool bCouldPeekInX = m_bCanPeekInX;
 
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< RawVolume<VoxelType> >::moveNegativeX();
 
-		m_bIsCurrentPositionValidInX = this->mVolume->getEnclosingRegion().containsPointInX(this->mXPosInVolume);
-
 		// Then we update the voxel pointer
-		if (this->isCurrentPositionValid() && bIsOldPositionValid)
+		if (mCurrentVoxel && bCouldPeekInX)
 		{
 			--mCurrentVoxel;
+			updateValidityInX();
 		}
 		else
 		{
@@ -207,18 +192,17 @@ namespace PolyVox
 	template <typename VoxelType>
 	void RawVolume<VoxelType>::Sampler::moveNegativeY(void)
 	{
-		// We'll need this in a moment...
-		bool bIsOldPositionValid = this->isCurrentPositionValid();
+		// If the old position had both of its neighbours in y inside the volume's data then so does the new one.
+		const bool bCouldPeekInY = m_bCanPeekInY;
 
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< RawVolume<VoxelType> >::moveNegativeY();
 
-		m_bIsCurrentPositionValidInY = this->mVolume->getEnclosingRegion().containsPointInY(this->mYPosInVolume);
-
 		// Then we update the voxel pointer
-		if (this->isCurrentPositionValid() && bIsOldPositionValid)
+		if (mCurrentVoxel && bCouldPeekInY)
 		{
-			mCurrentVoxel -= this->mVolume->getWidth();
+			mCurrentVoxel -= this->mVolume->m_iYStride;
+			updateValidityInY();
 		}
 		else
 		{
@@ -229,18 +213,17 @@ namespace PolyVox
 	template <typename VoxelType>
 	void RawVolume<VoxelType>::Sampler::moveNegativeZ(void)
 	{
-		// We'll need this in a moment...
-		bool bIsOldPositionValid = this->isCurrentPositionValid();
+		// If the old position had both of its neighbours in z inside the volume's data then so does the new one.
+		const bool bCouldPeekInZ = m_bCanPeekInZ;
 
 		// Base version updates position and validity flags.
 		BaseVolume<VoxelType>::template Sampler< RawVolume<VoxelType> >::moveNegativeZ();
 
-		m_bIsCurrentPositionValidInZ = this->mVolume->getEnclosingRegion().containsPointInZ(this->mZPosInVolume);
-
 		// Then we update the voxel pointer
-		if (this->isCurrentPositionValid() && bIsOldPositionValid)
+		if (mCurrentVoxel && bCouldPeekInZ)
 		{
-			mCurrentVoxel -= this->mVolume->getWidth() * this->mVolume->getHeight();
+			mCurrentVoxel -= this->mVolume->m_iZStride;
+			updateValidityInZ();
 		}
 		else
 		{
@@ -248,12 +231,36 @@ namespace PolyVox
 		}
 	}
 
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::Sampler::updateValidityInX(void)
+	{
+		m_bIsCurrentPositionValidInX = this->mVolume->getEnclosingRegion().containsPointInX(this->mXPosInVolume);
+		m_bCanPeekInX = this->mVolume->m_regDataRegion.containsPointInX(this->mXPosInVolume, 1);
+		m_bCanPeek = m_bCanPeekInX && m_bCanPeekInY && m_bCanPeekInZ;
+	}
+
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::Sampler::updateValidityInY(void)
+	{
+		m_bIsCurrentPositionValidInY = this->mVolume->getEnclosingRegion().containsPointInY(this->mYPosInVolume);
+		m_bCanPeekInY = this->mVolume->m_regDataRegion.containsPointInY(this->mYPosInVolume, 1);
+		m_bCanPeek = m_bCanPeekInX && m_bCanPeekInY && m_bCanPeekInZ;
+	}
+
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::Sampler::updateValidityInZ(void)
+	{
+		m_bIsCurrentPositionValidInZ = this->mVolume->getEnclosingRegion().containsPointInZ(this->mZPosInVolume);
+		m_bCanPeekInZ = this->mVolume->m_regDataRegion.containsPointInZ(this->mZPosInVolume, 1);
+		m_bCanPeek = m_bCanPeekInX && m_bCanPeekInY && m_bCanPeekInZ;
+	}
+
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_NEG_Y(this->mYPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 - this->mVolume->getWidth() - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - 1 - this->mVolume->m_iYStride - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume - 1, this->mZPosInVolume - 1);
 	}
@@ -261,9 +268,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx1ny0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_NEG_Y(this->mYPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 - this->mVolume->getWidth());
+			return *(mCurrentVoxel - 1 - this->mVolume->m_iYStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume - 1, this->mZPosInVolume);
 	}
@@ -271,9 +278,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx1ny1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_NEG_Y(this->mYPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 - this->mVolume->getWidth() + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - 1 - this->mVolume->m_iYStride + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume - 1, this->mZPosInVolume + 1);
 	}
@@ -281,9 +288,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx0py1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - 1 - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume, this->mZPosInVolume - 1);
 	}
@@ -291,7 +298,7 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx0py0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume))
+		if (m_bCanPeek)
 		{
 			return *(mCurrentVoxel - 1);
 		}
@@ -301,9 +308,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx0py1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - 1 + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume, this->mZPosInVolume + 1);
 	}
@@ -311,9 +318,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx1py1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_POS_Y(this->mYPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 + this->mVolume->getWidth() - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - 1 + this->mVolume->m_iYStride - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume + 1, this->mZPosInVolume - 1);
 	}
@@ -321,9 +328,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx1py0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_POS_Y(this->mYPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 + this->mVolume->getWidth());
+			return *(mCurrentVoxel - 1 + this->mVolume->m_iYStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume + 1, this->mZPosInVolume);
 	}
@@ -331,9 +338,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx1py1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_X(this->mXPosInVolume) && CAN_GO_POS_Y(this->mYPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - 1 + this->mVolume->getWidth() + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - 1 + this->mVolume->m_iYStride + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume - 1, this->mYPosInVolume + 1, this->mZPosInVolume + 1);
 	}
@@ -343,9 +350,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px1ny1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_Y(this->mYPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - this->mVolume->getWidth() - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - this->mVolume->m_iYStride - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume - 1, this->mZPosInVolume - 1);
 	}
@@ -353,9 +360,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px1ny0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_Y(this->mYPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - this->mVolume->getWidth());
+			return *(mCurrentVoxel - this->mVolume->m_iYStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume - 1, this->mZPosInVolume);
 	}
@@ -363,9 +370,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px1ny1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_Y(this->mYPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - this->mVolume->getWidth() + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - this->mVolume->m_iYStride + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume - 1, this->mZPosInVolume + 1);
 	}
@@ -373,9 +380,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px0py1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume - 1);
 	}
@@ -383,19 +390,15 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px0py0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()))
-		{
-			return *mCurrentVoxel;
-		}
-		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		return getVoxel();
 	}
 
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px0py1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume + 1);
 	}
@@ -403,9 +406,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px1py1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_Y(this->mYPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + this->mVolume->getWidth() - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + this->mVolume->m_iYStride - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume + 1, this->mZPosInVolume - 1);
 	}
@@ -413,9 +416,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px1py0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_Y(this->mYPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + this->mVolume->getWidth());
+			return *(mCurrentVoxel + this->mVolume->m_iYStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume + 1, this->mZPosInVolume);
 	}
@@ -423,9 +426,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel0px1py1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_Y(this->mYPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + this->mVolume->getWidth() + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + this->mVolume->m_iYStride + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume + 1, this->mZPosInVolume + 1);
 	}
@@ -435,9 +438,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px1ny1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_NEG_Y(this->mYPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 - this->mVolume->getWidth() - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + 1 - this->mVolume->m_iYStride - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume - 1, this->mZPosInVolume - 1);
 	}
@@ -445,9 +448,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px1ny0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_NEG_Y(this->mYPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 - this->mVolume->getWidth());
+			return *(mCurrentVoxel + 1 - this->mVolume->m_iYStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume - 1, this->mZPosInVolume);
 	}
@@ -455,9 +458,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px1ny1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_NEG_Y(this->mYPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 - this->mVolume->getWidth() + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + 1 - this->mVolume->m_iYStride + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume - 1, this->mZPosInVolume + 1);
 	}
@@ -465,9 +468,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px0py1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + 1 - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume, this->mZPosInVolume - 1);
 	}
@@ -475,7 +478,7 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px0py0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume))
+		if (m_bCanPeek)
 		{
 			return *(mCurrentVoxel + 1);
 		}
@@ -485,9 +488,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px0py1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + 1 + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume, this->mZPosInVolume + 1);
 	}
@@ -495,9 +498,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px1py1nz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_POS_Y(this->mYPosInVolume) && CAN_GO_NEG_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 + this->mVolume->getWidth() - this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + 1 + this->mVolume->m_iYStride - this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume + 1, this->mZPosInVolume - 1);
 	}
@@ -505,9 +508,9 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px1py0pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_POS_Y(this->mYPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 + this->mVolume->getWidth());
+			return *(mCurrentVoxel + 1 + this->mVolume->m_iYStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume + 1, this->mZPosInVolume);
 	}
@@ -515,17 +518,10 @@ namespace PolyVox
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1px1py1pz(void) const
 	{
-		if ((this->isCurrentPositionValid()) && CAN_GO_POS_X(this->mXPosInVolume) && CAN_GO_POS_Y(this->mYPosInVolume) && CAN_GO_POS_Z(this->mZPosInVolume))
+		if (m_bCanPeek)
 		{
-			return *(mCurrentVoxel + 1 + this->mVolume->getWidth() + this->mVolume->getWidth() * this->mVolume->getHeight());
+			return *(mCurrentVoxel + 1 + this->mVolume->m_iYStride + this->mVolume->m_iZStride);
 		}
 		return this->mVolume->getVoxel(this->mXPosInVolume + 1, this->mYPosInVolume + 1, this->mZPosInVolume + 1);
 	}
 }
-
-#undef CAN_GO_NEG_X
-#undef CAN_GO_POS_X
-#undef CAN_GO_NEG_Y
-#undef CAN_GO_POS_Y
-#undef CAN_GO_NEG_Z
-#undef CAN_GO_POS_Z
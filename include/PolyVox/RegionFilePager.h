@@ -0,0 +1,582 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_RegionFilePager_H__
+#define __PolyVox_RegionFilePager_H__
+
+#include "Impl/PlatformDefinitions.h"
+
+#include "PagedVolume.h"
+#include "Region.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace PolyVox
+{
+	/**
+	 * An implementation of Pager which packs chunks into a small number of large 'region files' on disk.
+	 *
+	 * Unlike the FilePager (which writes every chunk to a separate, temporary file) the data written by this pager is
+	 * persistent, so a volume can be paged back in by a later run of the application. Each region file holds a cube of
+	 * chunks (8x8x8 by default) and starts with an index giving the position and size of every chunk in the file, so only
+	 * a handful of files are ever open and finding a chunk does not require the file system to search a huge directory.
+	 *
+	 * Space within a file is managed by appending. A chunk is overwritten in place if it still fits in the space it
+	 * occupied before, and otherwise it is written to the end of the file and its old space is abandoned. Once enough
+	 * space has been abandoned the file is compacted, which rewrites it with the chunks packed together in index order.
+	 * As neighbouring chunks (along the x axis) are then also neighbours on disk, paging in a chunk reads any following
+	 * chunks which are stored contiguously with it in the same read, and keeps them until they are paged in too.
+	 *
+	 * As with the FilePager no compression is performed, uniform chunks are stored as a single voxel, and the data is
+	 * written in the native byte order so the files are not portable between platforms with different endianness. The
+	 * pager does not need to be thread safe because calls to it are serialised by the PagedVolume, but a set of region
+	 * files should only be used by one pager at a time.
+	 */
+	template <typename VoxelType>
+	class RegionFilePager : public PagedVolume<VoxelType>::Pager
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t uNoOfChunksPagedIn; ///< Calls to pageIn(), including those for chunks which were not in any file.
+			uint64_t uNoOfFileReads; ///< Reads from a region file when paging in, each of which may fetch several chunks.
+			uint64_t uNoOfReadAheadHits; ///< Chunks which were paged in from data fetched along with an earlier chunk.
+			uint64_t uNoOfCompactions; ///< Times a region file has been rewritten to reclaim abandoned space.
+		};
+
+		/// Constructor
+		/// \param strFolderName The folder containing the region files, which must already exist.
+		/// \param uRegionSideLengthInChunks The number of chunks along each side of the cube stored in each region file.
+		/// \param uMaxOpenFiles The number of region files which are kept open at once.
+		/// \param uMaxReadAheadChunks The maximum number of chunks which are fetched by a single read.
+		RegionFilePager(const std::string& strFolderName = ".", uint32_t uRegionSideLengthInChunks = 8, uint32_t uMaxOpenFiles = 16, uint32_t uMaxReadAheadChunks = 8)
+			:PagedVolume<VoxelType>::Pager()
+			, m_strFolderName(strFolderName)
+			, m_uRegionSideLengthInChunks(uRegionSideLengthInChunks)
+			, m_uMaxOpenFiles(uMaxOpenFiles)
+			, m_uMaxReadAheadChunks(uMaxReadAheadChunks)
+		{
+			POLYVOX_THROW_IF(uRegionSideLengthInChunks == 0, std::invalid_argument, "Region side length must be greater than zero.");
+			POLYVOX_THROW_IF(uMaxOpenFiles == 0, std::invalid_argument, "Must allow at least one open file.");
+
+			// Add the trailing slash, assuming the user dind't already do it.
+			if ((m_strFolderName.back() != '/') && (m_strFolderName.back() != '\\'))
+			{
+				m_strFolderName.append("/");
+			}
+
+			m_statistics = Statistics();
+		}
+
+		/// Destructor
+		virtual ~RegionFilePager()
+		{
+			// Region files are not deleted, as the whole point is that they persist.
+			while (!m_listOpenFiles.empty())
+			{
+				closeFile(m_listOpenFiles.back());
+				m_listOpenFiles.pop_back();
+			}
+		}
+
+		virtual void pageIn(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
+		{
+			POLYVOX_ASSERT(pChunk, "Attempting to page in NULL chunk");
+
+			m_statistics.uNoOfChunksPagedIn++;
+
+			const ChunkKey key = getChunkKey(region);
+
+			// The chunk may have been fetched along with one of its neighbours.
+			auto iterReadAhead = m_mapReadAheadChunks.find(key);
+			if (iterReadAhead != m_mapReadAheadChunks.end())
+			{
+				POLYVOX_LOG_TRACE("Paging in data for ", region, " from read-ahead");
+				m_statistics.uNoOfReadAheadHits++;
+				copyToChunk(iterReadAhead->second.data(), static_cast<uint32_t>(iterReadAhead->second.size()), pChunk);
+				m_mapReadAheadChunks.erase(iterReadAhead);
+				return;
+			}
+
+			RegionFile* pFile = getFile(region, false);
+			const uint32_t uIndex = pFile ? getIndexInFile(key) : 0;
+			if (!pFile || (pFile->vecIndex[uIndex].uLength == 0))
+			{
+				POLYVOX_LOG_TRACE("No data found for ", region, " during paging in.");
+				pChunk->setUniform(VoxelType());
+				return;
+			}
+
+			POLYVOX_LOG_TRACE("Paging in data for ", region);
+
+			// Extend the read over any following chunks in the same row which are stored immediately after this one.
+			const uint32_t uLocalX = uIndex % m_uRegionSideLengthInChunks;
+			uint32_t uLastIndex = uIndex;
+			while ((uLastIndex - uIndex + 1 < m_uMaxReadAheadChunks) && (uLocalX + (uLastIndex - uIndex) + 1 < m_uRegionSideLengthInChunks))
+			{
+				const IndexEntry& entry = pFile->vecIndex[uLastIndex];
+				const IndexEntry& nextEntry = pFile->vecIndex[uLastIndex + 1];
+				if ((nextEntry.uLength == 0) || (nextEntry.uOffset != entry.uOffset + entry.uCapacity))
+				{
+					break;
+				}
+				uLastIndex++;
+			}
+
+			const IndexEntry& firstEntry = pFile->vecIndex[uIndex];
+			const IndexEntry& lastEntry = pFile->vecIndex[uLastIndex];
+			const uint64_t uReadSize = lastEntry.uOffset + lastEntry.uLength - firstEntry.uOffset;
+			m_vecReadBuffer.resize(static_cast<size_t>(uReadSize));
+			readFromFile(pFile, firstEntry.uOffset, m_vecReadBuffer.data(), m_vecReadBuffer.size());
+			m_statistics.uNoOfFileReads++;
+
+			copyToChunk(m_vecReadBuffer.data(), firstEntry.uLength, pChunk);
+
+			// Only the most recent read is kept, so the read-ahead data never builds up.
+			m_mapReadAheadChunks.clear();
+			for (uint32_t uNext = uIndex + 1; uNext <= uLastIndex; uNext++)
+			{
+				const IndexEntry& entry = pFile->vecIndex[uNext];
+				const uint8_t* pData = m_vecReadBuffer.data() + (entry.uOffset - firstEntry.uOffset);
+				ChunkKey nextKey(std::get<0>(key) + static_cast<int32_t>(uNext - uIndex), std::get<1>(key), std::get<2>(key));
+				m_mapReadAheadChunks[nextKey].assign(pData, pData + entry.uLength);
+			}
+		}
+
+		virtual void pageOut(const Region& region, typename PagedVolume<VoxelType>::Chunk* pChunk)
+		{
+			POLYVOX_ASSERT(pChunk, "Attempting to page out NULL chunk");
+
+			POLYVOX_LOG_TRACE("Paging out data for ", region);
+
+			const ChunkKey key = getChunkKey(region);
+			m_mapReadAheadChunks.erase(key);
+
+			RegionFile* pFile = getFile(region, true);
+			IndexEntry& entry = pFile->vecIndex[getIndexInFile(key)];
+
+			VoxelType tUniformValue;
+			const void* pData = nullptr;
+			uint32_t uLength = 0;
+			if (pChunk->isUniform())
+			{
+				tUniformValue = pChunk->getUniformValue();
+				pData = &tUniformValue;
+				uLength = sizeof(VoxelType);
+			}
+			else
+			{
+				pData = pChunk->getData();
+				uLength = pChunk->getDataSizeInBytes();
+			}
+
+			// Overwrite the chunk in place if it fits, and otherwise append it and abandon the old space.
+			if (uLength > entry.uCapacity)
+			{
+				pFile->uAbandonedBytes += entry.uCapacity;
+				entry.uOffset = pFile->uFileSize;
+				entry.uCapacity = uLength;
+				pFile->uFileSize += uLength;
+			}
+			entry.uLength = uLength;
+
+			// The data is written before the index, so an interruption between the two leaves the old version of the chunk intact.
+			writeToFile(pFile, entry.uOffset, pData, uLength);
+			writeToFile(pFile, getIndexEntryOffset(getIndexInFile(key)), &entry, sizeof(IndexEntry));
+
+			if (shouldCompact(pFile))
+			{
+				compact(pFile);
+			}
+		}
+
+		/// Rewrites every open region file which is not already packed, so that it holds only the current chunks and they are stored
+		/// in index order. This is useful after writing a lot of data, as chunks are appended in the order they are paged out.
+		void compactAll(void)
+		{
+			for (auto iter = m_listOpenFiles.begin(); iter != m_listOpenFiles.end(); iter++)
+			{
+				if (!isPacked(iter->get()))
+				{
+					compact(iter->get());
+				}
+			}
+		}
+
+		/// Ensures everything written so far has been passed to the operating system.
+		void flush(void)
+		{
+			for (auto iter = m_listOpenFiles.begin(); iter != m_listOpenFiles.end(); iter++)
+			{
+				fflush((*iter)->pFile);
+			}
+		}
+
+		Statistics getStatistics(void) const
+		{
+			return m_statistics;
+		}
+
+	private:
+		typedef std::tuple<int32_t, int32_t, int32_t> ChunkKey;
+
+		// The header is followed immediately by one index entry per chunk, and then by the chunk data.
+		struct FileHeader
+		{
+			char acMagic[4];
+			uint32_t uVersion;
+			uint32_t uRegionSideLengthInChunks;
+			uint32_t uChunkSideLength;
+			uint32_t uVoxelSizeInBytes;
+		};
+
+		struct IndexEntry
+		{
+			uint64_t uOffset;
+			uint32_t uLength; ///< The size of the chunk's data, or zero if the chunk is not in the file.
+			uint32_t uCapacity; ///< The space reserved for the chunk, which can be more than its current size.
+		};
+
+		struct RegionFile
+		{
+			RegionFile()
+				:pFile(nullptr)
+				, uFileSize(0)
+				, uAbandonedBytes(0)
+			{
+			}
+
+			// Files are normally closed explicitly so that errors can be reported, but this ensures nothing leaks if an exception is thrown.
+			~RegionFile()
+			{
+				if (pFile)
+				{
+					fclose(pFile);
+				}
+			}
+
+			std::string strFilename;
+			ChunkKey regionKey;
+			FILE* pFile;
+			std::vector<IndexEntry> vecIndex;
+			uint64_t uFileSize;
+			uint64_t uAbandonedBytes;
+		};
+
+		static const uint32_t uFileFormatVersion = 1;
+
+		static int32_t floorDivide(int32_t iValue, int32_t iDivisor)
+		{
+			return (iValue >= 0) ? (iValue / iDivisor) : -((-iValue + iDivisor - 1) / iDivisor);
+		}
+
+		ChunkKey getChunkKey(const Region& region) const
+		{
+			const int32_t iSideLength = region.getWidthInVoxels();
+			return ChunkKey(floorDivide(region.getLowerX(), iSideLength), floorDivide(region.getLowerY(), iSideLength), floorDivide(region.getLowerZ(), iSideLength));
+		}
+
+		ChunkKey getRegionKey(const ChunkKey& chunkKey) const
+		{
+			const int32_t iSide = static_cast<int32_t>(m_uRegionSideLengthInChunks);
+			return ChunkKey(floorDivide(std::get<0>(chunkKey), iSide), floorDivide(std::get<1>(chunkKey), iSide), floorDivide(std::get<2>(chunkKey), iSide));
+		}
+
+		// Chunks are indexed with x varying fastest, so neighbours along x are neighbours in the index.
+		uint32_t getIndexInFile(const ChunkKey& chunkKey) const
+		{
+			const int32_t iSide = static_cast<int32_t>(m_uRegionSideLengthInChunks);
+			const ChunkKey regionKey = getRegionKey(chunkKey);
+			const uint32_t uLocalX = std::get<0>(chunkKey) - std::get<0>(regionKey) * iSide;
+			const uint32_t uLocalY = std::get<1>(chunkKey) - std::get<1>(regionKey) * iSide;
+			const uint32_t uLocalZ = std::get<2>(chunkKey) - std::get<2>(regionKey) * iSide;
+			return uLocalX + uLocalY * m_uRegionSideLengthInChunks + uLocalZ * m_uRegionSideLengthInChunks * m_uRegionSideLengthInChunks;
+		}
+
+		uint32_t getNoOfChunksPerFile(void) const
+		{
+			return m_uRegionSideLengthInChunks * m_uRegionSideLengthInChunks * m_uRegionSideLengthInChunks;
+		}
+
+		uint64_t getIndexEntryOffset(uint32_t uIndex) const
+		{
+			return sizeof(FileHeader) + static_cast<uint64_t>(uIndex) * sizeof(IndexEntry);
+		}
+
+		uint64_t getDataOffset(void) const
+		{
+			return getIndexEntryOffset(getNoOfChunksPerFile());
+		}
+
+		std::string getFilename(const ChunkKey& regionKey) const
+		{
+			std::stringstream ssFilename;
+			ssFilename << m_strFolderName << "region_" << std::get<0>(regionKey) << "_" << std::get<1>(regionKey) << "_" << std::get<2>(regionKey) << ".pvr";
+			return ssFilename.str();
+		}
+
+		// Abandoned space is reclaimed once it makes up over half of the file's data.
+		bool shouldCompact(const RegionFile* pFile) const
+		{
+			return pFile->uAbandonedBytes * 2 > pFile->uFileSize - getDataOffset();
+		}
+
+		// Whether the chunks are stored one after another in index order, with no gaps.
+		bool isPacked(const RegionFile* pFile) const
+		{
+			uint64_t uExpectedOffset = getDataOffset();
+			for (auto iter = pFile->vecIndex.begin(); iter != pFile->vecIndex.end(); iter++)
+			{
+				if (iter->uLength > 0)
+				{
+					if ((iter->uOffset != uExpectedOffset) || (iter->uCapacity != iter->uLength))
+					{
+						return false;
+					}
+					uExpectedOffset += iter->uLength;
+				}
+			}
+			return uExpectedOffset == pFile->uFileSize;
+		}
+
+		void copyToChunk(const uint8_t* pData, uint32_t uLength, typename PagedVolume<VoxelType>::Chunk* pChunk)
+		{
+			// Uniform chunks are stored as a single voxel.
+			if (uLength == sizeof(VoxelType))
+			{
+				VoxelType tUniformValue;
+				std::memcpy(&tUniformValue, pData, sizeof(VoxelType));
+				pChunk->setUniform(tUniformValue);
+			}
+			else
+			{
+				POLYVOX_THROW_IF(uLength != pChunk->getDataSizeInBytes(), std::runtime_error, "Chunk data in region file has the wrong size.");
+				std::memcpy(pChunk->getData(), pData, uLength);
+			}
+		}
+
+		// Finds the file which holds the given chunk, opening it if necessary. If the file does not exist it is only created if bCreate is set.
+		RegionFile* getFile(const Region& region, bool bCreate)
+		{
+			const ChunkKey regionKey = getRegionKey(getChunkKey(region));
+
+			// Open files are kept in order of use, with the most recent at the front.
+			for (auto iter = m_listOpenFiles.begin(); iter != m_listOpenFiles.end(); iter++)
+			{
+				if ((*iter)->regionKey == regionKey)
+				{
+					m_listOpenFiles.splice(m_listOpenFiles.begin(), m_listOpenFiles, iter);
+					return m_listOpenFiles.front().get();
+				}
+			}
+
+			std::unique_ptr<RegionFile> pRegionFile(new RegionFile);
+			pRegionFile->strFilename = getFilename(regionKey);
+			pRegionFile->regionKey = regionKey;
+
+			// FIXME - This should be replaced by C++ style IO, but currently this causes problems with
+			// the gameplay-cubiquity integration. See: https://github.com/blackberry/GamePlay/issues/919
+			pRegionFile->pFile = fopen(pRegionFile->strFilename.c_str(), "r+b");
+			if (pRegionFile->pFile)
+			{
+				readIndex(pRegionFile.get(), static_cast<uint32_t>(region.getWidthInVoxels()));
+			}
+			else
+			{
+				if (!bCreate)
+				{
+					return nullptr;
+				}
+
+				pRegionFile->pFile = fopen(pRegionFile->strFilename.c_str(), "w+b");
+				POLYVOX_THROW_IF(!pRegionFile->pFile, std::runtime_error, "Unable to create region file.");
+				pRegionFile->vecIndex.assign(getNoOfChunksPerFile(), IndexEntry());
+				writeIndex(pRegionFile.get(), static_cast<uint32_t>(region.getWidthInVoxels()));
+			}
+
+			if (m_listOpenFiles.size() >= m_uMaxOpenFiles)
+			{
+				closeFile(m_listOpenFiles.back());
+				m_listOpenFiles.pop_back();
+			}
+
+			m_listOpenFiles.push_front(std::move(pRegionFile));
+			return m_listOpenFiles.front().get();
+		}
+
+		void closeFile(const std::unique_ptr<RegionFile>& pRegionFile)
+		{
+			POLYVOX_LOG_WARNING_IF(fclose(pRegionFile->pFile) != 0, "Failed to close '", pRegionFile->strFilename, "'");
+			pRegionFile->pFile = nullptr;
+		}
+
+		void readIndex(RegionFile* pFile, uint32_t uChunkSideLength)
+		{
+			FileHeader header;
+			readFromFile(pFile, 0, &header, sizeof(header));
+			POLYVOX_THROW_IF(std::memcmp(header.acMagic, "PVRF", 4) != 0, std::runtime_error, "File is not a PolyVox region file.");
+			POLYVOX_THROW_IF(header.uVersion != uFileFormatVersion, std::runtime_error, "Region file has an unsupported version.");
+			POLYVOX_THROW_IF((header.uRegionSideLengthInChunks != m_uRegionSideLengthInChunks) || (header.uChunkSideLength != uChunkSideLength) ||
+				(header.uVoxelSizeInBytes != sizeof(VoxelType)), std::runtime_error, "Region file was written with different settings.");
+
+			pFile->vecIndex.resize(getNoOfChunksPerFile());
+			readFromFile(pFile, getIndexEntryOffset(0), pFile->vecIndex.data(), pFile->vecIndex.size() * sizeof(IndexEntry));
+
+			// Whatever is not reserved by a chunk has been abandoned.
+			seekInFile(pFile, 0, SEEK_END);
+			pFile->uFileSize = tellInFile(pFile);
+			uint64_t uReservedBytes = 0;
+			for (auto iter = pFile->vecIndex.begin(); iter != pFile->vecIndex.end(); iter++)
+			{
+				uReservedBytes += iter->uCapacity;
+			}
+			pFile->uAbandonedBytes = pFile->uFileSize - getDataOffset() - uReservedBytes;
+		}
+
+		void writeIndex(RegionFile* pFile, uint32_t uChunkSideLength)
+		{
+			FileHeader header;
+			std::memcpy(header.acMagic, "PVRF", 4);
+			header.uVersion = uFileFormatVersion;
+			header.uRegionSideLengthInChunks = m_uRegionSideLengthInChunks;
+			header.uChunkSideLength = uChunkSideLength;
+			header.uVoxelSizeInBytes = sizeof(VoxelType);
+
+			writeToFile(pFile, 0, &header, sizeof(header));
+			writeToFile(pFile, getIndexEntryOffset(0), pFile->vecIndex.data(), pFile->vecIndex.size() * sizeof(IndexEntry));
+			pFile->uFileSize = (std::max)(pFile->uFileSize, getDataOffset());
+		}
+
+		// Rewrites the file with the chunks packed together in index order, and replaces the original with it.
+		void compact(RegionFile* pFile)
+		{
+			POLYVOX_LOG_DEBUG("Compacting ", pFile->strFilename);
+			m_statistics.uNoOfCompactions++;
+
+			FileHeader header;
+			readFromFile(pFile, 0, &header, sizeof(header));
+
+			RegionFile newFile;
+			newFile.strFilename = pFile->strFilename + ".tmp";
+			newFile.regionKey = pFile->regionKey;
+			newFile.pFile = fopen(newFile.strFilename.c_str(), "w+b");
+			POLYVOX_THROW_IF(!newFile.pFile, std::runtime_error, "Unable to create temporary file for compacting region file.");
+			newFile.vecIndex.assign(getNoOfChunksPerFile(), IndexEntry());
+			newFile.uFileSize = getDataOffset();
+
+			std::vector<uint8_t> vecChunkData;
+			for (uint32_t uIndex = 0; uIndex < pFile->vecIndex.size(); uIndex++)
+			{
+				const IndexEntry& entry = pFile->vecIndex[uIndex];
+				if (entry.uLength > 0)
+				{
+					vecChunkData.resize(entry.uLength);
+					readFromFile(pFile, entry.uOffset, vecChunkData.data(), entry.uLength);
+					writeToFile(&newFile, newFile.uFileSize, vecChunkData.data(), entry.uLength);
+
+					newFile.vecIndex[uIndex].uOffset = newFile.uFileSize;
+					newFile.vecIndex[uIndex].uLength = entry.uLength;
+					newFile.vecIndex[uIndex].uCapacity = entry.uLength;
+					newFile.uFileSize += entry.uLength;
+				}
+			}
+			writeIndex(&newFile, header.uChunkSideLength);
+
+			// Some platforms cannot rename over an existing file, so the original has to be removed first.
+			fclose(newFile.pFile);
+			newFile.pFile = nullptr;
+			fclose(pFile->pFile);
+			pFile->pFile = nullptr;
+			POLYVOX_THROW_IF(std::remove(pFile->strFilename.c_str()) != 0, std::runtime_error, "Unable to replace region file when compacting it.");
+			POLYVOX_THROW_IF(std::rename(newFile.strFilename.c_str(), pFile->strFilename.c_str()) != 0, std::runtime_error, "Unable to replace region file when compacting it.");
+
+			pFile->pFile = fopen(pFile->strFilename.c_str(), "r+b");
+			POLYVOX_THROW_IF(!pFile->pFile, std::runtime_error, "Unable to reopen region file after compacting it.");
+			pFile->vecIndex.swap(newFile.vecIndex);
+			pFile->uFileSize = newFile.uFileSize;
+			pFile->uAbandonedBytes = 0;
+
+			// Chunks have moved, but the read-ahead data holds copies rather than positions so it is still valid.
+		}
+
+		// Offsets can exceed the range of a long, so use the 64-bit versions of fseek() and ftell() where they are named differently.
+		static void seekInFile(RegionFile* pFile, uint64_t uOffset, int iOrigin)
+		{
+#if defined(_MSC_VER)
+			const int iResult = _fseeki64(pFile->pFile, static_cast<int64_t>(uOffset), iOrigin);
+#else
+			const int iResult = fseeko(pFile->pFile, static_cast<off_t>(uOffset), iOrigin);
+#endif
+			POLYVOX_THROW_IF(iResult != 0, std::runtime_error, "Unable to seek in region file.");
+		}
+
+		static uint64_t tellInFile(RegionFile* pFile)
+		{
+#if defined(_MSC_VER)
+			return static_cast<uint64_t>(_ftelli64(pFile->pFile));
+#else
+			return static_cast<uint64_t>(ftello(pFile->pFile));
+#endif
+		}
+
+		static void readFromFile(RegionFile* pFile, uint64_t uOffset, void* pData, size_t uSizeInBytes)
+		{
+			seekInFile(pFile, uOffset, SEEK_SET);
+			const size_t uRead = fread(pData, 1, uSizeInBytes, pFile->pFile);
+			POLYVOX_THROW_IF(uRead != uSizeInBytes, std::runtime_error, "Error reading from region file.");
+		}
+
+		static void writeToFile(RegionFile* pFile, uint64_t uOffset, const void* pData, size_t uSizeInBytes)
+		{
+			seekInFile(pFile, uOffset, SEEK_SET);
+			const size_t uWritten = fwrite(pData, 1, uSizeInBytes, pFile->pFile);
+			POLYVOX_THROW_IF(uWritten != uSizeInBytes, std::runtime_error, "Error writing to region file.");
+		}
+
+		std::string m_strFolderName;
+		uint32_t m_uRegionSideLengthInChunks;
+		uint32_t m_uMaxOpenFiles;
+		uint32_t m_uMaxReadAheadChunks;
+
+		std::list< std::unique_ptr<RegionFile> > m_listOpenFiles;
+
+		std::map< ChunkKey, std::vector<uint8_t> > m_mapReadAheadChunks;
+		std::vector<uint8_t> m_vecReadBuffer;
+
+		Statistics m_statistics;
+	};
+}
+
+#endif //__PolyVox_RegionFilePager_H__
@@ -0,0 +1,182 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_RegionView_H__
+#define __PolyVox_RegionView_H__
+
+#include "Impl/ErrorHandling.h"
+#include "Impl/PlatformDefinitions.h"
+
+#include "BaseVolume.h"
+#include "BufferLayout.h"
+#include "Region.h"
+#include "Vector.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept> //For invalid_argument
+
+namespace PolyVox
+{
+	/**
+	 * A linear copy of a region of a volume (plus a 'halo' of neighbouring voxels) which algorithms can read at fixed strides.
+	 *
+	 * Kernels such as filters and gradient estimators read every voxel several times as part of overlapping neighbourhoods.
+	 * Doing this through a volume's Sampler means that each read has to check the edges of the volume (and for a PagedVolume,
+	 * the edges of the current chunk). Instead, stage() copies the region and its halo into a contiguous, cache line aligned
+	 * block in a single bulk readRegion() call, which a PagedVolume services a chunk at a time. Afterwards any voxel of the
+	 * staged region is at a fixed offset from its neighbours, so kernels can walk it with plain pointer arithmetic or with
+	 * the provided Sampler.
+	 *
+	 * Voxels outside the volume take the volume's border value, exactly as if they had been read with getVoxel(). The view
+	 * is a snapshot, so later changes to the volume are not seen until it is staged again.
+	 *
+	 * The block is only ever grown, so a view which is kept around and staged repeatedly (for example once for each region
+	 * of a volume which is being meshed) stops allocating once it has seen the largest region.
+	 */
+	template <typename _VoxelType>
+	class RegionView
+	{
+	public:
+		typedef _VoxelType VoxelType;
+
+		/// Reads voxels from a staged RegionView with the same interface as a volume's Sampler, but without any bounds checks.
+		/// The caller must ensure that the current position and any neighbours which are peeked lie within the staged region.
+		class Sampler
+		{
+		public:
+			Sampler(const RegionView<VoxelType>* view);
+
+			inline const VoxelType& getVoxel(void) const;
+
+			void setPosition(const Vector3DInt32& v3dNewPos);
+			void setPosition(int32_t xPos, int32_t yPos, int32_t zPos);
+
+			inline void movePositiveX(void);
+			inline void movePositiveY(void);
+			inline void movePositiveZ(void);
+
+			inline void moveNegativeX(void);
+			inline void moveNegativeY(void);
+			inline void moveNegativeZ(void);
+
+			inline const VoxelType& peekVoxel1nx1ny1nz(void) const;
+			inline const VoxelType& peekVoxel1nx1ny0pz(void) const;
+			inline const VoxelType& peekVoxel1nx1ny1pz(void) const;
+			inline const VoxelType& peekVoxel1nx0py1nz(void) const;
+			inline const VoxelType& peekVoxel1nx0py0pz(void) const;
+			inline const VoxelType& peekVoxel1nx0py1pz(void) const;
+			inline const VoxelType& peekVoxel1nx1py1nz(void) const;
+			inline const VoxelType& peekVoxel1nx1py0pz(void) const;
+			inline const VoxelType& peekVoxel1nx1py1pz(void) const;
+
+			inline const VoxelType& peekVoxel0px1ny1nz(void) const;
+			inline const VoxelType& peekVoxel0px1ny0pz(void) const;
+			inline const VoxelType& peekVoxel0px1ny1pz(void) const;
+			inline const VoxelType& peekVoxel0px0py1nz(void) const;
+			inline const VoxelType& peekVoxel0px0py0pz(void) const;
+			inline const VoxelType& peekVoxel0px0py1pz(void) const;
+			inline const VoxelType& peekVoxel0px1py1nz(void) const;
+			inline const VoxelType& peekVoxel0px1py0pz(void) const;
+			inline const VoxelType& peekVoxel0px1py1pz(void) const;
+
+			inline const VoxelType& peekVoxel1px1ny1nz(void) const;
+			inline const VoxelType& peekVoxel1px1ny0pz(void) const;
+			inline const VoxelType& peekVoxel1px1ny1pz(void) const;
+			inline const VoxelType& peekVoxel1px0py1nz(void) const;
+			inline const VoxelType& peekVoxel1px0py0pz(void) const;
+			inline const VoxelType& peekVoxel1px0py1pz(void) const;
+			inline const VoxelType& peekVoxel1px1py1nz(void) const;
+			inline const VoxelType& peekVoxel1px1py0pz(void) const;
+			inline const VoxelType& peekVoxel1px1py1pz(void) const;
+
+		private:
+			const RegionView<VoxelType>* mView;
+			const VoxelType* mCurrentVoxel;
+
+			// Copied from the view so that the peeks do not need to go through it.
+			int32_t m_iYStride;
+			int32_t m_iZStride;
+		};
+
+	public:
+		/// Constructor for creating an empty view. Nothing is allocated until the first call to stage().
+		RegionView();
+		/// Destructor
+		~RegionView();
+
+		// These are deleted to avoid accidental copying of the block.
+		RegionView(const RegionView&) = delete;
+		RegionView& operator=(const RegionView&) = delete;
+
+		/// Copies the given region of the volume, grown by the given number of voxels on every side, into the view.
+		template <typename VolumeType>
+		void stage(VolumeType* pVolume, const Region& region, uint16_t uHaloSize);
+
+		/// Gets the region which was passed to stage(), not including the halo.
+		const Region& getRegion(void) const;
+		/// Gets the region which is actually held by the view, which is the region grown by the halo.
+		const Region& getStagedRegion(void) const;
+		/// Gets the number of voxels by which the region was grown on every side.
+		uint16_t getHaloSize(void) const;
+
+		/// Gets the value of a voxel, which must lie within the staged region. Positions are in volume space.
+		const VoxelType& getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets the value of a voxel, which must lie within the staged region. Positions are in volume space.
+		const VoxelType& getVoxel(const Vector3DInt32& v3dPos) const;
+
+		/// Gets the first voxel of the block, which is the lower corner of the staged region.
+		const VoxelType* getData(void) const;
+		/// Gets the offset within the block of the voxel at the given position, which is in volume space.
+		int32_t getVoxelIndex(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets the distance (in voxels) between neighbouring voxels in the y direction.
+		int32_t getYStride(void) const;
+		/// Gets the distance (in voxels) between neighbouring voxels in the z direction.
+		int32_t getZStride(void) const;
+
+		/// Calculates approximately how many bytes of memory the view is currently using.
+		uint32_t calculateSizeInBytes(void) const;
+
+	private:
+		void reserve(size_t uNoOfVoxels);
+		void freeData(void);
+
+		Region m_regRegion;
+		Region m_regStagedRegion;
+		uint16_t m_uHaloSize;
+
+		int32_t m_iYStride;
+		int32_t m_iZStride;
+
+		// The block itself, which is aligned to a cache line within the allocation.
+		VoxelType* m_pData;
+		uint8_t* m_pAllocation;
+		size_t m_uCapacityInVoxels;
+	};
+}
+
+#include "RegionView.inl"
+#include "RegionViewSampler.inl"
+
+#endif //__PolyVox_RegionView_H__
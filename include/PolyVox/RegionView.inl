@@ -0,0 +1,179 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	RegionView<VoxelType>::RegionView()
+		:m_uHaloSize(0)
+		, m_iYStride(0)
+		, m_iZStride(0)
+		, m_pData(nullptr)
+		, m_pAllocation(nullptr)
+		, m_uCapacityInVoxels(0)
+	{
+	}
+
+	template <typename VoxelType>
+	RegionView<VoxelType>::~RegionView()
+	{
+		freeData();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The voxels are copied with readVolumeRegion(), so volumes which implement readRegion() are read in bulk.
+	/// \param pVolume The volume to copy from
+	/// \param region The region which the caller intends to process
+	/// \param uHaloSize The number of extra voxels to copy on every side of the region, for kernels which read neighbours
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	template <typename VolumeType>
+	void RegionView<VoxelType>::stage(VolumeType* pVolume, const Region& region, uint16_t uHaloSize)
+	{
+		POLYVOX_THROW_IF(pVolume == nullptr, std::invalid_argument, "Provided volume cannot be null");
+		POLYVOX_THROW_IF(!region.isValid(), std::invalid_argument, "Cannot stage an invalid region.");
+
+		m_regRegion = region;
+		m_uHaloSize = uHaloSize;
+		m_regStagedRegion = region;
+		m_regStagedRegion.grow(uHaloSize);
+
+		m_iYStride = m_regStagedRegion.getWidthInVoxels();
+		m_iZStride = m_iYStride * m_regStagedRegion.getHeightInVoxels();
+
+		reserve(static_cast<size_t>(m_iZStride) * m_regStagedRegion.getDepthInVoxels());
+
+		readVolumeRegion(pVolume, m_regStagedRegion, m_pData, BufferLayout::linear());
+	}
+
+	template <typename VoxelType>
+	const Region& RegionView<VoxelType>::getRegion(void) const
+	{
+		return m_regRegion;
+	}
+
+	template <typename VoxelType>
+	const Region& RegionView<VoxelType>::getStagedRegion(void) const
+	{
+		return m_regStagedRegion;
+	}
+
+	template <typename VoxelType>
+	uint16_t RegionView<VoxelType>::getHaloSize(void) const
+	{
+		return m_uHaloSize;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		POLYVOX_ASSERT(m_regStagedRegion.containsPoint(uXPos, uYPos, uZPos), "Position is outside the staged region.");
+		return m_pData[getVoxelIndex(uXPos, uYPos, uZPos)];
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::getVoxel(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	template <typename VoxelType>
+	const VoxelType* RegionView<VoxelType>::getData(void) const
+	{
+		return m_pData;
+	}
+
+	template <typename VoxelType>
+	int32_t RegionView<VoxelType>::getVoxelIndex(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		return (uXPos - m_regStagedRegion.getLowerX())
+			+ (uYPos - m_regStagedRegion.getLowerY()) * m_iYStride
+			+ (uZPos - m_regStagedRegion.getLowerZ()) * m_iZStride;
+	}
+
+	template <typename VoxelType>
+	int32_t RegionView<VoxelType>::getYStride(void) const
+	{
+		return m_iYStride;
+	}
+
+	template <typename VoxelType>
+	int32_t RegionView<VoxelType>::getZStride(void) const
+	{
+		return m_iZStride;
+	}
+
+	template <typename VoxelType>
+	uint32_t RegionView<VoxelType>::calculateSizeInBytes(void) const
+	{
+		return static_cast<uint32_t>(m_uCapacityInVoxels * sizeof(VoxelType));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The existing block is kept if it is already big enough, so repeated staging of similarly sized regions does not allocate.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void RegionView<VoxelType>::reserve(size_t uNoOfVoxels)
+	{
+		if (uNoOfVoxels <= m_uCapacityInVoxels)
+		{
+			return;
+		}
+
+		freeData();
+
+		const size_t uDataAlignment = 64;
+		m_pAllocation = new uint8_t[uNoOfVoxels * sizeof(VoxelType) + uDataAlignment];
+		const uintptr_t uAddress = reinterpret_cast<uintptr_t>(m_pAllocation);
+		m_pData = reinterpret_cast<VoxelType*>(m_pAllocation + ((uDataAlignment - (uAddress % uDataAlignment)) % uDataAlignment));
+
+		// readRegion() assigns to the voxels, so they need to have been constructed.
+		std::uninitialized_fill_n(m_pData, uNoOfVoxels, VoxelType());
+		m_uCapacityInVoxels = uNoOfVoxels;
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::freeData(void)
+	{
+		for (size_t uVoxel = 0; uVoxel < m_uCapacityInVoxels; uVoxel++)
+		{
+			m_pData[uVoxel].~VoxelType();
+		}
+
+		delete[] m_pAllocation;
+		m_pAllocation = nullptr;
+		m_pData = nullptr;
+		m_uCapacityInVoxels = 0;
+	}
+}
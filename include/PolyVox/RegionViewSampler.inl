@@ -0,0 +1,252 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	RegionView<VoxelType>::Sampler::Sampler(const RegionView<VoxelType>* view)
+		:mView(view)
+		, mCurrentVoxel(view->getData())
+		, m_iYStride(view->getYStride())
+		, m_iZStride(view->getZStride())
+	{
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::getVoxel(void) const
+	{
+		return *mCurrentVoxel;
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	{
+		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	{
+		POLYVOX_ASSERT(mView->getStagedRegion().containsPoint(xPos, yPos, zPos), "Position is outside the staged region.");
+		mCurrentVoxel = mView->getData() + mView->getVoxelIndex(xPos, yPos, zPos);
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::movePositiveX(void)
+	{
+		mCurrentVoxel += 1;
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::movePositiveY(void)
+	{
+		mCurrentVoxel += m_iYStride;
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::movePositiveZ(void)
+	{
+		mCurrentVoxel += m_iZStride;
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::moveNegativeX(void)
+	{
+		mCurrentVoxel -= 1;
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::moveNegativeY(void)
+	{
+		mCurrentVoxel -= m_iYStride;
+	}
+
+	template <typename VoxelType>
+	void RegionView<VoxelType>::Sampler::moveNegativeZ(void)
+	{
+		mCurrentVoxel -= m_iZStride;
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
+	{
+		return *(mCurrentVoxel - 1 - m_iYStride - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx1ny0pz(void) const
+	{
+		return *(mCurrentVoxel - 1 - m_iYStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx1ny1pz(void) const
+	{
+		return *(mCurrentVoxel - 1 - m_iYStride + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx0py1nz(void) const
+	{
+		return *(mCurrentVoxel - 1 - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx0py0pz(void) const
+	{
+		return *(mCurrentVoxel - 1);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx0py1pz(void) const
+	{
+		return *(mCurrentVoxel - 1 + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx1py1nz(void) const
+	{
+		return *(mCurrentVoxel - 1 + m_iYStride - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx1py0pz(void) const
+	{
+		return *(mCurrentVoxel - 1 + m_iYStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1nx1py1pz(void) const
+	{
+		return *(mCurrentVoxel - 1 + m_iYStride + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px1ny1nz(void) const
+	{
+		return *(mCurrentVoxel - m_iYStride - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px1ny0pz(void) const
+	{
+		return *(mCurrentVoxel - m_iYStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px1ny1pz(void) const
+	{
+		return *(mCurrentVoxel - m_iYStride + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px0py1nz(void) const
+	{
+		return *(mCurrentVoxel - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px0py0pz(void) const
+	{
+		return *mCurrentVoxel;
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px0py1pz(void) const
+	{
+		return *(mCurrentVoxel + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px1py1nz(void) const
+	{
+		return *(mCurrentVoxel + m_iYStride - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px1py0pz(void) const
+	{
+		return *(mCurrentVoxel + m_iYStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel0px1py1pz(void) const
+	{
+		return *(mCurrentVoxel + m_iYStride + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px1ny1nz(void) const
+	{
+		return *(mCurrentVoxel + 1 - m_iYStride - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px1ny0pz(void) const
+	{
+		return *(mCurrentVoxel + 1 - m_iYStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px1ny1pz(void) const
+	{
+		return *(mCurrentVoxel + 1 - m_iYStride + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px0py1nz(void) const
+	{
+		return *(mCurrentVoxel + 1 - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px0py0pz(void) const
+	{
+		return *(mCurrentVoxel + 1);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px0py1pz(void) const
+	{
+		return *(mCurrentVoxel + 1 + m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px1py1nz(void) const
+	{
+		return *(mCurrentVoxel + 1 + m_iYStride - m_iZStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px1py0pz(void) const
+	{
+		return *(mCurrentVoxel + 1 + m_iYStride);
+	}
+
+	template <typename VoxelType>
+	const VoxelType& RegionView<VoxelType>::Sampler::peekVoxel1px1py1pz(void) const
+	{
+		return *(mCurrentVoxel + 1 + m_iYStride + m_iZStride);
+	}
+}
@@ -0,0 +1,232 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#ifndef __PolyVox_SparseOctreeVolume_H__
+#define __PolyVox_SparseOctreeVolume_H__
+
+#include "BaseVolume.h"
+#include "Region.h"
+#include "Vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept> //For invalid_argument
+#include <vector>
+
+namespace PolyVox
+{
+	/**
+	 * A fixed size volume which stores its voxels in a sparse octree.
+	 *
+	 * The volume is covered by a single cubic octree whose side length is the smallest power of two which encloses it. Each node
+	 * either holds a single value for every voxel inside it, or has eight children. Writing a voxel splits the nodes above it as
+	 * required, and a node whose children all end up holding the same value is collapsed back into a single node. Large areas of
+	 * air or solid material therefore take almost no space, and the memory usage is roughly proportional to the surface area of
+	 * the scene rather than to its volume. This makes it a good fit for large but mostly empty scenes such as CAD imports or
+	 * scanned data, while the RawVolume and PagedVolume are better suited to dense data.
+	 *
+	 * Like the RawVolume it has a border value which is returned for voxels outside of the volume, and it can be used anywhere
+	 * those volumes can (such as with the surface extractors, raycasting or the AStarPathfinder). Its Sampler keeps track of the
+	 * path from the root to the node containing the current position, so moving the sampler or peeking at a neighbour only has to
+	 * look at the part of the tree which the two positions do not share. Samplers which are in use while the volume is modified
+	 * remain valid, but fall back to looking up each voxel from the root until they are next moved or repositioned.
+	 */
+	template <typename VoxelType>
+	class SparseOctreeVolume : public BaseVolume<VoxelType>
+	{
+	public:
+		/// The maximum depth of the tree, which is enough for a volume of 2^31 voxels along each side.
+		static const uint8_t uMaxDepth = 31;
+
+#ifndef SWIG
+#if defined(_MSC_VER)
+		class Sampler : public BaseVolume<VoxelType>::Sampler< SparseOctreeVolume<VoxelType> > //This line works on VS2010
+#else
+		class Sampler : public BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> > //This line works on GCC
+#endif
+		{
+		public:
+			Sampler(SparseOctreeVolume<VoxelType>* volume);
+			~Sampler();
+
+			inline VoxelType getVoxel(void) const;
+
+			bool isCurrentPositionValid(void) const;
+
+			void setPosition(const Vector3DInt32& v3dNewPos);
+			void setPosition(int32_t xPos, int32_t yPos, int32_t zPos);
+			inline bool setVoxel(VoxelType tValue);
+
+			void movePositiveX(void);
+			void movePositiveY(void);
+			void movePositiveZ(void);
+
+			void moveNegativeX(void);
+			void moveNegativeY(void);
+			void moveNegativeZ(void);
+
+			inline VoxelType peekVoxel1nx1ny1nz(void) const;
+			inline VoxelType peekVoxel1nx1ny0pz(void) const;
+			inline VoxelType peekVoxel1nx1ny1pz(void) const;
+			inline VoxelType peekVoxel1nx0py1nz(void) const;
+			inline VoxelType peekVoxel1nx0py0pz(void) const;
+			inline VoxelType peekVoxel1nx0py1pz(void) const;
+			inline VoxelType peekVoxel1nx1py1nz(void) const;
+			inline VoxelType peekVoxel1nx1py0pz(void) const;
+			inline VoxelType peekVoxel1nx1py1pz(void) const;
+
+			inline VoxelType peekVoxel0px1ny1nz(void) const;
+			inline VoxelType peekVoxel0px1ny0pz(void) const;
+			inline VoxelType peekVoxel0px1ny1pz(void) const;
+			inline VoxelType peekVoxel0px0py1nz(void) const;
+			inline VoxelType peekVoxel0px0py0pz(void) const;
+			inline VoxelType peekVoxel0px0py1pz(void) const;
+			inline VoxelType peekVoxel0px1py1nz(void) const;
+			inline VoxelType peekVoxel0px1py0pz(void) const;
+			inline VoxelType peekVoxel0px1py1pz(void) const;
+
+			inline VoxelType peekVoxel1px1ny1nz(void) const;
+			inline VoxelType peekVoxel1px1ny0pz(void) const;
+			inline VoxelType peekVoxel1px1ny1pz(void) const;
+			inline VoxelType peekVoxel1px0py1nz(void) const;
+			inline VoxelType peekVoxel1px0py0pz(void) const;
+			inline VoxelType peekVoxel1px0py1pz(void) const;
+			inline VoxelType peekVoxel1px1py1nz(void) const;
+			inline VoxelType peekVoxel1px1py0pz(void) const;
+			inline VoxelType peekVoxel1px1py1pz(void) const;
+
+		private:
+			// Finds the leaf containing the current position, starting from the node at the given depth on the current path.
+			void updateNodePath(uint8_t uStartDepth);
+			// Called after the sampler has moved along one axis, with the bits of the local position which changed.
+			void updateAfterMove(uint32_t uChangedBits, bool bWasPositionValid);
+			VoxelType peekVoxel(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const;
+
+			// The current position relative to the lower corner of the volume.
+			uint32_t m_uXPosInTree;
+			uint32_t m_uYPosInTree;
+			uint32_t m_uZPosInTree;
+
+			// The nodes from the root down to the leaf which contains the current position. These are only meaningful while the
+			// current position is valid and the volume has not been restructured since they were found (see m_uRevision).
+			uint32_t m_auNodePath[uMaxDepth + 1];
+			uint8_t m_uLeafDepth;
+			uint32_t m_uRevision;
+
+			bool m_bIsCurrentPositionValid;
+		};
+#endif // SWIG
+
+	public:
+		/// Constructor for creating a fixed size volume.
+		SparseOctreeVolume(const Region& regValid);
+
+		/// Destructor
+		~SparseOctreeVolume();
+
+		/// Gets the value used for voxels which are outside the volume
+		VoxelType getBorderValue(void) const;
+		/// Gets a Region representing the extents of the Volume.
+		const Region& getEnclosingRegion(void) const;
+
+		/// Gets the width of the volume in voxels.
+		int32_t getWidth(void) const;
+		/// Gets the height of the volume in voxels.
+		int32_t getHeight(void) const;
+		/// Gets the depth of the volume in voxels.
+		int32_t getDepth(void) const;
+
+		/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+		VoxelType getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets a voxel at the position given by a 3D vector
+		VoxelType getVoxel(const Vector3DInt32& v3dPos) const;
+
+		/// Sets the value used for voxels which are outside the volume
+		void setBorderValue(const VoxelType& tBorder);
+		/// Sets the voxel at the position given by <tt>x,y,z</tt> coordinates
+		void setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
+		/// Sets the voxel at the position given by a 3D vector
+		void setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue);
+
+		/// Copies all the voxels in a region into a buffer
+		void readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout = BufferLayout()) const;
+		/// Copies all the voxels in a region from a buffer
+		void writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout = BufferLayout());
+
+		/// Gets the number of nodes in the tree, including the ones which have been split.
+		uint32_t getNoOfNodes(void) const;
+
+		/// Calculates approximatly how many bytes of memory the volume is currently using.
+		uint32_t calculateSizeInBytes(void);
+
+	protected:
+		/// Copy constructor
+		SparseOctreeVolume(const SparseOctreeVolume& rhs);
+
+		/// Assignment operator
+		SparseOctreeVolume& operator=(const SparseOctreeVolume& rhs);
+
+	private:
+		struct Node
+		{
+			// The index of the first of the node's eight children, which are stored next to each other. This is zero if the node
+			// is a leaf, which is unambiguous because the root (at index zero) is never a child.
+			uint32_t uFirstChild;
+			// The value of every voxel in the node, if it is a leaf.
+			VoxelType tValue;
+		};
+
+		// Gets which of a node's children contains the given position. The node is at the given depth in the tree.
+		uint32_t getChildIndex(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos, uint8_t uDepth) const;
+		// Descends from the given node to the leaf containing the given position (which must be inside the node).
+		uint32_t findLeaf(uint32_t uNode, uint8_t uDepth, uint32_t uXPos, uint32_t uYPos, uint32_t uZPos) const;
+
+		void splitNode(uint32_t uNode);
+		bool collapseNode(uint32_t uNode);
+
+		void readNode(uint32_t uNode, const Region& regNode, const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const;
+		void fillRegion(const Region& regFill, VoxelType tValue, const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const;
+
+		//The size of the volume
+		Region m_regValidRegion;
+
+		//The border value
+		VoxelType m_tBorderValue;
+
+		// The tree has a side length of 2^m_uTreeDepth voxels, with the root at m_vecNodes[0]. Blocks of children which were
+		// freed by collapsing a node are kept in m_vecFreeChildren (by the index of their first child) for reuse.
+		uint8_t m_uTreeDepth;
+		std::vector<Node> m_vecNodes;
+		std::vector<uint32_t> m_vecFreeChildren;
+
+		// Incremented whenever nodes are split or collapsed, so that samplers know their node paths are out of date.
+		uint32_t m_uRevision;
+	};
+}
+
+#include "SparseOctreeVolume.inl"
+#include "SparseOctreeVolumeSampler.inl"
+
+#endif //__PolyVox_SparseOctreeVolume_H__
@@ -0,0 +1,452 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// This constructor creates a volume with a fixed size which is specified as a parameter. Initially every voxel has the
+	/// default value of the VoxelType, so the tree consists of just the root node.
+	/// \param regValid Specifies the minimum and maximum valid voxel positions.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	SparseOctreeVolume<VoxelType>::SparseOctreeVolume(const Region& regValid)
+		:BaseVolume<VoxelType>()
+		, m_regValidRegion(regValid)
+		, m_tBorderValue()
+		, m_uTreeDepth(0)
+		, m_uRevision(0)
+	{
+		if (this->getWidth() <= 0)
+		{
+			POLYVOX_THROW(std::invalid_argument, "Volume width must be greater than zero.");
+		}
+		if (this->getHeight() <= 0)
+		{
+			POLYVOX_THROW(std::invalid_argument, "Volume height must be greater than zero.");
+		}
+		if (this->getDepth() <= 0)
+		{
+			POLYVOX_THROW(std::invalid_argument, "Volume depth must be greater than zero.");
+		}
+
+		// Find the smallest power of two which covers the longest side.
+		const uint32_t uLongestSide = static_cast<uint32_t>((std::max)((std::max)(getWidth(), getHeight()), getDepth()));
+		while ((uint64_t(1) << m_uTreeDepth) < uLongestSide)
+		{
+			m_uTreeDepth++;
+		}
+
+		Node root;
+		root.uFirstChild = 0;
+		root.tValue = VoxelType();
+		m_vecNodes.push_back(root);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This function should never be called. Copying volumes by value would be expensive, and we want to prevent users from doing
+	/// it by accident (such as when passing them as paramenters to functions). That said, there are times when you really do want to
+	/// make a copy of a volume and in this case you should look at the VolumeResampler.
+	///
+	/// \sa VolumeResampler
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	SparseOctreeVolume<VoxelType>::SparseOctreeVolume(const SparseOctreeVolume<VoxelType>& /*rhs*/)
+	{
+		POLYVOX_THROW(not_implemented, "Volume copy constructor not implemented for performance reasons.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Destroys the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	SparseOctreeVolume<VoxelType>::~SparseOctreeVolume()
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This function should never be called. Copying volumes by value would be expensive, and we want to prevent users from doing
+	/// it by accident (such as when passing them as paramenters to functions). That said, there are times when you really do want to
+	/// make a copy of a volume and in this case you should look at the VolumeResampler.
+	///
+	/// \sa VolumeResampler
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	SparseOctreeVolume<VoxelType>& SparseOctreeVolume<VoxelType>::operator=(const SparseOctreeVolume<VoxelType>& /*rhs*/)
+	{
+		POLYVOX_THROW(not_implemented, "Volume assignment operator not implemented for performance reasons.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The border value is returned whenever an attempt is made to read a voxel which
+	/// is outside the extents of the volume.
+	/// \return The value used for voxels outside of the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::getBorderValue(void) const
+	{
+		return m_tBorderValue;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return A Region representing the extent of the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const Region& SparseOctreeVolume<VoxelType>::getEnclosingRegion(void) const
+	{
+		return m_regValidRegion;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The width of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g. 0 to 63 then the width is 64.
+	/// \sa getHeight(), getDepth()
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	int32_t SparseOctreeVolume<VoxelType>::getWidth(void) const
+	{
+		return m_regValidRegion.getUpperX() - m_regValidRegion.getLowerX() + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The height of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g. 0 to 63 then the height is 64.
+	/// \sa getWidth(), getDepth()
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	int32_t SparseOctreeVolume<VoxelType>::getHeight(void) const
+	{
+		return m_regValidRegion.getUpperY() - m_regValidRegion.getLowerY() + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The depth of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g. 0 to 63 then the depth is 64.
+	/// \sa getWidth(), getHeight()
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	int32_t SparseOctreeVolume<VoxelType>::getDepth(void) const
+	{
+		return m_regValidRegion.getUpperZ() - m_regValidRegion.getLowerZ() + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::getVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		if (this->m_regValidRegion.containsPoint(uXPos, uYPos, uZPos))
+		{
+			const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+			return m_vecNodes[findLeaf(0, 0, uXPos - v3dLowerCorner.getX(), uYPos - v3dLowerCorner.getY(), uZPos - v3dLowerCorner.getZ())].tValue;
+		}
+		else
+		{
+			return m_tBorderValue;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::getVoxel(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param tBorder The value to use for voxels outside the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::setBorderValue(const VoxelType& tBorder)
+	{
+		m_tBorderValue = tBorder;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Any leaf above the voxel is split so that the voxel gets a node of its own, and afterwards any nodes above it whose
+	/// children all hold the same value are collapsed. Writing the value which a voxel already has does not change the tree.
+	/// \param uXPos the \c x position of the voxel
+	/// \param uYPos the \c y position of the voxel
+	/// \param uZPos the \c z position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue)
+	{
+		if (this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)) == false)
+		{
+			POLYVOX_THROW(std::out_of_range, "Position is outside valid region");
+		}
+
+		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+		const uint32_t uXPosInTree = uXPos - v3dLowerCorner.getX();
+		const uint32_t uYPosInTree = uYPos - v3dLowerCorner.getY();
+		const uint32_t uZPosInTree = uZPos - v3dLowerCorner.getZ();
+
+		uint32_t auNodePath[uMaxDepth + 1];
+		uint32_t uNode = 0;
+		for (uint8_t uDepth = 0; uDepth < m_uTreeDepth; uDepth++)
+		{
+			auNodePath[uDepth] = uNode;
+			if (m_vecNodes[uNode].uFirstChild == 0)
+			{
+				if (m_vecNodes[uNode].tValue == tValue)
+				{
+					return;
+				}
+				splitNode(uNode);
+			}
+			uNode = m_vecNodes[uNode].uFirstChild + getChildIndex(uXPosInTree, uYPosInTree, uZPosInTree, uDepth);
+		}
+
+		m_vecNodes[uNode].tValue = tValue;
+
+		// Collapse as far up the tree as possible. Once a node cannot be collapsed none of the ones above it can be either.
+		for (uint8_t uDepth = m_uTreeDepth; uDepth > 0; uDepth--)
+		{
+			if (!collapseNode(auNodePath[uDepth - 1]))
+			{
+				break;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos the 3D position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::setVoxel(const Vector3DInt32& v3dPos, VoxelType tValue)
+	{
+		setVoxel(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Rather than looking up every voxel, this walks the parts of the tree which overlap the region and fills the buffer with the
+	/// value of each leaf in turn. The region may extend outside the volume, in which case the corresponding parts of the buffer are
+	/// filled with the border value.
+	/// \param regRead The region to copy
+	/// \param pDstBuffer The buffer to copy into, which must hold at least layout.getRequiredBufferSize(regRead) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::readRegion(const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const
+	{
+		layout.validate(regRead);
+		POLYVOX_THROW_IF(pDstBuffer == nullptr, std::invalid_argument, "Destination buffer must not be null.");
+
+		if (!m_regValidRegion.containsRegion(regRead))
+		{
+			fillRegion(regRead, m_tBorderValue, regRead, pDstBuffer, layout);
+		}
+
+		const int32_t iTreeSideLengthMinusOne = static_cast<int32_t>((uint64_t(1) << m_uTreeDepth) - 1);
+		const Region regTree(m_regValidRegion.getLowerCorner(), m_regValidRegion.getLowerCorner() + Vector3DInt32(iTreeSideLengthMinusOne, iTreeSideLengthMinusOne, iTreeSideLengthMinusOne));
+		readNode(0, regTree, regRead, pDstBuffer, layout);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The voxels are written one at a time, with the tree being collapsed as it goes. This means that writing a large homogeneous
+	/// region never needs more than a handful of nodes for the parts of it which are already complete.
+	/// \param regWrite The region to copy, which must lie within the volume
+	/// \param pSrcBuffer The buffer to copy from, which must hold at least layout.getRequiredBufferSize(regWrite) voxels
+	/// \param layout The arrangement of the voxels within the buffer
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::writeRegion(const Region& regWrite, const VoxelType* pSrcBuffer, const BufferLayout& layout)
+	{
+		layout.validate(regWrite);
+		POLYVOX_THROW_IF(pSrcBuffer == nullptr, std::invalid_argument, "Source buffer must not be null.");
+		POLYVOX_THROW_IF(!this->m_regValidRegion.containsRegion(regWrite), std::out_of_range, "Region is outside valid region");
+
+		for (int32_t z = regWrite.getLowerZ(); z <= regWrite.getUpperZ(); z++)
+		{
+			for (int32_t y = regWrite.getLowerY(); y <= regWrite.getUpperY(); y++)
+			{
+				for (int32_t x = regWrite.getLowerX(); x <= regWrite.getUpperX(); x++)
+				{
+					setVoxel(x, y, z, pSrcBuffer[layout.getIndex(regWrite, x - regWrite.getLowerX(), y - regWrite.getLowerY(), z - regWrite.getLowerZ())]);
+				}
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \return The number of nodes in the tree. Blocks of nodes which have been freed by collapsing and are waiting to be reused are not included.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t SparseOctreeVolume<VoxelType>::getNoOfNodes(void) const
+	{
+		return static_cast<uint32_t>(m_vecNodes.size() - m_vecFreeChildren.size() * 8);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This includes the space used by nodes which have been freed but are being kept for reuse.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t SparseOctreeVolume<VoxelType>::calculateSizeInBytes(void)
+	{
+		return static_cast<uint32_t>(m_vecNodes.capacity() * sizeof(Node) + m_vecFreeChildren.capacity() * sizeof(uint32_t));
+	}
+
+	template <typename VoxelType>
+	uint32_t SparseOctreeVolume<VoxelType>::getChildIndex(uint32_t uXPos, uint32_t uYPos, uint32_t uZPos, uint8_t uDepth) const
+	{
+		// The children of a node at the given depth are split by this bit of the position.
+		const uint8_t uShift = m_uTreeDepth - 1 - uDepth;
+		return ((uXPos >> uShift) & 1) | (((uYPos >> uShift) & 1) << 1) | (((uZPos >> uShift) & 1) << 2);
+	}
+
+	template <typename VoxelType>
+	uint32_t SparseOctreeVolume<VoxelType>::findLeaf(uint32_t uNode, uint8_t uDepth, uint32_t uXPos, uint32_t uYPos, uint32_t uZPos) const
+	{
+		while (m_vecNodes[uNode].uFirstChild != 0)
+		{
+			uNode = m_vecNodes[uNode].uFirstChild + getChildIndex(uXPos, uYPos, uZPos, uDepth);
+			uDepth++;
+		}
+		return uNode;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Gives a leaf eight children which all have its value.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::splitNode(uint32_t uNode)
+	{
+		POLYVOX_ASSERT(m_vecNodes[uNode].uFirstChild == 0, "Only a leaf can be split");
+
+		Node child;
+		child.uFirstChild = 0;
+		child.tValue = m_vecNodes[uNode].tValue;
+
+		uint32_t uFirstChild;
+		if (m_vecFreeChildren.empty())
+		{
+			uFirstChild = static_cast<uint32_t>(m_vecNodes.size());
+			m_vecNodes.insert(m_vecNodes.end(), 8, child);
+		}
+		else
+		{
+			uFirstChild = m_vecFreeChildren.back();
+			m_vecFreeChildren.pop_back();
+			std::fill(m_vecNodes.begin() + uFirstChild, m_vecNodes.begin() + uFirstChild + 8, child);
+		}
+
+		m_vecNodes[uNode].uFirstChild = uFirstChild;
+		m_uRevision++;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Turns a node back into a leaf if all of its children are leaves with the same value.
+	/// \return Whether the node was collapsed.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool SparseOctreeVolume<VoxelType>::collapseNode(uint32_t uNode)
+	{
+		const uint32_t uFirstChild = m_vecNodes[uNode].uFirstChild;
+		POLYVOX_ASSERT(uFirstChild != 0, "Only a node with children can be collapsed");
+
+		for (uint32_t uChild = uFirstChild; uChild < uFirstChild + 8; uChild++)
+		{
+			if ((m_vecNodes[uChild].uFirstChild != 0) || !(m_vecNodes[uChild].tValue == m_vecNodes[uFirstChild].tValue))
+			{
+				return false;
+			}
+		}
+
+		m_vecNodes[uNode].tValue = m_vecNodes[uFirstChild].tValue;
+		m_vecNodes[uNode].uFirstChild = 0;
+		m_vecFreeChildren.push_back(uFirstChild);
+		m_uRevision++;
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Copies the part of the given node (which covers regNode) which is inside both the volume and the region being read.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::readNode(uint32_t uNode, const Region& regNode, const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const
+	{
+		Region regOverlap = regNode;
+		regOverlap.cropTo(regRead);
+		regOverlap.cropTo(m_regValidRegion);
+		if (!regOverlap.isValid())
+		{
+			return;
+		}
+
+		const uint32_t uFirstChild = m_vecNodes[uNode].uFirstChild;
+		if (uFirstChild == 0)
+		{
+			fillRegion(regOverlap, m_vecNodes[uNode].tValue, regRead, pDstBuffer, layout);
+			return;
+		}
+
+		const int32_t iHalfSideLength = regNode.getWidthInVoxels() / 2;
+		for (uint32_t uChild = 0; uChild < 8; uChild++)
+		{
+			const Vector3DInt32 v3dChildLowerCorner = regNode.getLowerCorner() +
+				Vector3DInt32((uChild & 1) ? iHalfSideLength : 0, (uChild & 2) ? iHalfSideLength : 0, (uChild & 4) ? iHalfSideLength : 0);
+			const Region regChild(v3dChildLowerCorner, v3dChildLowerCorner + Vector3DInt32(iHalfSideLength - 1, iHalfSideLength - 1, iHalfSideLength - 1));
+			readNode(uFirstChild + uChild, regChild, regRead, pDstBuffer, layout);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Sets the voxels of regFill (which must be inside regRead) in a buffer holding regRead to the given value.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::fillRegion(const Region& regFill, VoxelType tValue, const Region& regRead, VoxelType* pDstBuffer, const BufferLayout& layout) const
+	{
+		const uint32_t uBufferX = regFill.getLowerX() - regRead.getLowerX();
+		const uint32_t uWidth = regFill.getWidthInVoxels();
+		const bool bLinear = (layout.getOrder() == BufferOrders::Linear);
+
+		for (int32_t z = regFill.getLowerZ(); z <= regFill.getUpperZ(); z++)
+		{
+			const uint32_t uBufferZ = z - regRead.getLowerZ();
+			for (int32_t y = regFill.getLowerY(); y <= regFill.getUpperY(); y++)
+			{
+				const uint32_t uBufferY = y - regRead.getLowerY();
+				if (bLinear)
+				{
+					VoxelType* pDstRow = pDstBuffer + layout.getIndex(regRead, uBufferX, uBufferY, uBufferZ);
+					std::fill(pDstRow, pDstRow + uWidth, tValue);
+				}
+				else
+				{
+					const uint32_t uBufferYZ = morton256_y[uBufferY] | morton256_z[uBufferZ];
+					for (uint32_t x = uBufferX; x < uBufferX + uWidth; x++)
+					{
+						pDstBuffer[morton256_x[x] | uBufferYZ] = tValue;
+					}
+				}
+			}
+		}
+	}
+}
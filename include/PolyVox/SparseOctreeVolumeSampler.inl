@@ -0,0 +1,442 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 David Williams and Matthew Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	SparseOctreeVolume<VoxelType>::Sampler::Sampler(SparseOctreeVolume<VoxelType>* volume)
+		:BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >(volume)
+		, m_uXPosInTree(0)
+		, m_uYPosInTree(0)
+		, m_uZPosInTree(0)
+		, m_uLeafDepth(0)
+		, m_uRevision(0)
+		, m_bIsCurrentPositionValid(false)
+	{
+		m_auNodePath[0] = 0;
+	}
+
+	template <typename VoxelType>
+	SparseOctreeVolume<VoxelType>::Sampler::~Sampler()
+	{
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::getVoxel(void) const
+	{
+		if (m_bIsCurrentPositionValid && (m_uRevision == this->mVolume->m_uRevision))
+		{
+			return this->mVolume->m_vecNodes[m_auNodePath[m_uLeafDepth]].tValue;
+		}
+		else
+		{
+			return this->mVolume->getVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	bool inline SparseOctreeVolume<VoxelType>::Sampler::isCurrentPositionValid(void) const
+	{
+		return m_bIsCurrentPositionValid;
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	{
+		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	{
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >::setPosition(xPos, yPos, zPos);
+
+		const Vector3DInt32& v3dLowerCorner = this->mVolume->m_regValidRegion.getLowerCorner();
+		m_uXPosInTree = static_cast<uint32_t>(xPos - v3dLowerCorner.getX());
+		m_uYPosInTree = static_cast<uint32_t>(yPos - v3dLowerCorner.getY());
+		m_uZPosInTree = static_cast<uint32_t>(zPos - v3dLowerCorner.getZ());
+
+		// Then we find the path down to the current position.
+		m_bIsCurrentPositionValid = this->mVolume->m_regValidRegion.containsPoint(xPos, yPos, zPos);
+		if (m_bIsCurrentPositionValid)
+		{
+			updateNodePath(0);
+		}
+	}
+
+	template <typename VoxelType>
+	bool SparseOctreeVolume<VoxelType>::Sampler::setVoxel(VoxelType tValue)
+	{
+		if (m_bIsCurrentPositionValid)
+		{
+			this->mVolume->setVoxel(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume, tValue);
+
+			// The write may have split or collapsed nodes on our path.
+			updateNodePath(0);
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::movePositiveX(void)
+	{
+		// We'll need these in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uOldPosInTree = m_uXPosInTree;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >::movePositiveX();
+
+		m_uXPosInTree = static_cast<uint32_t>(this->mXPosInVolume - this->mVolume->m_regValidRegion.getLowerX());
+		updateAfterMove(uOldPosInTree ^ m_uXPosInTree, bWasPositionValid);
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::movePositiveY(void)
+	{
+		// We'll need these in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uOldPosInTree = m_uYPosInTree;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >::movePositiveY();
+
+		m_uYPosInTree = static_cast<uint32_t>(this->mYPosInVolume - this->mVolume->m_regValidRegion.getLowerY());
+		updateAfterMove(uOldPosInTree ^ m_uYPosInTree, bWasPositionValid);
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::movePositiveZ(void)
+	{
+		// We'll need these in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uOldPosInTree = m_uZPosInTree;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >::movePositiveZ();
+
+		m_uZPosInTree = static_cast<uint32_t>(this->mZPosInVolume - this->mVolume->m_regValidRegion.getLowerZ());
+		updateAfterMove(uOldPosInTree ^ m_uZPosInTree, bWasPositionValid);
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::moveNegativeX(void)
+	{
+		// We'll need these in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uOldPosInTree = m_uXPosInTree;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >::moveNegativeX();
+
+		m_uXPosInTree = static_cast<uint32_t>(this->mXPosInVolume - this->mVolume->m_regValidRegion.getLowerX());
+		updateAfterMove(uOldPosInTree ^ m_uXPosInTree, bWasPositionValid);
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::moveNegativeY(void)
+	{
+		// We'll need these in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uOldPosInTree = m_uYPosInTree;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >::moveNegativeY();
+
+		m_uYPosInTree = static_cast<uint32_t>(this->mYPosInVolume - this->mVolume->m_regValidRegion.getLowerY());
+		updateAfterMove(uOldPosInTree ^ m_uYPosInTree, bWasPositionValid);
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::moveNegativeZ(void)
+	{
+		// We'll need these in a moment...
+		const bool bWasPositionValid = m_bIsCurrentPositionValid;
+		const uint32_t uOldPosInTree = m_uZPosInTree;
+
+		// Base version updates position.
+		BaseVolume<VoxelType>::template Sampler< SparseOctreeVolume<VoxelType> >::moveNegativeZ();
+
+		m_uZPosInTree = static_cast<uint32_t>(this->mZPosInVolume - this->mVolume->m_regValidRegion.getLowerZ());
+		updateAfterMove(uOldPosInTree ^ m_uZPosInTree, bWasPositionValid);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
+	{
+		return peekVoxel(-1, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx1ny0pz(void) const
+	{
+		return peekVoxel(-1, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx1ny1pz(void) const
+	{
+		return peekVoxel(-1, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx0py1nz(void) const
+	{
+		return peekVoxel(-1, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx0py0pz(void) const
+	{
+		return peekVoxel(-1, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx0py1pz(void) const
+	{
+		return peekVoxel(-1, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx1py1nz(void) const
+	{
+		return peekVoxel(-1, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx1py0pz(void) const
+	{
+		return peekVoxel(-1, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1nx1py1pz(void) const
+	{
+		return peekVoxel(-1, 1, 1);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px1ny1nz(void) const
+	{
+		return peekVoxel(0, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px1ny0pz(void) const
+	{
+		return peekVoxel(0, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px1ny1pz(void) const
+	{
+		return peekVoxel(0, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px0py1nz(void) const
+	{
+		return peekVoxel(0, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px0py0pz(void) const
+	{
+		return peekVoxel(0, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px0py1pz(void) const
+	{
+		return peekVoxel(0, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px1py1nz(void) const
+	{
+		return peekVoxel(0, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px1py0pz(void) const
+	{
+		return peekVoxel(0, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel0px1py1pz(void) const
+	{
+		return peekVoxel(0, 1, 1);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px1ny1nz(void) const
+	{
+		return peekVoxel(1, -1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px1ny0pz(void) const
+	{
+		return peekVoxel(1, -1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px1ny1pz(void) const
+	{
+		return peekVoxel(1, -1, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px0py1nz(void) const
+	{
+		return peekVoxel(1, 0, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px0py0pz(void) const
+	{
+		return peekVoxel(1, 0, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px0py1pz(void) const
+	{
+		return peekVoxel(1, 0, 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px1py1nz(void) const
+	{
+		return peekVoxel(1, 1, -1);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px1py0pz(void) const
+	{
+		return peekVoxel(1, 1, 0);
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel1px1py1pz(void) const
+	{
+		return peekVoxel(1, 1, 1);
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::updateNodePath(uint8_t uStartDepth)
+	{
+		const SparseOctreeVolume<VoxelType>* pVolume = this->mVolume;
+
+		uint32_t uNode = m_auNodePath[uStartDepth];
+		uint8_t uDepth = uStartDepth;
+		while (pVolume->m_vecNodes[uNode].uFirstChild != 0)
+		{
+			uNode = pVolume->m_vecNodes[uNode].uFirstChild + pVolume->getChildIndex(m_uXPosInTree, m_uYPosInTree, m_uZPosInTree, uDepth);
+			uDepth++;
+			m_auNodePath[uDepth] = uNode;
+		}
+
+		m_uLeafDepth = uDepth;
+		m_uRevision = pVolume->m_uRevision;
+	}
+
+	template <typename VoxelType>
+	void SparseOctreeVolume<VoxelType>::Sampler::updateAfterMove(uint32_t uChangedBits, bool bWasPositionValid)
+	{
+		m_bIsCurrentPositionValid = this->mVolume->m_regValidRegion.containsPoint(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		if (!m_bIsCurrentPositionValid)
+		{
+			return;
+		}
+
+		if (!bWasPositionValid || (m_uRevision != this->mVolume->m_uRevision))
+		{
+			updateNodePath(0);
+			return;
+		}
+
+		// The old and new positions share every node down to the depth at which the highest changed bit splits them. If that
+		// is below the current leaf then we are still in the same leaf, and there is nothing to do.
+		uint8_t uSharedDepth = this->mVolume->m_uTreeDepth;
+		while (uChangedBits != 0)
+		{
+			uSharedDepth--;
+			uChangedBits >>= 1;
+		}
+
+		if (uSharedDepth < m_uLeafDepth)
+		{
+			updateNodePath(uSharedDepth);
+		}
+	}
+
+	template <typename VoxelType>
+	VoxelType SparseOctreeVolume<VoxelType>::Sampler::peekVoxel(int32_t iXOffset, int32_t iYOffset, int32_t iZOffset) const
+	{
+		const SparseOctreeVolume<VoxelType>* pVolume = this->mVolume;
+
+		if (m_bIsCurrentPositionValid && (m_uRevision == pVolume->m_uRevision))
+		{
+			const uint32_t uXPosInTree = m_uXPosInTree + iXOffset;
+			const uint32_t uYPosInTree = m_uYPosInTree + iYOffset;
+			const uint32_t uZPosInTree = m_uZPosInTree + iZOffset;
+
+			// Positions just outside the volume wrap around to very large values, so this also catches those.
+			if ((uXPosInTree >= static_cast<uint32_t>(pVolume->getWidth())) ||
+				(uYPosInTree >= static_cast<uint32_t>(pVolume->getHeight())) ||
+				(uZPosInTree >= static_cast<uint32_t>(pVolume->getDepth())))
+			{
+				return pVolume->m_tBorderValue;
+			}
+
+			// As when moving, we only need to descend from the deepest node which contains both positions.
+			uint32_t uChangedBits = (m_uXPosInTree ^ uXPosInTree) | (m_uYPosInTree ^ uYPosInTree) | (m_uZPosInTree ^ uZPosInTree);
+			uint8_t uSharedDepth = pVolume->m_uTreeDepth;
+			while (uChangedBits != 0)
+			{
+				uSharedDepth--;
+				uChangedBits >>= 1;
+			}
+
+			if (uSharedDepth >= m_uLeafDepth)
+			{
+				return pVolume->m_vecNodes[m_auNodePath[m_uLeafDepth]].tValue;
+			}
+
+			return pVolume->m_vecNodes[pVolume->findLeaf(m_auNodePath[uSharedDepth], uSharedDepth, uXPosInTree, uYPosInTree, uZPosInTree)].tValue;
+		}
+
+		return pVolume->getVoxel(this->mXPosInVolume + iXOffset, this->mYPosInVolume + iYOffset, this->mZPosInVolume + iZOffset);
+	}
+}
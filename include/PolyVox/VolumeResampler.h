@@ -26,6 +26,9 @@
 #define __PolyVox_VolumeResampler_H__
 
 #include "Region.h"
+#include "RegionView.h"
+
+#include <vector>
 
 namespace PolyVox
 {
@@ -52,6 +55,10 @@ namespace PolyVox
 		//Destination data
 		DstVolumeType* m_pVolDst;
 		Region m_regDst;
+
+		//Scratch space, kept between calls to avoid reallocating it.
+		RegionView<typename SrcVolumeType::VoxelType> m_viewSrc;
+		std::vector<typename DstVolumeType::VoxelType> m_vecDstVoxels;
 	};
 
 }//namespace PolyVox
@@ -24,7 +24,9 @@
 
 #include "Impl/Interpolation.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace PolyVox
 {
@@ -67,17 +69,36 @@ namespace PolyVox
 	template< typename SrcVolumeType, typename DstVolumeType>
 	void VolumeResampler<SrcVolumeType, DstVolumeType>::resampleSameSize()
 	{
-		for (int32_t sz = m_regSrc.getLowerZ(), dz = m_regDst.getLowerZ(); dz <= m_regDst.getUpperZ(); sz++, dz++)
+		typedef typename SrcVolumeType::VoxelType SrcVoxelType;
+		typedef typename DstVolumeType::VoxelType DstVoxelType;
+
+		// Copy a slab of slices at a time through the bulk copy functions, which is much faster than going voxel by voxel
+		// but avoids needing a buffer for the whole region. Slabs are about a million voxels.
+		const int32_t iSliceSize = m_regSrc.getWidthInVoxels() * m_regSrc.getHeightInVoxels();
+		const int32_t iSlicesPerSlab = (std::max)((1 << 20) / iSliceSize, 1);
+
+		std::vector<SrcVoxelType> vecSrcVoxels;
+		for (int32_t iSlice = 0; iSlice < m_regSrc.getDepthInVoxels(); iSlice += iSlicesPerSlab)
 		{
-			for (int32_t sy = m_regSrc.getLowerY(), dy = m_regDst.getLowerY(); dy <= m_regDst.getUpperY(); sy++, dy++)
+			const int32_t iNoOfSlices = (std::min)(iSlicesPerSlab, m_regSrc.getDepthInVoxels() - iSlice);
+
+			Region regSrcSlab(m_regSrc);
+			regSrcSlab.setLowerZ(m_regSrc.getLowerZ() + iSlice);
+			regSrcSlab.setUpperZ(m_regSrc.getLowerZ() + iSlice + iNoOfSlices - 1);
+
+			Region regDstSlab(m_regDst);
+			regDstSlab.setLowerZ(m_regDst.getLowerZ() + iSlice);
+			regDstSlab.setUpperZ(m_regDst.getLowerZ() + iSlice + iNoOfSlices - 1);
+
+			vecSrcVoxels.resize(iSliceSize * iNoOfSlices);
+			m_vecDstVoxels.resize(iSliceSize * iNoOfSlices);
+
+			readVolumeRegion(m_pVolSrc, regSrcSlab, vecSrcVoxels.data());
+			for (std::size_t uVoxel = 0; uVoxel < vecSrcVoxels.size(); uVoxel++)
 			{
-				for (int32_t sx = m_regSrc.getLowerX(), dx = m_regDst.getLowerX(); dx <= m_regDst.getUpperX(); sx++, dx++)
-				{
-					const typename SrcVolumeType::VoxelType& tSrcVoxel = m_pVolSrc->getVoxel(sx, sy, sz);
-					const typename DstVolumeType::VoxelType& tDstVoxel = static_cast<typename DstVolumeType::VoxelType>(tSrcVoxel);
-					m_pVolDst->setVoxel(dx, dy, dz, tDstVoxel);
-				}
+				m_vecDstVoxels[uVoxel] = static_cast<DstVoxelType>(vecSrcVoxels[uVoxel]);
 			}
+			writeVolumeRegion(m_pVolDst, regDstSlab, m_vecDstVoxels.data());
 		}
 	}
 
@@ -96,23 +117,30 @@ namespace PolyVox
 		float fScaleY = srcHeight / dstHeight;
 		float fScaleZ = srcDepth / dstDepth;
 
-		typename SrcVolumeType::Sampler sampler(m_pVolSrc);
+		// The eight voxels around each sample point are at most one voxel beyond the source region.
+		m_viewSrc.stage(m_pVolSrc, m_regSrc, 1);
+		typename RegionView<typename SrcVolumeType::VoxelType>::Sampler sampler(&m_viewSrc);
 
-		for (int32_t dz = m_regDst.getLowerZ(); dz <= m_regDst.getUpperZ(); dz++)
+		const int32_t iDstWidth = m_regDst.getWidthInVoxels();
+		const int32_t iDstHeight = m_regDst.getHeightInVoxels();
+		const int32_t iDstDepth = m_regDst.getDepthInVoxels();
+		m_vecDstVoxels.resize(iDstWidth * iDstHeight * iDstDepth);
+
+		for (int32_t dz = 0; dz < iDstDepth; dz++)
 		{
-			for (int32_t dy = m_regDst.getLowerY(); dy <= m_regDst.getUpperY(); dy++)
+			for (int32_t dy = 0; dy < iDstHeight; dy++)
 			{
-				for (int32_t dx = m_regDst.getLowerX(); dx <= m_regDst.getUpperX(); dx++)
+				for (int32_t dx = 0; dx < iDstWidth; dx++)
 				{
-					float sx = (dx - m_regDst.getLowerX()) * fScaleX;
-					float sy = (dy - m_regDst.getLowerY()) * fScaleY;
-					float sz = (dz - m_regDst.getLowerZ()) * fScaleZ;
+					float sx = dx * fScaleX;
+					float sy = dy * fScaleY;
+					float sz = dz * fScaleZ;
 
 					sx += m_regSrc.getLowerX();
 					sy += m_regSrc.getLowerY();
 					sz += m_regSrc.getLowerZ();
 
-					sampler.setPosition(sx, sy, sz);
+					sampler.setPosition(static_cast<int32_t>(sx), static_cast<int32_t>(sy), static_cast<int32_t>(sz));
 					const typename SrcVolumeType::VoxelType& voxel000 = sampler.peekVoxel0px0py0pz();
 					const typename SrcVolumeType::VoxelType& voxel001 = sampler.peekVoxel0px0py1pz();
 					const typename SrcVolumeType::VoxelType& voxel010 = sampler.peekVoxel0px1py0pz();
@@ -130,10 +158,11 @@ namespace PolyVox
 
 					typename SrcVolumeType::VoxelType tInterpolatedValue = trilerp<float>(voxel000, voxel100, voxel010, voxel110, voxel001, voxel101, voxel011, voxel111, sx, sy, sz);
 
-					typename DstVolumeType::VoxelType result = static_cast<typename DstVolumeType::VoxelType>(tInterpolatedValue);
-					m_pVolDst->setVoxel(dx, dy, dz, result);
+					m_vecDstVoxels[dx + dy * iDstWidth + dz * iDstWidth * iDstHeight] = static_cast<typename DstVolumeType::VoxelType>(tInterpolatedValue);
 				}
 			}
 		}
+
+		writeVolumeRegion(m_pVolDst, m_regDst, m_vecDstVoxels.data());
 	}
 }
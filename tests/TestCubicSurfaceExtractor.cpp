@@ -38,6 +38,25 @@
 
 using namespace PolyVox;
 
+namespace PolyVox
+{
+	// A user's specialisation for a numeric voxel type, which the extractor must call rather than using bitmasks.
+	template<>
+	class DefaultIsQuadNeeded<int16_t>
+	{
+	public:
+		bool operator()(int16_t back, int16_t front, int16_t& materialToUse)
+		{
+			if ((back > 1) && (front <= 0))
+			{
+				materialToUse = back;
+				return true;
+			}
+			return false;
+		}
+	};
+}
+
 template<typename _VoxelType>
 class CustomIsQuadNeeded
 {
@@ -60,6 +79,20 @@ public:
 	}
 };
 
+// Uses the same criteria as the DefaultIsQuadNeeded, but is a different type so
+// the extractor has to call it rather than finding the faces with bitmasks.
+template<typename _VoxelType>
+class FunctorIsQuadNeeded
+{
+public:
+	typedef _VoxelType VoxelType;
+
+	bool operator()(VoxelType back, VoxelType front, VoxelType& materialToUse)
+	{
+		return DefaultIsQuadNeeded<VoxelType>()(back, front, materialToUse);
+	}
+};
+
 // Runs the surface extractor for a given type. 
 template <typename VolumeType>
 void createAndFillVolumeWithNoise(VolumeType& volData, int32_t iVolumeSideLength, typename VolumeType::VoxelType minValue, typename VolumeType::VoxelType maxValue)
@@ -132,31 +165,31 @@ void TestCubicSurfaceExtractor::testBehaviour()
 	RawVolume<uint8_t> uint8Vol(Region(0, 0, 0, iVolumeSideLength - 1, iVolumeSideLength - 1, iVolumeSideLength - 1));
 	createAndFillVolumeWithNoise(uint8Vol, 32, 0, 2);
 	auto uint8Mesh = extractCubicMesh(&uint8Vol, uint8Vol.getEnclosingRegion());
-	QCOMPARE(uint8Mesh.getNoOfVertices(), uint32_t(57544));
-	QCOMPARE(uint8Mesh.getNoOfIndices(), uint32_t(215304));
+	QCOMPARE(uint8Mesh.getNoOfVertices(), uint32_t(57516));
+	QCOMPARE(uint8Mesh.getNoOfIndices(), uint32_t(215082));
 
 	// Test with default mesh type but user-provided controller.
 	RawVolume<int8_t> int8Vol(Region(0, 0, 0, iVolumeSideLength - 1, iVolumeSideLength - 1, iVolumeSideLength - 1));
 	createAndFillVolumeWithNoise(int8Vol, 32, 0, 2);
 	auto int8Mesh = extractCubicMesh(&int8Vol, int8Vol.getEnclosingRegion(), CustomIsQuadNeeded<int8_t>());
-	QCOMPARE(int8Mesh.getNoOfVertices(), uint32_t(29106));
-	QCOMPARE(int8Mesh.getNoOfIndices(), uint32_t(178566));
+	QCOMPARE(int8Mesh.getNoOfVertices(), uint32_t(28971));
+	QCOMPARE(int8Mesh.getNoOfIndices(), uint32_t(177606));
 
 	// Test with default controller but user-provided mesh.
 	RawVolume<uint32_t> uint32Vol(Region(0, 0, 0, iVolumeSideLength - 1, iVolumeSideLength - 1, iVolumeSideLength - 1));
 	createAndFillVolumeWithNoise(uint32Vol, 32, 0, 2);
 	Mesh< CubicVertex< uint32_t >, uint16_t > uint32Mesh;
 	extractCubicMeshCustom(&uint32Vol, uint32Vol.getEnclosingRegion(), &uint32Mesh);
-	QCOMPARE(uint32Mesh.getNoOfVertices(), uint16_t(57544));
-	QCOMPARE(uint32Mesh.getNoOfIndices(), uint32_t(215304));
+	QCOMPARE(uint32Mesh.getNoOfVertices(), uint16_t(57516));
+	QCOMPARE(uint32Mesh.getNoOfIndices(), uint32_t(215082));
 
 	// Test with both mesh and controller being provided by the user.
 	RawVolume<int32_t> int32Vol(Region(0, 0, 0, iVolumeSideLength - 1, iVolumeSideLength - 1, iVolumeSideLength - 1));
 	createAndFillVolumeWithNoise(int32Vol, 32, 0, 2);
 	Mesh< CubicVertex< int32_t >, uint16_t > int32Mesh;
 	extractCubicMeshCustom(&int32Vol, int32Vol.getEnclosingRegion(), &int32Mesh, CustomIsQuadNeeded<int32_t>());
-	QCOMPARE(int32Mesh.getNoOfVertices(), uint16_t(29106));
-	QCOMPARE(int32Mesh.getNoOfIndices(), uint32_t(178566));
+	QCOMPARE(int32Mesh.getNoOfVertices(), uint16_t(28971));
+	QCOMPARE(int32Mesh.getNoOfIndices(), uint32_t(177606));
 }
 
 void TestCubicSurfaceExtractor::testEmptyVolumePerformance()
@@ -184,7 +217,106 @@ void TestCubicSurfaceExtractor::testNoiseVolumePerformance()
 	createAndFillVolumeWithNoise(noiseVol, 128, 0, 2);
 	Mesh< CubicVertex< uint32_t >, uint16_t > noiseMesh;
 	QBENCHMARK{ extractCubicMeshCustom(&noiseVol, Region(32, 32, 32, 63, 63, 63), &noiseMesh); }
-	QCOMPARE(noiseMesh.getNoOfVertices(), uint16_t(57905));
+	QCOMPARE(noiseMesh.getNoOfVertices(), uint16_t(57881));
+}
+
+void TestCubicSurfaceExtractor::testFlatTerrainPerformance()
+{
+	// Flat ground with a scattering of a second material, so there are many quads in the same plane which cannot all be merged.
+	RawVolume<uint8_t> terrainVol(Region(0, 0, 0, 127, 63, 127));
+	for (int32_t z = 0; z < 128; z++)
+	{
+		for (int32_t y = 0; y < 64; y++)
+		{
+			for (int32_t x = 0; x < 128; x++)
+			{
+				const int32_t height = 20 + z / 64;
+				terrainVol.setVoxel(x, y, z, (y > height) ? 0 : (((x * 7 + z * 13) % 5 == 0) ? 2 : 1));
+			}
+		}
+	}
+
+	Mesh< CubicVertex< uint8_t > > terrainMesh;
+	QBENCHMARK{ extractCubicMeshCustom(&terrainVol, terrainVol.getEnclosingRegion(), &terrainMesh); }
+	QCOMPARE(terrainMesh.getNoOfVertices(), uint32_t(39935));
+	QCOMPARE(terrainMesh.getNoOfIndices(), uint32_t(80520));
+}
+
+void TestCubicSurfaceExtractor::testOccupancyMasks()
+{
+	// Signed data has voxels which are neither solid nor empty, and the region is wider than a single
+	// 64-bit mask and extends past the lower edge of the volume.
+	RawVolume<int8_t> noiseVol(Region(0, 0, 0, 95, 95, 95));
+	createAndFillVolumeWithNoise(noiseVol, 96, -2, 2);
+	Region region(-1, 3, 5, 90, 70, 94);
+
+	auto maskMesh = extractCubicMesh(&noiseVol, region);
+	auto functorMesh = extractCubicMesh(&noiseVol, region, FunctorIsQuadNeeded<int8_t>());
+
+	QCOMPARE(maskMesh.getNoOfVertices(), functorMesh.getNoOfVertices());
+	QCOMPARE(maskMesh.getNoOfIndices(), functorMesh.getNoOfIndices());
+
+	uint32_t uDifferences = 0;
+	for (uint32_t ct = 0; ct < maskMesh.getNoOfVertices(); ct++)
+	{
+		const CubicVertex<int8_t>& maskVertex = maskMesh.getVertex(ct);
+		const CubicVertex<int8_t>& functorVertex = functorMesh.getVertex(ct);
+		if ((maskVertex.encodedPosition != functorVertex.encodedPosition) || (maskVertex.data != functorVertex.data))
+		{
+			uDifferences++;
+		}
+	}
+	for (uint32_t ct = 0; ct < maskMesh.getNoOfIndices(); ct++)
+	{
+		if (maskMesh.getIndex(ct) != functorMesh.getIndex(ct))
+		{
+			uDifferences++;
+		}
+	}
+	QCOMPARE(uDifferences, uint32_t(0));
+
+	// A specialisation of DefaultIsQuadNeeded has to be used in place of the bitmasks.
+	RawVolume<int16_t> specialisedVol(Region(0, 0, 0, 31, 31, 31));
+	createAndFillVolumeWithNoise(specialisedVol, 32, -2, 2);
+	auto specialisedMesh = extractCubicMesh(&specialisedVol, specialisedVol.getEnclosingRegion());
+	auto specialisedFunctorMesh = extractCubicMesh(&specialisedVol, specialisedVol.getEnclosingRegion(), FunctorIsQuadNeeded<int16_t>());
+	QCOMPARE(specialisedMesh.getNoOfVertices(), specialisedFunctorMesh.getNoOfVertices());
+	QCOMPARE(specialisedMesh.getNoOfIndices(), specialisedFunctorMesh.getNoOfIndices());
+}
+
+void TestCubicSurfaceExtractor::testQuadMerging()
+{
+	// An L-shaped layer of voxels, for which growing each run of faces into the following rows would split the
+	// middle row into more rectangles than merging the faces pair by pair did.
+	RawVolume<uint8_t> volData(Region(-1, -1, -1, 4, 3, 1));
+	for (int32_t z = -1; z <= 1; z++)
+	{
+		for (int32_t y = -1; y <= 3; y++)
+		{
+			for (int32_t x = -1; x <= 4; x++)
+			{
+				volData.setVoxel(x, y, z, 0);
+			}
+		}
+	}
+
+	const int32_t rowExtents[3][2] = { { 1, 2 }, { 0, 3 }, { 2, 3 } };
+	for (int32_t y = 0; y < 3; y++)
+	{
+		for (int32_t x = rowExtents[y][0]; x <= rowExtents[y][1]; x++)
+		{
+			volData.setVoxel(x, y, 0, 1);
+		}
+	}
+
+	// The quads are never more than those from merging pairs of faces, which needed three for each of the z faces.
+	auto mesh = extractCubicMesh(&volData, volData.getEnclosingRegion());
+	QCOMPARE(mesh.getNoOfIndices(), uint32_t(16 * 6));
+	QCOMPARE(mesh.getNoOfVertices(), uint32_t(22));
+
+	// Without merging there is a quad for every face.
+	auto unmergedMesh = extractCubicMesh(&volData, volData.getEnclosingRegion(), DefaultIsQuadNeeded<uint8_t>(), false);
+	QCOMPARE(unmergedMesh.getNoOfIndices(), uint32_t(30 * 6));
 }
 
 QTEST_MAIN(TestCubicSurfaceExtractor)
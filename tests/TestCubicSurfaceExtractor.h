@@ -36,6 +36,9 @@ class TestCubicSurfaceExtractor: public QObject
 		void testEmptyVolumePerformance();
 		void testRealisticVolumePerformance();
 		void testNoiseVolumePerformance();
+		void testFlatTerrainPerformance();
+		void testOccupancyMasks();
+		void testQuadMerging();
 };
 
 #endif
@@ -0,0 +1,137 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 Matthew Williams and David Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#include "TestLZCompressor.h"
+
+#include "PolyVox/LZCompressor.h"
+
+#include <QtTest>
+
+#include <vector>
+
+using namespace PolyVox;
+
+void TestLZCompressor::testRoundTrip()
+{
+	// A repeating pattern, which the RLECompressor could not do anything with, followed by some runs.
+	std::vector<int32_t> input;
+	for (uint32_t ct = 0; ct < 1000; ct++)
+	{
+		input.push_back(ct % 7);
+	}
+	input.insert(input.end(), 100, 1);
+	input.insert(input.end(), 1, 2);
+	input.insert(input.end(), 37, 3);
+	input.insert(input.end(), 1000, 0);
+
+	LZCompressor compressor;
+	const uint32_t inputSize = static_cast<uint32_t>(input.size() * sizeof(int32_t));
+	std::vector<uint8_t> compressed(compressor.getMaxCompressedSize(inputSize));
+	uint32_t compressedSize = compressor.compress(input.data(), inputSize, compressed.data(), static_cast<uint32_t>(compressed.size()));
+	QVERIFY(compressedSize < inputSize / 50);
+
+	std::vector<int32_t> output(input.size());
+	uint32_t outputSize = compressor.decompress(compressed.data(), compressedSize, output.data(), inputSize);
+	QCOMPARE(outputSize, inputSize);
+	QVERIFY(output == input);
+}
+
+void TestLZCompressor::testLongRuns()
+{
+	// A run is stored as a single literal followed by a match which overlaps itself.
+	std::vector<uint8_t> input(100000, 42);
+
+	LZCompressor compressor;
+	const uint32_t inputSize = static_cast<uint32_t>(input.size());
+	std::vector<uint8_t> compressed(compressor.getMaxCompressedSize(inputSize));
+	uint32_t compressedSize = compressor.compress(input.data(), inputSize, compressed.data(), static_cast<uint32_t>(compressed.size()));
+	QVERIFY(compressedSize < 500);
+
+	std::vector<uint8_t> output(input.size());
+	uint32_t outputSize = compressor.decompress(compressed.data(), compressedSize, output.data(), inputSize);
+	QCOMPARE(outputSize, inputSize);
+	QVERIFY(output == input);
+}
+
+void TestLZCompressor::testWorstCase()
+{
+	// Pseudo-random data cannot be compressed, but must still fit in the advertised size.
+	std::vector<uint8_t> input(65536);
+	uint32_t uSeed = 12345;
+	for (uint32_t ct = 0; ct < input.size(); ct++)
+	{
+		uSeed = uSeed * 1103515245 + 12345;
+		input[ct] = static_cast<uint8_t>(uSeed >> 24);
+	}
+
+	LZCompressor compressor;
+	const uint32_t inputSize = static_cast<uint32_t>(input.size());
+	std::vector<uint8_t> compressed(compressor.getMaxCompressedSize(inputSize));
+	uint32_t compressedSize = compressor.compress(input.data(), inputSize, compressed.data(), static_cast<uint32_t>(compressed.size()));
+	QVERIFY(compressedSize <= compressed.size());
+
+	std::vector<uint8_t> output(input.size());
+	compressor.decompress(compressed.data(), compressedSize, output.data(), inputSize);
+	QVERIFY(output == input);
+
+	// A buffer which is too small is an error.
+	bool exceptionThrown = false;
+	try
+	{
+		compressor.compress(input.data(), inputSize, compressed.data(), inputSize / 2);
+	}
+	catch (std::length_error&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
+}
+
+void TestLZCompressor::testCorruptData()
+{
+	std::vector<uint8_t> input(1000, 7);
+
+	LZCompressor compressor;
+	const uint32_t inputSize = static_cast<uint32_t>(input.size());
+	std::vector<uint8_t> compressed(compressor.getMaxCompressedSize(inputSize));
+	uint32_t compressedSize = compressor.compress(input.data(), inputSize, compressed.data(), static_cast<uint32_t>(compressed.size()));
+
+	// A match which refers to data before the start of the output must be detected rather than read.
+	compressed[2] = 0xFF;
+	compressed[3] = 0xFF;
+
+	std::vector<uint8_t> output(input.size());
+	bool exceptionThrown = false;
+	try
+	{
+		compressor.decompress(compressed.data(), compressedSize, output.data(), inputSize);
+	}
+	catch (std::runtime_error&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
+}
+
+QTEST_MAIN(TestLZCompressor)
@@ -86,6 +86,18 @@ void TestLowPassFilter::testExecute()
 	QCOMPARE(resultVolume.getVoxel(5, 5, 5), Density8(21));
 	QCOMPARE(resultVolume.getVoxel(6, 6, 6), Density8(10));
 	QCOMPARE(resultVolume.getVoxel(7, 7, 7), Density8(4));
+
+	// The destination region has to match the source region in size.
+	bool exceptionThrown = false;
+	try
+	{
+		LowPassFilter< RawVolume<Density8>, RawVolume<Density8>, Density16 > mismatchedFilter(&volData, reg, &resultVolume, Region(0, 0, 0, 3, 3, 3), 3);
+	}
+	catch (std::invalid_argument&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
 }
 
 QTEST_MAIN(TestLowPassFilter)
@@ -0,0 +1,107 @@
+/*******************************************************************************
+* The MIT License (MIT)
+*
+* Copyright (c) 2015 Matthew Williams and David Williams
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#include "TestRLECompressor.h"
+
+#include "PolyVox/RLECompressor.h"
+
+#include <QtTest>
+
+#include <vector>
+
+using namespace PolyVox;
+
+void TestRLECompressor::testRoundTrip()
+{
+	// Some runs of different lengths, including single values.
+	std::vector<int32_t> input;
+	input.insert(input.end(), 100, 1);
+	input.insert(input.end(), 1, 2);
+	input.insert(input.end(), 37, 3);
+	input.insert(input.end(), 1, 1);
+	input.insert(input.end(), 1000, 0);
+
+	RLECompressor<int32_t, uint16_t> compressor;
+	const uint32_t inputSize = static_cast<uint32_t>(input.size() * sizeof(int32_t));
+	std::vector<uint8_t> compressed(compressor.getMaxCompressedSize(inputSize));
+	uint32_t compressedSize = compressor.compress(input.data(), inputSize, compressed.data(), static_cast<uint32_t>(compressed.size()));
+
+	// Five runs, each of which is stored as a value and a length (with padding).
+	QCOMPARE(compressedSize, static_cast<uint32_t>(5 * 8));
+
+	std::vector<int32_t> output(input.size());
+	uint32_t outputSize = compressor.decompress(compressed.data(), compressedSize, output.data(), inputSize);
+	QCOMPARE(outputSize, inputSize);
+	QVERIFY(output == input);
+}
+
+void TestRLECompressor::testLongRuns()
+{
+	// Runs longer than the LengthType can represent must be split.
+	std::vector<uint8_t> input(1000, 42);
+
+	RLECompressor<uint8_t, uint8_t> compressor;
+	const uint32_t inputSize = static_cast<uint32_t>(input.size());
+	std::vector<uint8_t> compressed(compressor.getMaxCompressedSize(inputSize));
+	uint32_t compressedSize = compressor.compress(input.data(), inputSize, compressed.data(), static_cast<uint32_t>(compressed.size()));
+	QCOMPARE(compressedSize, static_cast<uint32_t>(4 * 2)); // 255 + 255 + 255 + 235
+
+	std::vector<uint8_t> output(input.size());
+	compressor.decompress(compressed.data(), compressedSize, output.data(), inputSize);
+	QVERIFY(output == input);
+}
+
+void TestRLECompressor::testWorstCase()
+{
+	// Every value is different, so the output is larger than the input but must still fit in the advertised size.
+	std::vector<int32_t> input(4096);
+	for (uint32_t ct = 0; ct < input.size(); ct++)
+	{
+		input[ct] = ct;
+	}
+
+	RLECompressor<int32_t, uint16_t> compressor;
+	const uint32_t inputSize = static_cast<uint32_t>(input.size() * sizeof(int32_t));
+	std::vector<uint8_t> compressed(compressor.getMaxCompressedSize(inputSize));
+	uint32_t compressedSize = compressor.compress(input.data(), inputSize, compressed.data(), static_cast<uint32_t>(compressed.size()));
+	QCOMPARE(compressedSize, static_cast<uint32_t>(compressed.size()));
+
+	std::vector<int32_t> output(input.size());
+	compressor.decompress(compressed.data(), compressedSize, output.data(), inputSize);
+	QVERIFY(output == input);
+
+	// A buffer which is too small is an error.
+	bool exceptionThrown = false;
+	try
+	{
+		compressor.compress(input.data(), inputSize, compressed.data(), inputSize);
+	}
+	catch (std::length_error&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
+}
+
+QTEST_MAIN(TestRLECompressor)
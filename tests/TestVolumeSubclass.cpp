@@ -28,7 +28,10 @@
 
 #include "PolyVox/BaseVolume.h"
 #include "PolyVox/CubicSurfaceExtractor.h"
+#include "PolyVox/LowPassFilter.h"
+#include "PolyVox/MarchingCubesSurfaceExtractor.h"
 #include "PolyVox/Material.h"
+#include "PolyVox/RawVolume.h"
 #include "PolyVox/Vector.h"
 
 #include <QtTest>
@@ -141,4 +144,57 @@ void TestVolumeSubclass::testExtractSurface()
 	QCOMPARE(result.getNoOfVertices(), static_cast<uint32_t>(8));
 }
 
+void TestVolumeSubclass::testRegionCopyFallback()
+{
+	// VolumeSubclass has no readRegion() or writeRegion(), so the algorithms which copy whole regions
+	// have to fall back to its getVoxel() and setVoxel(). The results should match those for a RawVolume.
+	Region region(0, 0, 0, 15, 15, 15);
+	VolumeSubclass<uint8_t> volumeSubclass(region);
+	RawVolume<uint8_t> rawVolume(region);
+
+	for (int32_t z = 0; z < region.getDepthInVoxels(); z++)
+	{
+		for (int32_t y = 0; y < region.getHeightInVoxels(); y++)
+		{
+			for (int32_t x = 0; x < region.getWidthInVoxels(); x++)
+			{
+				uint8_t uValue = ((x - 8) * (x - 8) + (y - 8) * (y - 8) + (z - 8) * (z - 8) < 36) ? 255 : 0;
+				volumeSubclass.setVoxel(x, y, z, uValue);
+				rawVolume.setVoxel(x, y, z, uValue);
+			}
+		}
+	}
+
+	Region regCopy(2, 3, 4, 9, 8, 7);
+	std::vector<uint8_t> vecSubclassVoxels(regCopy.getWidthInVoxels() * regCopy.getHeightInVoxels() * regCopy.getDepthInVoxels());
+	std::vector<uint8_t> vecRawVoxels(vecSubclassVoxels.size());
+	readVolumeRegion(&volumeSubclass, regCopy, vecSubclassVoxels.data());
+	readVolumeRegion(&rawVolume, regCopy, vecRawVoxels.data());
+	QCOMPARE(vecSubclassVoxels == vecRawVoxels, true);
+
+	auto subclassMesh = extractMarchingCubesMesh(&volumeSubclass, region);
+	auto rawMesh = extractMarchingCubesMesh(&rawVolume, region);
+	QCOMPARE(subclassMesh.getNoOfVertices(), rawMesh.getNoOfVertices());
+	QCOMPARE(subclassMesh.getNoOfIndices(), rawMesh.getNoOfIndices());
+
+	Region regFiltered(1, 1, 1, 14, 14, 14);
+	VolumeSubclass<uint8_t> subclassResult(region);
+	RawVolume<uint8_t> rawResult(region);
+	LowPassFilter< VolumeSubclass<uint8_t>, VolumeSubclass<uint8_t>, uint16_t > subclassFilter(&volumeSubclass, regFiltered, &subclassResult, regFiltered, 3);
+	LowPassFilter< RawVolume<uint8_t>, RawVolume<uint8_t>, uint16_t > rawFilter(&rawVolume, regFiltered, &rawResult, regFiltered, 3);
+	subclassFilter.execute();
+	rawFilter.execute();
+
+	for (int32_t z = regFiltered.getLowerZ(); z <= regFiltered.getUpperZ(); z++)
+	{
+		for (int32_t y = regFiltered.getLowerY(); y <= regFiltered.getUpperY(); y++)
+		{
+			for (int32_t x = regFiltered.getLowerX(); x <= regFiltered.getUpperX(); x++)
+			{
+				QCOMPARE(subclassResult.getVoxel(x, y, z), rawResult.getVoxel(x, y, z));
+			}
+		}
+	}
+}
+
 QTEST_MAIN(TestVolumeSubclass)
@@ -24,17 +24,244 @@
 
 #include "testvolume.h"
 
+#include "PolyVox/AStarPathfinder.h"
+#include "PolyVox/BrickVolume.h"
+#include "PolyVox/CompressedFilePager.h"
+#include "PolyVox/CubicSurfaceExtractor.h"
 #include "PolyVox/FilePager.h"
+#include "PolyVox/MappedFilePager.h"
+#include "PolyVox/MarchingCubesSurfaceExtractor.h"
 #include "PolyVox/PagedVolume.h"
+#include "PolyVox/Picking.h"
 #include "PolyVox/RawVolume.h"
+#include "PolyVox/RegionFilePager.h"
+#include "PolyVox/RLECompressor.h"
+#include "PolyVox/SparseOctreeVolume.h"
 
 #include <QtGlobal>
 #include <QtTest>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
 #include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 using namespace PolyVox;
 
+// A trivial pager which fills each chunk with a value derived from the chunk position. It is used by tests
+// which are interested in the cost of finding and managing chunks, rather than in the cost of paging itself.
+class PositionPager : public PagedVolume<int32_t>::Pager
+{
+public:
+	PositionPager()
+		:m_uNoOfPageIns(0)
+	{
+	}
+
+	virtual void pageIn(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		m_uNoOfPageIns++;
+		int32_t value = region.getLowerX() + region.getLowerY() + region.getLowerZ();
+		std::fill(pChunk->getData(), pChunk->getData() + region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels(), value);
+	}
+
+	virtual void pageOut(const Region& /*region*/, PagedVolume<int32_t>::Chunk* /*pChunk*/)
+	{
+	}
+
+	uint32_t m_uNoOfPageIns;
+};
+
+// A pager which keeps paged out chunks in memory and gives them back when they are paged in again. Chunks which have never been
+// paged out are filled in the same way as the PositionPager. It deliberately does no locking of its own, as the concurrent tests
+// rely on the volume to serialise calls to the pager.
+class MemoryPager : public PagedVolume<int32_t>::Pager
+{
+public:
+	virtual void pageIn(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		const uint32_t uNoOfVoxels = region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels();
+		auto iter = m_mapChunks.find(std::make_tuple(region.getLowerX(), region.getLowerY(), region.getLowerZ()));
+		if (iter != m_mapChunks.end())
+		{
+			std::copy(iter->second.begin(), iter->second.end(), pChunk->getData());
+		}
+		else
+		{
+			int32_t value = region.getLowerX() + region.getLowerY() + region.getLowerZ();
+			std::fill(pChunk->getData(), pChunk->getData() + uNoOfVoxels, value);
+		}
+	}
+
+	virtual void pageOut(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		const uint32_t uNoOfVoxels = region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels();
+		m_mapChunks[std::make_tuple(region.getLowerX(), region.getLowerY(), region.getLowerZ())].assign(pChunk->getData(), pChunk->getData() + uNoOfVoxels);
+	}
+
+	std::map< std::tuple<int32_t, int32_t, int32_t>, std::vector<int32_t> > m_mapChunks;
+};
+
+// A pager which reports chunks as uniform (solid below y = 0 and empty above) until they are paged out with other data.
+class UniformPager : public PagedVolume<int32_t>::Pager
+{
+public:
+	UniformPager()
+		:m_uNoOfUniformPageOuts(0)
+	{
+	}
+
+	virtual void pageIn(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		auto iter = m_mapChunks.find(std::make_tuple(region.getLowerX(), region.getLowerY(), region.getLowerZ()));
+		if (iter != m_mapChunks.end())
+		{
+			std::copy(iter->second.begin(), iter->second.end(), pChunk->getData());
+		}
+		else
+		{
+			pChunk->setUniform(region.getLowerY() < 0 ? 1 : 0);
+		}
+	}
+
+	virtual void pageOut(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		if (pChunk->isUniform())
+		{
+			m_uNoOfUniformPageOuts++;
+			return;
+		}
+
+		const uint32_t uNoOfVoxels = region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels();
+		m_mapChunks[std::make_tuple(region.getLowerX(), region.getLowerY(), region.getLowerZ())].assign(pChunk->getData(), pChunk->getData() + uNoOfVoxels);
+	}
+
+	uint32_t m_uNoOfUniformPageOuts;
+	std::map< std::tuple<int32_t, int32_t, int32_t>, std::vector<int32_t> > m_mapChunks;
+};
+
+// A pager which works with data in linear order, as many existing file formats do, and relies on the chunk to reorder it.
+class LinearPager : public PagedVolume<int32_t>::Pager
+{
+public:
+	LinearPager()
+		:m_uNoOfMisalignedChunks(0)
+		, m_uNoOfBadPageOuts(0)
+	{
+	}
+
+	virtual void pageIn(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		const uint32_t uNoOfVoxels = region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels();
+		int32_t* pData = pChunk->getData();
+		if (reinterpret_cast<uintptr_t>(pData) % SlabPool::uBlockAlignment != 0)
+		{
+			m_uNoOfMisalignedChunks++;
+		}
+
+		for (uint32_t uIndex = 0; uIndex < uNoOfVoxels; uIndex++)
+		{
+			pData[uIndex] = uIndex;
+		}
+		pChunk->changeLinearOrderingToMorton();
+	}
+
+	virtual void pageOut(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		const uint32_t uNoOfVoxels = region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels();
+		pChunk->changeMortonOrderingToLinear();
+		for (uint32_t uIndex = 0; uIndex < uNoOfVoxels; uIndex++)
+		{
+			// Only the first voxel of each chunk gets modified by the test.
+			if ((uIndex > 0) && (pChunk->getData()[uIndex] != static_cast<int32_t>(uIndex)))
+			{
+				m_uNoOfBadPageOuts++;
+				break;
+			}
+		}
+	}
+
+	uint32_t m_uNoOfMisalignedChunks;
+	uint32_t m_uNoOfBadPageOuts;
+};
+
+// A pager which blocks in pageIn() until it is opened, so that tests can control when background paging makes progress.
+class GatedPager : public PositionPager
+{
+public:
+	GatedPager()
+		:m_bOpen(false)
+		, m_bPageInStarted(false)
+	{
+	}
+
+	virtual void pageIn(const Region& region, PagedVolume<int32_t>::Chunk* pChunk)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_bPageInStarted = true;
+		m_condition.notify_all();
+		m_condition.wait(lock, [this]() { return m_bOpen; });
+		m_vecPagedInChunks.push_back(region.getLowerCorner());
+		PositionPager::pageIn(region, pChunk);
+	}
+
+	void waitForPageIn(void)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_bPageInStarted; });
+	}
+
+	void open(void)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bOpen = true;
+		m_condition.notify_all();
+	}
+
+	std::vector<Vector3DInt32> m_vecPagedInChunks;
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_bOpen;
+	bool m_bPageInStarted;
+};
+
+// A MemoryPager which records the batches it is given, before handling them in the default way.
+class BatchPager : public MemoryPager
+{
+public:
+	virtual void pageInBatch(const std::vector<BatchEntry>& vecEntries)
+	{
+		m_vecPageInBatchSizes.push_back(static_cast<uint32_t>(vecEntries.size()));
+		for (auto iter = vecEntries.begin(); iter != vecEntries.end(); iter++)
+		{
+			m_vecPagedInChunks.push_back(iter->region.getLowerCorner());
+		}
+		MemoryPager::pageInBatch(vecEntries);
+	}
+
+	virtual void pageOutBatch(const std::vector<BatchEntry>& vecEntries)
+	{
+		m_vecPageOutBatchSizes.push_back(static_cast<uint32_t>(vecEntries.size()));
+		for (auto iter = vecEntries.begin(); iter != vecEntries.end(); iter++)
+		{
+			m_vecPagedOutChunks.push_back(iter->region.getLowerCorner());
+		}
+		MemoryPager::pageOutBatch(vecEntries);
+	}
+
+	std::vector<uint32_t> m_vecPageInBatchSizes;
+	std::vector<uint32_t> m_vecPageOutBatchSizes;
+	std::vector<Vector3DInt32> m_vecPagedInChunks;
+	std::vector<Vector3DInt32> m_vecPagedOutChunks;
+};
+
 // This is used to compute a value from a list of integers. We use it to 
 // make sure we get the expected result from a series of volume accesses.
 inline int32_t cantorTupleFunction(int32_t previousResult, int32_t value)
@@ -246,6 +473,173 @@ int32_t testDirectRandomAccess(const VolumeType* volume)
 	return result;
 }
 
+// Sweeps twice through a block of chunks which is larger than the volume can hold, touching a single voxel in each
+// chunk. Almost every access is therefore a miss, and the cost is dominated by finding, creating and evicting chunks.
+template <typename VolumeType>
+int32_t testMissHeavyAccess(VolumeType* volume, int32_t chunkSideLength)
+{
+	int32_t result = 0;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int z = -8; z < 8; z++)
+		{
+			for (int y = -8; y < 8; y++)
+			{
+				for (int x = -8; x < 8; x++)
+				{
+					result = cantorTupleFunction(result, volume->getVoxel(x * chunkSideLength, y * chunkSideLength + 1, z * chunkSideLength + 2));
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+// Reads a region with the bulk copy function and counts how many voxels in the buffer differ from those given by getVoxel().
+template <typename VolumeType>
+int32_t countBulkReadErrors(const VolumeType* volume, const Region& region, const BufferLayout& layout)
+{
+	std::vector<typename VolumeType::VoxelType> buffer(layout.getRequiredBufferSize(region));
+	volume->readRegion(region, buffer.data(), layout);
+
+	int32_t errors = 0;
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			for (int x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				const uint32_t index = layout.getIndex(region, x - region.getLowerX(), y - region.getLowerY(), z - region.getLowerZ());
+				if (buffer[index] != volume->getVoxel(x, y, z))
+				{
+					errors++;
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+// Writes a pattern to a region with the bulk copy function, and counts how many voxels in the region differ from it afterwards.
+template <typename VolumeType>
+int32_t countBulkWriteErrors(VolumeType* volume, const Region& region, const BufferLayout& layout)
+{
+	std::vector<typename VolumeType::VoxelType> buffer(layout.getRequiredBufferSize(region));
+	for (std::size_t index = 0; index < buffer.size(); index++)
+	{
+		buffer[index] = static_cast<typename VolumeType::VoxelType>(index * 7 + 3);
+	}
+	volume->writeRegion(region, buffer.data(), layout);
+
+	int32_t errors = 0;
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			for (int x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				const uint32_t index = layout.getIndex(region, x - region.getLowerX(), y - region.getLowerY(), z - region.getLowerZ());
+				if (buffer[index] != volume->getVoxel(x, y, z))
+				{
+					errors++;
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+// Copies a region into a buffer one voxel at a time, for comparison with the bulk copy functions.
+template <typename VolumeType>
+void readRegionPerVoxel(const VolumeType* volume, const Region& region, typename VolumeType::VoxelType* buffer)
+{
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			for (int x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				*buffer++ = volume->getVoxel(x, y, z);
+			}
+		}
+	}
+}
+
+// Sums the Sobel gradients along the rows of a region which lie on either side of a chunk edge (where a chunk face in y meets
+// one in z). Here the 3x3x3 neighbourhood of each voxel spans four chunks, so on a PagedVolume this measures how well samplers
+// cope with chunk seams. The number of voxels visited is returned through noOfVoxels.
+template <typename VolumeType>
+int32_t sumSobelGradientsAlongChunkEdges(VolumeType* volume, const Region& region, int32_t chunkSideLength, int32_t& noOfVoxels)
+{
+	DefaultMarchingCubesController<typename VolumeType::VoxelType> controller;
+	typename VolumeType::Sampler sampler(volume);
+	int32_t result = 0;
+	noOfVoxels = 0;
+
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			// Only rows in the last or first layer of a chunk in both y and z.
+			const bool onYSeam = ((y + 1) % chunkSideLength == 0) || (y % chunkSideLength == 0);
+			const bool onZSeam = ((z + 1) % chunkSideLength == 0) || (z % chunkSideLength == 0);
+			if (!onYSeam || !onZSeam)
+			{
+				continue;
+			}
+
+			sampler.setPosition(region.getLowerX(), y, z);
+			for (int x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				Vector3DFloat v3dGradient = computeSobelGradient(sampler, controller);
+				result += static_cast<int32_t>(v3dGradient.getX() + v3dGradient.getY() + v3dGradient.getZ());
+				sampler.movePositiveX();
+				noOfVoxels++;
+			}
+		}
+	}
+
+	return result;
+}
+
+// Counts the vertices and indices which differ between two meshes extracted from different volumes.
+template <typename MeshType>
+int32_t countMeshDifferences(const MeshType& mesh1, const MeshType& mesh2)
+{
+	if ((mesh1.getNoOfVertices() != mesh2.getNoOfVertices()) || (mesh1.getNoOfIndices() != mesh2.getNoOfIndices()))
+	{
+		return -1;
+	}
+
+	int32_t differences = 0;
+	for (typename MeshType::IndexType index = 0; index < mesh1.getNoOfVertices(); index++)
+	{
+		if (mesh1.getVertex(index).encodedPosition != mesh2.getVertex(index).encodedPosition)
+		{
+			differences++;
+		}
+	}
+	for (uint32_t index = 0; index < mesh1.getNoOfIndices(); index++)
+	{
+		if (mesh1.getIndex(index) != mesh2.getIndex(index))
+		{
+			differences++;
+		}
+	}
+	return differences;
+}
+
+// Lets the pathfinder go anywhere in the volume which is not solid.
+template <typename VolumeType>
+bool isVoxelEmpty(const VolumeType* volData, const Vector3DInt32& v3dPos)
+{
+	return volData->getEnclosingRegion().containsPoint(v3dPos) && (volData->getVoxel(v3dPos) == 0);
+}
+
 TestVolume::TestVolume()
 {
 	m_regVolume = Region(-57, -31, 12, 64, 96, 131); // Deliberatly awkward size
@@ -260,11 +654,16 @@ TestVolume::TestVolume()
 
 	m_pFilePager = new FilePager<int32_t>(".");
 	m_pFilePagerHighMem = new FilePager<int32_t>(".");
+	m_pFilePagerFixedChunks = new FilePager<int32_t>(".");
 
 	//Create the volumes
 	m_pRawVolume = new RawVolume<int32_t>(m_regVolume);
+	m_pRawVolumeWithApron = new RawVolume<int32_t>(m_regVolume, 8, true);
 	m_pPagedVolume = new PagedVolume<int32_t>(m_pFilePager, 1 * 1024 * 1024, m_uChunkSideLength);
 	m_pPagedVolumeHighMem = new PagedVolume<int32_t>(m_pFilePagerHighMem, 256 * 1024 * 1024, m_uChunkSideLength);
+	m_pFixedChunkPagedVolume = new FixedChunkPagedVolume<int32_t, m_uChunkSideLength>(m_pFilePagerFixedChunks, 1 * 1024 * 1024);
+	m_pSparseOctreeVolume = new SparseOctreeVolume<int32_t>(m_regVolume);
+	m_pBrickVolume = new BrickVolume<int32_t>(m_regVolume);
 
 	//Fill the volume with some data
 	for (int z = m_regVolume.getLowerZ(); z <= m_regVolume.getUpperZ(); z++)
@@ -275,8 +674,12 @@ TestVolume::TestVolume()
 			{
 				int32_t value = x + y + z;
 				m_pRawVolume->setVoxel(x, y, z, value);
+				m_pRawVolumeWithApron->setVoxel(x, y, z, value);
 				m_pPagedVolume->setVoxel(x, y, z, value);
 				m_pPagedVolumeHighMem->setVoxel(x, y, z, value);
+				m_pFixedChunkPagedVolume->setVoxel(x, y, z, value);
+				m_pSparseOctreeVolume->setVoxel(x, y, z, value);
+				m_pBrickVolume->setVoxel(x, y, z, value);
 			}
 		}
 	}
@@ -300,9 +703,14 @@ TestVolume::~TestVolume()
 	delete m_pPagedVolumeChunk;
 
 	delete m_pRawVolume;
+	delete m_pRawVolumeWithApron;
 	delete m_pPagedVolume;
+	delete m_pFixedChunkPagedVolume;
+	delete m_pSparseOctreeVolume;
+	delete m_pBrickVolume;
 
 	delete m_pFilePager;
+	delete m_pFilePagerFixedChunks;
 }
 
 /*
@@ -397,6 +805,89 @@ void TestVolume::testRawVolumeSamplersWithExternalBackwards()
 	QCOMPARE(result, static_cast<int32_t>(-993539594));
 }
 
+void TestVolume::testRawVolumeWithApronSamplersAllInternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingForwards(m_pRawVolumeWithApron, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(1004598054));
+}
+
+void TestVolume::testRawVolumeWithApronSamplersWithExternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingForwards(m_pRawVolumeWithApron, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(337227750));
+}
+
+void TestVolume::testRawVolumeApron()
+{
+	const Region regValid(-3, 2, 5, 9, 11, 8);
+	RawVolume<int32_t> volume(regValid, 2);
+	QCOMPARE(volume.getApronSize(), static_cast<uint16_t>(2));
+	QCOMPARE(volume.getEnclosingRegion(), regValid);
+
+	for (int32_t z = regValid.getLowerZ(); z <= regValid.getUpperZ(); z++)
+	{
+		for (int32_t y = regValid.getLowerY(); y <= regValid.getUpperY(); y++)
+		{
+			for (int32_t x = regValid.getLowerX(); x <= regValid.getUpperX(); x++)
+			{
+				volume.setVoxel(x, y, z, x * 7 + y * 3 - z);
+			}
+		}
+	}
+
+	// The apron should be invisible, so samplers inside it, on its edge and beyond it must all agree with getVoxel().
+	for (int32_t borderValue : { 0, -42 })
+	{
+		volume.setBorderValue(borderValue);
+
+		Region regSampled(regValid);
+		regSampled.grow(4);
+
+		int32_t errors = 0;
+		RawVolume<int32_t>::Sampler sampler(&volume);
+		for (int32_t z = regSampled.getLowerZ(); z <= regSampled.getUpperZ(); z++)
+		{
+			for (int32_t y = regSampled.getLowerY(); y <= regSampled.getUpperY(); y++)
+			{
+				sampler.setPosition(regSampled.getLowerX(), y, z);
+				for (int32_t x = regSampled.getLowerX(); x <= regSampled.getUpperX(); x++)
+				{
+					if (sampler.getVoxel() != volume.getVoxel(x, y, z)) errors++;
+					if (sampler.peekVoxel1nx1ny1nz() != volume.getVoxel(x - 1, y - 1, z - 1)) errors++;
+					if (sampler.peekVoxel1px0py1nz() != volume.getVoxel(x + 1, y, z - 1)) errors++;
+					if (sampler.peekVoxel0px1py0pz() != volume.getVoxel(x, y + 1, z)) errors++;
+					if (sampler.peekVoxel1px1py1pz() != volume.getVoxel(x + 1, y + 1, z + 1)) errors++;
+					sampler.movePositiveX();
+				}
+			}
+		}
+		QCOMPARE(errors, 0);
+	}
+
+	// Writes outside the valid region must still be rejected, even where the apron has storage.
+	bool exceptionThrown = false;
+	try
+	{
+		volume.setVoxel(regValid.getLowerX() - 1, regValid.getLowerY(), regValid.getLowerZ(), 1);
+	}
+	catch (std::out_of_range&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
+	QCOMPARE(volume.getVoxel(regValid.getLowerX() - 1, regValid.getLowerY(), regValid.getLowerZ()), -42);
+}
+
 /*
  * PagedVolume Tests
  */
@@ -482,37 +973,305 @@ void TestVolume::testPagedVolumeSamplersWithExternalBackwards()
 }
 
 /*
- * Random access tests
+ * FixedChunkPagedVolume Tests
  */
-void TestVolume::testRawVolumeDirectRandomAccess()
+
+void TestVolume::testFixedChunkPagedVolumeDirectAccessAllInternalForwards()
 {
 	int32_t result = 0;
 	QBENCHMARK
 	{
-		result = testDirectRandomAccess(m_pRawVolume);
+		result = testDirectAccessWithWrappingForwards(m_pFixedChunkPagedVolume, m_regInternal);
 	}
-	QCOMPARE(result, static_cast<int32_t>(171835633));
+	QCOMPARE(result, static_cast<int32_t>(1004598054));
 }
 
-void TestVolume::testPagedVolumeDirectRandomAccess()
+void TestVolume::testFixedChunkPagedVolumeSamplersAllInternalForwards()
 {
 	int32_t result = 0;
 	QBENCHMARK
 	{
-		result = testDirectRandomAccess(m_pPagedVolumeHighMem);
+		result = testSamplersWithWrappingForwards(m_pFixedChunkPagedVolume, m_regInternal);
 	}
-	QCOMPARE(result, static_cast<int32_t>(171835633));
+	QCOMPARE(result, static_cast<int32_t>(1004598054));
 }
 
-int32_t TestVolume::testPagedVolumeChunkAccess(uint16_t localityMask)
+void TestVolume::testFixedChunkPagedVolumeDirectAccessWithExternalForwards()
 {
-	std::mt19937 rng;
-	int32_t sum = 0;
-	uint16_t x = 0;
-	uint16_t y = 0;
-	uint16_t z = 0;
-
-	// Used to constrain the range, as '&=m_uChunkSideLengthMask' should be faster than '%=m_uChunkSideLength'.
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingForwards(m_pFixedChunkPagedVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(337227750));
+}
+
+void TestVolume::testFixedChunkPagedVolumeSamplersWithExternalForwards()
+{
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingForwards(m_pFixedChunkPagedVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(337227750));
+}
+
+void TestVolume::testFixedChunkPagedVolumeDirectAccessAllInternalBackwards()
+{
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingBackwards(m_pFixedChunkPagedVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-269366578));
+}
+
+void TestVolume::testFixedChunkPagedVolumeSamplersAllInternalBackwards()
+{
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingBackwards(m_pFixedChunkPagedVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-269366578));
+}
+
+void TestVolume::testFixedChunkPagedVolumeDirectAccessWithExternalBackwards()
+{
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingBackwards(m_pFixedChunkPagedVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-993539594));
+}
+
+void TestVolume::testFixedChunkPagedVolumeSamplersWithExternalBackwards()
+{
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingBackwards(m_pFixedChunkPagedVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-993539594));
+}
+
+/*
+ * SparseOctreeVolume Tests
+ */
+
+void TestVolume::testSparseOctreeVolumeDirectAccessAllInternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingForwards(m_pSparseOctreeVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(1004598054));
+}
+
+void TestVolume::testSparseOctreeVolumeSamplersAllInternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingForwards(m_pSparseOctreeVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(1004598054));
+}
+
+void TestVolume::testSparseOctreeVolumeDirectAccessWithExternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingForwards(m_pSparseOctreeVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(337227750));
+}
+
+void TestVolume::testSparseOctreeVolumeSamplersWithExternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingForwards(m_pSparseOctreeVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(337227750));
+}
+
+void TestVolume::testSparseOctreeVolumeDirectAccessAllInternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingBackwards(m_pSparseOctreeVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-269366578));
+}
+
+void TestVolume::testSparseOctreeVolumeSamplersAllInternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingBackwards(m_pSparseOctreeVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-269366578));
+}
+
+void TestVolume::testSparseOctreeVolumeDirectAccessWithExternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingBackwards(m_pSparseOctreeVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-993539594));
+}
+
+void TestVolume::testSparseOctreeVolumeSamplersWithExternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingBackwards(m_pSparseOctreeVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-993539594));
+}
+
+/*
+ * BrickVolume Tests
+ */
+
+void TestVolume::testBrickVolumeDirectAccessAllInternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingForwards(m_pBrickVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(1004598054));
+}
+
+void TestVolume::testBrickVolumeSamplersAllInternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingForwards(m_pBrickVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(1004598054));
+}
+
+void TestVolume::testBrickVolumeDirectAccessWithExternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingForwards(m_pBrickVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(337227750));
+}
+
+void TestVolume::testBrickVolumeSamplersWithExternalForwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingForwards(m_pBrickVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(337227750));
+}
+
+void TestVolume::testBrickVolumeDirectAccessAllInternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingBackwards(m_pBrickVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-269366578));
+}
+
+void TestVolume::testBrickVolumeSamplersAllInternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingBackwards(m_pBrickVolume, m_regInternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-269366578));
+}
+
+void TestVolume::testBrickVolumeDirectAccessWithExternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testDirectAccessWithWrappingBackwards(m_pBrickVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-993539594));
+}
+
+void TestVolume::testBrickVolumeSamplersWithExternalBackwards()
+{
+	int32_t result = 0;
+
+	QBENCHMARK
+	{
+		result = testSamplersWithWrappingBackwards(m_pBrickVolume, m_regExternal);
+	}
+	QCOMPARE(result, static_cast<int32_t>(-993539594));
+}
+
+/*
+ * Random access tests
+ */
+void TestVolume::testRawVolumeDirectRandomAccess()
+{
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testDirectRandomAccess(m_pRawVolume);
+	}
+	QCOMPARE(result, static_cast<int32_t>(171835633));
+}
+
+void TestVolume::testPagedVolumeDirectRandomAccess()
+{
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		result = testDirectRandomAccess(m_pPagedVolumeHighMem);
+	}
+	QCOMPARE(result, static_cast<int32_t>(171835633));
+}
+
+int32_t TestVolume::testPagedVolumeChunkAccess(uint16_t localityMask)
+{
+	std::mt19937 rng;
+	int32_t sum = 0;
+	uint16_t x = 0;
+	uint16_t y = 0;
+	uint16_t z = 0;
+
+	// Used to constrain the range, as '&=m_uChunkSideLengthMask' should be faster than '%=m_uChunkSideLength'.
 	uint16_t m_uChunkSideLengthMask = m_uChunkSideLength - 1;
 
 	for (int32_t ct = 0; ct < 10000000; ct++)
@@ -600,4 +1359,1658 @@ void TestVolume::testPagedVolumeChunkRandomAccess()
 	QCOMPARE(result, static_cast<int32_t>(71649197));
 }
 
+void TestVolume::testPagedVolumeMissHeavyAccess()
+{
+	const int32_t chunkSideLength = 8;
+	PositionPager pager;
+
+	int32_t result = 0;
+	QBENCHMARK
+	{
+		PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, chunkSideLength);
+		result = testMissHeavyAccess(volume, chunkSideLength);
+		delete volume;
+	}
+	QCOMPARE(result, static_cast<int32_t>(-583239980));
+}
+
+void TestVolume::testPagedVolumeChunkEviction()
+{
+	const int32_t chunkSideLength = 8;
+	const uint32_t memoryLimit = 1 * 1024 * 1024;
+	const uint32_t chunkCountLimit = memoryLimit / (chunkSideLength * chunkSideLength * chunkSideLength * sizeof(int32_t));
+
+	ChunkEvictionPolicy policies[] = { ChunkEvictionPolicies::LeastRecentlyUsed, ChunkEvictionPolicies::Clock };
+	for (ChunkEvictionPolicy policy : policies)
+	{
+		PositionPager pager;
+		PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, memoryLimit, chunkSideLength, policy);
+
+		// Fill the volume exactly, and then touch every chunk again. Nothing should be paged in twice.
+		for (int pass = 0; pass < 2; pass++)
+		{
+			for (uint32_t chunk = 0; chunk < chunkCountLimit; chunk++)
+			{
+				volume->getVoxel(chunk * chunkSideLength, 0, 0);
+			}
+		}
+		QCOMPARE(pager.m_uNoOfPageIns, chunkCountLimit);
+		QCOMPARE(volume->calculateSizeInBytes(), memoryLimit);
+
+		// One more chunk means one must be evicted, and the budget must still be respected. Both policies should choose chunk 0.
+		volume->getVoxel(chunkCountLimit * chunkSideLength, 0, 0);
+		QCOMPARE(pager.m_uNoOfPageIns, chunkCountLimit + 1);
+		QCOMPARE(volume->calculateSizeInBytes(), memoryLimit);
+
+		// Chunk 1 is still resident, and touching it should protect it from the next eviction (which should take chunk 2).
+		volume->getVoxel(1 * chunkSideLength, 0, 0);
+		QCOMPARE(pager.m_uNoOfPageIns, chunkCountLimit + 1);
+		volume->getVoxel(0 * chunkSideLength, 0, 0);
+		QCOMPARE(pager.m_uNoOfPageIns, chunkCountLimit + 2);
+		volume->getVoxel(1 * chunkSideLength, 0, 0);
+		QCOMPARE(pager.m_uNoOfPageIns, chunkCountLimit + 2);
+		volume->getVoxel(2 * chunkSideLength, 0, 0);
+		QCOMPARE(pager.m_uNoOfPageIns, chunkCountLimit + 3);
+		QCOMPARE(volume->calculateSizeInBytes(), memoryLimit);
+
+		delete volume;
+	}
+}
+
+void TestVolume::testPagedVolumeConcurrentAccess()
+{
+	const uint16_t chunkSideLength = 16;
+	const int32_t chunkMask = ~(chunkSideLength - 1);
+
+	// A small budget means the readers and the writer are constantly evicting each other's chunks.
+	MemoryPager pager;
+	PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, chunkSideLength, ChunkEvictionPolicies::LeastRecentlyUsed, true);
+
+	// The readers work on a region which is never modified, so they know what every voxel should contain.
+	const Region regRead(0, 0, 0, 127, 63, 63);
+	const int noOfReaders = 4;
+	const int noOfPasses = 3;
+	std::atomic<int32_t> readErrors(0);
+
+	// The writer works on a separate region, writing a known value to every voxel on each pass.
+	const Region regWrite(-64, 0, 0, -1, 63, 63);
+	auto writeValue = [](int32_t x, int32_t y, int32_t z, int pass) { return x * 7 + y * 13 + z * 31 + pass; };
+
+	// Some threads extract meshes from the read region, which should come out the same as when nothing else is going on.
+	const Region regExtract(8, 8, 8, 71, 55, 55);
+	DefaultMarchingCubesController<int32_t> controller;
+	controller.setThreshold(40);
+	const auto expectedCubicMesh = extractCubicMesh(volume, regExtract);
+	const auto expectedMarchingCubesMesh = extractMarchingCubesMesh(volume, regExtract, controller);
+	const int noOfExtractors = 2;
+	std::atomic<int32_t> extractErrors(0);
+
+	std::vector<std::thread> threads;
+	for (int extractor = 0; extractor < noOfExtractors; extractor++)
+	{
+		threads.emplace_back([&]()
+		{
+			for (int pass = 0; pass < noOfPasses; pass++)
+			{
+				const auto cubicMesh = extractCubicMesh(volume, regExtract);
+				const auto marchingCubesMesh = extractMarchingCubesMesh(volume, regExtract, controller);
+				if ((cubicMesh.getNoOfVertices() != expectedCubicMesh.getNoOfVertices()) ||
+					(cubicMesh.getNoOfIndices() != expectedCubicMesh.getNoOfIndices()) ||
+					(marchingCubesMesh.getNoOfVertices() != expectedMarchingCubesMesh.getNoOfVertices()) ||
+					(marchingCubesMesh.getNoOfIndices() != expectedMarchingCubesMesh.getNoOfIndices()))
+				{
+					extractErrors++;
+				}
+			}
+		});
+	}
+
+	for (int reader = 0; reader < noOfReaders; reader++)
+	{
+		// Half the readers use samplers (which pin chunks) and half use direct access (which goes via the per-thread cache).
+		threads.emplace_back([&, reader]()
+		{
+			PagedVolume<int32_t>::Sampler sampler(volume);
+			for (int pass = 0; pass < noOfPasses; pass++)
+			{
+				for (int32_t z = regRead.getLowerZ(); z <= regRead.getUpperZ(); z++)
+				{
+					for (int32_t y = regRead.getLowerY(); y <= regRead.getUpperY(); y++)
+					{
+						sampler.setPosition(regRead.getLowerX(), y, z);
+						for (int32_t x = regRead.getLowerX(); x <= regRead.getUpperX(); x++)
+						{
+							const int32_t expected = (x & chunkMask) + (y & chunkMask) + (z & chunkMask);
+							const int32_t actual = (reader % 2) ? volume->getVoxel(x, y, z) : sampler.getVoxel();
+							if (actual != expected)
+							{
+								readErrors++;
+							}
+							sampler.movePositiveX();
+						}
+					}
+				}
+			}
+		});
+	}
+
+	std::atomic<int32_t> writeErrors(0);
+	threads.emplace_back([&]()
+	{
+		for (int pass = 0; pass < noOfPasses; pass++)
+		{
+			for (int32_t z = regWrite.getLowerZ(); z <= regWrite.getUpperZ(); z++)
+			{
+				for (int32_t y = regWrite.getLowerY(); y <= regWrite.getUpperY(); y++)
+				{
+					for (int32_t x = regWrite.getLowerX(); x <= regWrite.getUpperX(); x++)
+					{
+						volume->setVoxel(x, y, z, writeValue(x, y, z, pass));
+					}
+				}
+			}
+
+			// Read everything back. Most of it will have been evicted by now, so this checks it made it through the pager.
+			for (int32_t z = regWrite.getLowerZ(); z <= regWrite.getUpperZ(); z++)
+			{
+				for (int32_t y = regWrite.getLowerY(); y <= regWrite.getUpperY(); y++)
+				{
+					for (int32_t x = regWrite.getLowerX(); x <= regWrite.getUpperX(); x++)
+					{
+						if (volume->getVoxel(x, y, z) != writeValue(x, y, z, pass))
+						{
+							writeErrors++;
+						}
+					}
+				}
+			}
+		}
+	});
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	QCOMPARE(readErrors.load(), 0);
+	QCOMPARE(writeErrors.load(), 0);
+	QCOMPARE(extractErrors.load(), 0);
+	QVERIFY(expectedCubicMesh.getNoOfIndices() > 0);
+	QVERIFY(expectedMarchingCubesMesh.getNoOfIndices() > 0);
+	QCOMPARE(volume->calculateSizeInBytes(), static_cast<uint32_t>(1 * 1024 * 1024));
+
+	// Threads give up their cached chunks when they exit, so that is true of the threads above as well as of many more which come
+	// and go one after another (as in a thread pool which creates threads on demand). The last of these should still get a cache slot.
+	QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(0));
+	for (int thread = 0; thread < 100; thread++)
+	{
+		std::thread([&]() { volume->getVoxel(thread * chunkSideLength, 0, 0); }).join();
+	}
+	QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(0));
+
+	// Flushing should page out the last of the writer's changes.
+	volume->flushAll();
+	delete volume;
+
+	PagedVolume<int32_t>* reloadedVolume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, chunkSideLength);
+	int32_t reloadErrors = 0;
+	for (int32_t z = regWrite.getLowerZ(); z <= regWrite.getUpperZ(); z++)
+	{
+		for (int32_t y = regWrite.getLowerY(); y <= regWrite.getUpperY(); y++)
+		{
+			for (int32_t x = regWrite.getLowerX(); x <= regWrite.getUpperX(); x++)
+			{
+				if (reloadedVolume->getVoxel(x, y, z) != writeValue(x, y, z, noOfPasses - 1))
+				{
+					reloadErrors++;
+				}
+			}
+		}
+	}
+	QCOMPARE(reloadErrors, 0);
+	delete reloadedVolume;
+}
+
+void TestVolume::testPagedVolumeSamplerOutlivesVolume()
+{
+	// A sampler (and a copy of it) holding pins on several chunks can be destroyed after the volume, as long as it is not used.
+	MemoryPager pager;
+	PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, 16, ChunkEvictionPolicies::LeastRecentlyUsed, true);
+	PagedVolume<int32_t>::Sampler sampler(volume);
+	sampler.setPosition(15, 15, 15);
+	QCOMPARE(sampler.peekVoxel1px1py1pz(), volume->getVoxel(16, 16, 16));
+	QCOMPARE(sampler.peekVoxel1nx1ny1nz(), volume->getVoxel(14, 14, 14));
+	PagedVolume<int32_t>::Sampler copy(sampler);
+	QVERIFY(volume->getNoOfPinnedChunks() > 1);
+
+	delete volume;
+}
+
+void TestVolume::testPagedVolumePrefetchAsync()
+{
+	const uint16_t chunkSideLength = 16;
+
+	// Prefetch a block of chunks in the background, after which accessing them should not page anything else in.
+	{
+		PositionPager pager;
+		PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 4 * 1024 * 1024, chunkSideLength, ChunkEvictionPolicies::LeastRecentlyUsed, true);
+
+		auto request = volume->prefetchAsync(Region(0, 0, 0, 63, 63, 63));
+		request->getFuture().get();
+		QVERIFY(request->isComplete());
+		QCOMPARE(pager.m_uNoOfPageIns, static_cast<uint32_t>(64));
+
+		int32_t result = 0;
+		for (int32_t z = 0; z < 64; z += chunkSideLength)
+		{
+			for (int32_t y = 0; y < 64; y += chunkSideLength)
+			{
+				for (int32_t x = 0; x < 64; x += chunkSideLength)
+				{
+					result += volume->getVoxel(x, y, z);
+				}
+			}
+		}
+		QCOMPARE(result, static_cast<int32_t>(4608));
+		QCOMPARE(pager.m_uNoOfPageIns, static_cast<uint32_t>(64));
+
+		delete volume;
+	}
+
+	// A request which is cancelled before the workers reach it should not page anything in.
+	{
+		GatedPager pager;
+		PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 4 * 1024 * 1024, chunkSideLength, ChunkEvictionPolicies::LeastRecentlyUsed, true);
+
+		auto firstRequest = volume->prefetchAsync(Region(0, 0, 0, 31, 31, 31));
+		pager.waitForPageIn();
+
+		auto secondRequest = volume->prefetchAsync(Region(1024, 0, 0, 1055, 31, 31));
+		secondRequest->cancel();
+		QVERIFY(secondRequest->isCancelled());
+
+		pager.open();
+		firstRequest->wait();
+		secondRequest->wait();
+		QVERIFY(firstRequest->isComplete());
+		QVERIFY(secondRequest->isComplete());
+
+		QCOMPARE(pager.m_vecPagedInChunks.size(), static_cast<size_t>(8));
+		for (const Vector3DInt32& v3dChunk : pager.m_vecPagedInChunks)
+		{
+			QVERIFY(v3dChunk.getX() < 1024);
+		}
+
+		delete volume;
+	}
+}
+
+void TestVolume::testPagedVolumeWriteBehind()
+{
+	const uint16_t chunkSideLength = 16;
+	const int32_t noOfChunks = 256;
+
+	// The volume only holds 64 chunks, so most of the modified chunks will be evicted and queued for writing while we are still working.
+	MemoryPager pager;
+	PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, chunkSideLength);
+	volume->setWriteBehindEnabled(true);
+
+	// Every read should see the last value written, whether it comes from memory, the queue, or the pager.
+	int32_t errors = 0;
+	for (int32_t pass = 0; pass < 3; pass++)
+	{
+		for (int32_t chunk = 0; chunk < noOfChunks; chunk++)
+		{
+			volume->setVoxel(chunk * chunkSideLength, 0, 0, chunk + pass * 1000);
+		}
+
+		for (int32_t chunk = 0; chunk < noOfChunks; chunk++)
+		{
+			if (volume->getVoxel(chunk * chunkSideLength, 0, 0) != chunk + pass * 1000)
+			{
+				errors++;
+			}
+		}
+	}
+	QCOMPARE(errors, 0);
+
+	// Once flushAll() returns the pager must have been given everything.
+	volume->flushAll();
+	QCOMPARE(volume->calculateSizeInBytes(), static_cast<uint32_t>(0));
+	for (int32_t chunk = 0; chunk < noOfChunks; chunk++)
+	{
+		const std::vector<int32_t>& data = pager.m_mapChunks[std::make_tuple(chunk * chunkSideLength, 0, 0)];
+		if (data.empty() || (data[0] != chunk + 2000))
+		{
+			errors++;
+		}
+	}
+	QCOMPARE(errors, 0);
+
+	delete volume;
+}
+
+void TestVolume::testPagedVolumeCompressedTier()
+{
+	const uint16_t chunkSideLength = 16;
+	const uint32_t noOfChunks = 512; // Eight times as many as the uncompressed tier can hold.
+
+	MemoryPager pager;
+	RLECompressor<int32_t, uint16_t> compressor;
+	PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, chunkSideLength);
+	volume->setCompressedTier(&compressor, 1 * 1024 * 1024);
+
+	// Modify a single voxel in each chunk. Each chunk then compresses to a handful of runs.
+	for (uint32_t chunk = 0; chunk < noOfChunks; chunk++)
+	{
+		volume->setVoxel(chunk * chunkSideLength, 1, 0, chunk);
+	}
+
+	// Everything has fitted in memory, so nothing should have reached the pager.
+	QVERIFY(pager.m_mapChunks.empty());
+	QVERIFY(volume->calculateCompressedSizeInBytes() > 0);
+	QCOMPARE(volume->calculateSizeInBytes(), 1 * 1024 * 1024 + volume->calculateCompressedSizeInBytes());
+
+	// Reading everything back has to decompress most of the chunks.
+	int32_t errors = 0;
+	for (uint32_t chunk = 0; chunk < noOfChunks; chunk++)
+	{
+		const int32_t expectedFill = chunk * chunkSideLength;
+		if ((volume->getVoxel(chunk * chunkSideLength, 1, 0) != static_cast<int32_t>(chunk)) ||
+			(volume->getVoxel(chunk * chunkSideLength + 1, 1, 0) != expectedFill))
+		{
+			errors++;
+		}
+	}
+	QCOMPARE(errors, 0);
+	QVERIFY(pager.m_mapChunks.empty());
+
+	// Shrinking the compressed tier forces chunks out to the pager, and flushing sends everything.
+	volume->setCompressedTier(&compressor, 1024);
+	QVERIFY(volume->calculateCompressedSizeInBytes() <= 1024);
+	QVERIFY(!pager.m_mapChunks.empty());
+	volume->flushAll();
+	QCOMPARE(volume->calculateSizeInBytes(), static_cast<uint32_t>(0));
+	QCOMPARE(pager.m_mapChunks.size(), static_cast<size_t>(noOfChunks));
+
+	delete volume;
+}
+
+void TestVolume::testPagedVolumeUniformChunks()
+{
+	UniformPager pager;
+	PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, m_uChunkSideLength);
+
+	// Samplers (including their peeks) should see the uniform values of every chunk they pass through.
+	int32_t sum = 0;
+	int32_t peekSum = 0;
+	PagedVolume<int32_t>::Sampler sampler(&volume);
+	for (int32_t z = 0; z < 32; z++)
+	{
+		for (int32_t y = -64; y < 64; y++)
+		{
+			sampler.setPosition(-64, y, z);
+			for (int32_t x = -64; x < 64; x++)
+			{
+				sum += sampler.getVoxel();
+				peekSum += sampler.peekVoxel1px1py1pz();
+				sampler.movePositiveX();
+			}
+		}
+	}
+	QCOMPARE(sum, 128 * 64 * 32);
+	QCOMPARE(peekSum, 128 * 63 * 32);
+	QCOMPARE(volume.getVoxel(10, -10, 10), 1);
+	QCOMPARE(volume.getVoxel(10, 10, 10), 0);
+
+	// A sampler which entered a chunk while it was uniform must still see later writes to it.
+	sampler.setPosition(5, 5, 5);
+	volume.setVoxel(6, 5, 5, 7);
+	QCOMPARE(sampler.getVoxel(), 0);
+	QCOMPARE(sampler.peekVoxel1px0py0pz(), 7);
+	sampler.movePositiveX();
+	QCOMPARE(sampler.getVoxel(), 7);
+
+	// Writing the uniform value does not modify a chunk, so only the chunk with the 7 in it should be paged out.
+	volume.setVoxel(100, 100, 100, 0);
+	sampler.setPosition(1000, 1000, 1000); // Release the pin on the modified chunk.
+	volume.flushAll();
+	QCOMPARE(pager.m_uNoOfUniformPageOuts, static_cast<uint32_t>(0));
+	QCOMPARE(pager.m_mapChunks.size(), static_cast<size_t>(1));
+	QCOMPARE(volume.getVoxel(6, 5, 5), 7);
+	QCOMPARE(volume.getVoxel(7, 5, 5), 0);
+
+	// Uniform chunks should take almost no space in the compressed tier, and come back out of it unchanged.
+	RLECompressor<int32_t, uint16_t> compressor;
+	volume.setCompressedTier(&compressor, 1 * 1024 * 1024);
+	for (int32_t chunk = 0; chunk < 64; chunk++)
+	{
+		volume.setVoxel(chunk * m_uChunkSideLength, -1, 0, 1);
+	}
+	QVERIFY(volume.calculateCompressedSizeInBytes() > 0);
+	QVERIFY(volume.calculateCompressedSizeInBytes() <= 64 * sizeof(int32_t));
+	QCOMPARE(volume.getVoxel(0, -1, 0), 1);
+	QCOMPARE(volume.getVoxel(0, 0, 0), 0);
+}
+
+void TestVolume::testPagedVolumeChunkDataPool()
+{
+	const int32_t chunkSideLength = 32;
+	const int32_t noOfChunks = 32; // The minimum number of chunks a volume will hold.
+
+	LinearPager pager;
+	PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, chunkSideLength);
+
+	// Fill the volume, then keep replacing its contents. Only the first pass should need any new memory, and even then
+	// most of the blocks come from slabs which were allocated earlier in the pass.
+	int32_t errors = 0;
+	for (int32_t pass = 0; pass < 4; pass++)
+	{
+		for (int32_t chunk = 0; chunk < noOfChunks; chunk++)
+		{
+			const int32_t x = (pass * noOfChunks + chunk) * chunkSideLength;
+			if ((volume->getVoxel(x + 1, 2, 3) != 1 + 2 * chunkSideLength + 3 * chunkSideLength * chunkSideLength) ||
+				(volume->getVoxel(x + 31, 31, 31) != chunkSideLength * chunkSideLength * chunkSideLength - 1))
+			{
+				errors++;
+			}
+			volume->setVoxel(x, 0, 0, -1);
+		}
+	}
+	QCOMPARE(errors, 0);
+
+	SlabPool::Statistics statistics = volume->getChunkDataPoolStatistics();
+	QCOMPARE(statistics.uNoOfBlocksInUse, static_cast<uint32_t>(noOfChunks));
+	QCOMPARE(statistics.uNoOfHits + statistics.uNoOfMisses, static_cast<uint64_t>(4 * noOfChunks));
+	QVERIFY(statistics.uNoOfMisses < static_cast<uint64_t>(noOfChunks));
+	QCOMPARE(statistics.uNoOfOverflows, static_cast<uint64_t>(0));
+
+	// Flushing gives every block back, and the reordering done by the pager should not have disturbed any voxels.
+	volume->flushAll();
+	QCOMPARE(volume->getChunkDataPoolStatistics().uNoOfBlocksInUse, static_cast<uint32_t>(0));
+	QCOMPARE(pager.m_uNoOfMisalignedChunks, static_cast<uint32_t>(0));
+	QCOMPARE(pager.m_uNoOfBadPageOuts, static_cast<uint32_t>(0));
+
+	delete volume;
+}
+
+void TestVolume::testPagedVolumePinnedRegion()
+{
+	const int32_t chunkSideLength = 32;
+	const uint32_t chunkSizeInBytes = chunkSideLength * chunkSideLength * chunkSideLength * sizeof(int32_t);
+	const uint32_t noOfChunks = 32; // The minimum number of chunks a volume will hold.
+
+	PositionPager pager;
+	PagedVolume<int32_t>* volume = new PagedVolume<int32_t>(&pager, 1 * 1024 * 1024, chunkSideLength);
+
+	// Pinned chunks should survive plenty of other chunks being paged in.
+	PagedVolume<int32_t>::PinnedRegion pinnedRegion = volume->pinRegion(Region(0, 0, 0, 63, 63, 63));
+	QCOMPARE(pinnedRegion.getNoOfChunks(), static_cast<uint32_t>(8));
+	QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(8));
+	for (int32_t chunk = 0; chunk < 256; chunk++)
+	{
+		volume->getVoxel(-chunkSideLength * (chunk + 1), 0, 0);
+	}
+	const uint32_t noOfPageIns = pager.m_uNoOfPageIns;
+	QCOMPARE(volume->getVoxel(63, 63, 63), 32 + 32 + 32);
+	QCOMPARE(pager.m_uNoOfPageIns, noOfPageIns);
+
+	// Moving the pins keeps them in place.
+	PagedVolume<int32_t>::PinnedRegion movedRegion(std::move(pinnedRegion));
+	QCOMPARE(pinnedRegion.getNoOfChunks(), static_cast<uint32_t>(0));
+	QCOMPARE(movedRegion.getNoOfChunks(), static_cast<uint32_t>(8));
+	QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(8));
+
+	// Samplers pin their current chunk too, but a chunk only counts once however many pins it has.
+	{
+		PagedVolume<int32_t>::Sampler sampler(volume);
+		sampler.setPosition(10, 10, 10);
+		PagedVolume<int32_t>::Sampler otherSampler(sampler);
+		QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(8));
+		sampler.setPosition(100, 100, 100);
+		QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(9));
+	}
+	QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(8));
+	movedRegion.release();
+	QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(0));
+
+	// A region which could never fit is rejected.
+	bool exceptionThrown = false;
+	try
+	{
+		volume->pinRegion(Region(0, 0, 0, 32 * chunkSideLength, 0, 0));
+	}
+	catch (std::invalid_argument&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
+	QCOMPARE(volume->getNoOfPinnedChunks(), static_cast<uint32_t>(0));
+
+	// Once every chunk is pinned the volume has to go over its limit, but it recovers once the pins are released.
+	QCOMPARE(volume->getNoOfChunkLimitOverruns(), static_cast<uint64_t>(0));
+	PagedVolume<int32_t>::PinnedRegion fullRegion = volume->pinRegion(Region(0, 0, 0, noOfChunks * chunkSideLength - 1, 0, 0));
+	volume->getVoxel(0, -1, 0);
+	QCOMPARE(volume->getNoOfChunkLimitOverruns(), static_cast<uint64_t>(1));
+	QCOMPARE(volume->calculateSizeInBytes(), (noOfChunks + 1) * chunkSizeInBytes);
+	fullRegion.release();
+	volume->getVoxel(0, -1 - chunkSideLength, 0);
+	QCOMPARE(volume->calculateSizeInBytes(), noOfChunks * chunkSizeInBytes);
+
+	delete volume;
+}
+
+void TestVolume::testRawVolumeBulkRegionCopy()
+{
+	// Reads should match getVoxel(), including the border values outside the volume.
+	QCOMPARE(countBulkReadErrors(m_pRawVolume, m_regInternal, BufferLayout::linear()), 0);
+	QCOMPARE(countBulkReadErrors(m_pRawVolume, m_regExternal, BufferLayout::linear()), 0);
+	QCOMPARE(countBulkReadErrors(m_pRawVolume, m_regExternal, BufferLayout::strided(m_regExternal.getWidthInVoxels() + 5, (m_regExternal.getWidthInVoxels() + 5) * (m_regExternal.getHeightInVoxels() + 2))), 0);
+	QCOMPARE(countBulkReadErrors(m_pRawVolume, Region(-60, -20, 100, 3, 10, 140), BufferLayout::morton()), 0);
+	QCOMPARE(countBulkReadErrors(m_pRawVolume, Region(1000, 1000, 1000, 1010, 1010, 1010), BufferLayout::linear()), 0);
+
+	RawVolume<int32_t> volume(m_regVolume);
+	QCOMPARE(countBulkWriteErrors(&volume, m_regVolume, BufferLayout::linear()), 0);
+	QCOMPARE(countBulkWriteErrors(&volume, m_regInternal, BufferLayout::strided(m_regInternal.getWidthInVoxels() + 3, (m_regInternal.getWidthInVoxels() + 3) * m_regInternal.getHeightInVoxels())), 0);
+	QCOMPARE(countBulkWriteErrors(&volume, Region(-50, -30, 20, 13, 0, 51), BufferLayout::morton()), 0);
+
+	// Unlike reads, writes must lie within the volume.
+	bool exceptionThrown = false;
+	try
+	{
+		std::vector<int32_t> buffer(BufferLayout::linear().getRequiredBufferSize(m_regExternal));
+		volume.writeRegion(m_regExternal, buffer.data());
+	}
+	catch (std::out_of_range&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
+}
+
+void TestVolume::testPagedVolumeBulkRegionCopy()
+{
+	// Reads should match getVoxel(), whether or not the region is aligned to chunks. The aligned Morton region is copied a whole chunk at a time.
+	QCOMPARE(countBulkReadErrors(m_pPagedVolumeHighMem, m_regExternal, BufferLayout::linear()), 0);
+	QCOMPARE(countBulkReadErrors(m_pPagedVolumeHighMem, m_regInternal, BufferLayout::strided(m_regInternal.getWidthInVoxels() + 1, (m_regInternal.getWidthInVoxels() + 1) * (m_regInternal.getHeightInVoxels() + 1))), 0);
+	QCOMPARE(countBulkReadErrors(m_pPagedVolumeHighMem, Region(-64, -32, 0, 63, 31, 127), BufferLayout::morton()), 0);
+	QCOMPARE(countBulkReadErrors(m_pPagedVolumeHighMem, Region(-50, -20, 17, 13, 40, 100), BufferLayout::morton()), 0);
+
+	PositionPager positionPager;
+	PagedVolume<int32_t> volume(&positionPager, 64 * 1024 * 1024, m_uChunkSideLength);
+	QCOMPARE(countBulkWriteErrors(&volume, m_regExternal, BufferLayout::linear()), 0);
+	QCOMPARE(countBulkWriteErrors(&volume, Region(-64, -32, 0, 63, 31, 127), BufferLayout::morton()), 0);
+	QCOMPARE(countBulkWriteErrors(&volume, Region(-50, -20, 17, 13, 40, 100), BufferLayout::morton()), 0);
+
+	// Uniform chunks can be read without any voxel data, and writing their own value back leaves them untouched.
+	UniformPager uniformPager;
+	PagedVolume<int32_t>* uniformVolume = new PagedVolume<int32_t>(&uniformPager, 1 * 1024 * 1024, m_uChunkSideLength);
+	const Region regSolid(-40, -64, -40, 40, -1, 40);
+	QCOMPARE(countBulkReadErrors(uniformVolume, Region(-40, -40, -40, 40, 40, 40), BufferLayout::linear()), 0);
+	QCOMPARE(countBulkReadErrors(uniformVolume, Region(-64, -64, -64, 63, 63, 63), BufferLayout::morton()), 0);
+	std::vector<int32_t> solid(BufferLayout::linear().getRequiredBufferSize(regSolid), 1);
+	uniformVolume->writeRegion(regSolid, solid.data());
+	uniformVolume->flushAll();
+	QCOMPARE(uniformPager.m_mapChunks.size(), static_cast<size_t>(0));
+
+	// A write covering part of a uniform chunk keeps the chunk's value for the rest of it.
+	QCOMPARE(countBulkWriteErrors(uniformVolume, Region(-10, -10, -10, 10, 10, 10), BufferLayout::linear()), 0);
+	QCOMPARE(uniformVolume->getVoxel(-11, -11, -11), 1);
+	QCOMPARE(uniformVolume->getVoxel(11, 11, 11), 0);
+	uniformVolume->flushAll();
+	QCOMPARE(uniformPager.m_mapChunks.size(), static_cast<size_t>(8));
+
+	delete uniformVolume;
+}
+
+void TestVolume::testRawVolumeRegionReadPerVoxel()
+{
+	std::vector<int32_t> buffer(m_regInternal.getWidthInVoxels() * m_regInternal.getHeightInVoxels() * m_regInternal.getDepthInVoxels());
+	QBENCHMARK
+	{
+		readRegionPerVoxel(m_pRawVolume, m_regInternal, buffer.data());
+	}
+	QCOMPARE(buffer.back(), m_regInternal.getUpperX() + m_regInternal.getUpperY() + m_regInternal.getUpperZ());
+}
+
+void TestVolume::testRawVolumeRegionReadBulk()
+{
+	std::vector<int32_t> buffer(m_regInternal.getWidthInVoxels() * m_regInternal.getHeightInVoxels() * m_regInternal.getDepthInVoxels());
+	QBENCHMARK
+	{
+		m_pRawVolume->readRegion(m_regInternal, buffer.data());
+	}
+	QCOMPARE(buffer.back(), m_regInternal.getUpperX() + m_regInternal.getUpperY() + m_regInternal.getUpperZ());
+}
+
+void TestVolume::testPagedVolumeRegionReadPerVoxel()
+{
+	std::vector<int32_t> buffer(m_regInternal.getWidthInVoxels() * m_regInternal.getHeightInVoxels() * m_regInternal.getDepthInVoxels());
+	QBENCHMARK
+	{
+		readRegionPerVoxel(m_pPagedVolumeHighMem, m_regInternal, buffer.data());
+	}
+	QCOMPARE(buffer.back(), m_regInternal.getUpperX() + m_regInternal.getUpperY() + m_regInternal.getUpperZ());
+}
+
+void TestVolume::testPagedVolumeRegionReadBulk()
+{
+	std::vector<int32_t> buffer(m_regInternal.getWidthInVoxels() * m_regInternal.getHeightInVoxels() * m_regInternal.getDepthInVoxels());
+	QBENCHMARK
+	{
+		m_pPagedVolumeHighMem->readRegion(m_regInternal, buffer.data());
+	}
+	QCOMPARE(buffer.back(), m_regInternal.getUpperX() + m_regInternal.getUpperY() + m_regInternal.getUpperZ());
+}
+
+void TestVolume::testRawVolumeSobelGradientAlongChunkEdges()
+{
+	int32_t result = 0;
+	int32_t noOfVoxels = 0;
+	QBENCHMARK
+	{
+		result = sumSobelGradientsAlongChunkEdges(m_pRawVolume, m_regInternal, m_uChunkSideLength, noOfVoxels);
+	}
+	// The voxel values are x + y + z, so every gradient component is minus twice the sum of the weights on one side.
+	QVERIFY(noOfVoxels > 0);
+	QCOMPARE(result, -156 * noOfVoxels);
+}
+
+void TestVolume::testPagedVolumeSobelGradientAlongChunkEdges()
+{
+	int32_t result = 0;
+	int32_t noOfVoxels = 0;
+	QBENCHMARK
+	{
+		result = sumSobelGradientsAlongChunkEdges(m_pPagedVolumeHighMem, m_regInternal, m_uChunkSideLength, noOfVoxels);
+	}
+	QVERIFY(noOfVoxels > 0);
+	QCOMPARE(result, -156 * noOfVoxels);
+}
+
+void TestVolume::testRegionView()
+{
+	RegionView<int32_t> view;
+	QCOMPARE(view.calculateSizeInBytes(), static_cast<uint32_t>(0));
+
+	// The halo takes this region outside the volume, where the view should hold the border value.
+	Region region(m_regVolume.getLowerX() - 3, 10, 20, m_regVolume.getLowerX() + 40, 50, 27);
+	view.stage(m_pPagedVolume, region, 2);
+	QCOMPARE(view.getRegion(), region);
+	QCOMPARE(view.getHaloSize(), static_cast<uint16_t>(2));
+	region.grow(2);
+	QCOMPARE(view.getStagedRegion(), region);
+
+	int32_t errors = 0;
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				if (view.getVoxel(x, y, z) != m_pPagedVolume->getVoxel(x, y, z)) errors++;
+			}
+		}
+	}
+	QCOMPARE(errors, 0);
+
+	// Staging a smaller region should reuse the existing block.
+	const uint32_t sizeInBytes = view.calculateSizeInBytes();
+	view.stage(m_pRawVolume, Region(20, 30, 40, 30, 35, 41), 1);
+	QCOMPARE(view.calculateSizeInBytes(), sizeInBytes);
+
+	RegionView<int32_t>::Sampler sampler(&view);
+	sampler.setPosition(20, 30, 40);
+	QCOMPARE(sampler.getVoxel(), 90);
+	QCOMPARE(sampler.peekVoxel1nx1ny1nz(), 87);
+	QCOMPARE(sampler.peekVoxel1px0py1pz(), 92);
+	sampler.movePositiveZ();
+	sampler.moveNegativeY();
+	QCOMPARE(sampler.peekVoxel0px1py0pz(), 91);
+	QCOMPARE(sampler.peekVoxel1px1py1pz(), 93);
+}
+
+void TestVolume::testPagedVolumeSobelGradient()
+{
+	const Region region(-40, -20, 20, 39, 59, 99);
+	int32_t result = 0;
+	int32_t noOfVoxels = 0;
+	QBENCHMARK
+	{
+		// A seam spacing of one covers every voxel in the region.
+		result = sumSobelGradientsAlongChunkEdges(m_pPagedVolumeHighMem, region, 1, noOfVoxels);
+	}
+	QCOMPARE(noOfVoxels, 80 * 80 * 80);
+	QCOMPARE(result, -156 * noOfVoxels);
+}
+
+void TestVolume::testRegionViewSobelGradient()
+{
+	const Region region(-40, -20, 20, 39, 59, 99);
+	RegionView<int32_t> view;
+	int32_t result = 0;
+	int32_t noOfVoxels = 0;
+	QBENCHMARK
+	{
+		view.stage(m_pPagedVolumeHighMem, region, 1);
+		result = sumSobelGradientsAlongChunkEdges(&view, region, 1, noOfVoxels);
+	}
+	QCOMPARE(noOfVoxels, 80 * 80 * 80);
+	QCOMPARE(result, -156 * noOfVoxels);
+}
+
+void TestVolume::testPagedVolumeRegionFilePager()
+{
+	const int32_t chunkSideLength = 16;
+	const Region regData(0, 0, 0, 4 * chunkSideLength - 1, 2 * chunkSideLength - 1, chunkSideLength - 1); // Two rows of four chunks.
+
+	// Region files persist, so remove any left behind by an earlier run.
+	std::remove("./region_0_0_0.pvr");
+
+	std::vector<int32_t> data(regData.getWidthInVoxels() * regData.getHeightInVoxels() * regData.getDepthInVoxels());
+	for (std::size_t index = 0; index < data.size(); index++)
+	{
+		data[index] = static_cast<int32_t>(index);
+	}
+
+	{
+		RegionFilePager<int32_t> pager(".", 4);
+		PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+		volume.writeRegion(regData, data.data());
+		volume.flushAll();
+		pager.compactAll();
+		QCOMPARE(pager.getStatistics().uNoOfCompactions, static_cast<uint64_t>(1));
+	}
+
+	// A new pager and volume should see the same data. After compaction each row of chunks is fetched with a single read.
+	{
+		RegionFilePager<int32_t> pager(".", 4);
+		PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+		std::vector<int32_t> readBack(data.size());
+		volume.readRegion(regData, readBack.data());
+		QVERIFY(readBack == data);
+		QCOMPARE(pager.getStatistics().uNoOfChunksPagedIn, static_cast<uint64_t>(8));
+		QCOMPARE(pager.getStatistics().uNoOfFileReads, static_cast<uint64_t>(2));
+		QCOMPARE(pager.getStatistics().uNoOfReadAheadHits, static_cast<uint64_t>(6));
+
+		// Chunks which were never written are not in any file, and reading them does not create one.
+		QCOMPARE(volume.getVoxel(-1, 0, 0), 0);
+		FILE* pFile = fopen("./region_-1_0_0.pvr", "rb");
+		QVERIFY(pFile == nullptr);
+
+		// Changes should be written back to the same file.
+		volume.setVoxel(5, 6, 7, -1);
+		volume.flushAll();
+	}
+
+	// The files are only valid for the settings they were written with.
+	{
+		RegionFilePager<int32_t> pager(".", 4);
+		PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+		QCOMPARE(volume.getVoxel(5, 6, 7), -1);
+		QCOMPARE(volume.getVoxel(63, 31, 15), static_cast<int32_t>(data.size() - 1));
+
+		RegionFilePager<int32_t> mismatchedPager(".", 8);
+		PagedVolume<int32_t> mismatchedVolume(&mismatchedPager, 1 * 1024 * 1024, chunkSideLength);
+		bool exceptionThrown = false;
+		try
+		{
+			mismatchedVolume.getVoxel(0, 0, 0);
+		}
+		catch (std::runtime_error&)
+		{
+			exceptionThrown = true;
+		}
+		QVERIFY(exceptionThrown);
+	}
+
+	std::remove("./region_0_0_0.pvr");
+}
+
+void TestVolume::testPagedVolumeMappedFilePager()
+{
+	const int32_t chunkSideLength = 16;
+	const Region regData(0, 0, 0, 4 * chunkSideLength - 1, 2 * chunkSideLength - 1, chunkSideLength - 1); // Two rows of four chunks.
+
+	std::vector<int32_t> data(regData.getWidthInVoxels() * regData.getHeightInVoxels() * regData.getDepthInVoxels());
+	for (std::size_t index = 0; index < data.size(); index++)
+	{
+		data[index] = static_cast<int32_t>(index);
+	}
+
+	{
+		RawVolume<int32_t> rawVolume(regData);
+		rawVolume.writeRegion(regData, data.data());
+		MappedFilePager<int32_t>::writeVolumeFile("./mapped_volume.pvm", &rawVolume, regData, chunkSideLength);
+	}
+
+	{
+		MappedFilePager<int32_t> pager("./mapped_volume.pvm");
+		QCOMPARE(pager.getEnclosingRegion(), regData);
+
+		PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+		std::vector<int32_t> readBack(data.size());
+		volume.readRegion(regData, readBack.data());
+		QVERIFY(readBack == data);
+		QCOMPARE(pager.getStatistics().uNoOfChunksMapped, static_cast<uint64_t>(8));
+
+		// Chunks outside the file are not mapped.
+		QCOMPARE(volume.getVoxel(-1, 0, 0), 0);
+		QCOMPARE(pager.getStatistics().uNoOfChunksMapped, static_cast<uint64_t>(8));
+
+		// Writing to a mapped chunk changes the data in place, so a sampler which is already pointing at it sees the change.
+		{
+			PagedVolume<int32_t>::Sampler sampler(&volume);
+			sampler.setPosition(5, 6, 7);
+			QCOMPARE(sampler.getVoxel(), data[5 + 6 * 64 + 7 * 64 * 32]);
+			volume.setVoxel(5, 6, 7, -1);
+			QCOMPARE(sampler.getVoxel(), -1);
+		}
+
+		// The modified chunk comes back from the pager's copy, and the others are mapped again.
+		volume.flushAll();
+		QCOMPARE(pager.getStatistics().uNoOfChunksReleased, static_cast<uint64_t>(8));
+		QCOMPARE(volume.getVoxel(5, 6, 7), -1);
+		QCOMPARE(volume.getVoxel(63, 31, 15), static_cast<int32_t>(data.size() - 1));
+		QCOMPARE(pager.getStatistics().uNoOfChunksCopied, static_cast<uint64_t>(1));
+		QCOMPARE(pager.getStatistics().uNoOfChunksMapped, static_cast<uint64_t>(9));
+	}
+
+	// The file itself is never modified, and can only be used with the chunk size it was written with.
+	{
+		MappedFilePager<int32_t> pager("./mapped_volume.pvm");
+		PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+		QCOMPARE(volume.getVoxel(5, 6, 7), data[5 + 6 * 64 + 7 * 64 * 32]);
+
+		MappedFilePager<int32_t> mismatchedPager("./mapped_volume.pvm");
+		PagedVolume<int32_t> mismatchedVolume(&mismatchedPager, 1 * 1024 * 1024, chunkSideLength * 2);
+		bool exceptionThrown = false;
+		try
+		{
+			mismatchedVolume.getVoxel(0, 0, 0);
+		}
+		catch (std::invalid_argument&)
+		{
+			exceptionThrown = true;
+		}
+		QVERIFY(exceptionThrown);
+	}
+
+	std::remove("./mapped_volume.pvm");
+}
+
+// Interleaves the bits of a (non-negative) position, with x in the lowest bit.
+uint64_t mortonCode(const Vector3DInt32& v3dPos)
+{
+	uint64_t result = 0;
+	for (uint32_t bit = 0; bit < 21; bit++)
+	{
+		result |= static_cast<uint64_t>((v3dPos.getX() >> bit) & 1) << (bit * 3);
+		result |= static_cast<uint64_t>((v3dPos.getY() >> bit) & 1) << (bit * 3 + 1);
+		result |= static_cast<uint64_t>((v3dPos.getZ() >> bit) & 1) << (bit * 3 + 2);
+	}
+	return result;
+}
+
+bool isInMortonOrder(const std::vector<Vector3DInt32>& positions)
+{
+	for (std::size_t index = 1; index < positions.size(); index++)
+	{
+		if (mortonCode(positions[index - 1]) >= mortonCode(positions[index]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void TestVolume::testPagedVolumeBatchedPaging()
+{
+	const int32_t chunkSideLength = 16;
+	const Region regPrefetch(0, 0, 0, 4 * chunkSideLength - 1, 4 * chunkSideLength - 1, 2 * chunkSideLength - 1); // 32 chunks.
+
+	BatchPager pager;
+	PagedVolume<int32_t> volume(&pager, 4 * 1024 * 1024, chunkSideLength);
+
+	// Prefetching pages in all the chunks as one batch, in Morton order.
+	volume.prefetch(regPrefetch);
+	QCOMPARE(pager.m_vecPageInBatchSizes.size(), static_cast<std::size_t>(1));
+	QCOMPARE(pager.m_vecPageInBatchSizes[0], static_cast<uint32_t>(32));
+	QVERIFY(isInMortonOrder(pager.m_vecPagedInChunks));
+
+	// The data is the same as it would be without batching, and nothing more needs paging in.
+	QCOMPARE(volume.getVoxel(0, 0, 0), 0);
+	QCOMPARE(volume.getVoxel(63, 40, 20), 48 + 32 + 16);
+	QCOMPARE(pager.m_vecPageInBatchSizes.size(), static_cast<std::size_t>(1));
+
+	// Prefetching again does nothing.
+	volume.prefetch(regPrefetch);
+	QCOMPARE(pager.m_vecPageInBatchSizes.size(), static_cast<std::size_t>(1));
+
+	// Flushing pages out all the modified chunks as one batch, in Morton order.
+	for (int32_t z = 0; z < 2; z++)
+	{
+		for (int32_t y = 0; y < 4; y++)
+		{
+			for (int32_t x = 0; x < 4; x++)
+			{
+				volume.setVoxel(x * chunkSideLength, y * chunkSideLength, z * chunkSideLength, -(x + y * 4 + z * 16));
+			}
+		}
+	}
+	volume.flushAll();
+	QCOMPARE(pager.m_vecPageOutBatchSizes.size(), static_cast<std::size_t>(1));
+	QCOMPARE(pager.m_vecPageOutBatchSizes[0], static_cast<uint32_t>(32));
+	QVERIFY(isInMortonOrder(pager.m_vecPagedOutChunks));
+
+	// Flushing again has nothing to page out, and the changes come back when the chunks are next paged in.
+	volume.flushAll();
+	QCOMPARE(pager.m_vecPageOutBatchSizes.size(), static_cast<std::size_t>(1));
+	volume.prefetch(regPrefetch);
+	QCOMPARE(pager.m_vecPageInBatchSizes.size(), static_cast<std::size_t>(2));
+	QCOMPARE(volume.getVoxel(3 * chunkSideLength, 2 * chunkSideLength, chunkSideLength), -(3 + 2 * 4 + 16));
+}
+
+void TestVolume::testPagedVolumeCompressedFilePager()
+{
+	const int32_t chunkSideLength = 16;
+	const Region regData(0, 0, 0, 4 * chunkSideLength - 1, 2 * chunkSideLength - 1, chunkSideLength - 1); // Two rows of four chunks.
+
+	// Smoothly varying data (like most terrain) which compresses well.
+	std::vector<int32_t> data(regData.getWidthInVoxels() * regData.getHeightInVoxels() * regData.getDepthInVoxels());
+	for (int32_t z = 0; z < regData.getDepthInVoxels(); z++)
+	{
+		for (int32_t y = 0; y < regData.getHeightInVoxels(); y++)
+		{
+			for (int32_t x = 0; x < regData.getWidthInVoxels(); x++)
+			{
+				data[x + y * 64 + z * 64 * 32] = (x + y) / 8 + z / 4;
+			}
+		}
+	}
+
+	const BufferOrder orders[] = { BufferOrders::Morton, BufferOrders::Linear };
+	for (const BufferOrder order : orders)
+	{
+		{
+			CompressedFilePager<int32_t> pager(".", nullptr, order);
+			PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+			volume.writeRegion(regData, data.data());
+			volume.flushAll();
+
+			CompressedFilePager<int32_t>::Statistics stats = pager.getStatistics();
+			QCOMPARE(stats.uNoOfChunksPagedOut, static_cast<uint64_t>(8));
+			QCOMPARE(stats.uNoOfUncompressedBytesWritten, static_cast<uint64_t>(data.size() * sizeof(int32_t)));
+			QVERIFY(stats.uNoOfStoredBytesWritten * 4 < stats.uNoOfUncompressedBytesWritten);
+		}
+
+		// The files persist, and can be read by a pager which writes in the other order.
+		{
+			CompressedFilePager<int32_t> pager(".", nullptr, (order == BufferOrders::Morton) ? BufferOrders::Linear : BufferOrders::Morton);
+			PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+			std::vector<int32_t> readBack(data.size());
+			volume.readRegion(regData, readBack.data());
+			QVERIFY(readBack == data);
+			QCOMPARE(pager.getStatistics().uNoOfChunksPagedIn, static_cast<uint64_t>(8));
+
+			// Chunks without a file are empty.
+			QCOMPARE(volume.getVoxel(-1, 0, 0), 0);
+		}
+	}
+
+	// Flip a byte in the middle of the data of one chunk, which is detected when it is paged in.
+	CompressedFilePager<int32_t> pager;
+	const std::string filename = pager.getFilename(Region(0, 0, 0, chunkSideLength - 1, chunkSideLength - 1, chunkSideLength - 1));
+	{
+		FILE* pFile = fopen(filename.c_str(), "r+b");
+		QVERIFY(pFile != nullptr);
+		fseek(pFile, 0L, SEEK_END);
+		const long fileSize = ftell(pFile);
+		fseek(pFile, fileSize / 2 + 16, SEEK_SET);
+		const int value = fgetc(pFile);
+		fseek(pFile, fileSize / 2 + 16, SEEK_SET);
+		fputc(value ^ 0x01, pFile);
+		fclose(pFile);
+	}
+	{
+		PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+		bool exceptionThrown = false;
+		try
+		{
+			volume.getVoxel(0, 0, 0);
+		}
+		catch (std::runtime_error&)
+		{
+			exceptionThrown = true;
+		}
+		QVERIFY(exceptionThrown);
+	}
+
+	// Any compressor can be used (though files must be read with the same one as they were written with).
+	{
+		const Region regRLE(regData.getLowerCorner() + Vector3DInt32(0, 0, chunkSideLength), regData.getUpperCorner() + Vector3DInt32(0, 0, chunkSideLength));
+		RLECompressor<int32_t, uint16_t> compressor;
+		{
+			CompressedFilePager<int32_t> rlePager(".", &compressor);
+			PagedVolume<int32_t> volume(&rlePager, 1 * 1024 * 1024, chunkSideLength);
+			volume.writeRegion(regRLE, data.data());
+		}
+
+		CompressedFilePager<int32_t> rlePager(".", &compressor);
+		PagedVolume<int32_t> volume(&rlePager, 1 * 1024 * 1024, chunkSideLength);
+		std::vector<int32_t> readBack(data.size());
+		volume.readRegion(regRLE, readBack.data());
+		QVERIFY(readBack == data);
+	}
+
+	for (int32_t z = 0; z < 2; z++)
+	{
+		for (int32_t y = 0; y < 2; y++)
+		{
+			for (int32_t x = 0; x < 4; x++)
+			{
+				Region regChunk(x * chunkSideLength, y * chunkSideLength, z * chunkSideLength, (x + 1) * chunkSideLength - 1, (y + 1) * chunkSideLength - 1, (z + 1) * chunkSideLength - 1);
+				std::remove(pager.getFilename(regChunk).c_str());
+			}
+		}
+	}
+}
+
+void TestVolume::testPagedVolumePaletteStorage()
+{
+	const uint16_t chunkSideLength = 16;
+
+	// Chunks filled with a single value take almost no space, so many more of them fit in the same memory.
+	{
+		PositionPager pager;
+		PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+		volume.setPaletteStorageEnabled(true);
+		for (uint32_t pass = 0; pass < 2; pass++)
+		{
+			for (int32_t chunk = 0; chunk < 512; chunk++)
+			{
+				volume.getVoxel(chunk * chunkSideLength, 0, 0);
+			}
+		}
+		QCOMPARE(pager.m_uNoOfPageIns, static_cast<uint32_t>(512));
+
+		PositionPager fullPager;
+		PagedVolume<int32_t> fullVolume(&fullPager, 1 * 1024 * 1024, chunkSideLength);
+		for (uint32_t pass = 0; pass < 2; pass++)
+		{
+			for (int32_t chunk = 0; chunk < 512; chunk++)
+			{
+				fullVolume.getVoxel(chunk * chunkSideLength, 0, 0);
+			}
+		}
+		QVERIFY(fullPager.m_uNoOfPageIns > 512);
+	}
+
+	// Chunks with only a few values are stored as a palette, and read back correctly through every access path.
+	MemoryPager pager;
+	PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+	PagedVolume<int32_t> fullVolume(&pager, 1 * 1024 * 1024, chunkSideLength);
+	volume.setPaletteStorageEnabled(true);
+
+	Region region(0, 0, 0, 63, 63, 63);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				volume.setVoxel(x, y, z, 100 + (x + y + z) % 3);
+				fullVolume.setVoxel(x, y, z, 100 + (x + y + z) % 3);
+			}
+		}
+	}
+	QVERIFY(volume.calculateSizeInBytes() * 8 < fullVolume.calculateSizeInBytes());
+
+	int32_t errors = 0;
+	PagedVolume<int32_t>::Sampler sampler(&volume);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			sampler.setPosition(region.getLowerX(), y, z);
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				const int32_t expected = 100 + (x + y + z) % 3;
+				if ((volume.getVoxel(x, y, z) != expected) || (sampler.getVoxel() != expected) ||
+					((x < region.getUpperX()) && (sampler.peekVoxel1px0py0pz() != 100 + (x + y + z + 1) % 3)))
+				{
+					errors++;
+				}
+				sampler.movePositiveX();
+			}
+		}
+	}
+	QCOMPARE(errors, 0);
+
+	std::vector<int32_t> regionData(region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels());
+	volume.readRegion(region, regionData.data());
+	for (size_t index = 0; index < regionData.size(); index++)
+	{
+		const int32_t x = index % 64, y = (index / 64) % 64, z = index / (64 * 64);
+		if (regionData[index] != 100 + (x + y + z) % 3)
+		{
+			errors++;
+		}
+	}
+	QCOMPARE(errors, 0);
+
+	// A sampler in a palette chunk must see the palette growing underneath it, and then the chunk being expanded to full data.
+	sampler.setPosition(64, 0, 0);
+	for (int32_t x = 0; x < chunkSideLength; x++)
+	{
+		for (int32_t y = 0; y < chunkSideLength; y++)
+		{
+			for (int32_t z = 0; z < chunkSideLength; z++)
+			{
+				volume.setVoxel(64 + x, y, z, x + y * chunkSideLength + z * chunkSideLength * chunkSideLength);
+			}
+		}
+	}
+	QCOMPARE(sampler.getVoxel(), 0);
+	QCOMPARE(sampler.peekVoxel1px1py1pz(), 1 + chunkSideLength + chunkSideLength * chunkSideLength);
+	for (int32_t x = 0; x < chunkSideLength; x++)
+	{
+		for (int32_t y = 0; y < chunkSideLength; y++)
+		{
+			for (int32_t z = 0; z < chunkSideLength; z++)
+			{
+				if (volume.getVoxel(64 + x, y, z) != x + y * chunkSideLength + z * chunkSideLength * chunkSideLength)
+				{
+					errors++;
+				}
+			}
+		}
+	}
+	QCOMPARE(errors, 0);
+
+	// Writing a region with few values in it stores it compactly again.
+	std::fill(regionData.begin(), regionData.end(), 5);
+	regionData[12345] = 6;
+	sampler.setPosition(1000, 1000, 1000);
+	const uint32_t sizeBeforeWrite = volume.calculateSizeInBytes();
+	volume.writeRegion(Region(64, 0, 0, 127, 63, 63), regionData.data());
+	QVERIFY(volume.calculateSizeInBytes() < sizeBeforeWrite + 64 * 1024);
+	QCOMPARE(volume.getVoxel(64, 0, 0), 5);
+
+	// Palette chunks are expanded for the pager, and compacted again when paged back in.
+	volume.flushAll();
+	QCOMPARE(volume.calculateSizeInBytes(), static_cast<uint32_t>(0));
+	QCOMPARE(volume.getVoxel(1, 2, 3), 100);
+	QCOMPARE(volume.getVoxel(64 + 15, 15, 15), 5);
+	QCOMPARE(volume.getVoxel(64 + (12345 % 64), (12345 / 64) % 64, 12345 / (64 * 64)), 6);
+	QVERIFY(volume.calculateSizeInBytes() < chunkSideLength * chunkSideLength * chunkSideLength * sizeof(int32_t));
+
+	// Palette storage relies on the chunks being accessed from a single thread.
+	PagedVolume<int32_t> concurrentVolume(&pager, 1 * 1024 * 1024, chunkSideLength, ChunkEvictionPolicies::LeastRecentlyUsed, true);
+	bool exceptionThrown = false;
+	try
+	{
+		concurrentVolume.setPaletteStorageEnabled(true);
+	}
+	catch (std::logic_error&)
+	{
+		exceptionThrown = true;
+	}
+	QVERIFY(exceptionThrown);
+}
+
+// A terrain like scene, with several materials below the ground and nothing above it.
+int32_t snapshotTerrainValue(int32_t x, int32_t y, int32_t z)
+{
+	return (y <= (x * 3 + z * 5) % 40) ? 1 + (x + z) % 3 : 0;
+}
+
+void TestVolume::testPagedVolumeSnapshot()
+{
+	const uint16_t chunkSideLength = 16;
+
+	MemoryPager pager;
+	PagedVolume<int32_t> volume(&pager, 4 * 1024 * 1024, chunkSideLength);
+
+	Region region(0, 0, 0, 63, 63, 63);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				volume.setVoxel(x, y, z, snapshotTerrainValue(x, y, z));
+			}
+		}
+	}
+
+	// Taking a snapshot does not copy any voxel data.
+	const uint32_t blocksInUse = volume.getChunkDataPoolStatistics().uNoOfBlocksInUse;
+	PagedVolume<int32_t>::Snapshot snapshot = volume.snapshot(region);
+	QCOMPARE(volume.getChunkDataPoolStatistics().uNoOfBlocksInUse, blocksInUse);
+	QCOMPARE(snapshot.getNoOfChunks(), static_cast<uint32_t>(64));
+	QCOMPARE(snapshot.getVersion(), static_cast<uint64_t>(1));
+	QCOMPARE(volume.snapshot(Region(0, 0, 0, 0, 0, 0)).getVersion(), static_cast<uint64_t>(2));
+
+	Region extractRegion(1, 1, 1, 62, 62, 62);
+	auto liveMesh = extractCubicMesh(&volume, extractRegion);
+	auto snapshotMesh = extractCubicMesh(&snapshot, extractRegion);
+	QVERIFY(snapshotMesh.getNoOfIndices() > 0);
+	QCOMPARE(countMeshDifferences(liveMesh, snapshotMesh), 0);
+
+	// A Sampler which is already in a chunk must still see the writes made to it, even though the chunk has to copy its data.
+	PagedVolume<int32_t>::Sampler liveSampler(&volume);
+	liveSampler.setPosition(20, 5, 5);
+	volume.setVoxel(21, 5, 5, -1);
+	QCOMPARE(volume.getChunkDataPoolStatistics().uNoOfBlocksInUse, blocksInUse + 1);
+	QCOMPARE(liveSampler.peekVoxel1px0py0pz(), -1);
+	QCOMPARE(snapshot.getVoxel(21, 5, 5), snapshotTerrainValue(21, 5, 5));
+
+	// Carve a hole through the live volume, by writing voxels and by writing a region which covers a whole chunk.
+	for (int32_t z = 30; z < 40; z++)
+	{
+		for (int32_t y = 0; y < 20; y++)
+		{
+			for (int32_t x = 30; x < 40; x++)
+			{
+				volume.setVoxel(x, y, z, 0);
+			}
+		}
+	}
+	std::vector<int32_t> emptyChunk(chunkSideLength * chunkSideLength * chunkSideLength, 0);
+	volume.writeRegion(Region(0, 0, 0, 15, 15, 15), emptyChunk.data());
+	QVERIFY(countMeshDifferences(liveMesh, extractCubicMesh(&volume, extractRegion)) != 0);
+
+	// Meanwhile the snapshot is unchanged, whether it is read directly or through samplers.
+	int32_t errors = 0;
+	PagedVolume<int32_t>::Snapshot::Sampler sampler(&snapshot);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y++)
+		{
+			sampler.setPosition(region.getLowerX(), y, z);
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
+			{
+				const int32_t expected = snapshotTerrainValue(x, y, z);
+				if ((snapshot.getVoxel(x, y, z) != expected) || (sampler.getVoxel() != expected) ||
+					((x < region.getUpperX()) && (sampler.peekVoxel1px0py0pz() != snapshotTerrainValue(x + 1, y, z))) ||
+					((x > region.getLowerX()) && (y > region.getLowerY()) && (sampler.peekVoxel1nx1ny0pz() != snapshotTerrainValue(x - 1, y - 1, z))))
+				{
+					errors++;
+				}
+				sampler.movePositiveX();
+			}
+		}
+	}
+	QCOMPARE(errors, 0);
+	QCOMPARE(snapshot.getVoxel(-1, 0, 0), 0);
+	QCOMPARE(snapshot.getVoxel(64, 0, 0), 0);
+	QCOMPARE(countMeshDifferences(liveMesh, extractCubicMesh(&snapshot, extractRegion)), 0);
+
+	// Copies share the same chunks, and the old data is only freed once the last copy has gone.
+	const uint32_t blocksInUseWithSnapshot = volume.getChunkDataPoolStatistics().uNoOfBlocksInUse;
+	{
+		PagedVolume<int32_t>::Snapshot snapshotCopy = snapshot;
+		snapshot = PagedVolume<int32_t>::Snapshot();
+		QCOMPARE(snapshot.getVoxel(40, 2, 40), 0);
+		QCOMPARE(snapshotCopy.getVoxel(35, 0, 35), snapshotTerrainValue(35, 0, 35));
+		QCOMPARE(volume.getChunkDataPoolStatistics().uNoOfBlocksInUse, blocksInUseWithSnapshot);
+	}
+	QVERIFY(volume.getChunkDataPoolStatistics().uNoOfBlocksInUse < blocksInUseWithSnapshot);
+
+	// Once no snapshot holds the data the chunk takes it back, rather than copying it when it is next written.
+	volume.snapshot(region);
+	const uint32_t blocksInUseWithoutSnapshot = volume.getChunkDataPoolStatistics().uNoOfBlocksInUse;
+	volume.setVoxel(50, 50, 50, 7);
+	QCOMPARE(volume.getChunkDataPoolStatistics().uNoOfBlocksInUse, blocksInUseWithoutSnapshot);
+	QCOMPARE(volume.getVoxel(50, 50, 50), 7);
+
+	// A snapshot keeps its data when the chunks are evicted, and can be meshed on another thread while the volume is being edited.
+	snapshot = volume.snapshot(region);
+	auto expectedMesh = extractCubicMesh(&volume, extractRegion);
+	volume.flushAll();
+	QCOMPARE(snapshot.getVoxel(50, 50, 50), 7);
+
+	decltype(expectedMesh) threadMesh;
+	std::thread meshingThread([&snapshot, &threadMesh, &extractRegion]()
+	{
+		threadMesh = extractCubicMesh(&snapshot, extractRegion);
+	});
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
+		{
+			volume.setVoxel(x, 0, z, 0);
+		}
+	}
+	meshingThread.join();
+	QCOMPARE(countMeshDifferences(expectedMesh, threadMesh), 0);
+	QCOMPARE(volume.getVoxel(20, 0, 20), 0);
+	QCOMPARE(snapshot.getVoxel(20, 0, 20), snapshotTerrainValue(20, 0, 20));
+
+	// Uniform and palette chunks are captured as well.
+	PagedVolume<int32_t> paletteVolume(&pager, 1 * 1024 * 1024, chunkSideLength);
+	paletteVolume.setPaletteStorageEnabled(true);
+	paletteVolume.writeRegion(Region(1000, 0, 0, 1015, 15, 15), emptyChunk.data());
+	paletteVolume.setVoxel(1016, 0, 0, 3);
+	auto paletteSnapshot = paletteVolume.snapshot(Region(1000, 0, 0, 1031, 15, 15));
+	paletteVolume.setVoxel(1001, 0, 0, 4);
+	paletteVolume.setVoxel(1016, 0, 0, 5);
+	QCOMPARE(paletteSnapshot.getVoxel(1001, 0, 0), 0);
+	QCOMPARE(paletteSnapshot.getVoxel(1016, 0, 0), 3);
+	QCOMPARE(paletteSnapshot.getVoxel(1017, 0, 0), paletteVolume.getVoxel(1017, 0, 0));
+
+	// Snapshots must not outlive their volumes.
+	snapshot = PagedVolume<int32_t>::Snapshot();
+}
+
+void TestVolume::testPagedVolumeChangeJournal()
+{
+	const uint16_t chunkSideLength = 16;
+
+	MemoryPager pager;
+	PagedVolume<int32_t> volume(&pager, 1 * 1024 * 1024, chunkSideLength);
+
+	// Reading does not count as a change.
+	const uint64_t initialVersion = volume.markVersion();
+	volume.getVoxel(100, 100, 100);
+	QVERIFY(volume.getModifiedRegionsSince(initialVersion).empty());
+
+	volume.setVoxel(5, 5, 5, 1);
+	std::vector<Region> modifiedRegions = volume.getModifiedRegionsSince(initialVersion);
+	QCOMPARE(modifiedRegions.size(), static_cast<size_t>(1));
+	QVERIFY(modifiedRegions[0] == Region(0, 0, 0, 15, 15, 15));
+
+	// Only the changes made after a version are reported for it.
+	const uint64_t secondVersion = volume.markVersion();
+	QVERIFY(secondVersion > initialVersion);
+	volume.setVoxel(40, 3, 3, 2);
+	std::vector<int32_t> chunkData(chunkSideLength * chunkSideLength * chunkSideLength, 3);
+	volume.writeRegion(Region(-16, 0, 0, -1, 15, 15), chunkData.data());
+	modifiedRegions = volume.getModifiedRegionsSince(secondVersion);
+	QCOMPARE(modifiedRegions.size(), static_cast<size_t>(2));
+	QVERIFY(std::find(modifiedRegions.begin(), modifiedRegions.end(), Region(32, 0, 0, 47, 15, 15)) != modifiedRegions.end());
+	QVERIFY(std::find(modifiedRegions.begin(), modifiedRegions.end(), Region(-16, 0, 0, -1, 15, 15)) != modifiedRegions.end());
+	QCOMPARE(volume.getModifiedRegionsSince(initialVersion).size(), static_cast<size_t>(3));
+	QCOMPARE(volume.getModifiedRegionsSince(0).size(), static_cast<size_t>(3));
+
+	// The changes can be given in terms of larger mesh regions, and can include the neighbouring regions which may also need to be
+	// extracted again. The chunk at the origin lies on the lower faces of its mesh region, so it touches seven neighbouring ones.
+	modifiedRegions = volume.getModifiedRegionsSince(secondVersion, 64);
+	QCOMPARE(modifiedRegions.size(), static_cast<size_t>(2));
+	QVERIFY(std::find(modifiedRegions.begin(), modifiedRegions.end(), Region(0, 0, 0, 63, 63, 63)) != modifiedRegions.end());
+	QVERIFY(std::find(modifiedRegions.begin(), modifiedRegions.end(), Region(-64, 0, 0, -1, 63, 63)) != modifiedRegions.end());
+	QCOMPARE(volume.getModifiedRegionsSince(initialVersion, 64).size(), static_cast<size_t>(2));
+	modifiedRegions = volume.getModifiedRegionsSince(initialVersion, 64, true);
+	QCOMPARE(modifiedRegions.size(), static_cast<size_t>(8));
+	QVERIFY(std::find(modifiedRegions.begin(), modifiedRegions.end(), Region(-64, -64, -64, -1, -1, -1)) != modifiedRegions.end());
+	modifiedRegions = volume.getModifiedRegionsSince(secondVersion, 0, true);
+	QCOMPARE(modifiedRegions.size(), static_cast<size_t>(2));
+	QVERIFY(std::find(modifiedRegions.begin(), modifiedRegions.end(), Region(31, -1, -1, 48, 16, 16)) != modifiedRegions.end());
+
+	// The journal outlives the chunks, and chunks which are paged back in are tracked as before.
+	volume.flushAll();
+	QCOMPARE(volume.getModifiedRegionsSince(initialVersion).size(), static_cast<size_t>(3));
+	const uint64_t thirdVersion = volume.markVersion();
+	QVERIFY(volume.getModifiedRegionsSince(thirdVersion).empty());
+	volume.setVoxel(6, 6, 6, 4);
+	modifiedRegions = volume.getModifiedRegionsSince(thirdVersion);
+	QCOMPARE(modifiedRegions.size(), static_cast<size_t>(1));
+	QVERIFY(modifiedRegions[0] == Region(0, 0, 0, 15, 15, 15));
+	QCOMPARE(volume.getModifiedRegionsSince(secondVersion).size(), static_cast<size_t>(3));
+
+	// Discarding the older changes only forgets the chunks which have not been written to since, and those which are written to
+	// again are tracked as before.
+	volume.discardChangesUpTo(thirdVersion);
+	QCOMPARE(volume.getModifiedRegionsSince(0).size(), static_cast<size_t>(1));
+	QCOMPARE(volume.getModifiedRegionsSince(thirdVersion).size(), static_cast<size_t>(1));
+	volume.setVoxel(40, 3, 3, 5);
+	QCOMPARE(volume.getModifiedRegionsSince(thirdVersion).size(), static_cast<size_t>(2));
+
+	// Writes are counted even if they leave the voxels as they were, including writing the value of a uniform chunk back to it.
+	UniformPager uniformPager;
+	PagedVolume<int32_t> uniformVolume(&uniformPager, 1 * 1024 * 1024, chunkSideLength);
+	const uint64_t uniformVersion = uniformVolume.markVersion();
+	std::vector<int32_t> emptyChunkData(chunkSideLength * chunkSideLength * chunkSideLength, 0);
+	uniformVolume.writeRegion(Region(0, 0, 16, 15, 15, 31), emptyChunkData.data());
+	modifiedRegions = uniformVolume.getModifiedRegionsSince(uniformVersion);
+	QCOMPARE(modifiedRegions.size(), static_cast<size_t>(1));
+	QVERIFY(modifiedRegions[0] == Region(0, 0, 16, 15, 15, 31));
+	uniformVolume.flushAll();
+	QCOMPARE(uniformPager.m_mapChunks.size(), static_cast<size_t>(0));
+}
+
+void TestVolume::testSparseOctreeVolumeSparseScene()
+{
+	// A solid ball in a large and otherwise empty volume.
+	const Region region(0, 0, 0, 255, 255, 255);
+	const Vector3DInt32 centre(128, 128, 128);
+	const int32_t radius = 30;
+
+	RawVolume<uint8_t> rawVolume(region);
+	SparseOctreeVolume<uint8_t> sparseVolume(region);
+	for (int32_t z = centre.getZ() - radius; z <= centre.getZ() + radius; z++)
+	{
+		for (int32_t y = centre.getY() - radius; y <= centre.getY() + radius; y++)
+		{
+			for (int32_t x = centre.getX() - radius; x <= centre.getX() + radius; x++)
+			{
+				if ((Vector3DInt32(x, y, z) - centre).lengthSquared() <= radius * radius)
+				{
+					rawVolume.setVoxel(x, y, z, 255);
+					sparseVolume.setVoxel(x, y, z, 255);
+				}
+			}
+		}
+	}
+
+	// Only the surface of the ball needs to be stored at full resolution.
+	QVERIFY(sparseVolume.calculateSizeInBytes() * 16 < rawVolume.calculateSizeInBytes());
+
+	// The surface extractors should produce exactly the same meshes from both volumes.
+	const Region extractRegion(64, 64, 64, 191, 191, 191);
+	auto rawCubicMesh = extractCubicMesh(&rawVolume, extractRegion);
+	auto sparseCubicMesh = extractCubicMesh(&sparseVolume, extractRegion);
+	QVERIFY(rawCubicMesh.getNoOfIndices() > 0);
+	QCOMPARE(countMeshDifferences(rawCubicMesh, sparseCubicMesh), 0);
+
+	auto rawMarchingCubesMesh = extractMarchingCubesMesh(&rawVolume, extractRegion);
+	auto sparseMarchingCubesMesh = extractMarchingCubesMesh(&sparseVolume, extractRegion);
+	QVERIFY(rawMarchingCubesMesh.getNoOfIndices() > 0);
+	QCOMPARE(countMeshDifferences(rawMarchingCubesMesh, sparseMarchingCubesMesh), 0);
+
+	// So should raycasting...
+	PickResult rawPick = pickVoxel(&rawVolume, Vector3DFloat(10.0f, 128.0f, 128.0f), Vector3DFloat(200.0f, 0.0f, 0.0f), 0);
+	PickResult sparsePick = pickVoxel(&sparseVolume, Vector3DFloat(10.0f, 128.0f, 128.0f), Vector3DFloat(200.0f, 0.0f, 0.0f), 0);
+	QVERIFY(sparsePick.didHit);
+	QCOMPARE(sparsePick.hitVoxel, Vector3DInt32(centre.getX() - radius, 128, 128));
+	QCOMPARE(sparsePick.hitVoxel, rawPick.hitVoxel);
+
+	// ...and pathfinding. This uses a smaller scene (a pillar which has to be climbed over) to keep the search short.
+	const Region pathRegion(0, 0, 0, 31, 31, 31);
+	RawVolume<uint8_t> rawPathVolume(pathRegion);
+	SparseOctreeVolume<uint8_t> sparsePathVolume(pathRegion);
+	for (int32_t z = 8; z < 24; z++)
+	{
+		for (int32_t y = 0; y < 28; y++)
+		{
+			for (int32_t x = 8; x < 24; x++)
+			{
+				rawPathVolume.setVoxel(x, y, z, 1);
+				sparsePathVolume.setVoxel(x, y, z, 1);
+			}
+		}
+	}
+
+	std::list<Vector3DInt32> rawPath;
+	std::list<Vector3DInt32> sparsePath;
+	AStarPathfinder< RawVolume<uint8_t> > rawPathfinder(AStarPathfinderParams< RawVolume<uint8_t> >(&rawPathVolume, Vector3DInt32(16, 4, 4), Vector3DInt32(16, 4, 28), &rawPath, 1.0f, 10000, TwentySixConnected, &isVoxelEmpty< RawVolume<uint8_t> >));
+	AStarPathfinder< SparseOctreeVolume<uint8_t> > sparsePathfinder(AStarPathfinderParams< SparseOctreeVolume<uint8_t> >(&sparsePathVolume, Vector3DInt32(16, 4, 4), Vector3DInt32(16, 4, 28), &sparsePath, 1.0f, 10000, TwentySixConnected, &isVoxelEmpty< SparseOctreeVolume<uint8_t> >));
+	rawPathfinder.execute();
+	sparsePathfinder.execute();
+	QVERIFY(sparsePath.size() > static_cast<size_t>(24));
+	QVERIFY(sparsePath == rawPath);
+
+	// Removing the ball again should collapse the tree back down to its root.
+	std::vector<uint8_t> emptyVoxels(region.getWidthInVoxels() * region.getHeightInVoxels(), 0);
+	for (int32_t z = centre.getZ() - radius; z <= centre.getZ() + radius; z++)
+	{
+		rawVolume.writeRegion(Region(0, 0, z, 255, 255, z), emptyVoxels.data());
+		sparseVolume.writeRegion(Region(0, 0, z, 255, 255, z), emptyVoxels.data());
+	}
+	QCOMPARE(sparseVolume.getNoOfNodes(), static_cast<uint32_t>(1));
+	QCOMPARE(sparseVolume.getVoxel(centre), static_cast<uint8_t>(0));
+
+	// Samplers which were in use while the volume changed must see the new values.
+	SparseOctreeVolume<uint8_t>::Sampler sampler(&sparseVolume);
+	sampler.setPosition(centre);
+	sparseVolume.setVoxel(centre + Vector3DInt32(1, 0, 0), 7);
+	QCOMPARE(sampler.getVoxel(), static_cast<uint8_t>(0));
+	QCOMPARE(sampler.peekVoxel1px0py0pz(), static_cast<uint8_t>(7));
+	sampler.movePositiveX();
+	QCOMPARE(sampler.getVoxel(), static_cast<uint8_t>(7));
+	QVERIFY(sampler.setVoxel(3));
+	QCOMPARE(sparseVolume.getVoxel(centre + Vector3DInt32(1, 0, 0)), static_cast<uint8_t>(3));
+	QCOMPARE(sampler.peekVoxel1nx0py0pz(), static_cast<uint8_t>(0));
+
+	// Reading a region back should give the same result as for the raw volume, including the border.
+	sparseVolume.setBorderValue(9);
+	rawVolume.setBorderValue(9);
+	rawVolume.setVoxel(centre + Vector3DInt32(1, 0, 0), 3);
+	const Region readRegion(centre.getX() - 40, 250, centre.getZ() - 40, centre.getX() + 40, 259, centre.getZ() + 40);
+	std::vector<uint8_t> rawVoxels(readRegion.getWidthInVoxels() * readRegion.getHeightInVoxels() * readRegion.getDepthInVoxels());
+	std::vector<uint8_t> sparseVoxels(rawVoxels.size());
+	rawVolume.readRegion(readRegion, rawVoxels.data());
+	sparseVolume.readRegion(readRegion, sparseVoxels.data());
+	QVERIFY(sparseVoxels == rawVoxels);
+
+	const Region mortonRegion(centre.getX() - 8, centre.getY() - 8, centre.getZ() - 8, centre.getX() + 7, centre.getY() + 7, centre.getZ() + 7);
+	std::vector<uint8_t> rawMortonVoxels(16 * 16 * 16);
+	std::vector<uint8_t> sparseMortonVoxels(16 * 16 * 16);
+	rawVolume.readRegion(mortonRegion, rawMortonVoxels.data(), BufferLayout::morton());
+	sparseVolume.readRegion(mortonRegion, sparseMortonVoxels.data(), BufferLayout::morton());
+	QVERIFY(sparseMortonVoxels == rawMortonVoxels);
+}
+
+void TestVolume::testBrickVolumeSharedBricks()
+{
+	// Rolling terrain of solid ground (with a few pillars of another material) under empty air. The size is not a multiple of the brick
+	// size, so the bricks at the upper edges of the volume extend outside it.
+	const Region region(-5, 3, 10, 250, 130, 265);
+	RawVolume<uint8_t> rawVolume(region);
+	BrickVolume<uint8_t> brickVolume(region, 200);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z++)
+	{
+		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x++)
+		{
+			const int32_t groundHeight = 60 + (x * 7 + z * 3) % 5 + ((x / 16 + z / 16) % 3) * 4;
+			for (int32_t y = region.getLowerY(); y < groundHeight; y++)
+			{
+				const uint8_t value = ((x % 50 == 7) && (z % 50 == 7) && (y < 20)) ? 150 : 200;
+				rawVolume.setVoxel(x, y, z, value);
+				brickVolume.setVoxel(x, y, z, value);
+			}
+		}
+	}
+
+	// Only the bricks near the surface or containing the other material need to be allocated.
+	const uint32_t noOfBricks = ((region.getWidthInVoxels() + 7) / 8) * ((region.getHeightInVoxels() + 7) / 8) * ((region.getDepthInVoxels() + 7) / 8);
+	QVERIFY(brickVolume.getNoOfAllocatedBricks() * 2 < noOfBricks);
+	QVERIFY(brickVolume.calculateSizeInBytes() * 2 < rawVolume.calculateSizeInBytes());
+
+	// Reading the whole volume back should give the same result as for the raw volume, including the border.
+	rawVolume.setBorderValue(9);
+	brickVolume.setBorderValue(9);
+	Region readRegion = region;
+	readRegion.grow(3);
+	std::vector<uint8_t> rawVoxels(readRegion.getWidthInVoxels() * readRegion.getHeightInVoxels() * readRegion.getDepthInVoxels());
+	std::vector<uint8_t> brickVoxels(rawVoxels.size());
+	rawVolume.readRegion(readRegion, rawVoxels.data());
+	brickVolume.readRegion(readRegion, brickVoxels.data());
+	QVERIFY(brickVoxels == rawVoxels);
+
+	const Region mortonRegion(240, 50, 250, 255, 65, 265);
+	std::vector<uint8_t> rawMortonVoxels(16 * 16 * 16);
+	std::vector<uint8_t> brickMortonVoxels(16 * 16 * 16);
+	rawVolume.readRegion(mortonRegion, rawMortonVoxels.data(), BufferLayout::morton());
+	brickVolume.readRegion(mortonRegion, brickMortonVoxels.data(), BufferLayout::morton());
+	QVERIFY(brickMortonVoxels == rawMortonVoxels);
+
+	// The samplers should see the same neighbours everywhere, including across brick boundaries and at the edges of the volume.
+	Region sampleRegion(-7, 55, 8, 30, 75, 40);
+	int32_t noOfMismatches = 0;
+	RawVolume<uint8_t>::Sampler rawSampler(&rawVolume);
+	BrickVolume<uint8_t>::Sampler brickSampler(&brickVolume);
+	for (int32_t z = sampleRegion.getLowerZ(); z <= sampleRegion.getUpperZ(); z++)
+	{
+		for (int32_t y = sampleRegion.getLowerY(); y <= sampleRegion.getUpperY(); y++)
+		{
+			rawSampler.setPosition(sampleRegion.getLowerX(), y, z);
+			brickSampler.setPosition(sampleRegion.getLowerX(), y, z);
+			for (int32_t x = sampleRegion.getLowerX(); x <= sampleRegion.getUpperX(); x++)
+			{
+				noOfMismatches += (brickSampler.peekVoxel1nx1ny1nz() != rawSampler.peekVoxel1nx1ny1nz()) ? 1 : 0;
+				noOfMismatches += (brickSampler.peekVoxel0px1ny0pz() != rawSampler.peekVoxel0px1ny0pz()) ? 1 : 0;
+				noOfMismatches += (brickSampler.peekVoxel1px0py1nz() != rawSampler.peekVoxel1px0py1nz()) ? 1 : 0;
+				noOfMismatches += (brickSampler.peekVoxel0px0py0pz() != rawSampler.peekVoxel0px0py0pz()) ? 1 : 0;
+				noOfMismatches += (brickSampler.peekVoxel1nx1py0pz() != rawSampler.peekVoxel1nx1py0pz()) ? 1 : 0;
+				noOfMismatches += (brickSampler.peekVoxel1px1py1pz() != rawSampler.peekVoxel1px1py1pz()) ? 1 : 0;
+				noOfMismatches += (brickSampler.getVoxel() != rawSampler.getVoxel()) ? 1 : 0;
+				rawSampler.movePositiveX();
+				brickSampler.movePositiveX();
+			}
+		}
+	}
+	QCOMPARE(noOfMismatches, 0);
+
+	// The surface extractors should produce exactly the same meshes from both volumes.
+	const Region extractRegion(-5, 40, 10, 60, 90, 70);
+	auto rawCubicMesh = extractCubicMesh(&rawVolume, extractRegion);
+	auto brickCubicMesh = extractCubicMesh(&brickVolume, extractRegion);
+	QVERIFY(rawCubicMesh.getNoOfIndices() > 0);
+	QCOMPARE(countMeshDifferences(rawCubicMesh, brickCubicMesh), 0);
+
+	auto rawMarchingCubesMesh = extractMarchingCubesMesh(&rawVolume, extractRegion);
+	auto brickMarchingCubesMesh = extractMarchingCubesMesh(&brickVolume, extractRegion);
+	QVERIFY(rawMarchingCubesMesh.getNoOfIndices() > 0);
+	QCOMPARE(countMeshDifferences(rawMarchingCubesMesh, brickMarchingCubesMesh), 0);
+
+	// The occupancy masks let whole bricks and rows be checked for emptiness.
+	QVERIFY(brickVolume.isRegionEmpty(Region(-5, 100, 10, 250, 130, 265)));
+	QVERIFY(brickVolume.isRegionEmpty(Region(0, 200, 0, 10, 300, 10)));
+	QVERIFY(!brickVolume.isRegionEmpty(Region(-5, 3, 10, 2, 10, 17)));
+	QVERIFY(!brickVolume.isRegionEmpty(Region(100, 50, 100, 100, 90, 100)));
+	QVERIFY(brickVolume.isRegionEmpty(Region(100, 60, 100, 100, 90, 100)));
+
+	// A voxel written into a shared brick gets a brick of its own, which is freed again when it becomes empty.
+	const uint32_t noOfAllocatedBricks = brickVolume.getNoOfAllocatedBricks();
+	brickVolume.setVoxel(101, 110, 102, 5);
+	QCOMPARE(brickVolume.getNoOfAllocatedBricks(), noOfAllocatedBricks + 1);
+	QVERIFY(!brickVolume.isRegionEmpty(Region(96, 104, 96, 103, 111, 103)));
+	QVERIFY(brickVolume.isRegionEmpty(Region(96, 104, 96, 100, 111, 103)));
+	QVERIFY(brickVolume.isRegionEmpty(Region(96, 104, 103, 103, 111, 103)));
+	QCOMPARE(brickVolume.getVoxel(101, 110, 102), static_cast<uint8_t>(5));
+
+	// Samplers which were in use while bricks were allocated or freed must see the new values.
+	BrickVolume<uint8_t>::Sampler sampler(&brickVolume);
+	sampler.setPosition(101, 110, 102);
+	brickVolume.setVoxel(101, 110, 102, 0);
+	QCOMPARE(brickVolume.getNoOfAllocatedBricks(), noOfAllocatedBricks);
+	QCOMPARE(sampler.getVoxel(), static_cast<uint8_t>(0));
+	brickVolume.setVoxel(102, 111, 103, 6);
+	QCOMPARE(sampler.peekVoxel1px1py1pz(), static_cast<uint8_t>(6));
+	sampler.movePositiveX();
+	QCOMPARE(sampler.peekVoxel0px1py1pz(), static_cast<uint8_t>(6));
+	QVERIFY(sampler.setVoxel(7));
+	QCOMPARE(brickVolume.getVoxel(102, 110, 102), static_cast<uint8_t>(7));
+	QCOMPARE(sampler.peekVoxel0px1py1pz(), static_cast<uint8_t>(6));
+
+	// Filling a brick with the full value frees it in favour of the shared full brick.
+	std::vector<uint8_t> fullVoxels(8 * 8 * 8, 200);
+	brickVolume.writeRegion(Region(91, 107, 98, 98, 114, 105), fullVoxels.data());
+	QCOMPARE(brickVolume.getNoOfAllocatedBricks(), noOfAllocatedBricks + 1);
+	QCOMPARE(brickVolume.getVoxel(95, 110, 100), static_cast<uint8_t>(200));
+	QVERIFY(!brickVolume.isRegionEmpty(Region(95, 110, 100, 95, 110, 100)));
+}
+
 QTEST_MAIN(TestVolume)
@@ -25,10 +25,14 @@
 #ifndef __PolyVox_TestVolume_H__
 #define __PolyVox_TestVolume_H__
 
+#include "PolyVox/BrickVolume.h"
 #include "PolyVox/FilePager.h"
+#include "PolyVox/FixedChunkPagedVolume.h"
 #include "PolyVox/PagedVolume.h"
 #include "PolyVox/RawVolume.h"
+#include "PolyVox/RegionView.h"
 #include "PolyVox/Region.h"
+#include "PolyVox/SparseOctreeVolume.h"
 
 #include <QObject>
 
@@ -49,6 +53,9 @@ private slots:
 	void testRawVolumeSamplersAllInternalBackwards();
 	void testRawVolumeDirectAccessWithExternalBackwards();
 	void testRawVolumeSamplersWithExternalBackwards();
+	void testRawVolumeWithApronSamplersAllInternalForwards();
+	void testRawVolumeWithApronSamplersWithExternalForwards();
+	void testRawVolumeApron();
 
 	void testPagedVolumeDirectAccessAllInternalForwards();
 	void testPagedVolumeSamplersAllInternalForwards();
@@ -59,12 +66,72 @@ private slots:
 	void testPagedVolumeDirectAccessWithExternalBackwards();
 	void testPagedVolumeSamplersWithExternalBackwards();
 
+	void testFixedChunkPagedVolumeDirectAccessAllInternalForwards();
+	void testFixedChunkPagedVolumeSamplersAllInternalForwards();
+	void testFixedChunkPagedVolumeDirectAccessWithExternalForwards();
+	void testFixedChunkPagedVolumeSamplersWithExternalForwards();
+	void testFixedChunkPagedVolumeDirectAccessAllInternalBackwards();
+	void testFixedChunkPagedVolumeSamplersAllInternalBackwards();
+	void testFixedChunkPagedVolumeDirectAccessWithExternalBackwards();
+	void testFixedChunkPagedVolumeSamplersWithExternalBackwards();
+
+	void testSparseOctreeVolumeDirectAccessAllInternalForwards();
+	void testSparseOctreeVolumeSamplersAllInternalForwards();
+	void testSparseOctreeVolumeDirectAccessWithExternalForwards();
+	void testSparseOctreeVolumeSamplersWithExternalForwards();
+	void testSparseOctreeVolumeDirectAccessAllInternalBackwards();
+	void testSparseOctreeVolumeSamplersAllInternalBackwards();
+	void testSparseOctreeVolumeDirectAccessWithExternalBackwards();
+	void testSparseOctreeVolumeSamplersWithExternalBackwards();
+
+	void testBrickVolumeDirectAccessAllInternalForwards();
+	void testBrickVolumeSamplersAllInternalForwards();
+	void testBrickVolumeDirectAccessWithExternalForwards();
+	void testBrickVolumeSamplersWithExternalForwards();
+	void testBrickVolumeDirectAccessAllInternalBackwards();
+	void testBrickVolumeSamplersAllInternalBackwards();
+	void testBrickVolumeDirectAccessWithExternalBackwards();
+	void testBrickVolumeSamplersWithExternalBackwards();
+
 	void testRawVolumeDirectRandomAccess();
 	void testPagedVolumeDirectRandomAccess();
 
 	void testPagedVolumeChunkLocalAccess();
 	void testPagedVolumeChunkRandomAccess();
 
+	void testPagedVolumeMissHeavyAccess();
+	void testPagedVolumeChunkEviction();
+	void testPagedVolumeConcurrentAccess();
+	void testPagedVolumeSamplerOutlivesVolume();
+	void testPagedVolumePrefetchAsync();
+	void testPagedVolumeWriteBehind();
+	void testPagedVolumeCompressedTier();
+	void testPagedVolumeUniformChunks();
+	void testPagedVolumeChunkDataPool();
+	void testPagedVolumePinnedRegion();
+
+	void testRawVolumeBulkRegionCopy();
+	void testPagedVolumeBulkRegionCopy();
+	void testRawVolumeRegionReadPerVoxel();
+	void testRawVolumeRegionReadBulk();
+	void testPagedVolumeRegionReadPerVoxel();
+	void testPagedVolumeRegionReadBulk();
+	void testRawVolumeSobelGradientAlongChunkEdges();
+	void testPagedVolumeSobelGradientAlongChunkEdges();
+	void testPagedVolumeSobelGradient();
+	void testRegionView();
+	void testRegionViewSobelGradient();
+	void testPagedVolumeRegionFilePager();
+	void testPagedVolumeMappedFilePager();
+	void testPagedVolumeBatchedPaging();
+	void testPagedVolumeCompressedFilePager();
+	void testPagedVolumePaletteStorage();
+	void testPagedVolumeSnapshot();
+	void testPagedVolumeChangeJournal();
+
+	void testSparseOctreeVolumeSparseScene();
+	void testBrickVolumeSharedBricks();
+
 private:
 	int32_t testPagedVolumeChunkAccess(uint16_t localityMask);
 
@@ -75,10 +142,15 @@ private:
 	PolyVox::Region m_regExternal;
 	PolyVox::FilePager<int32_t>* m_pFilePager;
 	PolyVox::FilePager<int32_t>* m_pFilePagerHighMem;
+	PolyVox::FilePager<int32_t>* m_pFilePagerFixedChunks;
 
 	PolyVox::RawVolume<int32_t>* m_pRawVolume;
+	PolyVox::RawVolume<int32_t>* m_pRawVolumeWithApron;
 	PolyVox::PagedVolume<int32_t>* m_pPagedVolume;
 	PolyVox::PagedVolume<int32_t>* m_pPagedVolumeHighMem;
+	PolyVox::FixedChunkPagedVolume<int32_t, m_uChunkSideLength>* m_pFixedChunkPagedVolume;
+	PolyVox::SparseOctreeVolume<int32_t>* m_pSparseOctreeVolume;
+	PolyVox::BrickVolume<int32_t>* m_pBrickVolume;
 
 	PolyVox::PagedVolume<uint32_t>::Chunk* m_pPagedVolumeChunk;
 };